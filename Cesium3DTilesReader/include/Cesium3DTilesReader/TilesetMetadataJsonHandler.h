@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Cesium3DTiles/GroupMetadata.h>
+#include <Cesium3DTiles/MetadataEntity.h>
+#include <Cesium3DTiles/Schema.h>
+#include <Cesium3DTilesReader/Library.h>
+#include <CesiumJsonReader/IJsonHandler.h>
+#include <CesiumJsonReader/JsonReaderOptions.h>
+
+#include <memory>
+#include <vector>
+
+namespace Cesium3DTilesReader {
+class GroupMetadataJsonHandler;
+class MetadataEntityJsonHandler;
+class SchemaJsonHandler;
+
+/**
+ * @brief Reads the `schema`, `metadata`, and `groups` properties of a tileset
+ * as they are encountered by another JSON handler.
+ *
+ * This allows a handler that reads the rest of a tileset.json in its own way,
+ * such as straight into the tiles of a renderer, to read the metadata without
+ * reading the whole tileset into a {@link Cesium3DTiles::Tileset}.
+ */
+class CESIUM3DTILESREADER_API TilesetMetadataJsonHandler {
+public:
+  /**
+   * @brief Constructs a new instance.
+   *
+   * @param options The options controlling how the JSON is read.
+   */
+  explicit TilesetMetadataJsonHandler(
+      const CesiumJsonReader::JsonReaderOptions& options =
+          CesiumJsonReader::JsonReaderOptions());
+  ~TilesetMetadataJsonHandler() noexcept;
+
+  /**
+   * @brief Gets the handler that reads the value of the `schema` property.
+   *
+   * @param pParent The handler to return to once the value has been read.
+   * @param schema The schema to read the value into.
+   * @return The handler to give the value to.
+   */
+  CesiumJsonReader::IJsonHandler* readSchema(
+      CesiumJsonReader::IJsonHandler* pParent,
+      Cesium3DTiles::Schema& schema);
+
+  /**
+   * @brief Gets the handler that reads the value of the `metadata` property.
+   *
+   * @param pParent The handler to return to once the value has been read.
+   * @param metadata The metadata to read the value into.
+   * @return The handler to give the value to.
+   */
+  CesiumJsonReader::IJsonHandler* readMetadata(
+      CesiumJsonReader::IJsonHandler* pParent,
+      Cesium3DTiles::MetadataEntity& metadata);
+
+  /**
+   * @brief Gets the handler that reads the value of the `groups` property.
+   *
+   * @param pParent The handler to return to once the value has been read.
+   * @param groups The groups to read the value into.
+   * @return The handler to give the value to.
+   */
+  CesiumJsonReader::IJsonHandler* readGroups(
+      CesiumJsonReader::IJsonHandler* pParent,
+      std::vector<Cesium3DTiles::GroupMetadata>& groups);
+
+private:
+  class GroupsJsonHandler;
+
+  // The handlers refer to the options, so they must be declared after them.
+  CesiumJsonReader::JsonReaderOptions _options;
+  std::unique_ptr<SchemaJsonHandler> _pSchema;
+  std::unique_ptr<MetadataEntityJsonHandler> _pMetadata;
+  std::unique_ptr<GroupsJsonHandler> _pGroups;
+};
+} // namespace Cesium3DTilesReader
@@ -0,0 +1,47 @@
+#include "GroupMetadataJsonHandler.h"
+#include "MetadataEntityJsonHandler.h"
+#include "SchemaJsonHandler.h"
+
+#include <Cesium3DTilesReader/TilesetMetadataJsonHandler.h>
+#include <CesiumJsonReader/ArrayJsonHandler.h>
+
+using namespace Cesium3DTiles;
+using namespace CesiumJsonReader;
+
+namespace Cesium3DTilesReader {
+class TilesetMetadataJsonHandler::GroupsJsonHandler
+    : public ArrayJsonHandler<GroupMetadata, GroupMetadataJsonHandler> {
+public:
+  explicit GroupsJsonHandler(const JsonReaderOptions& options) noexcept
+      : ArrayJsonHandler<GroupMetadata, GroupMetadataJsonHandler>(options) {}
+};
+
+TilesetMetadataJsonHandler::TilesetMetadataJsonHandler(
+    const JsonReaderOptions& options)
+    : _options(options),
+      _pSchema(std::make_unique<SchemaJsonHandler>(this->_options)),
+      _pMetadata(std::make_unique<MetadataEntityJsonHandler>(this->_options)),
+      _pGroups(std::make_unique<GroupsJsonHandler>(this->_options)) {}
+
+TilesetMetadataJsonHandler::~TilesetMetadataJsonHandler() noexcept = default;
+
+IJsonHandler*
+TilesetMetadataJsonHandler::readSchema(IJsonHandler* pParent, Schema& schema) {
+  this->_pSchema->reset(pParent, &schema);
+  return this->_pSchema.get();
+}
+
+IJsonHandler* TilesetMetadataJsonHandler::readMetadata(
+    IJsonHandler* pParent,
+    MetadataEntity& metadata) {
+  this->_pMetadata->reset(pParent, &metadata);
+  return this->_pMetadata.get();
+}
+
+IJsonHandler* TilesetMetadataJsonHandler::readGroups(
+    IJsonHandler* pParent,
+    std::vector<GroupMetadata>& groups) {
+  this->_pGroups->reset(pParent, &groups);
+  return this->_pGroups.get();
+}
+} // namespace Cesium3DTilesReader
@@ -31,6 +31,7 @@ class RasterOverlayTile;
 namespace Cesium3DTilesSelection {
 
 class Tile;
+class TileRenderBatch;
 
 struct TileLoadResultAndRenderResources {
   TileLoadResult result;
@@ -67,7 +68,10 @@ public:
    * arbitrary "render resources" data representing the result of the load
    * process. The loaded data may be the same as was originally given to this
    * method, or it may be modified. The render resources are passed to
-   * {@link prepareInMainThread} as the `pLoadThreadResult` parameter.
+   * {@link prepareInMainThread} as the `pLoadThreadResult` parameter. If the
+   * content is shared through {@link TilesetExternals::pTileContentRegistry},
+   * the given data is a copy of the shared content, and the modifications to
+   * its glTF model are discarded once the render resources are created.
    */
   virtual CesiumAsync::Future<TileLoadResultAndRenderResources>
   prepareInLoadThread(
@@ -156,6 +160,116 @@ public:
       int32_t overlayTextureCoordinateID,
       const CesiumRasterOverlays::RasterOverlayTile& rasterTile,
       void* pMainThreadRendererResources) noexcept = 0;
+
+  /**
+   * @brief Prepares renderer resources for a batch of merged sibling tiles.
+   * This method is invoked in the load thread.
+   *
+   * This is only called when {@link TilesetOptions::enableTileBatching} is
+   * true. The default implementation does nothing and returns `nullptr`.
+   *
+   * @param model The merged model. It may be modified by this method.
+   * @param transform The transform of the merged model.
+   * @param rendererOptions Renderer options from
+   * {@link TilesetOptions::rendererOptions}.
+   * @returns Arbitrary data representing the result of the load process. It is
+   * passed to {@link prepareBatchInMainThread} as the `pLoadThreadResult`
+   * parameter.
+   */
+  virtual void* prepareBatchInLoadThread(
+      CesiumGltf::Model& model,
+      const glm::dmat4& transform,
+      const std::any& rendererOptions);
+
+  /**
+   * @brief Further prepares renderer resources for a batch of merged sibling
+   * tiles.
+   *
+   * This is called after {@link prepareBatchInLoadThread}, and unlike that
+   * method, this one is called from the same thread that called
+   * {@link Tileset::updateView}. The default implementation does nothing and
+   * returns `nullptr`.
+   *
+   * @param batch The batch to prepare.
+   * @param pLoadThreadResult The value returned from
+   * {@link prepareBatchInLoadThread}.
+   * @returns Arbitrary data representing the result of the load process. It is
+   * available from {@link TileRenderBatch::getRenderResources}.
+   */
+  virtual void*
+  prepareBatchInMainThread(TileRenderBatch& batch, void* pLoadThreadResult);
+
+  /**
+   * @brief Frees previously-prepared renderer resources of a batch.
+   *
+   * This method is always called from the thread that called
+   * {@link Tileset::updateView} or deleted the tileset. The default
+   * implementation does nothing.
+   *
+   * @param batch The batch for which to free renderer resources.
+   * @param pLoadThreadResult The result returned by
+   * {@link prepareBatchInLoadThread}. If {@link prepareBatchInMainThread} has
+   * already been called, this parameter will be `nullptr`.
+   * @param pMainThreadResult The result returned by
+   * {@link prepareBatchInMainThread}. If {@link prepareBatchInMainThread} has
+   * not yet been called, this parameter will be `nullptr`.
+   */
+  virtual void freeBatch(
+      TileRenderBatch& batch,
+      void* pLoadThreadResult,
+      void* pMainThreadResult) noexcept;
+
+  /**
+   * @brief Prepares renderer resources for a higher resolution of one of the
+   * textures of a tile. This method is invoked in the load thread.
+   *
+   * This is only called when
+   * {@link TilesetOptions::enableProgressiveTextures} is true. The default
+   * implementation does nothing and returns `nullptr`.
+   *
+   * @param image The new image. It may be modified by this method.
+   * @param rendererOptions Renderer options from
+   * {@link TilesetOptions::rendererOptions}.
+   * @returns Arbitrary data representing the result of the load process. It is
+   * passed to {@link attachTextureInMainThread} as the `pLoadThreadResult`
+   * parameter.
+   */
+  virtual void* prepareTextureInLoadThread(
+      CesiumGltf::ImageCesium& image,
+      const std::any& rendererOptions);
+
+  /**
+   * @brief Replaces one of the textures of a tile with a higher resolution.
+   *
+   * This is called after {@link prepareTextureInLoadThread}, from the same
+   * thread that called {@link Tileset::updateView}. The image at the given
+   * index in the model of the tile has already been replaced. The default
+   * implementation does nothing.
+   *
+   * @param tile The tile whose texture is replaced.
+   * @param imageIndex The index of the image in the model of the tile.
+   * @param pLoadThreadResult The value returned from
+   * {@link prepareTextureInLoadThread}.
+   */
+  virtual void attachTextureInMainThread(
+      Tile& tile,
+      int32_t imageIndex,
+      void* pLoadThreadResult);
+
+  /**
+   * @brief Frees renderer resources prepared by
+   * {@link prepareTextureInLoadThread} that will not be attached, because the
+   * tile was unloaded in the meantime.
+   *
+   * This method is always called from the thread that called
+   * {@link Tileset::updateView} or deleted the tileset. The default
+   * implementation does nothing.
+   *
+   * @param tile The tile for which the texture was prepared.
+   * @param pLoadThreadResult The value returned from
+   * {@link prepareTextureInLoadThread}.
+   */
+  virtual void freeTexture(Tile& tile, void* pLoadThreadResult) noexcept;
 };
 
 } // namespace Cesium3DTilesSelection
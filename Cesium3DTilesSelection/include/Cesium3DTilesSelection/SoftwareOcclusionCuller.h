@@ -0,0 +1,159 @@
+#pragma once
+
+#include "BoundingVolume.h"
+#include "Library.h"
+#include "TileOcclusionRendererProxy.h"
+#include "ViewState.h"
+
+#include <CesiumGeospatial/Ellipsoid.h>
+
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+class Tile;
+
+/**
+ * @brief A {@link TileOcclusionRendererProxyPool} that determines the
+ * occlusion of tiles on the CPU, for applications that cannot issue occlusion
+ * queries to a GPU, such as headless servers.
+ *
+ * After each call to {@link Tileset::updateView}, call {@link update} with the
+ * same views and the tiles that were selected, such as
+ * {@link ViewUpdateResult::tilesToRenderThisFrame}, possibly of several
+ * tilesets. The triangles of these tiles are rasterized into a coarse depth
+ * buffer for each view. In the next call to {@link Tileset::updateView}, a
+ * tile is occluded when its bounding volume is behind these depth buffers in
+ * every view, so that tiles hidden behind terrain or large buildings are
+ * neither refined nor loaded. Like the results of GPU occlusion queries, the
+ * results lag one frame behind.
+ *
+ * Every triangle is written to the depth buffers at the depth of its farthest
+ * vertex, and only to the pixels whose four corners are all covered by the
+ * occluders, so that the pixels along their silhouettes are left empty. A
+ * bounding volume is only occluded if it is in the view, does not reach the
+ * camera, and all pixels that it may cover are closer than its nearest
+ * corner. Tiles are therefore only reported as occluded when they are hidden,
+ * apart from gaps in the occluders narrower than a pixel, although some
+ * hidden tiles are not.
+ *
+ * To use it, give an instance to
+ * {@link TilesetExternals::pTileOcclusionProxyPool} and enable
+ * {@link TilesetOptions::enableOcclusionCulling}.
+ */
+class CESIUM3DTILESSELECTION_API SoftwareOcclusionCuller final
+    : public TileOcclusionRendererProxyPool {
+public:
+  /**
+   * @brief Creates a culler without any occluders.
+   *
+   * @param maximumPoolSize The maximum number of tiles whose occlusion is
+   * tracked at the same time.
+   * @param width The width of the depth buffers, in pixels.
+   * @param height The height of the depth buffers, in pixels.
+   * @param ellipsoid The ellipsoid of the tilesets.
+   */
+  SoftwareOcclusionCuller(
+      int32_t maximumPoolSize,
+      int32_t width,
+      int32_t height,
+      const CesiumGeospatial::Ellipsoid& ellipsoid CESIUM_DEFAULT_ELLIPSOID);
+
+  /**
+   * @brief Destroys this culler and its proxies.
+   */
+  ~SoftwareOcclusionCuller() noexcept override;
+
+  /**
+   * @brief Rasterizes the given tiles into a new depth buffer for each of the
+   * given views.
+   *
+   * Tiles without render content are ignored. The tiles are not referenced
+   * after this call returns.
+   *
+   * @param views The views, which should be the ones that were given to
+   * {@link Tileset::updateView}.
+   * @param occluders The tiles that hide the tiles behind them.
+   */
+  void update(
+      const std::vector<ViewState>& views,
+      const std::vector<Tile*>& occluders);
+
+  /**
+   * @brief Determines whether the given bounding volume is hidden by the
+   * occluders in all views of the last call to {@link update}.
+   *
+   * @return {@link TileOcclusionState::Occluded} if the bounding volume is
+   * known to be hidden, and {@link TileOcclusionState::NotOccluded} otherwise,
+   * including when there are no depth buffers yet.
+   */
+  TileOcclusionState
+  computeOcclusionState(const BoundingVolume& boundingVolume) const;
+
+  /**
+   * @brief Gets the number of times {@link update} was called, so that the
+   * results of {@link computeOcclusionState} can be cached until it changes.
+   */
+  uint64_t getUpdateCount() const noexcept { return this->_updateCount; }
+
+protected:
+  TileOcclusionRendererProxy* createProxy() override;
+  void destroyProxy(TileOcclusionRendererProxy* pProxy) override;
+
+private:
+  struct DepthBuffer {
+    glm::dvec3 position;
+    glm::dvec3 direction;
+    glm::dvec3 right;
+    glm::dvec3 up;
+    double horizontalScale;
+    double verticalScale;
+
+    // The distance along the view direction to the nearest occluder, for
+    // each pixel in row-major order.
+    std::vector<float> depths;
+  };
+
+  struct ProjectedVertex {
+    double x;
+    double y;
+    double depth;
+  };
+
+  ProjectedVertex _project(
+      const DepthBuffer& buffer,
+      const glm::dvec3& position) const noexcept;
+  void _rasterizeTile(DepthBuffer& buffer, const Tile& tile);
+  void _rasterizeTriangle(
+      std::vector<float>& cornerDepths,
+      const ProjectedVertex& v0,
+      const ProjectedVertex& v1,
+      const ProjectedVertex& v2) const noexcept;
+  bool _isOccluded(
+      const DepthBuffer& buffer,
+      const glm::dvec3* pCorners,
+      size_t cornerCount) const noexcept;
+
+  int32_t _width;
+  int32_t _height;
+  CesiumGeospatial::Ellipsoid _ellipsoid;
+  uint64_t _updateCount;
+
+  // One depth buffer per view. Buffers beyond _viewCount are kept so that
+  // their storage can be reused.
+  std::vector<DepthBuffer> _buffers;
+  size_t _viewCount;
+
+  // Holds the projected vertices of a primitive while it is rasterized.
+  std::vector<ProjectedVertex> _projectedVertices;
+
+  // The depths at the corners of the pixels of the view being updated, in
+  // row-major order. Triangles are rasterized at the corners, and each pixel
+  // then takes the farthest depth of its four corners.
+  std::vector<float> _cornerDepths;
+};
+
+} // namespace Cesium3DTilesSelection
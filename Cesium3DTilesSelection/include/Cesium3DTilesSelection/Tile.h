@@ -233,9 +233,7 @@ public:
    *
    * @return The viewer request volume, or an empty optional.
    */
-  const std::optional<BoundingVolume>& getViewerRequestVolume() const noexcept {
-    return this->_viewerRequestVolume;
-  }
+  const std::optional<BoundingVolume>& getViewerRequestVolume() const noexcept;
 
   /**
    * @brief Set the viewer request volume of this tile.
@@ -245,9 +243,7 @@ public:
    * @param value The viewer request volume.
    */
   void
-  setViewerRequestVolume(const std::optional<BoundingVolume>& value) noexcept {
-    this->_viewerRequestVolume = value;
-  }
+  setViewerRequestVolume(const std::optional<BoundingVolume>& value) noexcept;
 
   /**
    * @brief Returns the geometric error of this tile.
@@ -340,7 +336,7 @@ public:
    *
    * @return The transform matrix.
    */
-  const glm::dmat4x4& getTransform() const noexcept { return this->_transform; }
+  const glm::dmat4x4& getTransform() const noexcept;
 
   /**
    * @brief Set the transformation matrix for this tile.
@@ -349,9 +345,17 @@ public:
    *
    * @param value The transform matrix.
    */
-  void setTransform(const glm::dmat4x4& value) noexcept {
-    this->_transform = value;
-  }
+  void setTransform(const glm::dmat4x4& value) noexcept;
+
+  /**
+   * @brief Set the transformation matrix for this tile to the one of another
+   * tile, sharing the matrix instead of copying it.
+   *
+   * This function is not supposed to be called by clients.
+   *
+   * @param other The tile whose transform matrix to use.
+   */
+  void shareTransform(const Tile& other) noexcept;
 
   /**
    * @brief Returns the {@link TileID} of this tile.
@@ -383,9 +387,7 @@ public:
    * @see Tile::getBoundingVolume
    */
   const std::optional<BoundingVolume>&
-  getContentBoundingVolume() const noexcept {
-    return this->_contentBoundingVolume;
-  }
+  getContentBoundingVolume() const noexcept;
 
   /**
    * @brief Set the {@link BoundingVolume} of the renderable content of this
@@ -396,9 +398,7 @@ public:
    * @param value The content bounding volume
    */
   void setContentBoundingVolume(
-      const std::optional<BoundingVolume>& value) noexcept {
-    this->_contentBoundingVolume = value;
-  }
+      const std::optional<BoundingVolume>& value) noexcept;
 
   /**
    * @brief Returns the {@link TileSelectionState} of this tile.
@@ -499,6 +499,8 @@ private:
 
   void setParent(Tile* pParent) noexcept;
 
+  void clearChildTiles() noexcept;
+
   void setState(TileLoadState state) noexcept;
 
   bool shouldContentContinueUpdating() const noexcept;
@@ -506,19 +508,29 @@ private:
   void
   setContentShouldContinueUpdating(bool shouldContentContinueUpdating) noexcept;
 
+  // The bounding volumes that most tiles do not have.
+  struct OptionalBoundingVolumes {
+    std::optional<BoundingVolume> viewerRequestVolume;
+    std::optional<BoundingVolume> contentBoundingVolume;
+  };
+
+  OptionalBoundingVolumes& getOrCreateOptionalBoundingVolumes();
+
   // Position in bounding-volume hierarchy.
   Tile* _pParent;
   std::vector<Tile> _children;
 
   // Properties from tileset.json.
   // These are immutable after the tile leaves TileState::Unloaded.
+  // To keep tiles small, the optional bounding volumes are only allocated
+  // when set, and the transform only when it is not the identity. Children
+  // usually share the transform of their parent.
   TileID _id;
   BoundingVolume _boundingVolume;
-  std::optional<BoundingVolume> _viewerRequestVolume;
-  std::optional<BoundingVolume> _contentBoundingVolume;
+  std::unique_ptr<OptionalBoundingVolumes> _pOptionalBoundingVolumes;
   double _geometricError;
   TileRefine _refine;
-  glm::dmat4x4 _transform;
+  std::shared_ptr<const glm::dmat4x4> _pTransform;
 
   // Selection state
   TileSelectionState _lastSelectionState;
@@ -13,6 +13,8 @@
 #include <vector>
 
 namespace Cesium3DTilesSelection {
+class TileRenderBatch;
+
 /**
  * @brief A content tag that indicates the {@link TilesetContentLoader} does not
  * know if a tile's content will point to a mesh content or an external
@@ -69,6 +71,14 @@ public:
    */
   TileRenderContent(CesiumGltf::Model&& model);
 
+  /**
+   * @brief Construct the content with a glTF model that is shared with the
+   * content of other tiles, such as the same tile in another tileset.
+   *
+   * @param pSharedModel A glTF model that will not be modified by this content
+   */
+  TileRenderContent(std::shared_ptr<const CesiumGltf::Model>&& pSharedModel);
+
   /**
    * @brief Retrieve a glTF model that is owned by this content
    *
@@ -77,11 +87,35 @@ public:
   const CesiumGltf::Model& getModel() const noexcept;
 
   /**
-   * @brief Retrieve a glTF model that is owned by this content
+   * @brief Retrieve a glTF model that is owned by this content and that may
+   * be modified
+   *
+   * If the model is shared with the content of other tiles, this content
+   * takes a copy of it first and no longer shares it, so that the other tiles
+   * are not affected by the modifications. Use the const {@link getModel} to
+   * only read the model.
    *
    * @return A glTF model that is owned by this content
    */
-  CesiumGltf::Model& getModel() noexcept;
+  CesiumGltf::Model& getMutableModel();
+
+  /**
+   * @brief Gets a glTF model that can be shared with other threads or the
+   * content of other tiles without copying it.
+   *
+   * If the model is not shared yet, it is moved into the returned model and
+   * this content refers to it from then on. Like any shared model, it is
+   * copied again by {@link getMutableModel}.
+   *
+   * @return The shared glTF model.
+   */
+  std::shared_ptr<const CesiumGltf::Model> shareModel();
+
+  /**
+   * @brief Determines if the glTF model of this content is shared with the
+   * content of other tiles.
+   */
+  bool isModelShared() const noexcept;
 
   /**
    * @brief Set the glTF model for this content
@@ -192,12 +226,34 @@ public:
    */
   void setLodTransitionFadePercentage(float percentage) noexcept;
 
+  /**
+   * @brief Get the {@link TileRenderBatch} that this tile's model has been
+   * merged into, if any.
+   *
+   * This will only be set when {@link TilesetOptions::enableTileBatching} is
+   * true.
+   *
+   * @return The render batch, or nullptr if this tile is not part of a batch.
+   */
+  const TileRenderBatch* getRenderBatch() const noexcept;
+
+  /**
+   * @brief Set the {@link TileRenderBatch} that this tile's model has been
+   * merged into. Not to be used by clients.
+   *
+   * @param pRenderBatch The render batch, or nullptr if this tile is no longer
+   * part of a batch.
+   */
+  void setRenderBatch(const TileRenderBatch* pRenderBatch) noexcept;
+
 private:
   CesiumGltf::Model _model;
+  std::shared_ptr<const CesiumGltf::Model> _pSharedModel;
   void* _pRenderResources;
   CesiumRasterOverlays::RasterOverlayDetails _rasterOverlayDetails;
   std::vector<CesiumUtility::Credit> _credits;
   float _lodTransitionFadePercentage;
+  const TileRenderBatch* _pRenderBatch;
 };
 
 /**
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Library.h"
+#include "TileLoadResult.h"
+
+#include <CesiumAsync/AsyncSystem.h>
+#include <CesiumAsync/SharedFuture.h>
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace Cesium3DTilesSelection {
+
+/**
+ * @brief Shares the content of tiles between {@link Tileset} instances that
+ * load the same tiles, such as several tilesets created from the same URL to
+ * render different views.
+ *
+ * Give the same registry to the {@link TilesetExternals} of each tileset. The
+ * first tileset to load a tile downloads and decodes its glTF, and the other
+ * tilesets wait for that load and then share its result, so that only one
+ * copy of the glTF is held in memory for as long as any tileset uses it. Each
+ * tileset still creates its own renderer resources and keeps its own
+ * selection state. The renderer of each tileset prepares a copy of the glTF
+ * in {@link IPrepareRendererResources::prepareInLoadThread}, so changes it
+ * makes to that copy are not kept.
+ *
+ * Content is identified by the key returned by
+ * {@link TilesetContentLoader::getTileContentKey}, usually its URL, together
+ * with the {@link TilesetContentOptions} of the tileset, so that only
+ * tilesets with the same options share content. Tiles with raster overlays
+ * are not shared, because their glTF holds texture coordinates for the
+ * overlays of their own tileset. Each tileset counts the shared content
+ * towards its own {@link TilesetOptions::maximumCachedBytes}.
+ *
+ * The methods of this class may be called from any thread.
+ */
+class CESIUM3DTILESSELECTION_API TileContentRegistry final {
+public:
+  /**
+   * @brief Creates an empty registry.
+   */
+  TileContentRegistry();
+
+  /**
+   * @brief Looks up the content with the given key for a tileset that is about
+   * to load it.
+   *
+   * @param asyncSystem The async system of the tileset.
+   * @param key The key of the content.
+   * @return A future that resolves to the content once it is loaded by another
+   * tileset, or to nullptr if that tileset could not share it. Or
+   * `std::nullopt` if no other tileset holds or is loading the content, in
+   * which case the caller must load it and then call either
+   * {@link finishLoading} or {@link cancelLoading}.
+   */
+  std::optional<
+      CesiumAsync::SharedFuture<std::shared_ptr<const TileLoadResult>>>
+  beginLoading(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& key);
+
+  /**
+   * @brief Shares the content that was loaded after {@link beginLoading}
+   * returned `std::nullopt`.
+   *
+   * @param key The key of the content.
+   * @param result The successfully loaded and post-processed glTF content. It
+   * must not have a {@link TileLoadResult::tileInitializer}.
+   * @return The shared content. It can be found in the registry until the last
+   * reference to it is released.
+   */
+  std::shared_ptr<const TileLoadResult>
+  finishLoading(const std::string& key, TileLoadResult&& result);
+
+  /**
+   * @brief Gives up sharing content after {@link beginLoading} returned
+   * `std::nullopt`, because it could not be loaded or is not a glTF.
+   *
+   * The tilesets waiting for the content receive nullptr.
+   *
+   * @param key The key of the content.
+   */
+  void cancelLoading(const std::string& key);
+
+  /**
+   * @brief Gets the number of contents that are currently shared or being
+   * loaded.
+   */
+  size_t size() const;
+
+private:
+  struct State;
+  std::shared_ptr<State> _pState;
+};
+
+} // namespace Cesium3DTilesSelection
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "Library.h"
+
+#include <CesiumGltf/Model.h>
+
+#include <glm/mat4x4.hpp>
+#include <gsl/span>
+
+#include <cstdint>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+class Tile;
+
+/**
+ * @brief A single glTF model built by merging the content of several small
+ * sibling leaf tiles, so that they can be rendered with one set of renderer
+ * resources instead of one per tile.
+ *
+ * Render batches are only created when
+ * {@link TilesetOptions::enableTileBatching} is true. A batch is created once
+ * all children of a tile are loaded leaf tiles with render content smaller
+ * than {@link TilesetOptions::maximumBatchedTileBytes}. It is freed as soon as
+ * any of its members is unloaded, and rebuilt when that member is loaded
+ * again.
+ *
+ * A batch is reported in {@link ViewUpdateResult::batchesToRenderThisFrame}
+ * only in frames where all of its members are selected for rendering. In such
+ * a frame, the renderer should draw the batch instead of the individual member
+ * tiles.
+ */
+class CESIUM3DTILESSELECTION_API TileRenderBatch final {
+public:
+  /**
+   * @brief Describes the part of the merged model that came from one member
+   * tile.
+   */
+  struct Member {
+    /**
+     * @brief The tile whose content was merged into the batch.
+     */
+    Tile* pTile;
+
+    /**
+     * @brief The index of the node in the merged model that holds the content
+     * of this tile. All nodes that came from this tile are descendants of this
+     * node, and its transform places the tile's content relative to
+     * {@link TileRenderBatch::getTransform}.
+     */
+    int32_t rootNode;
+
+    /**
+     * @brief The index of the first mesh in the merged model that came from
+     * this tile.
+     */
+    int32_t firstMesh;
+
+    /**
+     * @brief The number of meshes in the merged model that came from this
+     * tile.
+     */
+    int32_t meshCount;
+  };
+
+  /**
+   * @brief Constructs a new batch.
+   *
+   * This function is not supposed to be called by clients.
+   *
+   * @param parent The tile whose children are merged into this batch.
+   * @param members The member tiles and where their content is found in the
+   * merged model.
+   * @param model The merged model.
+   * @param transform The transform from the merged model's coordinates to
+   * ECEF.
+   */
+  TileRenderBatch(
+      Tile& parent,
+      std::vector<Member>&& members,
+      CesiumGltf::Model&& model,
+      const glm::dmat4x4& transform) noexcept;
+
+  /**
+   * @brief Gets the tile whose children are merged into this batch.
+   */
+  Tile& getParent() noexcept { return *this->_pParent; }
+
+  /** @copydoc TileRenderBatch::getParent() */
+  const Tile& getParent() const noexcept { return *this->_pParent; }
+
+  /**
+   * @brief Gets the member tiles of this batch.
+   */
+  gsl::span<const Member> getMembers() const noexcept {
+    return gsl::span<const Member>(this->_members);
+  }
+
+  /**
+   * @brief Gets the merged model.
+   *
+   * The model never has a `CESIUM_RTC` extension and its `gltfUpAxis` is
+   * always Z, because the transforms of the individual tiles are baked into
+   * the node of each member.
+   */
+  const CesiumGltf::Model& getModel() const noexcept { return this->_model; }
+
+  /** @copydoc TileRenderBatch::getModel() */
+  CesiumGltf::Model& getModel() noexcept { return this->_model; }
+
+  /**
+   * @brief Gets the transform from the merged model's coordinates to ECEF.
+   */
+  const glm::dmat4x4& getTransform() const noexcept {
+    return this->_transform;
+  }
+
+  /**
+   * @brief Gets the renderer resources created for this batch by
+   * {@link IPrepareRendererResources::prepareBatchInMainThread}.
+   */
+  void* getRenderResources() const noexcept { return this->_pRenderResources; }
+
+  /**
+   * @brief Sets the renderer resources of this batch.
+   *
+   * This function is not supposed to be called by clients.
+   *
+   * @param pRenderResources The renderer resources.
+   */
+  void setRenderResources(void* pRenderResources) noexcept {
+    this->_pRenderResources = pRenderResources;
+  }
+
+  /**
+   * @brief Determines the number of bytes in this batch's geometry and texture
+   * data.
+   */
+  int64_t computeByteSize() const noexcept;
+
+private:
+  Tile* _pParent;
+  std::vector<Member> _members;
+  CesiumGltf::Model _model;
+  glm::dmat4x4 _transform;
+  void* _pRenderResources;
+};
+
+} // namespace Cesium3DTilesSelection
@@ -11,6 +11,7 @@
 #include "ViewUpdateResult.h"
 
 #include <CesiumAsync/AsyncSystem.h>
+#include <CesiumUtility/CountingAllocator.h>
 #include <CesiumUtility/IntrusivePointer.h>
 
 #include <rapidjson/fwd.h>
@@ -18,9 +19,11 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace Cesium3DTilesSelection {
+class MultiViewCuller;
 class TilesetContentManager;
 class TilesetMetadata;
 
@@ -190,6 +193,36 @@ public:
   const ViewUpdateResult&
   updateViewOffline(const std::vector<ViewState>& frustums);
 
+  /**
+   * @brief Selects the tiles for many independent sets of views, such as the
+   * cameras of separate images or sensors, and waits for all tiles that meet
+   * sse in any of them to finish loading.
+   *
+   * Each set of views is selected as by {@link Tileset::updateViewOffline}.
+   * The sets are traversed in turn, so the loads of all of them are scheduled
+   * together, up to {@link TilesetOptions::maximumSimultaneousTileLoads}, and
+   * a tile needed by several sets is only loaded once. Loaded tiles are not
+   * unloaded until the returned future resolves, so that the tiles of all sets
+   * are still loaded when it does.
+   *
+   * The selection makes progress in the main thread whenever main thread
+   * tasks are dispatched, so no frame loop is needed: waiting for the returned
+   * future with {@link CesiumAsync::Future::waitInMainThread} is enough. A set
+   * of views is only traversed again after one of the tiles it is waiting for
+   * finishes loading, and the asset accessor is only ticked then, so it must
+   * complete requests without calls to
+   * {@link CesiumAsync::IAssetAccessor::tick}.
+   * `updateView` must not be called, and the tileset must not be destroyed,
+   * until the future resolves.
+   *
+   * @param viewSets The sets of {@link ViewState}s to select tiles for.
+   * @returns A future that resolves to the result for each set of views, in
+   * the same order. The tiles in the results are valid until the next call to
+   * `updateView` or until the tileset is destroyed, whichever comes first.
+   */
+  CesiumAsync::Future<std::vector<ViewUpdateResult>>
+  updateViewSetsOffline(std::vector<std::vector<ViewState>> viewSets);
+
   /**
    * @brief Updates this view, returning the set of tiles to render in this
    * view.
@@ -330,7 +363,8 @@ private:
    */
   struct FrameState {
     const std::vector<ViewState>& frustums;
-    std::vector<double> fogDensities;
+    const MultiViewCuller& culler;
+    const CesiumUtility::CountingVector<double>& fogDensities;
     int32_t lastFrameNumber;
     int32_t currentFrameNumber;
   };
@@ -381,12 +415,12 @@ private:
       CullResult& cullResult);
   void _fogCull(
       const FrameState& frameState,
-      const std::vector<double>& distances,
+      const CesiumUtility::CountingVector<double>& distances,
       CullResult& cullResult);
   bool _meetsSse(
       const std::vector<ViewState>& frustums,
       const Tile& tile,
-      const std::vector<double>& distances,
+      const CesiumUtility::CountingVector<double>& distances,
       bool culled) const noexcept;
 
   TraversalDetails _visitTileIfNeeded(
@@ -423,17 +457,45 @@ private:
       double tilePriority,
       bool queuedForLoad);
 
-  void _processWorkerThreadLoadQueue();
+  void _processWorkerThreadLoadQueue(const std::vector<ViewState>& frustums);
   void _processMainThreadLoadQueue();
 
   void _unloadCachedTiles(double timeBudget) noexcept;
   void _markTileVisited(Tile& tile) noexcept;
 
+  // Selects the tiles for the views, but only unloads tiles and prunes
+  // subtrees if unloadTiles is true.
+  const ViewUpdateResult& _updateView(
+      const std::vector<ViewState>& frustums,
+      float deltaTime,
+      bool unloadTiles);
+
+  struct OfflineViewSets;
+  void _updateViewSetsOffline(
+      const std::shared_ptr<OfflineViewSets>& pState,
+      bool traverseAll);
+  void _updateViewSetsOfflineAfter(
+      CesiumAsync::Future<void>&& future,
+      const std::shared_ptr<OfflineViewSets>& pState,
+      bool traverseAll);
+
   void _updateLodTransitions(
       const FrameState& frameState,
       float deltaTime,
       ViewUpdateResult& result) const noexcept;
 
+  void _updateTilesToShowAndHide(ViewUpdateResult& result);
+
+  // Updates the texture resolution of the rendered tiles, after
+  // _updateTilesToShowAndHide.
+  void _updateTextureResolutions(
+      const std::vector<ViewState>& frustums,
+      const ViewUpdateResult& result);
+
+  void _pruneUnusedSubtrees(int32_t currentFrameNumber);
+  bool _canPruneDescendants(Tile& tile, int32_t lastUnusedFrameNumber);
+  void _removeDescendantsFromLoadedTiles(Tile& tile) noexcept;
+
   TilesetExternals _externals;
   CesiumAsync::AsyncSystem _asyncSystem;
 
@@ -442,6 +504,11 @@ private:
   int32_t _previousFrameNumber;
   ViewUpdateResult _updateResult;
 
+  // The tiles rendered after the previous and the current call to updateView,
+  // used to find the tiles that are shown or hidden.
+  CesiumUtility::FlatHashSet<Tile*> _tilesRenderedLastFrame;
+  CesiumUtility::FlatHashSet<Tile*> _tilesRenderedThisFrame;
+
   enum class TileLoadPriorityGroup {
     /**
      * @brief Low priority tiles that aren't needed right now, but
@@ -493,18 +560,32 @@ private:
     }
   };
 
-  std::vector<TileLoadTask> _mainThreadLoadQueue;
-  std::vector<TileLoadTask> _workerThreadLoadQueue;
+  // The number of allocations of the containers below that the tile selection
+  // reuses between calls to updateView, reported in
+  // ViewUpdateResult::selectionAllocations.
+  size_t _selectionAllocations;
+
+  CesiumUtility::CountingVector<TileLoadTask> _mainThreadLoadQueue;
+  CesiumUtility::CountingVector<TileLoadTask> _workerThreadLoadQueue;
 
   Tile::LoadedLinkedList _loadedTiles;
 
   // Holds computed distances, to avoid allocating them on the heap during tile
   // selection.
-  std::vector<double> _distances;
+  CesiumUtility::CountingVector<double> _distances;
 
   // Holds the occlusion proxies of the children of a tile. Store them in this
   // scratch variable so that it can allocate only when growing bigger.
-  std::vector<const TileOcclusionRendererProxy*> _childOcclusionProxies;
+  CesiumUtility::CountingVector<const TileOcclusionRendererProxy*>
+      _childOcclusionProxies;
+
+  // The following hold the temporaries of a call to updateView. They are reset
+  // at the start of every call but keep their storage, so that selecting tiles
+  // for the same views does not allocate once all lists have grown to size.
+  CesiumUtility::CountingVector<double> _fogDensities;
+  std::unique_ptr<MultiViewCuller> _pCuller;
+  CesiumUtility::CountingVector<uint8_t> _visibility;
+  CesiumUtility::CountingVector<std::pair<uint32_t, Tile*>> _pruningCandidates;
 
   CesiumUtility::IntrusivePointer<TilesetContentManager>
       _pTilesetContentManager;
@@ -19,6 +19,7 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 namespace Cesium3DTilesSelection {
@@ -145,5 +146,33 @@ public:
       const Tile& tile,
       const CesiumGeospatial::Ellipsoid& ellipsoid
           CESIUM_DEFAULT_ELLIPSOID) = 0;
+
+  /**
+   * @brief Gets a key that identifies the content of a tile independently of
+   * the tileset that loads it, usually the URL of the content.
+   *
+   * Tilesets that share a {@link TileContentRegistry} share the content of
+   * tiles with the same key. The default implementation returns an empty
+   * string, so that the content of the tiles of this loader is never shared.
+   *
+   * @param tile The tile.
+   * @return The key, or an empty string if the content of the tile cannot be
+   * shared.
+   */
+  virtual std::string getTileContentKey(const Tile& tile) const;
+
+  /**
+   * @brief Notifies the loader that the children of a tile are about to be
+   * destroyed because they have not been used for a while.
+   *
+   * The children are created again with {@link createTileChildren}, or by
+   * loading the tile again if it has external content, when they are needed.
+   * The loader may free anything it keeps only for the children and their
+   * descendants, which are still alive when this is called. The default
+   * implementation does nothing.
+   *
+   * @param tile The tile whose children are about to be destroyed.
+   */
+  virtual void releaseTileChildren(const Tile& tile);
 };
 } // namespace Cesium3DTilesSelection
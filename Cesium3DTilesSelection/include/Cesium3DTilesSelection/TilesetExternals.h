@@ -9,7 +9,9 @@
 #include <memory>
 
 namespace CesiumAsync {
+class EndpointCache;
 class IAssetAccessor;
+class ICacheDatabase;
 class ITaskProcessor;
 } // namespace CesiumAsync
 
@@ -19,6 +21,7 @@ class CreditSystem;
 
 namespace Cesium3DTilesSelection {
 class IPrepareRendererResources;
+class TileContentRegistry;
 
 /**
  * @brief External interfaces used by a {@link Tileset}.
@@ -65,10 +68,51 @@ public:
    * tile bounding volumes.
    *
    * If not specified, the traversal will not attempt to leverage occlusion
-   * information.
+   * information. Applications that cannot query occlusion from a GPU can use
+   * a {@link SoftwareOcclusionCuller}.
    */
   std::shared_ptr<TileOcclusionRendererProxyPool> pTileOcclusionProxyPool =
       nullptr;
+
+  /**
+   * @brief A database in which to persist content that is derived from the
+   * tileset, such as the proxies created when
+   * {@link TilesetOptions::enableProxyContent} is true.
+   *
+   * If not specified, derived content is not persisted between sessions.
+   */
+  std::shared_ptr<CesiumAsync::ICacheDatabase> pCacheDatabase = nullptr;
+
+  /**
+   * @brief A registry through which this tileset shares the content of its
+   * tiles with the other tilesets given the same registry, so that the tiles
+   * they have in common are only loaded and held in memory once.
+   *
+   * The {@link IPrepareRendererResources} of each tileset prepares its own
+   * copy of shared content, but the tile then holds the shared model rather
+   * than that copy. Changes that
+   * {@link IPrepareRendererResources::prepareInLoadThread} makes to the model,
+   * such as freeing the pixels of images that were uploaded to the GPU, are
+   * discarded, and the shared model is counted in full in the memory usage of
+   * each tileset that holds it.
+   *
+   * If not specified, the tileset loads its own copy of all content.
+   */
+  std::shared_ptr<TileContentRegistry> pTileContentRegistry = nullptr;
+
+  /**
+   * @brief The cache of the Cesium ion asset endpoints that tell a tileset
+   * loaded from Cesium ion where and how to load the asset.
+   *
+   * To persist the endpoints between sessions, so that tilesets start
+   * loading without requesting the endpoint first, give it a database and
+   * allow it to persist access tokens. The response of every Cesium ion asset
+   * endpoint holds an access token, so a cache that is not allowed to persist
+   * them only keeps the endpoints in memory. Give the same cache to
+   * {@link CesiumRasterOverlays::IonRasterOverlay}s to share it with them. If
+   * not specified, {@link CesiumAsync::EndpointCache::getDefault} is used.
+   */
+  std::shared_ptr<CesiumAsync::EndpointCache> pEndpointCache = nullptr;
 };
 
 } // namespace Cesium3DTilesSelection
@@ -11,6 +11,10 @@
 #include <string>
 #include <vector>
 
+namespace CesiumGltfReader {
+class SharedImageCache;
+}
+
 namespace Cesium3DTilesSelection {
 
 class ITileExcluder;
@@ -41,6 +45,19 @@ struct CESIUM3DTILESSELECTION_API TilesetContentOptions {
    */
   bool generateMissingNormalsSmooth = false;
 
+  /**
+   * @brief Whether to reorder the triangles and vertices of loaded meshes for
+   * more efficient rendering.
+   *
+   * When true, each glTF is run through
+   * {@link CesiumGltfContent::GltfUtilities::optimizeMeshes} in a worker
+   * thread before it is passed to
+   * {@link IPrepareRendererResources::prepareInLoadThread}. This reduces the
+   * cost of vertex processing and overdraw on the GPU for content whose
+   * triangles are poorly ordered, at the cost of more time spent loading.
+   */
+  bool optimizeMeshes = false;
+
   /**
    * @brief For each possible input transmission format, this struct names
    * the ideal target gpu-compressed pixel format to transcode to.
@@ -54,6 +71,20 @@ struct CESIUM3DTILESSELECTION_API TilesetContentOptions {
    * shader.
    */
   bool applyTextureTransform = true;
+
+  /**
+   * @brief The cache through which the images of the loaded glTFs are fetched
+   * and decoded, so that images that are used by many tiles, or by several
+   * tilesets given the same cache, are fetched and decoded only once. The
+   * images of the tiles then reference the shared pixels in
+   * `CesiumGltf::ImageCesium::pSharedPixelData` rather than holding their own
+   * copy in `pixelData`.
+   *
+   * If not specified, the images of each tile are fetched and decoded
+   * separately.
+   */
+  std::shared_ptr<CesiumGltfReader::SharedImageCache> pSharedImageCache =
+      nullptr;
 };
 
 /**
@@ -238,6 +269,17 @@ struct CESIUM3DTILESSELECTION_API TilesetOptions {
    */
   bool renderTilesUnderCamera = true;
 
+  /**
+   * @brief Whether to report the tiles to render for each of the views given
+   * to {@link Tileset::updateView} separately, in
+   * {@link ViewUpdateResult::tilesToRenderPerView}.
+   *
+   * Tiles are always selected by a single traversal for all views, so enabling
+   * this does not change which tiles are loaded or rendered. It lets clients
+   * that render the views separately skip the tiles outside of each view.
+   */
+  bool enablePerViewRenderLists = false;
+
   /**
    * @brief A list of interfaces that are given an opportunity to exclude tiles
    * from loading and rendering. If any of the excluders indicate that a tile
@@ -306,6 +348,125 @@ struct CESIUM3DTILESSELECTION_API TilesetOptions {
    */
   double tileCacheUnloadTimeLimit = 0.0;
 
+  /**
+   * @brief Whether to merge the content of small sibling leaf tiles into
+   * render batches.
+   *
+   * When all children of a tile are loaded leaf tiles whose render content is
+   * no larger than {@link maximumBatchedTileBytes}, their models are merged
+   * into a single {@link TileRenderBatch} in a worker thread. Batches are
+   * reported in {@link ViewUpdateResult::batchesToRenderThisFrame} so that the
+   * client can issue one draw for many small tiles. Tiles with raster overlays
+   * are never batched.
+   */
+  bool enableTileBatching = false;
+
+  /**
+   * @brief The maximum size, in bytes, of a tile's render content for the
+   * tile to be merged into a {@link TileRenderBatch}.
+   *
+   * Only applicable when {@link enableTileBatching} is true.
+   */
+  int64_t maximumBatchedTileBytes = 256 * 1024;
+
+  /**
+   * @brief Whether to generate simplified proxy content for tiles that have
+   * no content of their own.
+   *
+   * When all children of a content-less, unconditionally-refined tile are
+   * loaded, their models are merged, simplified, and given downsampled
+   * textures in a worker thread. The result becomes the content of the parent
+   * tile, so that distant areas can be rendered from a single lightweight
+   * model instead of from all of the children. If
+   * {@link TilesetExternals::pCacheDatabase} is set, the proxies are stored in
+   * it and reused by later sessions. A proxy that is unloaded is loaded or
+   * built again when one of the children finishes loading. Tilesets with
+   * raster overlays never get proxies.
+   */
+  bool enableProxyContent = false;
+
+  /**
+   * @brief The fraction of the children's triangles to aim for in a proxy.
+   *
+   * Only applicable when {@link enableProxyContent} is true.
+   */
+  float proxySimplificationRatio = 0.1f;
+
+  /**
+   * @brief The largest error that simplification may introduce into a proxy,
+   * relative to the extent of each mesh.
+   *
+   * Only applicable when {@link enableProxyContent} is true.
+   */
+  float proxySimplificationError = 0.01f;
+
+  /**
+   * @brief The maximum width and height, in pixels, of the textures of a
+   * proxy. Larger textures are downsampled.
+   *
+   * Only applicable when {@link enableProxyContent} is true.
+   */
+  int32_t maximumProxyTextureSize = 256;
+
+  /**
+   * @brief Whether to store a binary snapshot of the tiles created from the
+   * tileset.json in {@link TilesetExternals::pCacheDatabase}.
+   *
+   * When a tileset is later created from the same URL and the response for
+   * the tileset.json has the same `ETag` or `Last-Modified` header, its tiles
+   * are rebuilt from the snapshot instead of by parsing the JSON, which is
+   * much faster for large tilesets. Responses with neither header, tilesets
+   * with metadata, and the tiles of external tilesets are not cached.
+   */
+  bool enableTileHierarchyCache = false;
+
+  /**
+   * @brief Whether to load the textures of tiles at a reduced resolution first
+   * and stream in the higher resolutions as the tiles grow on screen.
+   *
+   * When a tile is loaded, the images embedded in its glTF are halved until
+   * they are no larger than {@link minimumProgressiveTextureSize}. The images
+   * are still decoded in full before they are halved, so this saves memory and
+   * upload time, but not decoding time. While the tile is rendered and covers
+   * more pixels, a higher resolution is decoded again from the embedded image
+   * in a worker thread and handed to the renderer with
+   * {@link IPrepareRendererResources::prepareTextureInLoadThread} and
+   * {@link IPrepareRendererResources::attachTextureInMainThread}. Content
+   * shared through {@link TilesetExternals::pTileContentRegistry} and images
+   * that are compressed or referenced by URI are always loaded in full.
+   */
+  bool enableProgressiveTextures = false;
+
+  /**
+   * @brief The width and height, in pixels, below which textures are not
+   * reduced.
+   *
+   * Only applicable when {@link enableProgressiveTextures} is true.
+   */
+  int32_t minimumProgressiveTextureSize = 256;
+
+  /**
+   * @brief Whether to destroy the tiles below a tile when none of them has
+   * been visited in the last {@link subtreePruningFrames} frames and none of
+   * them has content loaded.
+   *
+   * The tiles of external tilesets and the tiles created by subdividing
+   * other tiles, such as those of implicit tilesets, terrain, and raster
+   * overlay upsampling, are otherwise kept for the lifetime of the tileset,
+   * even after their content is unloaded. Destroyed tiles are created again
+   * when they are needed, which may require loading their subtree
+   * availability or external tileset again.
+   */
+  bool enableSubtreePruning = false;
+
+  /**
+   * @brief The number of frames in which a tile must not have been visited
+   * for it to be destroyed.
+   *
+   * Only applicable when {@link enableSubtreePruning} is true.
+   */
+  int32_t subtreePruningFrames = 600;
+
   /**
    * @brief Options for configuring the parsing of a {@link Tileset}'s content
    * and construction of Gltf models.
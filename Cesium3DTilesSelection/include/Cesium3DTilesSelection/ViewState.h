@@ -100,6 +100,13 @@ public:
     return this->_verticalFieldOfView;
   }
 
+  /**
+   * @brief Gets the planes of the view frustum, with normals pointing inwards.
+   */
+  const CullingVolume& getCullingVolume() const noexcept {
+    return this->_cullingVolume;
+  }
+
   /**
    * @brief Returns whether the given {@link BoundingVolume} is visible for this
    * camera
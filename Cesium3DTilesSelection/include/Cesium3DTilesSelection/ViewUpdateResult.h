@@ -2,12 +2,14 @@
 
 #include "Library.h"
 
+#include <CesiumUtility/FlatHashSet.h>
+
 #include <cstdint>
-#include <unordered_set>
 #include <vector>
 
 namespace Cesium3DTilesSelection {
 class Tile;
+class TileRenderBatch;
 
 /**
  * @brief Reports the results of {@link Tileset::updateView}.
@@ -30,6 +32,17 @@ public:
    */
   std::vector<Tile*> tilesToRenderThisFrame;
 
+  /**
+   * @brief For each view given to {@link Tileset::updateView}, in the same
+   * order, the tiles of {@link tilesToRenderThisFrame} that are inside the
+   * frustum of that view or, if
+   * {@link TilesetOptions::renderTilesUnderCamera} is true, under its camera.
+   *
+   * This is only populated when
+   * {@link TilesetOptions::enablePerViewRenderLists} is true.
+   */
+  std::vector<std::vector<Tile*>> tilesToRenderPerView;
+
   /**
    * @brief Tiles on this list are no longer selected for rendering.
    *
@@ -37,7 +50,36 @@ public:
    * fading out. If a tile's {TileRenderContent::lodTransitionPercentage} is 0
    * or lod transitions are disabled, the tile should be hidden right away.
    */
-  std::unordered_set<Tile*> tilesFadingOut;
+  CesiumUtility::FlatHashSet<Tile*> tilesFadingOut;
+
+  /**
+   * @brief The tiles in {@link tilesToRenderThisFrame} that were not in it
+   * after the previous call to {@link Tileset::updateView}.
+   *
+   * Together with {@link tilesToHideThisFrame}, this lets clients update the
+   * visibility of their tiles in proportion to the number of tiles that
+   * changed rather than to the number of tiles that are rendered.
+   */
+  std::vector<Tile*> tilesToShowThisFrame;
+
+  /**
+   * @brief The tiles that were in {@link tilesToRenderThisFrame} after the
+   * previous call to {@link Tileset::updateView}, but are not anymore.
+   *
+   * These tiles may also be in {@link tilesFadingOut}. Their content may have
+   * been unloaded already, in which case the client was told to free it.
+   */
+  std::vector<Tile*> tilesToHideThisFrame;
+
+  /**
+   * @brief The render batches whose members are all in
+   * {@link tilesToRenderThisFrame} and fully faded in this frame.
+   *
+   * The client should render each of these batches instead of its member
+   * tiles. This is only populated when
+   * {@link TilesetOptions::enableTileBatching} is true.
+   */
+  std::vector<const TileRenderBatch*> batchesToRenderThisFrame;
 
   /**
    * @brief The number of tiles in the worker thread load queue.
@@ -49,6 +91,15 @@ public:
    */
   int32_t mainThreadTileLoadQueueLength = 0;
 
+  /**
+   * @brief The number of times that the containers that the tileset reuses
+   * between calls to {@link Tileset::updateView} allocated during this call.
+   *
+   * These containers only allocate when they grow, so once the tileset has
+   * selected the tiles of the same views a few times, this is 0.
+   */
+  uint32_t selectionAllocations = 0;
+
   //! @cond Doxygen_Suppress
   uint32_t tilesVisited = 0;
   uint32_t culledTilesVisited = 0;
@@ -3,14 +3,18 @@
 #include "LayerJsonTerrainLoader.h"
 #include "TilesetJsonLoader.h"
 
+#include <CesiumAsync/EndpointCache.h>
 #include <CesiumAsync/IAssetAccessor.h>
 #include <CesiumAsync/IAssetResponse.h>
+#include <CesiumAsync/Promise.h>
+#include <CesiumUtility/Assert.h>
 #include <CesiumUtility/JsonHelpers.h>
 #include <CesiumUtility/Uri.h>
 
+#include <modp_b64.h>
 #include <rapidjson/document.h>
 
-#include <unordered_map>
+#include <algorithm>
 
 namespace Cesium3DTilesSelection {
 namespace {
@@ -26,7 +30,70 @@ struct AssetEndpoint {
   std::vector<AssetEndpointAttribution> attributions;
 };
 
-std::unordered_map<std::string, AssetEndpoint> endpointCache;
+const std::shared_ptr<CesiumAsync::EndpointCache>&
+getEndpointCache(const TilesetExternals& externals) {
+  return externals.pEndpointCache ? externals.pEndpointCache
+                                  : CesiumAsync::EndpointCache::getDefault();
+}
+
+// How long before the access token of an asset expires to request a new one.
+constexpr std::chrono::minutes tokenRenewalMargin{5};
+
+/**
+ * @brief Gets the time at which to request a new access token to replace the
+ * given one, from the expiration time in the payload of the JSON Web Token.
+ *
+ * @param token The access token.
+ * @return The time, or `std::nullopt` if the token has no expiration time.
+ */
+std::optional<std::chrono::system_clock::time_point>
+getTokenRenewalTime(const std::string& token) {
+  const size_t startPos = token.find('.');
+  if (startPos == std::string::npos) {
+    return std::nullopt;
+  }
+
+  const size_t endPos = token.find('.', startPos + 1);
+  if (endPos == std::string::npos || endPos == startPos + 1) {
+    return std::nullopt;
+  }
+
+  std::string encoded = token.substr(startPos + 1, endPos - startPos - 1);
+
+  // JSON Web Tokens use the URL-safe base64 alphabet without padding, but
+  // modp_b64_decode expects the standard alphabet with padding.
+  std::replace(encoded.begin(), encoded.end(), '-', '+');
+  std::replace(encoded.begin(), encoded.end(), '_', '/');
+  const size_t remainder = encoded.size() % 4;
+  if (remainder != 0) {
+    encoded.resize(encoded.size() + 4 - remainder, '=');
+  }
+
+  std::string decoded(modp_b64_decode_len(encoded.size()), '\0');
+  const size_t decodedLength =
+      modp_b64_decode(decoded.data(), encoded.data(), encoded.size());
+  if (decodedLength == 0 || decodedLength == std::string::npos) {
+    return std::nullopt;
+  }
+
+  decoded.resize(decodedLength);
+
+  rapidjson::Document payload;
+  payload.Parse(decoded.data(), decoded.size());
+  if (payload.HasParseError() || !payload.IsObject()) {
+    return std::nullopt;
+  }
+
+  const int64_t expirationTime =
+      CesiumUtility::JsonHelpers::getInt64OrDefault(payload, "exp", -1);
+  if (expirationTime < 0) {
+    return std::nullopt;
+  }
+
+  return std::chrono::system_clock::time_point(
+             std::chrono::seconds(expirationTime)) -
+         tokenRenewalMargin;
+}
 
 std::string createEndpointResource(
     int64_t ionAssetID,
@@ -68,6 +135,43 @@ std::optional<std::string> getNewAccessToken(
       "");
 }
 
+/**
+ * @brief The parts of a {@link TileLoadInput} needed to load the tile again
+ * later, such as after the access token is refreshed.
+ *
+ * The tile, content options, and request headers belong to the tileset and
+ * outlive the load of the tile, but the other parts of the input are copied.
+ */
+struct DeferredTileLoadInput {
+  explicit DeferredTileLoadInput(const TileLoadInput& loadInput)
+      : tile(loadInput.tile),
+        contentOptions(loadInput.contentOptions),
+        asyncSystem(loadInput.asyncSystem),
+        pAssetAccessor(loadInput.pAssetAccessor),
+        pLogger(loadInput.pLogger),
+        requestHeaders(loadInput.requestHeaders),
+        ellipsoid(loadInput.ellipsoid) {}
+
+  TileLoadInput toLoadInput() const {
+    return TileLoadInput(
+        tile,
+        contentOptions,
+        asyncSystem,
+        pAssetAccessor,
+        pLogger,
+        requestHeaders,
+        ellipsoid);
+  }
+
+  const Tile& tile;
+  const TilesetContentOptions& contentOptions;
+  CesiumAsync::AsyncSystem asyncSystem;
+  std::shared_ptr<CesiumAsync::IAssetAccessor> pAssetAccessor;
+  std::shared_ptr<spdlog::logger> pLogger;
+  const std::vector<CesiumAsync::IAssetAccessor::THeader>& requestHeaders;
+  CesiumGeospatial::Ellipsoid ellipsoid;
+};
+
 CesiumAsync::Future<TilesetContentLoaderResult<CesiumIonTilesetLoader>>
 mainThreadLoadTilesetJsonFromAssetEndpoint(
     const TilesetExternals& externals,
@@ -104,6 +208,8 @@ mainThreadLoadTilesetJsonFromAssetEndpoint(
           [credits = std::move(credits),
            requestHeaders,
            ionAssetID,
+           endpointAccessToken = endpoint.accessToken,
+           pEndpointCache = getEndpointCache(externals),
            ionAccessToken = std::move(ionAccessToken),
            ionAssetEndpointUrl = std::move(ionAssetEndpointUrl),
            headerChangeListener = std::move(headerChangeListener),
@@ -124,8 +230,10 @@ mainThreadLoadTilesetJsonFromAssetEndpoint(
                   ionAssetID,
                   std::move(ionAccessToken),
                   std::move(ionAssetEndpointUrl),
+                  endpointAccessToken,
                   std::move(tilesetJsonResult.pLoader),
                   std::move(headerChangeListener),
+                  pEndpointCache,
                   ellipsoid);
               result.pRootTile = std::move(tilesetJsonResult.pRootTile);
               result.credits = std::move(tilesetJsonResult.credits);
@@ -133,6 +241,7 @@ mainThreadLoadTilesetJsonFromAssetEndpoint(
             }
             result.errors = std::move(tilesetJsonResult.errors);
             result.statusCode = tilesetJsonResult.statusCode;
+            result.tilesetVersion = std::move(tilesetJsonResult.tilesetVersion);
             return result;
           });
 }
@@ -178,6 +287,8 @@ mainThreadLoadLayerJsonFromAssetEndpoint(
                         credits = std::move(credits),
                         requestHeaders,
                         ionAssetID,
+                        endpointAccessToken = endpoint.accessToken,
+                        pEndpointCache = getEndpointCache(externals),
                         ionAccessToken = std::move(ionAccessToken),
                         ionAssetEndpointUrl = std::move(ionAssetEndpointUrl),
                         headerChangeListener = std::move(headerChangeListener)](
@@ -198,8 +309,10 @@ mainThreadLoadLayerJsonFromAssetEndpoint(
               ionAssetID,
               std::move(ionAccessToken),
               std::move(ionAssetEndpointUrl),
+              endpointAccessToken,
               std::move(tilesetJsonResult.pLoader),
               std::move(headerChangeListener),
+              pEndpointCache,
               ellipsoid);
           result.pRootTile = std::move(tilesetJsonResult.pRootTile);
           result.credits = std::move(tilesetJsonResult.credits);
@@ -312,7 +425,6 @@ mainThreadHandleEndpointResponse(
     endpoint.type = type;
     endpoint.url = url;
     endpoint.accessToken = accessToken;
-    endpointCache[requestUrl] = endpoint;
     return mainThreadLoadLayerJsonFromAssetEndpoint(
         externals,
         contentOptions,
@@ -327,7 +439,6 @@ mainThreadHandleEndpointResponse(
     endpoint.type = type;
     endpoint.url = url;
     endpoint.accessToken = accessToken;
-    endpointCache[requestUrl] = endpoint;
     return mainThreadLoadTilesetJsonFromAssetEndpoint(
         externals,
         endpoint,
@@ -344,62 +455,94 @@ mainThreadHandleEndpointResponse(
       fmt::format("Received unsupported asset response type: {}", type));
   return externals.asyncSystem.createResolvedFuture(std::move(result));
 }
+
+CesiumAsync::Future<TilesetContentLoaderResult<CesiumIonTilesetLoader>>
+loadFromAssetEndpoint(
+    const TilesetExternals& externals,
+    const TilesetContentOptions& contentOptions,
+    int64_t ionAssetID,
+    const std::string& ionAccessToken,
+    const std::string& ionAssetEndpointUrl,
+    const CesiumIonTilesetLoader::AuthorizationHeaderChangeListener&
+        headerChangeListener,
+    bool showCreditsOnScreen,
+    const CesiumGeospatial::Ellipsoid& ellipsoid) {
+  std::string ionUrl =
+      createEndpointResource(ionAssetID, ionAccessToken, ionAssetEndpointUrl);
+  return getEndpointCache(externals)
+      ->get(externals.asyncSystem, externals.pAssetAccessor, ionUrl)
+      .thenInMainThread(
+          [externals,
+           ellipsoid,
+           ionAssetID,
+           ionAccessToken = ionAccessToken,
+           ionAssetEndpointUrl = ionAssetEndpointUrl,
+           headerChangeListener = headerChangeListener,
+           showCreditsOnScreen,
+           contentOptions](
+              std::shared_ptr<CesiumAsync::IAssetRequest>&& pRequest) mutable {
+            return mainThreadHandleEndpointResponse(
+                externals,
+                std::move(pRequest),
+                ionAssetID,
+                std::move(ionAccessToken),
+                std::move(ionAssetEndpointUrl),
+                contentOptions,
+                std::move(headerChangeListener),
+                showCreditsOnScreen,
+                ellipsoid);
+          });
+}
 } // namespace
 
 CesiumIonTilesetLoader::CesiumIonTilesetLoader(
     int64_t ionAssetID,
     std::string&& ionAccessToken,
     std::string&& ionAssetEndpointUrl,
+    const std::string& endpointAccessToken,
     std::unique_ptr<TilesetContentLoader>&& pAggregatedLoader,
     AuthorizationHeaderChangeListener&& headerChangeListener,
+    const std::shared_ptr<CesiumAsync::EndpointCache>& pEndpointCache,
     const CesiumGeospatial::Ellipsoid& ellipsoid)
     : _ellipsoid{ellipsoid},
       _refreshTokenState{TokenRefreshState::None},
+      _tokenRefreshed{},
+      _tokenVersion{0},
+      _tokenRenewalTime{getTokenRenewalTime(endpointAccessToken)},
       _ionAssetID{ionAssetID},
       _ionAccessToken{std::move(ionAccessToken)},
       _ionAssetEndpointUrl{std::move(ionAssetEndpointUrl)},
       _pAggregatedLoader{std::move(pAggregatedLoader)},
-      _headerChangeListener{std::move(headerChangeListener)} {}
+      _headerChangeListener{std::move(headerChangeListener)},
+      _pEndpointCache{pEndpointCache} {}
 
 CesiumAsync::Future<TileLoadResult>
 CesiumIonTilesetLoader::loadTileContent(const TileLoadInput& loadInput) {
-  if (this->_refreshTokenState == TokenRefreshState::Loading) {
-    return loadInput.asyncSystem.createResolvedFuture(
-        TileLoadResult::createRetryLaterResult(nullptr));
-  } else if (this->_refreshTokenState == TokenRefreshState::Failed) {
+  if (this->_refreshTokenState == TokenRefreshState::Failed) {
     return loadInput.asyncSystem.createResolvedFuture(
         TileLoadResult::createFailedResult(nullptr));
   }
 
-  const auto& asyncSystem = loadInput.asyncSystem;
-  const auto& pAssetAccessor = loadInput.pAssetAccessor;
-  const auto& pLogger = loadInput.pLogger;
-
-  // TODO: the way this is structured, requests already in progress
-  // with the old key might complete after the key has been updated,
-  // and there's nothing here clever enough to avoid refreshing the
-  // key _again_ in that instance.
-  auto refreshTokenInMainThread =
-      [this, pLogger, pAssetAccessor, asyncSystem]() {
-        this->refreshTokenInMainThread(pLogger, pAssetAccessor, asyncSystem);
-      };
+  // Request a new token shortly before the current one expires, so that
+  // requests keep using the current one in the meantime instead of failing.
+  if (this->_tokenRenewalTime &&
+      this->_refreshTokenState != TokenRefreshState::Loading) {
+    const std::chrono::system_clock::time_point now =
+        std::chrono::system_clock::now();
+    if (now >= *this->_tokenRenewalTime) {
+      this->refreshTokenInMainThread(
+          loadInput.pLogger,
+          loadInput.pAssetAccessor,
+          loadInput.asyncSystem,
+          now >= *this->_tokenRenewalTime + tokenRenewalMargin);
+    }
+  }
 
-  return this->_pAggregatedLoader->loadTileContent(loadInput).thenImmediately(
-      [asyncSystem,
-       refreshTokenInMainThread = std::move(refreshTokenInMainThread)](
-          TileLoadResult&& result) mutable {
-        // check to see if we need to refresh token
-        if (result.pCompletedRequest) {
-          auto response = result.pCompletedRequest->response();
-          if (response->statusCode() == 401) {
-            // retry later
-            result.state = TileLoadResultState::RetryLater;
-            asyncSystem.runInMainThread(std::move(refreshTokenInMainThread));
-          }
-        }
+  if (this->_refreshTokenState == TokenRefreshState::Loading) {
+    return this->loadTileContentAfterTokenRefresh(loadInput);
+  }
 
-        return std::move(result);
-      });
+  return this->loadTileContentWithCurrentToken(loadInput, true);
 }
 
 TileChildrenResult CesiumIonTilesetLoader::createTileChildren(
@@ -409,52 +552,166 @@ TileChildrenResult CesiumIonTilesetLoader::createTileChildren(
   return pLoader->createTileChildren(tile, ellipsoid);
 }
 
+std::string
+CesiumIonTilesetLoader::getTileContentKey(const Tile& tile) const {
+  // Tiles are not shared while the token is refreshed, so that they are loaded
+  // again later through this loader.
+  if (this->_refreshTokenState == TokenRefreshState::Loading ||
+      this->_refreshTokenState == TokenRefreshState::Failed) {
+    return std::string();
+  }
+
+  return this->_pAggregatedLoader->getTileContentKey(tile);
+}
+
+void CesiumIonTilesetLoader::releaseTileChildren(const Tile& tile) {
+  auto pLoader = tile.getLoader();
+  pLoader->releaseTileChildren(tile);
+}
+
+CesiumAsync::Future<TileLoadResult>
+CesiumIonTilesetLoader::loadTileContentWithCurrentToken(
+    const TileLoadInput& loadInput,
+    bool retryIfUnauthorized) {
+  return this->_pAggregatedLoader->loadTileContent(loadInput).thenImmediately(
+      [this,
+       tokenVersion = this->_tokenVersion,
+       retryIfUnauthorized,
+       deferredInput = DeferredTileLoadInput(loadInput)](
+          TileLoadResult&& result) -> CesiumAsync::Future<TileLoadResult> {
+        const CesiumAsync::AsyncSystem& asyncSystem = deferredInput.asyncSystem;
+        const CesiumAsync::IAssetResponse* pResponse =
+            result.pCompletedRequest ? result.pCompletedRequest->response()
+                                     : nullptr;
+        if (!pResponse || pResponse->statusCode() != 401) {
+          return asyncSystem.createResolvedFuture(std::move(result));
+        }
+
+        if (!retryIfUnauthorized) {
+          // The request was already sent again with a new token.
+          result.state = TileLoadResultState::RetryLater;
+          return asyncSystem.createResolvedFuture(std::move(result));
+        }
+
+        // Unless the token changed since this request was sent, refresh it.
+        // Then send the request again with the new token.
+        return asyncSystem.runInMainThread([this,
+                                            tokenVersion,
+                                            deferredInput]() {
+          if (this->_tokenVersion == tokenVersion) {
+            this->refreshTokenInMainThread(
+                deferredInput.pLogger,
+                deferredInput.pAssetAccessor,
+                deferredInput.asyncSystem,
+                true);
+          }
+
+          return this->loadTileContentAfterTokenRefresh(
+              deferredInput.toLoadInput());
+        });
+      });
+}
+
+CesiumAsync::Future<TileLoadResult>
+CesiumIonTilesetLoader::loadTileContentAfterTokenRefresh(
+    const TileLoadInput& loadInput) {
+  CESIUM_ASSERT(this->_tokenRefreshed);
+  return this->_tokenRefreshed->thenInMainThread(
+      [this, deferredInput = DeferredTileLoadInput(loadInput)]() {
+        if (this->_refreshTokenState == TokenRefreshState::Failed) {
+          return deferredInput.asyncSystem.createResolvedFuture(
+              TileLoadResult::createFailedResult(nullptr));
+        }
+
+        // The token may have expired again while this request was waiting.
+        if (this->_refreshTokenState == TokenRefreshState::Loading) {
+          return this->loadTileContentAfterTokenRefresh(
+              deferredInput.toLoadInput());
+        }
+
+        return this->loadTileContentWithCurrentToken(
+            deferredInput.toLoadInput(),
+            false);
+      });
+}
+
 void CesiumIonTilesetLoader::refreshTokenInMainThread(
     const std::shared_ptr<spdlog::logger>& pLogger,
     const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAssetAccessor,
-    const CesiumAsync::AsyncSystem& asyncSystem) {
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    bool tokenExpired) {
   if (this->_refreshTokenState == TokenRefreshState::Loading) {
     return;
   }
 
-  this->_refreshTokenState = TokenRefreshState::Loading;
+  if (this->_refreshTokenState == TokenRefreshState::Renewing) {
+    // A new token is already on its way. If the current one has expired in
+    // the meantime, new requests have to wait for it.
+    if (tokenExpired) {
+      this->_refreshTokenState = TokenRefreshState::Loading;
+    }
+    return;
+  }
+
+  this->_refreshTokenState =
+      tokenExpired ? TokenRefreshState::Loading : TokenRefreshState::Renewing;
+
+  CesiumAsync::Promise<void> refreshed = asyncSystem.createPromise<void>();
+  this->_tokenRefreshed = refreshed.getFuture().share();
 
   std::string url = createEndpointResource(
       this->_ionAssetID,
       this->_ionAccessToken,
       this->_ionAssetEndpointUrl);
-  pAssetAccessor->get(asyncSystem, url)
+  // Discard the endpoint response with the old token, so that the endpoint is
+  // requested again rather than the cached response being returned.
+  this->_pEndpointCache->invalidate(url);
+  this->_pEndpointCache->get(asyncSystem, pAssetAccessor, url)
       .thenInMainThread(
-          [this,
-           pLogger](std::shared_ptr<CesiumAsync::IAssetRequest>&& pIonRequest) {
+          [pLogger](std::shared_ptr<CesiumAsync::IAssetRequest>&& pIonRequest)
+              -> std::optional<std::string> {
             const CesiumAsync::IAssetResponse* pIonResponse =
                 pIonRequest->response();
-
             if (!pIonResponse) {
-              this->_refreshTokenState = TokenRefreshState::Failed;
-              return;
+              return std::nullopt;
             }
 
             uint16_t statusCode = pIonResponse->statusCode();
-            if (statusCode >= 200 && statusCode < 300) {
-              auto accessToken = getNewAccessToken(pIonResponse, pLogger);
-              if (accessToken) {
-                this->_headerChangeListener(
-                    "Authorization",
-                    "Bearer " + *accessToken);
-
-                // update cache with new access token
-                auto cacheIt = endpointCache.find(pIonRequest->url());
-                if (cacheIt != endpointCache.end()) {
-                  cacheIt->second.accessToken = accessToken.value();
-                }
-
-                this->_refreshTokenState = TokenRefreshState::Done;
-                return;
-              }
+            if (statusCode < 200 || statusCode >= 300) {
+              return std::nullopt;
             }
 
-            this->_refreshTokenState = TokenRefreshState::Failed;
+            return getNewAccessToken(pIonResponse, pLogger);
+          })
+      .catchInMainThread(
+          [pLogger](std::exception&& e) -> std::optional<std::string> {
+            SPDLOG_LOGGER_ERROR(
+                pLogger,
+                "Error when refreshing Cesium ion access token: {}",
+                e.what());
+            return std::nullopt;
+          })
+      .thenInMainThread(
+          [this, refreshed](std::optional<std::string>&& accessToken) {
+            if (accessToken) {
+              this->_headerChangeListener(
+                  "Authorization",
+                  "Bearer " + *accessToken);
+              ++this->_tokenVersion;
+              this->_tokenRenewalTime = getTokenRenewalTime(*accessToken);
+              this->_refreshTokenState = TokenRefreshState::Done;
+            } else if (
+                this->_refreshTokenState == TokenRefreshState::Renewing) {
+              // The current token has not expired yet, so keep using it until
+              // it is rejected.
+              this->_tokenRenewalTime.reset();
+              this->_refreshTokenState = TokenRefreshState::Done;
+            } else {
+              this->_refreshTokenState = TokenRefreshState::Failed;
+            }
+
+            // Send the requests that were waiting for the new token.
+            refreshed.resolve();
           });
 }
 
@@ -468,106 +725,38 @@ CesiumIonTilesetLoader::createLoader(
     const AuthorizationHeaderChangeListener& headerChangeListener,
     bool showCreditsOnScreen,
     const CesiumGeospatial::Ellipsoid& ellipsoid) {
-  std::string ionUrl =
-      createEndpointResource(ionAssetID, ionAccessToken, ionAssetEndpointUrl);
-  auto cacheIt = endpointCache.find(ionUrl);
-  if (cacheIt != endpointCache.end()) {
-    const auto& endpoint = cacheIt->second;
-    if (endpoint.type == "TERRAIN") {
-      return mainThreadLoadLayerJsonFromAssetEndpoint(
-                 externals,
-                 contentOptions,
-                 endpoint,
-                 ionAssetID,
-                 ionAccessToken,
-                 ionAssetEndpointUrl,
-                 headerChangeListener,
-                 showCreditsOnScreen,
-                 ellipsoid)
-          .thenInMainThread(
-              [externals,
-               ellipsoid,
-               contentOptions,
-               ionAssetID,
-               ionAccessToken,
-               ionAssetEndpointUrl,
-               headerChangeListener,
-               showCreditsOnScreen](
-                  TilesetContentLoaderResult<CesiumIonTilesetLoader>&& result) {
-                return refreshTokenIfNeeded(
-                    externals,
-                    contentOptions,
-                    ionAssetID,
-                    ionAccessToken,
-                    ionAssetEndpointUrl,
-                    headerChangeListener,
-                    showCreditsOnScreen,
-                    std::move(result),
-                    ellipsoid);
-              });
-    } else if (endpoint.type == "3DTILES") {
-      return mainThreadLoadTilesetJsonFromAssetEndpoint(
-                 externals,
-                 endpoint,
-                 ionAssetID,
-                 ionAccessToken,
-                 ionAssetEndpointUrl,
-                 headerChangeListener,
-                 showCreditsOnScreen,
-                 ellipsoid)
-          .thenInMainThread(
-              [externals,
-               contentOptions,
-               ionAssetID,
-               ionAccessToken,
-               ionAssetEndpointUrl,
-               headerChangeListener,
-               showCreditsOnScreen,
-               ellipsoid](
-                  TilesetContentLoaderResult<CesiumIonTilesetLoader>&& result) {
-                return refreshTokenIfNeeded(
-                    externals,
-                    contentOptions,
-                    ionAssetID,
-                    ionAccessToken,
-                    ionAssetEndpointUrl,
-                    headerChangeListener,
-                    showCreditsOnScreen,
-                    std::move(result),
-                    ellipsoid);
-              });
-    }
-
-    TilesetContentLoaderResult<CesiumIonTilesetLoader> result;
-    result.errors.emplaceError(fmt::format(
-        "Received unsupported asset response type: {}",
-        endpoint.type));
-    return externals.asyncSystem.createResolvedFuture(std::move(result));
-  } else {
-    return externals.pAssetAccessor->get(externals.asyncSystem, ionUrl)
-        .thenInMainThread(
-            [externals,
-             ellipsoid,
+  return loadFromAssetEndpoint(
+             externals,
+             contentOptions,
              ionAssetID,
-             ionAccessToken = ionAccessToken,
-             ionAssetEndpointUrl = ionAssetEndpointUrl,
-             headerChangeListener = headerChangeListener,
+             ionAccessToken,
+             ionAssetEndpointUrl,
+             headerChangeListener,
              showCreditsOnScreen,
-             contentOptions](std::shared_ptr<CesiumAsync::IAssetRequest>&&
-                                 pRequest) mutable {
-              return mainThreadHandleEndpointResponse(
-                  externals,
-                  std::move(pRequest),
-                  ionAssetID,
-                  std::move(ionAccessToken),
-                  std::move(ionAssetEndpointUrl),
-                  contentOptions,
-                  std::move(headerChangeListener),
-                  showCreditsOnScreen,
-                  ellipsoid);
-            });
-  }
+             ellipsoid)
+      .thenInMainThread(
+          [externals,
+           contentOptions,
+           ionAssetID,
+           ionAccessToken,
+           ionAssetEndpointUrl,
+           headerChangeListener,
+           showCreditsOnScreen,
+           ellipsoid](
+              TilesetContentLoaderResult<CesiumIonTilesetLoader>&& result) {
+            return refreshTokenIfNeeded(
+                externals,
+                contentOptions,
+                ionAssetID,
+                ionAccessToken,
+                ionAssetEndpointUrl,
+                headerChangeListener,
+                showCreditsOnScreen,
+                std::move(result),
+                ellipsoid);
+          });
 }
+
 CesiumAsync::Future<TilesetContentLoaderResult<CesiumIonTilesetLoader>>
 CesiumIonTilesetLoader::refreshTokenIfNeeded(
     const TilesetExternals& externals,
@@ -581,11 +770,13 @@ CesiumIonTilesetLoader::refreshTokenIfNeeded(
     const CesiumGeospatial::Ellipsoid& ellipsoid) {
   if (result.errors.hasErrors()) {
     if (result.statusCode == 401) {
-      endpointCache.erase(createEndpointResource(
+      // The access token in a cached endpoint response may have expired, so
+      // request the endpoint again, but only once.
+      getEndpointCache(externals)->invalidate(createEndpointResource(
           ionAssetID,
           ionAccessToken,
           ionAssetEndpointUrl));
-      return CesiumIonTilesetLoader::createLoader(
+      return loadFromAssetEndpoint(
           externals,
           contentOptions,
           ionAssetID,
@@ -4,13 +4,25 @@
 
 #include <Cesium3DTilesSelection/TilesetContentLoader.h>
 #include <Cesium3DTilesSelection/TilesetExternals.h>
+#include <CesiumAsync/EndpointCache.h>
+#include <CesiumAsync/SharedFuture.h>
 
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <optional>
 #include <string>
 
 namespace Cesium3DTilesSelection {
 class CesiumIonTilesetLoader : public TilesetContentLoader {
-  enum class TokenRefreshState { None, Loading, Done, Failed };
+  /**
+   * @brief The state of the refresh of the access token of the asset.
+   *
+   * While `Loading`, the current token is expired and requests wait for the
+   * new one. While `Renewing`, the current token is about to expire and
+   * requests still use it.
+   */
+  enum class TokenRefreshState { None, Loading, Renewing, Done, Failed };
 
 public:
   using AuthorizationHeaderChangeListener = std::function<
@@ -20,8 +32,10 @@ public:
       int64_t ionAssetID,
       std::string&& ionAccessToken,
       std::string&& ionAssetEndpointUrl,
+      const std::string& endpointAccessToken,
       std::unique_ptr<TilesetContentLoader>&& pAggregatedLoader,
       AuthorizationHeaderChangeListener&& headerChangeListener,
+      const std::shared_ptr<CesiumAsync::EndpointCache>& pEndpointCache,
       const CesiumGeospatial::Ellipsoid& ellipsoid CESIUM_DEFAULT_ELLIPSOID);
 
   CesiumAsync::Future<TileLoadResult>
@@ -31,6 +45,10 @@ public:
       const Tile& tile,
       const CesiumGeospatial::Ellipsoid& ellipsoid) override;
 
+  std::string getTileContentKey(const Tile& tile) const override;
+
+  void releaseTileChildren(const Tile& tile) override;
+
   static CesiumAsync::Future<TilesetContentLoaderResult<CesiumIonTilesetLoader>>
   createLoader(
       const TilesetExternals& externals,
@@ -55,17 +73,37 @@ public:
       const CesiumGeospatial::Ellipsoid& ellipsoid CESIUM_DEFAULT_ELLIPSOID);
 
 private:
+  CesiumAsync::Future<TileLoadResult> loadTileContentWithCurrentToken(
+      const TileLoadInput& loadInput,
+      bool retryIfUnauthorized);
+
+  CesiumAsync::Future<TileLoadResult>
+  loadTileContentAfterTokenRefresh(const TileLoadInput& loadInput);
+
   void refreshTokenInMainThread(
       const std::shared_ptr<spdlog::logger>& pLogger,
       const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAssetAccessor,
-      const CesiumAsync::AsyncSystem& asyncSystem);
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      bool tokenExpired);
 
   CesiumGeospatial::Ellipsoid _ellipsoid;
   TokenRefreshState _refreshTokenState;
+
+  // Resolved when the last refresh of the token finishes, successfully or not.
+  std::optional<CesiumAsync::SharedFuture<void>> _tokenRefreshed;
+
+  // Incremented whenever the token changes, to tell whether a request was
+  // sent with the current token.
+  uint64_t _tokenVersion;
+
+  // When to request a new token before the current one expires, if known.
+  std::optional<std::chrono::system_clock::time_point> _tokenRenewalTime;
+
   int64_t _ionAssetID;
   std::string _ionAccessToken;
   std::string _ionAssetEndpointUrl;
   std::unique_ptr<TilesetContentLoader> _pAggregatedLoader;
   AuthorizationHeaderChangeListener _headerChangeListener;
+  std::shared_ptr<CesiumAsync::EndpointCache> _pEndpointCache;
 };
 } // namespace Cesium3DTilesSelection
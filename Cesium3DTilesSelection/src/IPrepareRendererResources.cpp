@@ -0,0 +1,36 @@
+#include <Cesium3DTilesSelection/IPrepareRendererResources.h>
+
+namespace Cesium3DTilesSelection {
+void* IPrepareRendererResources::prepareBatchInLoadThread(
+    CesiumGltf::Model& /* model */,
+    const glm::dmat4& /* transform */,
+    const std::any& /* rendererOptions */) {
+  return nullptr;
+}
+
+void* IPrepareRendererResources::prepareBatchInMainThread(
+    TileRenderBatch& /* batch */,
+    void* /* pLoadThreadResult */) {
+  return nullptr;
+}
+
+void IPrepareRendererResources::freeBatch(
+    TileRenderBatch& /* batch */,
+    void* /* pLoadThreadResult */,
+    void* /* pMainThreadResult */) noexcept {}
+
+void* IPrepareRendererResources::prepareTextureInLoadThread(
+    CesiumGltf::ImageCesium& /* image */,
+    const std::any& /* rendererOptions */) {
+  return nullptr;
+}
+
+void IPrepareRendererResources::attachTextureInMainThread(
+    Tile& /* tile */,
+    int32_t /* imageIndex */,
+    void* /* pLoadThreadResult */) {}
+
+void IPrepareRendererResources::freeTexture(
+    Tile& /* tile */,
+    void* /* pLoadThreadResult */) noexcept {}
+} // namespace Cesium3DTilesSelection
@@ -72,7 +72,7 @@ std::vector<Tile> populateSubtree(
     if (relativeChildLevel == subtreeLevels) {
       if (subtreeAvailability.isSubtreeAvailable(relativeChildMortonID)) {
         Tile& child = children.emplace_back(&loader);
-        child.setTransform(tile.getTransform());
+        child.shareTransform(tile);
         child.setBoundingVolume(subdivideBoundingVolume(
             childID,
             loader.getBoundingVolume(),
@@ -95,7 +95,7 @@ std::vector<Tile> populateSubtree(
         }
 
         Tile& child = children.back();
-        child.setTransform(tile.getTransform());
+        child.shareTransform(tile);
         child.setBoundingVolume(subdivideBoundingVolume(
             childID,
             loader.getBoundingVolume(),
@@ -118,12 +118,15 @@ CesiumAsync::Future<TileLoadResult> requestTileContent(
     const std::vector<CesiumAsync::IAssetAccessor::THeader>& requestHeaders,
     CesiumGltf::Ktx2TranscodeTargets ktx2TranscodeTargets,
     bool applyTextureTransform,
+    const std::shared_ptr<CesiumGltfReader::SharedImageCache>&
+        pSharedImageCache,
     const glm::dmat4& tileTransform,
     const CesiumGeospatial::Ellipsoid& ellipsoid) {
   return pAssetAccessor->get(asyncSystem, tileUrl, requestHeaders)
       .thenInWorkerThread([pLogger,
                            ktx2TranscodeTargets,
                            applyTextureTransform,
+                           pSharedImageCache,
                            &asyncSystem,
                            pAssetAccessor,
                            tileTransform,
@@ -169,6 +172,7 @@ CesiumAsync::Future<TileLoadResult> requestTileContent(
           CesiumGltfReader::GltfReaderOptions gltfOptions;
           gltfOptions.ktx2TranscodeTargets = ktx2TranscodeTargets;
           gltfOptions.applyTextureTransform = applyTextureTransform;
+          gltfOptions.pSharedImageCache = pSharedImageCache;
           AssetFetcher assetFetcher{
               asyncSystem,
               pAssetAccessor,
@@ -295,6 +299,7 @@ ImplicitOctreeLoader::loadTileContent(const TileLoadInput& loadInput) {
       requestHeaders,
       contentOptions.ktx2TranscodeTargets,
       contentOptions.applyTextureTransform,
+      contentOptions.pSharedImageCache,
       tile.getTransform(),
       ellipsoid);
 }
@@ -337,6 +342,50 @@ TileChildrenResult ImplicitOctreeLoader::createTileChildren(
   return {{}, TileLoadResultState::RetryLater};
 }
 
+std::string
+ImplicitOctreeLoader::getTileContentKey(const Tile& tile) const {
+  const CesiumGeometry::OctreeTileID* pOctreeID =
+      std::get_if<CesiumGeometry::OctreeTileID>(&tile.getTileID());
+  if (!pOctreeID) {
+    return std::string();
+  }
+
+  // Whether the tile has content is only known once its subtree is loaded by
+  // this loader.
+  CesiumGeometry::OctreeTileID subtreeID =
+      ImplicitTilingUtilities::getSubtreeRootID(
+          this->_subtreeLevels,
+          *pOctreeID);
+  uint32_t subtreeLevelIdx = subtreeID.level / this->_subtreeLevels;
+  if (subtreeLevelIdx >= this->_loadedSubtrees.size()) {
+    return std::string();
+  }
+
+  uint64_t subtreeMortonIdx =
+      ImplicitTilingUtilities::computeMortonIndex(subtreeID);
+  auto subtreeIt =
+      this->_loadedSubtrees[subtreeLevelIdx].find(subtreeMortonIdx);
+  if (subtreeIt == this->_loadedSubtrees[subtreeLevelIdx].end() ||
+      !subtreeIt->second.isContentAvailable(subtreeID, *pOctreeID, 0)) {
+    return std::string();
+  }
+
+  return ImplicitTilingUtilities::resolveUrl(
+      this->_baseUrl,
+      this->_contentUrlTemplate,
+      *pOctreeID);
+}
+
+const std::string&
+ImplicitOctreeLoader::getContentUrlTemplate() const noexcept {
+  return this->_contentUrlTemplate;
+}
+
+const std::string&
+ImplicitOctreeLoader::getSubtreeUrlTemplate() const noexcept {
+  return this->_subtreeUrlTemplate;
+}
+
 uint32_t ImplicitOctreeLoader::getSubtreeLevels() const noexcept {
   return this->_subtreeLevels;
 }
@@ -350,6 +399,25 @@ ImplicitOctreeLoader::getBoundingVolume() const noexcept {
   return this->_boundingVolume;
 }
 
+void ImplicitOctreeLoader::releaseTileChildren(const Tile& tile) {
+  // The subtrees whose roots are below the tile are loaded again when the
+  // tiles in them are.
+  for (const Tile& child : tile.getChildren()) {
+    const CesiumGeometry::OctreeTileID* pOctreeID =
+        std::get_if<CesiumGeometry::OctreeTileID>(&child.getTileID());
+    if (pOctreeID && child.getLoader() == this &&
+        pOctreeID->level % this->_subtreeLevels == 0) {
+      uint32_t levelIndex = pOctreeID->level / this->_subtreeLevels;
+      if (levelIndex < this->_loadedSubtrees.size()) {
+        this->_loadedSubtrees[levelIndex].erase(
+            ImplicitTilingUtilities::computeMortonIndex(*pOctreeID));
+      }
+    }
+
+    this->releaseTileChildren(child);
+  }
+}
+
 void ImplicitOctreeLoader::addSubtreeAvailability(
     const CesiumGeometry::OctreeTileID& subtreeID,
     SubtreeAvailability&& subtreeAvailability) {
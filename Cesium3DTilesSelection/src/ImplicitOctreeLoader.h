@@ -45,6 +45,14 @@ public:
       const CesiumGeospatial::Ellipsoid& ellipsoid
           CESIUM_DEFAULT_ELLIPSOID) override;
 
+  std::string getTileContentKey(const Tile& tile) const override;
+
+  void releaseTileChildren(const Tile& tile) override;
+
+  const std::string& getContentUrlTemplate() const noexcept;
+
+  const std::string& getSubtreeUrlTemplate() const noexcept;
+
   uint32_t getSubtreeLevels() const noexcept;
 
   uint32_t getAvailableLevels() const noexcept;
@@ -84,7 +84,7 @@ std::vector<Tile> populateSubtree(
     if (relativeChildLevel == subtreeLevels) {
       if (subtreeAvailability.isSubtreeAvailable(relativeChildMortonID)) {
         Tile& child = children.emplace_back(&loader);
-        child.setTransform(tile.getTransform());
+        child.shareTransform(tile);
         child.setBoundingVolume(subdivideBoundingVolume(
             childID,
             loader.getBoundingVolume(),
@@ -107,7 +107,7 @@ std::vector<Tile> populateSubtree(
         }
 
         Tile& child = children.back();
-        child.setTransform(tile.getTransform());
+        child.shareTransform(tile);
         child.setBoundingVolume(subdivideBoundingVolume(
             childID,
             loader.getBoundingVolume(),
@@ -130,6 +130,8 @@ CesiumAsync::Future<TileLoadResult> requestTileContent(
     const std::vector<CesiumAsync::IAssetAccessor::THeader>& requestHeaders,
     CesiumGltf::Ktx2TranscodeTargets ktx2TranscodeTargets,
     bool applyTextureTransform,
+    const std::shared_ptr<CesiumGltfReader::SharedImageCache>&
+        pSharedImageCache,
     const glm::dmat4& tileTransform,
     const CesiumGeospatial::Ellipsoid& ellipsoid) {
   return pAssetAccessor->get(asyncSystem, tileUrl, requestHeaders)
@@ -137,6 +139,7 @@ CesiumAsync::Future<TileLoadResult> requestTileContent(
                            pLogger,
                            ktx2TranscodeTargets,
                            applyTextureTransform,
+                           pSharedImageCache,
                            &asyncSystem,
                            pAssetAccessor,
                            tileTransform,
@@ -181,6 +184,7 @@ CesiumAsync::Future<TileLoadResult> requestTileContent(
           CesiumGltfReader::GltfReaderOptions gltfOptions;
           gltfOptions.ktx2TranscodeTargets = ktx2TranscodeTargets;
           gltfOptions.applyTextureTransform = applyTextureTransform;
+          gltfOptions.pSharedImageCache = pSharedImageCache;
           AssetFetcher assetFetcher{
               asyncSystem,
               pAssetAccessor,
@@ -336,6 +340,7 @@ ImplicitQuadtreeLoader::loadTileContent(const TileLoadInput& loadInput) {
       requestHeaders,
       contentOptions.ktx2TranscodeTargets,
       contentOptions.applyTextureTransform,
+      contentOptions.pSharedImageCache,
       tile.getTransform(),
       ellipsoid);
 }
@@ -379,6 +384,50 @@ TileChildrenResult ImplicitQuadtreeLoader::createTileChildren(
   return {{}, TileLoadResultState::RetryLater};
 }
 
+std::string
+ImplicitQuadtreeLoader::getTileContentKey(const Tile& tile) const {
+  const CesiumGeometry::QuadtreeTileID* pQuadtreeID =
+      std::get_if<CesiumGeometry::QuadtreeTileID>(&tile.getTileID());
+  if (!pQuadtreeID) {
+    return std::string();
+  }
+
+  // Whether the tile has content is only known once its subtree is loaded by
+  // this loader.
+  CesiumGeometry::QuadtreeTileID subtreeID =
+      ImplicitTilingUtilities::getSubtreeRootID(
+          this->_subtreeLevels,
+          *pQuadtreeID);
+  uint32_t subtreeLevelIdx = subtreeID.level / this->_subtreeLevels;
+  if (subtreeLevelIdx >= this->_loadedSubtrees.size()) {
+    return std::string();
+  }
+
+  uint64_t subtreeMortonIdx =
+      ImplicitTilingUtilities::computeMortonIndex(subtreeID);
+  auto subtreeIt =
+      this->_loadedSubtrees[subtreeLevelIdx].find(subtreeMortonIdx);
+  if (subtreeIt == this->_loadedSubtrees[subtreeLevelIdx].end() ||
+      !subtreeIt->second.isContentAvailable(subtreeID, *pQuadtreeID, 0)) {
+    return std::string();
+  }
+
+  return ImplicitTilingUtilities::resolveUrl(
+      this->_baseUrl,
+      this->_contentUrlTemplate,
+      *pQuadtreeID);
+}
+
+const std::string&
+ImplicitQuadtreeLoader::getContentUrlTemplate() const noexcept {
+  return this->_contentUrlTemplate;
+}
+
+const std::string&
+ImplicitQuadtreeLoader::getSubtreeUrlTemplate() const noexcept {
+  return this->_subtreeUrlTemplate;
+}
+
 uint32_t ImplicitQuadtreeLoader::getSubtreeLevels() const noexcept {
   return this->_subtreeLevels;
 }
@@ -392,6 +441,25 @@ ImplicitQuadtreeLoader::getBoundingVolume() const noexcept {
   return this->_boundingVolume;
 }
 
+void ImplicitQuadtreeLoader::releaseTileChildren(const Tile& tile) {
+  // The subtrees whose roots are below the tile are loaded again when the
+  // tiles in them are.
+  for (const Tile& child : tile.getChildren()) {
+    const CesiumGeometry::QuadtreeTileID* pQuadtreeID =
+        std::get_if<CesiumGeometry::QuadtreeTileID>(&child.getTileID());
+    if (pQuadtreeID && child.getLoader() == this &&
+        pQuadtreeID->level % this->_subtreeLevels == 0) {
+      uint32_t levelIndex = pQuadtreeID->level / this->_subtreeLevels;
+      if (levelIndex < this->_loadedSubtrees.size()) {
+        this->_loadedSubtrees[levelIndex].erase(
+            ImplicitTilingUtilities::computeMortonIndex(*pQuadtreeID));
+      }
+    }
+
+    this->releaseTileChildren(child);
+  }
+}
+
 void ImplicitQuadtreeLoader::addSubtreeAvailability(
     const CesiumGeometry::QuadtreeTileID& subtreeID,
     SubtreeAvailability&& subtreeAvailability) {
@@ -1090,7 +1090,7 @@ void LayerJsonTerrainLoader::createChildTile(
     bool isAvailable) {
   Tile& child = children.emplace_back(this);
   child.setRefine(parent.getRefine());
-  child.setTransform(parent.getTransform());
+  child.shareTransform(parent);
   if (isAvailable) {
     child.setTileID(childID);
   } else {
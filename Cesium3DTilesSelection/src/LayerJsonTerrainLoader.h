@@ -10,13 +10,13 @@
 #include <CesiumGeometry/QuadtreeTilingScheme.h>
 #include <CesiumGeospatial/Projection.h>
 #include <CesiumUtility/Assert.h>
+#include <CesiumUtility/FlatHashSet.h>
 
 #include <rapidjson/fwd.h>
 
 #include <memory>
 #include <optional>
 #include <string>
-#include <unordered_set>
 #include <vector>
 
 namespace Cesium3DTilesSelection {
@@ -60,7 +60,7 @@ public:
     std::string version;
     std::vector<std::string> tileTemplateUrls;
     CesiumGeometry::QuadtreeRectangleAvailability contentAvailability;
-    std::vector<std::unordered_set<uint64_t>> loadedSubtrees;
+    std::vector<CesiumUtility::FlatHashSet<uint64_t>> loadedSubtrees;
     int32_t availabilityLevels;
   };
 
@@ -0,0 +1,216 @@
+#include "MultiViewCuller.h"
+
+#include <CesiumGeometry/CullingVolume.h>
+#include <CesiumGeometry/Plane.h>
+
+#include <glm/common.hpp>
+
+using namespace CesiumGeometry;
+using namespace CesiumGeospatial;
+using namespace CesiumUtility;
+
+namespace Cesium3DTilesSelection {
+namespace {
+// The left, right, top, and bottom planes of a CullingVolume.
+constexpr size_t planesPerView = 4;
+
+const std::vector<ViewState> noViews;
+} // namespace
+
+MultiViewCuller::MultiViewCuller(size_t* pAllocationCount) noexcept
+    : _pFrustums(&noViews),
+      _normalX(CountingAllocator<double>(pAllocationCount)),
+      _normalY(CountingAllocator<double>(pAllocationCount)),
+      _normalZ(CountingAllocator<double>(pAllocationCount)),
+      _distance(CountingAllocator<double>(pAllocationCount)),
+      _outside(CountingAllocator<uint8_t>(pAllocationCount)) {}
+
+MultiViewCuller::MultiViewCuller(const std::vector<ViewState>& frustums)
+    : MultiViewCuller() {
+  this->setViews(frustums);
+}
+
+void MultiViewCuller::setViews(const std::vector<ViewState>& frustums) {
+  this->_pFrustums = &frustums;
+
+  const size_t planeCount = frustums.size() * planesPerView;
+  this->_normalX.clear();
+  this->_normalY.clear();
+  this->_normalZ.clear();
+  this->_distance.clear();
+  this->_normalX.reserve(planeCount);
+  this->_normalY.reserve(planeCount);
+  this->_normalZ.reserve(planeCount);
+  this->_distance.reserve(planeCount);
+  this->_outside.resize(planeCount);
+
+  for (const ViewState& frustum : frustums) {
+    const CullingVolume& cullingVolume = frustum.getCullingVolume();
+    for (const Plane* pPlane :
+         {&cullingVolume.leftPlane,
+          &cullingVolume.rightPlane,
+          &cullingVolume.topPlane,
+          &cullingVolume.bottomPlane}) {
+      const glm::dvec3& normal = pPlane->getNormal();
+      this->_normalX.push_back(normal.x);
+      this->_normalY.push_back(normal.y);
+      this->_normalZ.push_back(normal.z);
+      this->_distance.push_back(pPlane->getDistance());
+    }
+  }
+}
+
+void MultiViewCuller::clearViews() noexcept {
+  this->_pFrustums = &noViews;
+  this->_normalX.clear();
+  this->_normalY.clear();
+  this->_normalZ.clear();
+  this->_distance.clear();
+  this->_outside.clear();
+}
+
+bool MultiViewCuller::isVisibleInAnyView(
+    const BoundingVolume& boundingVolume) const {
+  if (!this->_cullAgainstAllPlanes(boundingVolume)) {
+    for (const ViewState& frustum : *this->_pFrustums) {
+      if (frustum.isBoundingVolumeVisible(boundingVolume)) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  const uint8_t* pOutside = this->_outside.data();
+  for (size_t i = 0; i < this->_outside.size(); i += planesPerView) {
+    if ((pOutside[i] | pOutside[i + 1] | pOutside[i + 2] | pOutside[i + 3]) ==
+        0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void MultiViewCuller::computeVisibility(
+    const BoundingVolume& boundingVolume,
+    CountingVector<uint8_t>& visibility) const {
+  const size_t viewCount = this->_pFrustums->size();
+  visibility.resize(viewCount);
+
+  if (!this->_cullAgainstAllPlanes(boundingVolume)) {
+    for (size_t i = 0; i < viewCount; ++i) {
+      visibility[i] = static_cast<uint8_t>(
+          (*this->_pFrustums)[i].isBoundingVolumeVisible(boundingVolume));
+    }
+
+    return;
+  }
+
+  const uint8_t* pOutside = this->_outside.data();
+  for (size_t i = 0; i < viewCount; ++i) {
+    const uint8_t* pPlanes = pOutside + i * planesPerView;
+    visibility[i] = static_cast<uint8_t>(
+        (pPlanes[0] | pPlanes[1] | pPlanes[2] | pPlanes[3]) == 0);
+  }
+}
+
+bool MultiViewCuller::_cullAgainstAllPlanes(
+    const BoundingVolume& boundingVolume) const {
+  struct Operation {
+    const MultiViewCuller& culler;
+
+    bool operator()(const OrientedBoundingBox& boundingBox) noexcept {
+      culler._cullBoxAgainstAllPlanes(boundingBox);
+      return true;
+    }
+
+    bool operator()(const BoundingRegion& boundingRegion) noexcept {
+      culler._cullBoxAgainstAllPlanes(boundingRegion.getBoundingBox());
+      return true;
+    }
+
+    bool operator()(const BoundingSphere& boundingSphere) noexcept {
+      culler._cullSphereAgainstAllPlanes(boundingSphere);
+      return true;
+    }
+
+    bool operator()(
+        const BoundingRegionWithLooseFittingHeights& boundingRegion) noexcept {
+      culler._cullBoxAgainstAllPlanes(
+          boundingRegion.getBoundingRegion().getBoundingBox());
+      return true;
+    }
+
+    bool operator()(const S2CellBoundingVolume& /*s2Cell*/) noexcept {
+      return false;
+    }
+  };
+
+  return std::visit(Operation{*this}, boundingVolume);
+}
+
+void MultiViewCuller::_cullBoxAgainstAllPlanes(
+    const OrientedBoundingBox& box) const noexcept {
+  const glm::dvec3& center = box.getCenter();
+  const glm::dmat3& halfAxes = box.getHalfAxes();
+
+  // Copy everything the loop reads into locals so that the compiler knows it
+  // does not alias the output.
+  const double cx = center.x;
+  const double cy = center.y;
+  const double cz = center.z;
+  const double xx = halfAxes[0].x;
+  const double xy = halfAxes[0].y;
+  const double xz = halfAxes[0].z;
+  const double yx = halfAxes[1].x;
+  const double yy = halfAxes[1].y;
+  const double yz = halfAxes[1].z;
+  const double zx = halfAxes[2].x;
+  const double zy = halfAxes[2].y;
+  const double zz = halfAxes[2].z;
+
+  const double* pNormalX = this->_normalX.data();
+  const double* pNormalY = this->_normalY.data();
+  const double* pNormalZ = this->_normalZ.data();
+  const double* pDistance = this->_distance.data();
+  uint8_t* pOutside = this->_outside.data();
+  const size_t planeCount = this->_outside.size();
+
+  // The same test as OrientedBoundingBox::intersectPlane, for every plane.
+  for (size_t i = 0; i < planeCount; ++i) {
+    const double nx = pNormalX[i];
+    const double ny = pNormalY[i];
+    const double nz = pNormalZ[i];
+    const double radEffective = glm::abs(nx * xx + ny * xy + nz * xz) +
+                                glm::abs(nx * yx + ny * yy + nz * yz) +
+                                glm::abs(nx * zx + ny * zy + nz * zz);
+    const double distanceToPlane = nx * cx + ny * cy + nz * cz + pDistance[i];
+    pOutside[i] = static_cast<uint8_t>(distanceToPlane <= -radEffective);
+  }
+}
+
+void MultiViewCuller::_cullSphereAgainstAllPlanes(
+    const BoundingSphere& sphere) const noexcept {
+  const glm::dvec3& center = sphere.getCenter();
+  const double cx = center.x;
+  const double cy = center.y;
+  const double cz = center.z;
+  const double radius = sphere.getRadius();
+
+  const double* pNormalX = this->_normalX.data();
+  const double* pNormalY = this->_normalY.data();
+  const double* pNormalZ = this->_normalZ.data();
+  const double* pDistance = this->_distance.data();
+  uint8_t* pOutside = this->_outside.data();
+  const size_t planeCount = this->_outside.size();
+
+  // The same test as BoundingSphere::intersectPlane, for every plane.
+  for (size_t i = 0; i < planeCount; ++i) {
+    const double distanceToPlane = pNormalX[i] * cx + pNormalY[i] * cy +
+                                   pNormalZ[i] * cz + pDistance[i];
+    pOutside[i] = static_cast<uint8_t>(distanceToPlane < -radius);
+  }
+}
+
+} // namespace Cesium3DTilesSelection
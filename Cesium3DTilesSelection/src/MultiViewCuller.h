@@ -0,0 +1,103 @@
+#pragma once
+
+#include <Cesium3DTilesSelection/BoundingVolume.h>
+#include <Cesium3DTilesSelection/ViewState.h>
+#include <CesiumUtility/CountingAllocator.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+
+/**
+ * @brief Culls bounding volumes against the frustums of all views of a frame
+ * at once.
+ *
+ * The planes of all frustums are stored as separate arrays of normal
+ * components and distances, so that a bounding volume is tested against every
+ * plane of every view in a single branch-free loop that the compiler can
+ * vectorize. Bounding volumes that are not boxes or spheres, such as S2
+ * cells, fall back to {@link ViewState::isBoundingVolumeVisible}.
+ *
+ * An instance refers to the given views until they are replaced or cleared,
+ * and must not be used after they are destroyed. It is not thread-safe,
+ * because it reuses a scratch buffer across calls. An instance can be reused
+ * for the views of every frame, so that it only allocates when the number of
+ * views grows.
+ */
+class MultiViewCuller {
+public:
+  /**
+   * @brief Creates a culler without any views.
+   *
+   * @param pAllocationCount The variable in which to count the allocations of
+   * the culler, or nullptr to not count them.
+   */
+  explicit MultiViewCuller(size_t* pAllocationCount = nullptr) noexcept;
+
+  /**
+   * @brief Creates a culler for the given views.
+   *
+   * @param frustums The views.
+   */
+  explicit MultiViewCuller(const std::vector<ViewState>& frustums);
+
+  /**
+   * @brief Replaces the views of this culler, reusing its storage.
+   *
+   * @param frustums The views.
+   */
+  void setViews(const std::vector<ViewState>& frustums);
+
+  /**
+   * @brief Removes the views of this culler, so that it no longer refers to
+   * them, keeping its storage for the next call to {@link setViews}.
+   */
+  void clearViews() noexcept;
+
+  /**
+   * @brief Gets the number of views.
+   */
+  size_t getViewCount() const noexcept { return this->_pFrustums->size(); }
+
+  /**
+   * @brief Returns whether the bounding volume is at least partially inside
+   * the frustum of at least one view.
+   *
+   * This is equivalent to calling {@link ViewState::isBoundingVolumeVisible}
+   * for each view.
+   */
+  bool isVisibleInAnyView(const BoundingVolume& boundingVolume) const;
+
+  /**
+   * @brief Computes whether the bounding volume is at least partially inside
+   * the frustum of each view.
+   *
+   * @param boundingVolume The bounding volume.
+   * @param visibility Receives one element per view, which is 1 if the
+   * bounding volume is visible in that view and 0 otherwise.
+   */
+  void computeVisibility(
+      const BoundingVolume& boundingVolume,
+      CesiumUtility::CountingVector<uint8_t>& visibility) const;
+
+private:
+  bool _cullAgainstAllPlanes(const BoundingVolume& boundingVolume) const;
+  void
+  _cullBoxAgainstAllPlanes(const CesiumGeometry::OrientedBoundingBox& box) const
+      noexcept;
+  void _cullSphereAgainstAllPlanes(
+      const CesiumGeometry::BoundingSphere& sphere) const noexcept;
+
+  const std::vector<ViewState>* _pFrustums;
+  CesiumUtility::CountingVector<double> _normalX;
+  CesiumUtility::CountingVector<double> _normalY;
+  CesiumUtility::CountingVector<double> _normalZ;
+  CesiumUtility::CountingVector<double> _distance;
+
+  // For each plane, 1 if the last bounding volume is entirely outside of it.
+  mutable CesiumUtility::CountingVector<uint8_t> _outside;
+};
+
+} // namespace Cesium3DTilesSelection
@@ -0,0 +1,407 @@
+#include "Cesium3DTilesSelection/SoftwareOcclusionCuller.h"
+
+#include <Cesium3DTilesSelection/Tile.h>
+#include <CesiumGeometry/OrientedBoundingBox.h>
+#include <CesiumGltf/AccessorUtility.h>
+#include <CesiumGltf/Model.h>
+#include <CesiumGltfContent/GltfUtilities.h>
+#include <CesiumUtility/Tracing.h>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <variant>
+
+using namespace CesiumGeometry;
+using namespace CesiumGeospatial;
+using namespace CesiumGltf;
+using namespace CesiumGltfContent;
+
+namespace Cesium3DTilesSelection {
+namespace {
+// Vertices closer to the camera than this are not projected, because
+// triangles and bounding volumes that reach behind the camera cannot be
+// tested reliably.
+constexpr double nearDistance = 1.0;
+
+int32_t clampToPixel(double value, int32_t minimum, int32_t maximum) noexcept {
+  return int32_t(glm::clamp(value, double(minimum), double(maximum)));
+}
+
+// Computes which side of the edge from a to b the point p is on. Swapping a
+// and b gives exactly the negated result, so that the triangles on both sides
+// of a shared edge agree about the points on it.
+double computeEdgeFunction(
+    double ax,
+    double ay,
+    double bx,
+    double by,
+    double px,
+    double py) noexcept {
+  if (ax < bx || (ax == bx && ay < by)) {
+    return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+  }
+  return -((ax - bx) * (py - by) - (ay - by) * (px - bx));
+}
+
+class SoftwareOcclusionProxy : public TileOcclusionRendererProxy {
+public:
+  explicit SoftwareOcclusionProxy(const SoftwareOcclusionCuller& culler)
+      : _culler(culler),
+        _pTile(nullptr),
+        _state(TileOcclusionState::NotOccluded),
+        _updateCount(0) {}
+
+  TileOcclusionState getOcclusionState() const override {
+    if (!this->_pTile) {
+      return TileOcclusionState::NotOccluded;
+    }
+
+    // The depth buffers only change in update, so the state is computed
+    // once per update rather than every time the traversal asks for it.
+    const uint64_t updateCount = this->_culler.getUpdateCount();
+    if (updateCount != this->_updateCount) {
+      this->_state = this->_culler.computeOcclusionState(
+          this->_pTile->getBoundingVolume());
+      this->_updateCount = updateCount;
+    }
+
+    return this->_state;
+  }
+
+protected:
+  void reset(const Tile* pTile) override {
+    this->_pTile = pTile;
+    this->_updateCount = 0;
+  }
+
+private:
+  const SoftwareOcclusionCuller& _culler;
+  const Tile* _pTile;
+  mutable TileOcclusionState _state;
+  mutable uint64_t _updateCount;
+};
+} // namespace
+
+SoftwareOcclusionCuller::SoftwareOcclusionCuller(
+    int32_t maximumPoolSize,
+    int32_t width,
+    int32_t height,
+    const Ellipsoid& ellipsoid)
+    : TileOcclusionRendererProxyPool(maximumPoolSize),
+      _width(std::max(width, 1)),
+      _height(std::max(height, 1)),
+      _ellipsoid(ellipsoid),
+      _updateCount(0),
+      _buffers(),
+      _viewCount(0),
+      _projectedVertices(),
+      _cornerDepths() {}
+
+SoftwareOcclusionCuller::~SoftwareOcclusionCuller() noexcept {
+  // The proxies must be destroyed while destroyProxy can still be called.
+  this->destroyPool();
+}
+
+void SoftwareOcclusionCuller::update(
+    const std::vector<ViewState>& views,
+    const std::vector<Tile*>& occluders) {
+  CESIUM_TRACE("SoftwareOcclusionCuller::update");
+
+  if (this->_buffers.size() < views.size()) {
+    this->_buffers.resize(views.size());
+  }
+  this->_viewCount = views.size();
+
+  const size_t pixelCount = size_t(this->_width) * size_t(this->_height);
+  const size_t cornerStride = size_t(this->_width) + 1;
+  const size_t cornerCount = cornerStride * (size_t(this->_height) + 1);
+  for (size_t i = 0; i < views.size(); ++i) {
+    const ViewState& view = views[i];
+    DepthBuffer& buffer = this->_buffers[i];
+
+    buffer.position = view.getPosition();
+    buffer.direction = glm::normalize(view.getDirection());
+    buffer.right = glm::normalize(glm::cross(buffer.direction, view.getUp()));
+    buffer.up = glm::cross(buffer.right, buffer.direction);
+    buffer.horizontalScale =
+        0.5 / glm::tan(0.5 * view.getHorizontalFieldOfView());
+    buffer.verticalScale = 0.5 / glm::tan(0.5 * view.getVerticalFieldOfView());
+
+    this->_cornerDepths.assign(cornerCount, std::numeric_limits<float>::max());
+    for (const Tile* pTile : occluders) {
+      if (pTile) {
+        this->_rasterizeTile(buffer, *pTile);
+      }
+    }
+
+    // A pixel is only as near as the farthest of its corners, so a pixel that
+    // is partly outside of the occluders stays empty.
+    buffer.depths.resize(pixelCount);
+    for (size_t y = 0; y < size_t(this->_height); ++y) {
+      const float* pTop = this->_cornerDepths.data() + y * cornerStride;
+      const float* pBottom = pTop + cornerStride;
+      float* pRow = buffer.depths.data() + y * size_t(this->_width);
+      for (size_t x = 0; x < size_t(this->_width); ++x) {
+        pRow[x] = glm::max(
+            glm::max(pTop[x], pTop[x + 1]),
+            glm::max(pBottom[x], pBottom[x + 1]));
+      }
+    }
+  }
+
+  ++this->_updateCount;
+}
+
+TileOcclusionState SoftwareOcclusionCuller::computeOcclusionState(
+    const BoundingVolume& boundingVolume) const {
+  if (this->_viewCount == 0) {
+    return TileOcclusionState::NotOccluded;
+  }
+
+  const OrientedBoundingBox box = getOrientedBoundingBoxFromBoundingVolume(
+      boundingVolume,
+      this->_ellipsoid);
+  const glm::dvec3& center = box.getCenter();
+  const glm::dmat3& halfAxes = box.getHalfAxes();
+
+  std::array<glm::dvec3, 8> corners;
+  for (size_t i = 0; i < corners.size(); ++i) {
+    corners[i] = center + ((i & 1) ? halfAxes[0] : -halfAxes[0]) +
+                 ((i & 2) ? halfAxes[1] : -halfAxes[1]) +
+                 ((i & 4) ? halfAxes[2] : -halfAxes[2]);
+  }
+
+  for (size_t i = 0; i < this->_viewCount; ++i) {
+    const DepthBuffer& buffer = this->_buffers[i];
+    if (!this->_isOccluded(buffer, corners.data(), corners.size())) {
+      return TileOcclusionState::NotOccluded;
+    }
+  }
+
+  return TileOcclusionState::Occluded;
+}
+
+TileOcclusionRendererProxy* SoftwareOcclusionCuller::createProxy() {
+  return new SoftwareOcclusionProxy(*this);
+}
+
+void SoftwareOcclusionCuller::destroyProxy(
+    TileOcclusionRendererProxy* pProxy) {
+  delete pProxy;
+}
+
+SoftwareOcclusionCuller::ProjectedVertex SoftwareOcclusionCuller::_project(
+    const DepthBuffer& buffer,
+    const glm::dvec3& position) const noexcept {
+  const glm::dvec3 toPosition = position - buffer.position;
+  const double depth = glm::dot(toPosition, buffer.direction);
+  if (depth < nearDistance) {
+    return ProjectedVertex{0.0, 0.0, -1.0};
+  }
+
+  const double x = glm::dot(toPosition, buffer.right) / depth;
+  const double y = glm::dot(toPosition, buffer.up) / depth;
+  return ProjectedVertex{
+      (0.5 + x * buffer.horizontalScale) * this->_width,
+      (0.5 - y * buffer.verticalScale) * this->_height,
+      depth};
+}
+
+void SoftwareOcclusionCuller::_rasterizeTile(
+    DepthBuffer& buffer,
+    const Tile& tile) {
+  const TileRenderContent* pRenderContent =
+      tile.getContent().getRenderContent();
+  if (!pRenderContent) {
+    return;
+  }
+
+  const Model& model = pRenderContent->getModel();
+  glm::dmat4x4 rootTransform =
+      GltfUtilities::applyRtcCenter(model, tile.getTransform());
+  rootTransform = GltfUtilities::applyGltfUpAxisTransform(model, rootTransform);
+
+  model.forEachPrimitiveInScene(
+      -1,
+      [this, &buffer, &rootTransform](
+          const Model& gltf,
+          const Node& /*node*/,
+          const Mesh& /*mesh*/,
+          const MeshPrimitive& primitive,
+          const glm::dmat4& nodeTransform) {
+        if (primitive.mode != MeshPrimitive::Mode::TRIANGLES) {
+          return;
+        }
+
+        const PositionAccessorType positions =
+            getPositionAccessorView(gltf, primitive);
+        if (positions.status() != AccessorViewStatus::Valid) {
+          return;
+        }
+
+        // Project every vertex once, rather than once per triangle.
+        const glm::dmat4 transform = rootTransform * nodeTransform;
+        std::vector<ProjectedVertex>& projected = this->_projectedVertices;
+        projected.resize(size_t(positions.size()));
+        for (int64_t i = 0; i < positions.size(); ++i) {
+          const AccessorTypes::VEC3<float>& position = positions[i];
+          projected[size_t(i)] = this->_project(
+              buffer,
+              glm::dvec3(
+                  transform * glm::dvec4(
+                                  position.value[0],
+                                  position.value[1],
+                                  position.value[2],
+                                  1.0)));
+        }
+
+        const int64_t vertexCount = positions.size();
+        auto rasterize = [this, &buffer, &projected, vertexCount](
+                             int64_t i0,
+                             int64_t i1,
+                             int64_t i2) {
+          if (i0 < 0 || i0 >= vertexCount || i1 < 0 || i1 >= vertexCount ||
+              i2 < 0 || i2 >= vertexCount) {
+            return;
+          }
+          this->_rasterizeTriangle(
+              this->_cornerDepths,
+              projected[size_t(i0)],
+              projected[size_t(i1)],
+              projected[size_t(i2)]);
+        };
+
+        std::visit(
+            [&primitive, &rasterize, vertexCount](const auto& indices) {
+              using IndicesType = std::decay_t<decltype(indices)>;
+              if constexpr (std::is_same_v<IndicesType, std::monostate>) {
+                // A primitive without indices, or with invalid ones.
+                if (primitive.indices < 0) {
+                  for (int64_t i = 0; i + 2 < vertexCount; i += 3) {
+                    rasterize(i, i + 1, i + 2);
+                  }
+                }
+              } else if (indices.status() == AccessorViewStatus::Valid) {
+                for (int64_t i = 0; i + 2 < indices.size(); i += 3) {
+                  rasterize(
+                      int64_t(indices[i]),
+                      int64_t(indices[i + 1]),
+                      int64_t(indices[i + 2]));
+                }
+              }
+            },
+            getIndexAccessorView(gltf, primitive));
+      });
+}
+
+void SoftwareOcclusionCuller::_rasterizeTriangle(
+    std::vector<float>& cornerDepths,
+    const ProjectedVertex& v0,
+    const ProjectedVertex& v1,
+    const ProjectedVertex& v2) const noexcept {
+  // Triangles that reach behind the camera are left out, which only makes
+  // them hide less.
+  if (v0.depth < 0.0 || v1.depth < 0.0 || v2.depth < 0.0) {
+    return;
+  }
+
+  const double area = (v1.x - v0.x) * (v2.y - v0.y) -
+                      (v1.y - v0.y) * (v2.x - v0.x);
+  if (glm::abs(area) < 1e-12) {
+    return;
+  }
+
+  // The pixel corners within the bounds of the triangle. A corner on an edge
+  // is covered by the triangles on both sides, so that there are no gaps
+  // between the triangles of a mesh.
+  const double minX = glm::min(v0.x, glm::min(v1.x, v2.x));
+  const double maxX = glm::max(v0.x, glm::max(v1.x, v2.x));
+  const double minY = glm::min(v0.y, glm::min(v1.y, v2.y));
+  const double maxY = glm::max(v0.y, glm::max(v1.y, v2.y));
+  const int32_t x0 = clampToPixel(std::ceil(minX), 0, this->_width + 1);
+  const int32_t x1 = clampToPixel(std::floor(maxX), -1, this->_width);
+  const int32_t y0 = clampToPixel(std::ceil(minY), 0, this->_height + 1);
+  const int32_t y1 = clampToPixel(std::floor(maxY), -1, this->_height);
+  if (x0 > x1 || y0 > y1) {
+    return;
+  }
+
+  const float depth = float(glm::max(v0.depth, glm::max(v1.depth, v2.depth)));
+  const double sign = area > 0.0 ? 1.0 : -1.0;
+  const size_t cornerStride = size_t(this->_width) + 1;
+
+  for (int32_t y = y0; y <= y1; ++y) {
+    const double py = y;
+    float* pRow = cornerDepths.data() + size_t(y) * cornerStride;
+    for (int32_t x = x0; x <= x1; ++x) {
+      const double px = x;
+      const double w0 =
+          sign * computeEdgeFunction(v1.x, v1.y, v2.x, v2.y, px, py);
+      const double w1 =
+          sign * computeEdgeFunction(v2.x, v2.y, v0.x, v0.y, px, py);
+      const double w2 =
+          sign * computeEdgeFunction(v0.x, v0.y, v1.x, v1.y, px, py);
+      if (w0 >= 0.0 && w1 >= 0.0 && w2 >= 0.0) {
+        pRow[x] = glm::min(pRow[x], depth);
+      }
+    }
+  }
+}
+
+bool SoftwareOcclusionCuller::_isOccluded(
+    const DepthBuffer& buffer,
+    const glm::dvec3* pCorners,
+    size_t cornerCount) const noexcept {
+  double minX = std::numeric_limits<double>::max();
+  double maxX = std::numeric_limits<double>::lowest();
+  double minY = std::numeric_limits<double>::max();
+  double maxY = std::numeric_limits<double>::lowest();
+  double nearestDepth = std::numeric_limits<double>::max();
+
+  for (size_t i = 0; i < cornerCount; ++i) {
+    const ProjectedVertex corner = this->_project(buffer, pCorners[i]);
+    if (corner.depth < 0.0) {
+      // The camera is in or next to the bounding volume.
+      return false;
+    }
+
+    minX = glm::min(minX, corner.x);
+    maxX = glm::max(maxX, corner.x);
+    minY = glm::min(minY, corner.y);
+    maxY = glm::max(maxY, corner.y);
+    nearestDepth = glm::min(nearestDepth, corner.depth);
+  }
+
+  // Every pixel that the bounding volume may touch must be covered by a
+  // nearer occluder. The parts outside of the view cannot be seen in it.
+  const int32_t x0 = clampToPixel(std::floor(minX), 0, this->_width);
+  const int32_t x1 = clampToPixel(std::floor(maxX), -1, this->_width - 1);
+  const int32_t y0 = clampToPixel(std::floor(minY), 0, this->_height);
+  const int32_t y1 = clampToPixel(std::floor(maxY), -1, this->_height - 1);
+  if (x0 > x1 || y0 > y1) {
+    // The bounding volume is not in this view, so nothing in the view is
+    // known to hide it.
+    return false;
+  }
+
+  for (int32_t y = y0; y <= y1; ++y) {
+    const float* pRow =
+        buffer.depths.data() + size_t(y) * size_t(this->_width);
+    for (int32_t x = x0; x <= x1; ++x) {
+      if (double(pRow[x]) >= nearestDepth) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+} // namespace Cesium3DTilesSelection
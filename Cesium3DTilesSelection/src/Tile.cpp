@@ -16,6 +16,11 @@ using namespace CesiumUtility;
 using namespace std::string_literals;
 
 namespace Cesium3DTilesSelection {
+namespace {
+const std::optional<BoundingVolume> noBoundingVolume{};
+const glm::dmat4x4 identityTransform{1.0};
+} // namespace
+
 Tile::Tile(TilesetContentLoader* pLoader) noexcept
     : Tile(TileConstructorImpl{}, TileLoadState::Unloaded, pLoader) {}
 
@@ -47,11 +52,10 @@ Tile::Tile(
       _children(),
       _id(""s),
       _boundingVolume(OrientedBoundingBox(glm::dvec3(), glm::dmat3())),
-      _viewerRequestVolume(),
-      _contentBoundingVolume(),
+      _pOptionalBoundingVolumes(),
       _geometricError(0.0),
       _refine(TileRefine::Replace),
-      _transform(1.0),
+      _pTransform(),
       _lastSelectionState(),
       _loadedTilesLinks(),
       _content{std::forward<TileContentArgs>(args)...},
@@ -64,11 +68,10 @@ Tile::Tile(Tile&& rhs) noexcept
       _children(std::move(rhs._children)),
       _id(std::move(rhs._id)),
       _boundingVolume(rhs._boundingVolume),
-      _viewerRequestVolume(rhs._viewerRequestVolume),
-      _contentBoundingVolume(rhs._contentBoundingVolume),
+      _pOptionalBoundingVolumes(std::move(rhs._pOptionalBoundingVolumes)),
       _geometricError(rhs._geometricError),
       _refine(rhs._refine),
-      _transform(rhs._transform),
+      _pTransform(std::move(rhs._pTransform)),
       _lastSelectionState(rhs._lastSelectionState),
       _loadedTilesLinks(),
       _content(std::move(rhs._content)),
@@ -96,11 +99,10 @@ Tile& Tile::operator=(Tile&& rhs) noexcept {
 
     this->_id = std::move(rhs._id);
     this->_boundingVolume = rhs._boundingVolume;
-    this->_viewerRequestVolume = rhs._viewerRequestVolume;
-    this->_contentBoundingVolume = rhs._contentBoundingVolume;
+    this->_pOptionalBoundingVolumes = std::move(rhs._pOptionalBoundingVolumes);
     this->_geometricError = rhs._geometricError;
     this->_refine = rhs._refine;
-    this->_transform = rhs._transform;
+    this->_pTransform = std::move(rhs._pTransform);
     this->_lastSelectionState = rhs._lastSelectionState;
     this->_content = std::move(rhs._content);
     this->_pLoader = rhs._pLoader;
@@ -122,6 +124,57 @@ void Tile::createChildTiles(std::vector<Tile>&& children) {
   }
 }
 
+const std::optional<BoundingVolume>&
+Tile::getViewerRequestVolume() const noexcept {
+  if (!this->_pOptionalBoundingVolumes) {
+    return noBoundingVolume;
+  }
+  return this->_pOptionalBoundingVolumes->viewerRequestVolume;
+}
+
+void Tile::setViewerRequestVolume(
+    const std::optional<BoundingVolume>& value) noexcept {
+  if (!value && !this->_pOptionalBoundingVolumes) {
+    return;
+  }
+  this->getOrCreateOptionalBoundingVolumes().viewerRequestVolume = value;
+}
+
+const glm::dmat4x4& Tile::getTransform() const noexcept {
+  if (!this->_pTransform) {
+    return identityTransform;
+  }
+  return *this->_pTransform;
+}
+
+void Tile::setTransform(const glm::dmat4x4& value) noexcept {
+  if (value == identityTransform) {
+    this->_pTransform.reset();
+  } else if (!this->_pTransform || *this->_pTransform != value) {
+    this->_pTransform = std::make_shared<const glm::dmat4x4>(value);
+  }
+}
+
+void Tile::shareTransform(const Tile& other) noexcept {
+  this->_pTransform = other._pTransform;
+}
+
+const std::optional<BoundingVolume>&
+Tile::getContentBoundingVolume() const noexcept {
+  if (!this->_pOptionalBoundingVolumes) {
+    return noBoundingVolume;
+  }
+  return this->_pOptionalBoundingVolumes->contentBoundingVolume;
+}
+
+void Tile::setContentBoundingVolume(
+    const std::optional<BoundingVolume>& value) noexcept {
+  if (!value && !this->_pOptionalBoundingVolumes) {
+    return;
+  }
+  this->getOrCreateOptionalBoundingVolumes().contentBoundingVolume = value;
+}
+
 double Tile::getNonZeroGeometricError() const noexcept {
   double geometricError = this->getGeometricError();
   if (geometricError > Math::Epsilon5) {
@@ -223,8 +276,21 @@ TilesetContentLoader* Tile::getLoader() const noexcept {
 
 TileLoadState Tile::getState() const noexcept { return this->_loadState; }
 
+Tile::OptionalBoundingVolumes& Tile::getOrCreateOptionalBoundingVolumes() {
+  if (!this->_pOptionalBoundingVolumes) {
+    this->_pOptionalBoundingVolumes =
+        std::make_unique<OptionalBoundingVolumes>();
+  }
+  return *this->_pOptionalBoundingVolumes;
+}
+
 void Tile::setParent(Tile* pParent) noexcept { this->_pParent = pParent; }
 
+void Tile::clearChildTiles() noexcept {
+  // Release the memory of the children, not just destroy them.
+  this->_children = std::vector<Tile>();
+}
+
 void Tile::setState(TileLoadState state) noexcept { this->_loadState = state; }
 
 bool Tile::shouldContentContinueUpdating() const noexcept {
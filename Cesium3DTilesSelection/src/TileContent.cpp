@@ -6,23 +6,62 @@ using namespace CesiumUtility;
 namespace Cesium3DTilesSelection {
 TileRenderContent::TileRenderContent(CesiumGltf::Model&& model)
     : _model{std::move(model)},
+      _pSharedModel{nullptr},
       _pRenderResources{nullptr},
       _rasterOverlayDetails{},
       _credits{},
-      _lodTransitionFadePercentage{0.0f} {}
+      _lodTransitionFadePercentage{0.0f},
+      _pRenderBatch{nullptr} {}
+
+TileRenderContent::TileRenderContent(
+    std::shared_ptr<const CesiumGltf::Model>&& pSharedModel)
+    : _model{},
+      _pSharedModel{std::move(pSharedModel)},
+      _pRenderResources{nullptr},
+      _rasterOverlayDetails{},
+      _credits{},
+      _lodTransitionFadePercentage{0.0f},
+      _pRenderBatch{nullptr} {}
 
 const CesiumGltf::Model& TileRenderContent::getModel() const noexcept {
+  if (this->_pSharedModel) {
+    return *this->_pSharedModel;
+  }
+
+  return _model;
+}
+
+CesiumGltf::Model& TileRenderContent::getMutableModel() {
+  if (this->_pSharedModel) {
+    this->_model = *this->_pSharedModel;
+    this->_pSharedModel.reset();
+  }
+
   return _model;
 }
 
-CesiumGltf::Model& TileRenderContent::getModel() noexcept { return _model; }
+std::shared_ptr<const CesiumGltf::Model> TileRenderContent::shareModel() {
+  if (!this->_pSharedModel) {
+    this->_pSharedModel =
+        std::make_shared<const CesiumGltf::Model>(std::move(this->_model));
+    this->_model = CesiumGltf::Model();
+  }
+
+  return this->_pSharedModel;
+}
+
+bool TileRenderContent::isModelShared() const noexcept {
+  return this->_pSharedModel != nullptr;
+}
 
 void TileRenderContent::setModel(const CesiumGltf::Model& model) {
   _model = model;
+  _pSharedModel.reset();
 }
 
 void TileRenderContent::setModel(CesiumGltf::Model&& model) {
   _model = std::move(model);
+  _pSharedModel.reset();
 }
 
 const RasterOverlayDetails&
@@ -77,6 +116,15 @@ void TileRenderContent::setLodTransitionFadePercentage(
   this->_lodTransitionFadePercentage = percentage;
 }
 
+const TileRenderBatch* TileRenderContent::getRenderBatch() const noexcept {
+  return this->_pRenderBatch;
+}
+
+void TileRenderContent::setRenderBatch(
+    const TileRenderBatch* pRenderBatch) noexcept {
+  this->_pRenderBatch = pRenderBatch;
+}
+
 TileContent::TileContent() : _contentKind{TileUnknownContent{}} {}
 
 TileContent::TileContent(TileEmptyContent content) : _contentKind{content} {}
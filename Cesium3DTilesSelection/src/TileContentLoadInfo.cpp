@@ -21,5 +21,6 @@ TileContentLoadInfo::TileContentLoadInfo(
       tileRefine(tile.getRefine()),
       tileGeometricError(tile.getGeometricError()),
       tileTransform(tile.getTransform()),
-      contentOptions(contentOptions_) {}
+      contentOptions(contentOptions_),
+      maximumTextureSize(0) {}
 } // namespace Cesium3DTilesSelection
@@ -14,6 +14,7 @@
 #include <spdlog/fwd.h>
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 
 namespace Cesium3DTilesSelection {
@@ -48,5 +49,8 @@ struct TileContentLoadInfo {
   glm::dmat4 tileTransform;
 
   TilesetContentOptions contentOptions;
+
+  // The size to which embedded images are reduced, or 0 to keep them whole.
+  int32_t maximumTextureSize;
 };
 } // namespace Cesium3DTilesSelection
@@ -0,0 +1,121 @@
+#include <Cesium3DTilesSelection/TileContentRegistry.h>
+#include <CesiumAsync/Promise.h>
+#include <CesiumUtility/Assert.h>
+
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+using namespace CesiumAsync;
+
+namespace Cesium3DTilesSelection {
+using SharedContent = std::shared_ptr<const TileLoadResult>;
+
+struct TileContentRegistry::State {
+  struct Entry {
+    // The content, once it is loaded and while any tileset uses it.
+    std::weak_ptr<const TileLoadResult> pContent;
+
+    // Resolved when the tileset loading the content finishes or gives up.
+    std::optional<Promise<SharedContent>> loadingPromise;
+    std::optional<SharedFuture<SharedContent>> loadingFuture;
+  };
+
+  mutable std::mutex mutex;
+  std::unordered_map<std::string, Entry> entries;
+};
+
+TileContentRegistry::TileContentRegistry()
+    : _pState{std::make_shared<State>()} {}
+
+std::optional<SharedFuture<SharedContent>> TileContentRegistry::beginLoading(
+    const AsyncSystem& asyncSystem,
+    const std::string& key) {
+  std::lock_guard<std::mutex> lock(this->_pState->mutex);
+
+  State::Entry& entry = this->_pState->entries[key];
+  if (entry.loadingFuture) {
+    return *entry.loadingFuture;
+  }
+
+  SharedContent pContent = entry.pContent.lock();
+  if (pContent) {
+    return asyncSystem.createResolvedFuture(std::move(pContent)).share();
+  }
+
+  Promise<SharedContent> promise = asyncSystem.createPromise<SharedContent>();
+  entry.loadingFuture = promise.getFuture().share();
+  entry.loadingPromise = std::move(promise);
+  return std::nullopt;
+}
+
+SharedContent TileContentRegistry::finishLoading(
+    const std::string& key,
+    TileLoadResult&& result) {
+  CESIUM_ASSERT(
+      result.state == TileLoadResultState::Success &&
+      std::holds_alternative<CesiumGltf::Model>(result.contentKind) &&
+      !result.tileInitializer);
+
+  // Remove the entry when the last tileset releases the content, unless
+  // another tileset has started loading it again in the meantime.
+  std::weak_ptr<State> pWeakState = this->_pState;
+  SharedContent pContent(
+      new TileLoadResult(std::move(result)),
+      [pWeakState, key](const TileLoadResult* pResult) {
+        std::shared_ptr<State> pState = pWeakState.lock();
+        if (pState) {
+          std::lock_guard<std::mutex> lock(pState->mutex);
+          auto it = pState->entries.find(key);
+          if (it != pState->entries.end() && !it->second.loadingFuture &&
+              it->second.pContent.expired()) {
+            pState->entries.erase(it);
+          }
+        }
+
+        delete pResult;
+      });
+
+  std::optional<Promise<SharedContent>> maybePromise;
+  {
+    std::lock_guard<std::mutex> lock(this->_pState->mutex);
+    State::Entry& entry = this->_pState->entries[key];
+    entry.pContent = pContent;
+    maybePromise = std::move(entry.loadingPromise);
+    entry.loadingPromise.reset();
+    entry.loadingFuture.reset();
+  }
+
+  // Resolve outside of the lock, because the continuations of the waiting
+  // tilesets may run immediately.
+  if (maybePromise) {
+    maybePromise->resolve(pContent);
+  }
+
+  return pContent;
+}
+
+void TileContentRegistry::cancelLoading(const std::string& key) {
+  std::optional<Promise<SharedContent>> maybePromise;
+  {
+    std::lock_guard<std::mutex> lock(this->_pState->mutex);
+    auto it = this->_pState->entries.find(key);
+    if (it == this->_pState->entries.end() || !it->second.loadingFuture) {
+      return;
+    }
+
+    maybePromise = std::move(it->second.loadingPromise);
+    this->_pState->entries.erase(it);
+  }
+
+  if (maybePromise) {
+    maybePromise->resolve(nullptr);
+  }
+}
+
+size_t TileContentRegistry::size() const {
+  std::lock_guard<std::mutex> lock(this->_pState->mutex);
+  return this->_pState->entries.size();
+}
+
+} // namespace Cesium3DTilesSelection
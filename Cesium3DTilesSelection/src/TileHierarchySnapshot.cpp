@@ -0,0 +1,558 @@
+#include "TileHierarchySnapshot.h"
+
+#include "ImplicitOctreeLoader.h"
+#include "ImplicitQuadtreeLoader.h"
+#include "TilesetJsonLoader.h"
+
+#include <Cesium3DTiles/ImplicitTiling.h>
+#include <CesiumGeometry/Axis.h>
+#include <CesiumGeometry/BoundingSphere.h>
+#include <CesiumGeometry/OrientedBoundingBox.h>
+#include <CesiumGeospatial/BoundingRegion.h>
+#include <CesiumGeospatial/BoundingRegionWithLooseFittingHeights.h>
+#include <CesiumGeospatial/GlobeRectangle.h>
+#include <CesiumGeospatial/S2CellBoundingVolume.h>
+
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <variant>
+
+using namespace CesiumGeometry;
+using namespace CesiumGeospatial;
+
+namespace Cesium3DTilesSelection {
+namespace {
+// The bytes "CTHS" when written by a little-endian machine. Snapshots written
+// with a different byte order are rejected.
+constexpr uint32_t SnapshotMagic = 0x53485443;
+constexpr uint32_t SnapshotVersion = 1;
+
+// The low two bits of the flags of a tile hold the kind of its content.
+constexpr uint8_t UnknownContent = 0;
+constexpr uint8_t EmptyContent = 1;
+constexpr uint8_t ExternalContent = 2;
+constexpr uint8_t ContentMask = 0x03;
+
+constexpr uint8_t RefineAddFlag = 0x04;
+constexpr uint8_t TransformFlag = 0x08;
+constexpr uint8_t ViewerRequestVolumeFlag = 0x10;
+constexpr uint8_t ContentBoundingVolumeFlag = 0x20;
+constexpr uint8_t ImplicitTilingFlag = 0x40;
+
+class SnapshotWriter {
+public:
+  template <typename T> void write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const size_t offset = this->_data.size();
+    this->_data.resize(offset + sizeof(T));
+    std::memcpy(this->_data.data() + offset, &value, sizeof(T));
+  }
+
+  void writeDoubles(const double* pValues, size_t count) {
+    const size_t offset = this->_data.size();
+    this->_data.resize(offset + count * sizeof(double));
+    std::memcpy(
+        this->_data.data() + offset,
+        pValues,
+        count * sizeof(double));
+  }
+
+  void writeString(const std::string& value) {
+    this->write(uint32_t(value.size()));
+    const size_t offset = this->_data.size();
+    this->_data.resize(offset + value.size());
+    std::memcpy(this->_data.data() + offset, value.data(), value.size());
+  }
+
+  std::vector<std::byte>& getData() noexcept { return this->_data; }
+
+private:
+  std::vector<std::byte> _data;
+};
+
+class SnapshotReader {
+public:
+  explicit SnapshotReader(const gsl::span<const std::byte>& data) noexcept
+      : _data(data), _offset(0) {}
+
+  template <typename T> bool read(T& value) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (this->getRemainingBytes() < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, this->_data.data() + this->_offset, sizeof(T));
+    this->_offset += sizeof(T);
+    return true;
+  }
+
+  bool readDoubles(double* pValues, size_t count) noexcept {
+    if (this->getRemainingBytes() / sizeof(double) < count) {
+      return false;
+    }
+    std::memcpy(
+        pValues,
+        this->_data.data() + this->_offset,
+        count * sizeof(double));
+    this->_offset += count * sizeof(double);
+    return true;
+  }
+
+  bool readString(std::string& value) {
+    uint32_t size;
+    if (!this->read(size) || this->getRemainingBytes() < size) {
+      return false;
+    }
+    value.assign(
+        reinterpret_cast<const char*>(this->_data.data() + this->_offset),
+        size);
+    this->_offset += size;
+    return true;
+  }
+
+  size_t getRemainingBytes() const noexcept {
+    return this->_data.size() - this->_offset;
+  }
+
+private:
+  gsl::span<const std::byte> _data;
+  size_t _offset;
+};
+
+void writeBoundingVolume(
+    SnapshotWriter& writer,
+    const BoundingVolume& boundingVolume) {
+  // The type is the index of the alternative in the BoundingVolume variant.
+  writer.write(uint8_t(boundingVolume.index()));
+
+  struct Operation {
+    SnapshotWriter& writer;
+
+    void operator()(const BoundingSphere& sphere) {
+      writer.writeDoubles(glm::value_ptr(sphere.getCenter()), 3);
+      writer.write(sphere.getRadius());
+    }
+
+    void operator()(const OrientedBoundingBox& box) {
+      writer.writeDoubles(glm::value_ptr(box.getCenter()), 3);
+      writer.writeDoubles(glm::value_ptr(box.getHalfAxes()), 9);
+    }
+
+    void operator()(const BoundingRegion& region) {
+      const GlobeRectangle& rectangle = region.getRectangle();
+      const double values[6]{
+          rectangle.getWest(),
+          rectangle.getSouth(),
+          rectangle.getEast(),
+          rectangle.getNorth(),
+          region.getMinimumHeight(),
+          region.getMaximumHeight()};
+      writer.writeDoubles(values, 6);
+    }
+
+    void operator()(const BoundingRegionWithLooseFittingHeights& region) {
+      (*this)(region.getBoundingRegion());
+    }
+
+    void operator()(const S2CellBoundingVolume& s2Cell) {
+      writer.write(s2Cell.getCellID().getID());
+      writer.write(s2Cell.getMinimumHeight());
+      writer.write(s2Cell.getMaximumHeight());
+    }
+  };
+
+  std::visit(Operation{writer}, boundingVolume);
+}
+
+std::optional<BoundingRegion>
+readBoundingRegion(SnapshotReader& reader, const Ellipsoid& ellipsoid) {
+  double values[6];
+  if (!reader.readDoubles(values, 6)) {
+    return std::nullopt;
+  }
+
+  return BoundingRegion(
+      GlobeRectangle(values[0], values[1], values[2], values[3]),
+      values[4],
+      values[5],
+      ellipsoid);
+}
+
+std::optional<BoundingVolume>
+readBoundingVolume(SnapshotReader& reader, const Ellipsoid& ellipsoid) {
+  uint8_t type;
+  if (!reader.read(type)) {
+    return std::nullopt;
+  }
+
+  switch (type) {
+  case 0: {
+    glm::dvec3 center;
+    double radius;
+    if (!reader.readDoubles(glm::value_ptr(center), 3) ||
+        !reader.read(radius)) {
+      return std::nullopt;
+    }
+    return BoundingSphere(center, radius);
+  }
+  case 1: {
+    glm::dvec3 center;
+    glm::dmat3 halfAxes;
+    if (!reader.readDoubles(glm::value_ptr(center), 3) ||
+        !reader.readDoubles(glm::value_ptr(halfAxes), 9)) {
+      return std::nullopt;
+    }
+    return OrientedBoundingBox(center, halfAxes);
+  }
+  case 2:
+    return readBoundingRegion(reader, ellipsoid);
+  case 3: {
+    std::optional<BoundingRegion> region =
+        readBoundingRegion(reader, ellipsoid);
+    if (!region) {
+      return std::nullopt;
+    }
+    return BoundingRegionWithLooseFittingHeights(*region);
+  }
+  case 4: {
+    uint64_t cellID;
+    double minimumHeight;
+    double maximumHeight;
+    if (!reader.read(cellID) || !reader.read(minimumHeight) ||
+        !reader.read(maximumHeight)) {
+      return std::nullopt;
+    }
+    return S2CellBoundingVolume(
+        S2CellID(cellID),
+        minimumHeight,
+        maximumHeight,
+        ellipsoid);
+  }
+  default:
+    return std::nullopt;
+  }
+}
+
+bool writeImplicitTiling(SnapshotWriter& writer, const Tile& implicitRoot) {
+  const TilesetContentLoader* pLoader = implicitRoot.getLoader();
+  if (const auto* pQuadtreeLoader =
+          dynamic_cast<const ImplicitQuadtreeLoader*>(pLoader)) {
+    writer.writeString(
+        Cesium3DTiles::ImplicitTiling::SubdivisionScheme::QUADTREE);
+    writer.writeString(pQuadtreeLoader->getContentUrlTemplate());
+    writer.writeString(pQuadtreeLoader->getSubtreeUrlTemplate());
+    writer.write(pQuadtreeLoader->getSubtreeLevels());
+    writer.write(pQuadtreeLoader->getAvailableLevels());
+    return true;
+  }
+
+  if (const auto* pOctreeLoader =
+          dynamic_cast<const ImplicitOctreeLoader*>(pLoader)) {
+    writer.writeString(
+        Cesium3DTiles::ImplicitTiling::SubdivisionScheme::OCTREE);
+    writer.writeString(pOctreeLoader->getContentUrlTemplate());
+    writer.writeString(pOctreeLoader->getSubtreeUrlTemplate());
+    writer.write(pOctreeLoader->getSubtreeLevels());
+    writer.write(pOctreeLoader->getAvailableLevels());
+    return true;
+  }
+
+  return false;
+}
+
+bool writeTile(
+    SnapshotWriter& writer,
+    const Tile& tile,
+    const glm::dmat4& parentTransform,
+    const TilesetJsonLoader& loader) {
+  if (tile.getLoader() != &loader) {
+    return false;
+  }
+
+  const std::string* pContentUri =
+      std::get_if<std::string>(&tile.getTileID());
+  if (!pContentUri) {
+    return false;
+  }
+
+  const gsl::span<const Tile> children = tile.getChildren();
+  const bool isImplicit = tile.isExternalContent() && children.size() == 1 &&
+                          children[0].getLoader() != &loader;
+
+  uint8_t flags = UnknownContent;
+  if (tile.isExternalContent()) {
+    flags = ExternalContent;
+  } else if (tile.isEmptyContent()) {
+    flags = EmptyContent;
+  }
+  if (tile.getRefine() == TileRefine::Add) {
+    flags |= RefineAddFlag;
+  }
+  if (tile.getTransform() != parentTransform) {
+    flags |= TransformFlag;
+  }
+  if (tile.getViewerRequestVolume()) {
+    flags |= ViewerRequestVolumeFlag;
+  }
+  if (tile.getContentBoundingVolume()) {
+    flags |= ContentBoundingVolumeFlag;
+  }
+  if (isImplicit) {
+    flags |= ImplicitTilingFlag;
+  }
+  writer.write(flags);
+
+  if (flags & TransformFlag) {
+    writer.writeDoubles(glm::value_ptr(tile.getTransform()), 16);
+  }
+  writeBoundingVolume(writer, tile.getBoundingVolume());
+  if (tile.getViewerRequestVolume()) {
+    writeBoundingVolume(writer, *tile.getViewerRequestVolume());
+  }
+  if (tile.getContentBoundingVolume()) {
+    writeBoundingVolume(writer, *tile.getContentBoundingVolume());
+  }
+  writer.write(tile.getGeometricError());
+  if ((flags & ContentMask) == UnknownContent) {
+    writer.writeString(*pContentUri);
+  }
+
+  if (isImplicit) {
+    // The implicit tiles are recreated from the parameters of their loader.
+    return writeImplicitTiling(writer, children[0]);
+  }
+
+  writer.write(uint32_t(children.size()));
+  for (const Tile& child : children) {
+    if (!writeTile(writer, child, tile.getTransform(), loader)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::optional<Tile> readTile(
+    SnapshotReader& reader,
+    const glm::dmat4& parentTransform,
+    const Ellipsoid& ellipsoid,
+    TilesetJsonLoader& loader) {
+  uint8_t flags;
+  if (!reader.read(flags)) {
+    return std::nullopt;
+  }
+
+  glm::dmat4 transform = parentTransform;
+  if ((flags & TransformFlag) &&
+      !reader.readDoubles(glm::value_ptr(transform), 16)) {
+    return std::nullopt;
+  }
+
+  std::optional<BoundingVolume> boundingVolume =
+      readBoundingVolume(reader, ellipsoid);
+  if (!boundingVolume) {
+    return std::nullopt;
+  }
+
+  std::optional<BoundingVolume> viewerRequestVolume;
+  if (flags & ViewerRequestVolumeFlag) {
+    viewerRequestVolume = readBoundingVolume(reader, ellipsoid);
+    if (!viewerRequestVolume) {
+      return std::nullopt;
+    }
+  }
+
+  std::optional<BoundingVolume> contentBoundingVolume;
+  if (flags & ContentBoundingVolumeFlag) {
+    contentBoundingVolume = readBoundingVolume(reader, ellipsoid);
+    if (!contentBoundingVolume) {
+      return std::nullopt;
+    }
+  }
+
+  double geometricError;
+  if (!reader.read(geometricError)) {
+    return std::nullopt;
+  }
+
+  std::optional<Tile> tile;
+  switch (flags & ContentMask) {
+  case UnknownContent: {
+    std::string contentUri;
+    if (!reader.readString(contentUri)) {
+      return std::nullopt;
+    }
+    tile.emplace(&loader);
+    tile->setTileID(contentUri);
+    break;
+  }
+  case EmptyContent:
+    tile.emplace(&loader, TileEmptyContent{});
+    tile->setTileID("");
+    break;
+  case ExternalContent:
+    tile.emplace(&loader, std::make_unique<TileExternalContent>());
+    tile->setTileID("");
+    break;
+  default:
+    return std::nullopt;
+  }
+
+  tile->setTransform(transform);
+  tile->setBoundingVolume(*boundingVolume);
+  tile->setViewerRequestVolume(viewerRequestVolume);
+  tile->setContentBoundingVolume(contentBoundingVolume);
+  tile->setGeometricError(geometricError);
+  tile->setRefine(
+      (flags & RefineAddFlag) ? TileRefine::Add : TileRefine::Replace);
+
+  if (flags & ImplicitTilingFlag) {
+    std::string subdivisionScheme;
+    std::string contentUriTemplate;
+    std::string subtreeUriTemplate;
+    uint32_t subtreeLevels;
+    uint32_t availableLevels;
+    if (!reader.readString(subdivisionScheme) ||
+        !reader.readString(contentUriTemplate) ||
+        !reader.readString(subtreeUriTemplate) ||
+        !reader.read(subtreeLevels) || !reader.read(availableLevels)) {
+      return std::nullopt;
+    }
+
+    loader.addImplicitTileset(
+        *tile,
+        subdivisionScheme,
+        contentUriTemplate,
+        subtreeUriTemplate,
+        subtreeLevels,
+        availableLevels);
+    return tile;
+  }
+
+  uint32_t childCount;
+  // Each tile takes more than one byte, so a larger count can only come from
+  // a corrupted snapshot.
+  if (!reader.read(childCount) || childCount > reader.getRemainingBytes()) {
+    return std::nullopt;
+  }
+
+  std::vector<Tile> children;
+  children.reserve(childCount);
+  for (uint32_t i = 0; i < childCount; ++i) {
+    std::optional<Tile> child =
+        readTile(reader, transform, ellipsoid, loader);
+    if (!child) {
+      return std::nullopt;
+    }
+    children.emplace_back(std::move(*child));
+  }
+  tile->createChildTiles(std::move(children));
+
+  return tile;
+}
+} // namespace
+
+/*static*/ std::string
+TileHierarchySnapshot::getValidator(const CesiumAsync::HttpHeaders& headers) {
+  auto etagIt = headers.find("ETag");
+  if (etagIt != headers.end() && !etagIt->second.empty()) {
+    return "ETag " + etagIt->second;
+  }
+
+  auto lastModifiedIt = headers.find("Last-Modified");
+  if (lastModifiedIt != headers.end() && !lastModifiedIt->second.empty()) {
+    return "Last-Modified " + lastModifiedIt->second;
+  }
+
+  return std::string();
+}
+
+/*static*/ std::vector<std::byte> TileHierarchySnapshot::write(
+    const Tile& rootTile,
+    const TilesetJsonLoader& loader,
+    const std::string& validator,
+    const Ellipsoid& ellipsoid) {
+  const TileExternalContent* pExternal =
+      rootTile.getContent().getExternalContent();
+  if (!pExternal || rootTile.getChildren().size() != 1) {
+    return {};
+  }
+
+  const TilesetMetadata& metadata = pExternal->metadata;
+  if (metadata.schema || metadata.metadata || !metadata.groups.empty()) {
+    return {};
+  }
+
+  SnapshotWriter writer;
+  writer.write(SnapshotMagic);
+  writer.write(SnapshotVersion);
+  writer.writeString(validator);
+  writer.writeDoubles(glm::value_ptr(ellipsoid.getRadii()), 3);
+  writer.write(uint8_t(loader.getUpAxis()));
+  writer.write(uint8_t(metadata.schemaUri ? 1 : 0));
+  if (metadata.schemaUri) {
+    writer.writeString(*metadata.schemaUri);
+  }
+
+  if (!writeTile(
+          writer,
+          rootTile.getChildren()[0],
+          glm::dmat4(1.0),
+          loader)) {
+    return {};
+  }
+
+  return std::move(writer.getData());
+}
+
+/*static*/ std::optional<Tile> TileHierarchySnapshot::read(
+    const gsl::span<const std::byte>& snapshot,
+    const std::string& validator,
+    const Ellipsoid& ellipsoid,
+    TilesetJsonLoader& loader,
+    TileExternalContent& externalContent) {
+  SnapshotReader reader(snapshot);
+
+  uint32_t magic;
+  uint32_t version;
+  std::string snapshotValidator;
+  if (!reader.read(magic) || magic != SnapshotMagic ||
+      !reader.read(version) || version != SnapshotVersion ||
+      !reader.readString(snapshotValidator) ||
+      snapshotValidator != validator) {
+    return std::nullopt;
+  }
+
+  glm::dvec3 radii;
+  uint8_t upAxis;
+  uint8_t hasSchemaUri;
+  if (!reader.readDoubles(glm::value_ptr(radii), 3) ||
+      radii != ellipsoid.getRadii() || !reader.read(upAxis) ||
+      upAxis > uint8_t(Axis::Z) || !reader.read(hasSchemaUri)) {
+    return std::nullopt;
+  }
+
+  if (hasSchemaUri) {
+    std::string schemaUri;
+    if (!reader.readString(schemaUri)) {
+      return std::nullopt;
+    }
+    externalContent.metadata.schemaUri = std::move(schemaUri);
+  }
+
+  loader.setUpAxis(Axis(upAxis));
+
+  std::optional<Tile> rootTile =
+      readTile(reader, glm::dmat4(1.0), ellipsoid, loader);
+  if (!rootTile || reader.getRemainingBytes() != 0) {
+    return std::nullopt;
+  }
+
+  return rootTile;
+}
+} // namespace Cesium3DTilesSelection
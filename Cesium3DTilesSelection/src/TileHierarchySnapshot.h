@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Cesium3DTilesSelection/Tile.h>
+#include <CesiumAsync/HttpHeaders.h>
+#include <CesiumGeospatial/Ellipsoid.h>
+
+#include <gsl/span>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+class TilesetJsonLoader;
+
+/**
+ * @brief Writes and reads a compact binary snapshot of the tiles created from
+ * a tileset.json, so that a later session can rebuild them without parsing
+ * the JSON again.
+ *
+ * The snapshot holds the final transform, bounding volumes, geometric error,
+ * refinement, and content URI of each tile, as well as the parameters of
+ * implicit tilesets, in depth-first pre-order. Tiles that share the transform
+ * of their parent do not repeat it. The snapshot is only valid for the
+ * version of the tileset.json identified by its validator, and for the
+ * ellipsoid it was written with.
+ *
+ * Tiles loaded later, such as those of external tilesets, are not part of the
+ * snapshot.
+ */
+class TileHierarchySnapshot {
+public:
+  /**
+   * @brief Gets a string identifying the version of a tileset.json from the
+   * headers of its response: its `ETag` or, failing that, its
+   * `Last-Modified` header.
+   *
+   * @return The validator, or an empty string if the response has neither
+   * header, in which case no snapshot should be used.
+   */
+  static std::string getValidator(const CesiumAsync::HttpHeaders& headers);
+
+  /**
+   * @brief Writes a snapshot of the tiles created by
+   * {@link TilesetJsonLoader::createLoader}.
+   *
+   * Tilesets with a metadata schema, metadata, or groups are not supported,
+   * because these are not part of the snapshot.
+   *
+   * @param rootTile The root tile returned by the loader, which represents the
+   * tileset.json itself.
+   * @param loader The loader of the tiles.
+   * @param validator The validator of the tileset.json.
+   * @param ellipsoid The ellipsoid of the tileset.
+   * @return The snapshot, or an empty vector if it is not supported.
+   */
+  static std::vector<std::byte> write(
+      const Tile& rootTile,
+      const TilesetJsonLoader& loader,
+      const std::string& validator,
+      const CesiumGeospatial::Ellipsoid& ellipsoid);
+
+  /**
+   * @brief Reads the tiles of a snapshot written by {@link write}.
+   *
+   * @param snapshot The snapshot.
+   * @param validator The validator of the current version of the tileset.json.
+   * @param ellipsoid The ellipsoid of the tileset.
+   * @param loader The loader of the tiles, whose up axis is set from the
+   * snapshot and which receives the loaders of implicit tilesets.
+   * @param externalContent The content of the tile representing the
+   * tileset.json, which receives its metadata.
+   * @return The tile that was the only child of the root tile given to
+   * {@link write}, or `std::nullopt` if the snapshot is invalid or does not
+   * match the validator or ellipsoid.
+   */
+  static std::optional<Tile> read(
+      const gsl::span<const std::byte>& snapshot,
+      const std::string& validator,
+      const CesiumGeospatial::Ellipsoid& ellipsoid,
+      TilesetJsonLoader& loader,
+      TileExternalContent& externalContent);
+};
+} // namespace Cesium3DTilesSelection
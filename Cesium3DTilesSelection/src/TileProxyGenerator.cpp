@@ -0,0 +1,372 @@
+#include "TileProxyGenerator.h"
+
+#include "TileHierarchySnapshot.h"
+
+#include <Cesium3DTilesSelection/Tile.h>
+#include <CesiumGltf/ImageCesium.h>
+#include <CesiumGltfContent/GltfUtilities.h>
+#include <CesiumGltfContent/ImageManipulation.h>
+#include <CesiumGltfReader/GltfReader.h>
+#include <CesiumGltfWriter/GltfWriter.h>
+#include <CesiumUtility/ErrorList.h>
+#include <CesiumUtility/Tracing.h>
+
+#include <picosha2.h>
+#include <spdlog/logger.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+using namespace CesiumGltf;
+using namespace CesiumGltfContent;
+
+namespace Cesium3DTilesSelection {
+namespace {
+const std::string GeometricErrorKey = "Cesium3DTiles_ProxyGeometricError";
+
+// Only uncompressed 8-bit images with a single mip level can be scaled and
+// stored as PNG.
+bool isPlainImage(const ImageCesium& image) noexcept {
+  return !image.getPixelData().empty() && image.mipPositions.empty() &&
+         image.compressedPixelFormat == GpuCompressedPixelFormat::NONE &&
+         image.bytesPerChannel == 1;
+}
+
+void downsampleImages(Model& model, int32_t maximumSize) {
+  for (Image& image : model.images) {
+    const ImageCesium& source = image.cesium;
+    if (source.width <= maximumSize && source.height <= maximumSize) {
+      continue;
+    }
+
+    if (!isPlainImage(source)) {
+      continue;
+    }
+
+    const double scale = double(maximumSize) /
+                         double(std::max(source.width, source.height));
+
+    ImageCesium target;
+    target.width = std::max(1, int32_t(double(source.width) * scale));
+    target.height = std::max(1, int32_t(double(source.height) * scale));
+    target.channels = source.channels;
+    target.bytesPerChannel = 1;
+    target.pixelData.resize(
+        size_t(target.width) * size_t(target.height) *
+        size_t(target.channels));
+
+    const bool blitted = ImageManipulation::blitImage(
+        target,
+        PixelRectangle{0, 0, target.width, target.height},
+        source,
+        PixelRectangle{0, 0, source.width, source.height});
+    if (blitted) {
+      image.cesium = std::move(target);
+    }
+  }
+}
+
+uint64_t hashString(uint64_t hash, const std::string& value) noexcept {
+  // 64-bit FNV-1a
+  for (const char c : value) {
+    hash ^= uint64_t(uint8_t(c));
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+} // namespace
+
+TileProxyGenerator::TileProxyGenerator() noexcept
+    : _entries{}, _tileRequestCounts{}, _nextRequestId{0} {}
+
+/*static*/ bool TileProxyGenerator::canHaveProxy(const Tile& tile) noexcept {
+  return tile.getState() == TileLoadState::Done &&
+         tile.getContent().isEmptyContent() &&
+         tile.getRefine() == TileRefine::Replace &&
+         !tile.getChildren().empty();
+}
+
+bool TileProxyGenerator::hasProxy(const Tile& tile) const noexcept {
+  auto it = this->_entries.find(&tile);
+  return it != this->_entries.end() && it->second.state == ProxyState::Ready &&
+         tile.getContent().isRenderContent();
+}
+
+std::optional<uint64_t> TileProxyGenerator::beginLoad(const Tile& tile) {
+  if (this->_entries.find(&tile) != this->_entries.end()) {
+    return std::nullopt;
+  }
+
+  const uint64_t requestId = ++this->_nextRequestId;
+  this->_entries.emplace(
+      &tile,
+      ProxyEntry{ProxyState::Loading, requestId, tile.getGeometricError()});
+  ++this->_tileRequestCounts[&tile];
+  return requestId;
+}
+
+std::optional<std::pair<uint64_t, TileProxyGenerator::BuildInput>>
+TileProxyGenerator::beginBuild(Tile& tile) {
+  auto entryIt = this->_entries.find(&tile);
+  if (entryIt == this->_entries.end() ||
+      entryIt->second.state != ProxyState::Missing) {
+    return std::nullopt;
+  }
+
+  gsl::span<Tile> children = tile.getChildren();
+  for (const Tile& child : children) {
+    if (child.getState() != TileLoadState::Done ||
+        !child.getContent().isRenderContent() ||
+        !child.getMappedRasterTiles().empty()) {
+      return std::nullopt;
+    }
+  }
+
+  CESIUM_TRACE("TileProxyGenerator::beginBuild");
+
+  const uint64_t requestId = ++this->_nextRequestId;
+  entryIt->second.state = ProxyState::Building;
+  entryIt->second.requestId = requestId;
+  ++this->_tileRequestCounts[&tile];
+
+  BuildInput input{
+      TileRenderBatcher::BuildInput{
+          &tile,
+          requestId,
+          tile.getTransform(),
+          {},
+          {},
+          {}},
+      0.0};
+  input.children.tiles.reserve(children.size());
+  input.children.tileTransforms.reserve(children.size());
+  input.children.models.reserve(children.size());
+  for (Tile& child : children) {
+    input.children.tiles.emplace_back(&child);
+    input.children.tileTransforms.emplace_back(child.getTransform());
+    TileRenderContent* pRenderContent = child.getContent().getRenderContent();
+    input.children.models.emplace_back(pRenderContent->shareModel());
+    input.childGeometricError = std::max(
+        input.childGeometricError,
+        child.getNonZeroGeometricError());
+  }
+
+  return std::make_pair(requestId, std::move(input));
+}
+
+bool TileProxyGenerator::finish(
+    const Tile& tile,
+    uint64_t requestId,
+    bool succeeded) noexcept {
+  auto countIt = this->_tileRequestCounts.find(&tile);
+  if (countIt != this->_tileRequestCounts.end() && --countIt->second == 0) {
+    this->_tileRequestCounts.erase(countIt);
+  }
+
+  auto entryIt = this->_entries.find(&tile);
+  if (entryIt == this->_entries.end() ||
+      entryIt->second.requestId != requestId) {
+    return false;
+  }
+
+  ProxyEntry& entry = entryIt->second;
+  if (succeeded) {
+    entry.state = ProxyState::Ready;
+  } else if (entry.state == ProxyState::Loading) {
+    entry.state = ProxyState::Missing;
+  } else {
+    entry.state = ProxyState::Failed;
+  }
+
+  return true;
+}
+
+bool TileProxyGenerator::isRequesting(const Tile& tile) const noexcept {
+  return this->_tileRequestCounts.find(&tile) !=
+         this->_tileRequestCounts.end();
+}
+
+double TileProxyGenerator::getReplacedGeometricError(
+    const Tile& tile) const noexcept {
+  auto it = this->_entries.find(&tile);
+  if (it == this->_entries.end()) {
+    return tile.getGeometricError();
+  }
+  return it->second.replacedGeometricError;
+}
+
+void TileProxyGenerator::forget(const Tile& tile) noexcept {
+  this->_entries.erase(&tile);
+}
+
+void TileProxyGenerator::forgetAll() noexcept { this->_entries.clear(); }
+
+/*static*/ std::optional<Model> TileProxyGenerator::buildInWorkerThread(
+    BuildInput&& input,
+    const Settings& settings,
+    const std::shared_ptr<spdlog::logger>& pLogger) {
+  CESIUM_TRACE("TileProxyGenerator::buildInWorkerThread");
+
+  std::optional<TileRenderBatcher::BuildResult> maybeMerged =
+      TileRenderBatcher::mergeInWorkerThread(
+          std::move(input.children),
+          pLogger);
+  if (!maybeMerged) {
+    return std::nullopt;
+  }
+
+  Model model = std::move(maybeMerged->model);
+
+  const double simplificationError = GltfUtilities::simplifyMeshes(
+      model,
+      settings.simplificationRatio,
+      settings.simplificationError);
+  downsampleImages(model, settings.maximumTextureSize);
+
+  // The proxy is coarser than any of the children, so give it at least the
+  // usual doubling of the geometric error from one level to the next.
+  model.extras[GeometricErrorKey] = std::max(
+      2.0 * input.childGeometricError,
+      input.childGeometricError + simplificationError);
+
+  return model;
+}
+
+/*static*/ std::optional<double>
+TileProxyGenerator::getGeometricError(const Model& model) {
+  auto it = model.extras.find(GeometricErrorKey);
+  if (it == model.extras.end()) {
+    return std::nullopt;
+  }
+
+  const double geometricError = it->second.getSafeNumberOrDefault(-1.0);
+  if (geometricError < 0.0) {
+    return std::nullopt;
+  }
+
+  return geometricError;
+}
+
+/*static*/ std::string TileProxyGenerator::createCacheKey(
+    const std::string& tilesetKey,
+    const Tile& tile) {
+  uint64_t childrenHash = 14695981039346656037ULL;
+  for (const Tile& child : tile.getChildren()) {
+    childrenHash = hashString(
+        childrenHash,
+        TileIdUtilities::createTileIdString(child.getTileID()));
+    childrenHash = hashString(childrenHash, "\n");
+  }
+
+  return tilesetKey + "#proxy/" +
+         TileIdUtilities::createTileIdString(tile.getTileID()) + "/" +
+         std::to_string(tile.getChildren().size()) + "/" +
+         std::to_string(childrenHash);
+}
+
+/*static*/ std::string TileProxyGenerator::getTilesetVersion(
+    const CesiumAsync::IAssetResponse& response) {
+  std::string validator =
+      TileHierarchySnapshot::getValidator(response.headers());
+  if (!validator.empty()) {
+    return validator;
+  }
+
+  const gsl::span<const std::byte> data = response.data();
+  const unsigned char* pBegin =
+      reinterpret_cast<const unsigned char*>(data.data());
+  std::array<unsigned char, picosha2::k_digest_size> digest;
+  picosha2::hash256(pBegin, pBegin + data.size(), digest.begin(), digest.end());
+  return "SHA-256 " +
+         picosha2::bytes_to_hex_string(digest.begin(), digest.end());
+}
+
+/*static*/ std::vector<std::byte> TileProxyGenerator::writeProxy(
+    const Model& model,
+    const std::shared_ptr<spdlog::logger>& pLogger) {
+  CESIUM_TRACE("TileProxyGenerator::writeProxy");
+
+  Model glb = model;
+  GltfUtilities::collapseToSingleBuffer(glb);
+  if (glb.buffers.empty()) {
+    glb.buffers.emplace_back();
+  }
+
+  // The writer ignores decoded pixels, so store each image in the binary
+  // chunk as a PNG. An image that cannot be stored that way, such as a
+  // compressed image or one with mip levels, would be missing when the proxy
+  // is read again, so such a proxy is not stored at all.
+  std::vector<std::byte>& data = glb.buffers[0].cesium.data;
+  for (Image& image : glb.images) {
+    if (!isPlainImage(image.cesium)) {
+      return {};
+    }
+
+    const std::vector<std::byte> png =
+        ImageManipulation::savePng(image.cesium);
+    if (png.empty()) {
+      SPDLOG_LOGGER_WARN(pLogger, "Failed to encode a proxy image as PNG.");
+      return {};
+    }
+
+    // Keep each buffer view aligned to 8 bytes.
+    data.resize((data.size() + 7) / 8 * 8);
+
+    BufferView& bufferView = glb.bufferViews.emplace_back();
+    bufferView.buffer = 0;
+    bufferView.byteOffset = int64_t(data.size());
+    bufferView.byteLength = int64_t(png.size());
+    data.insert(data.end(), png.begin(), png.end());
+
+    image.bufferView = int32_t(glb.bufferViews.size() - 1);
+    image.mimeType = Image::MimeType::image_png;
+    image.uri.reset();
+    image.cesium = ImageCesium();
+  }
+
+  glb.buffers[0].byteLength = int64_t(data.size());
+  glb.buffers[0].uri.reset();
+
+  CesiumGltfWriter::GltfWriter writer;
+  CesiumGltfWriter::GltfWriterResult result = writer.writeGlb(glb, data);
+  CesiumUtility::ErrorList errors{
+      std::move(result.errors),
+      std::move(result.warnings)};
+  errors.logWarning(pLogger, "Warnings while writing a proxy");
+  if (errors.hasErrors()) {
+    errors.logError(pLogger, "Failed to write a proxy");
+    return {};
+  }
+
+  return std::move(result.gltfBytes);
+}
+
+/*static*/ std::optional<Model> TileProxyGenerator::readProxy(
+    const gsl::span<const std::byte>& data,
+    const std::shared_ptr<spdlog::logger>& pLogger) {
+  CESIUM_TRACE("TileProxyGenerator::readProxy");
+
+  CesiumGltfReader::GltfReader reader;
+  CesiumGltfReader::GltfReaderResult result = reader.readGltf(data);
+  CesiumUtility::ErrorList errors{
+      std::move(result.errors),
+      std::move(result.warnings)};
+  errors.logWarning(pLogger, "Warnings while reading a cached proxy");
+  if (errors.hasErrors() || !result.model) {
+    errors.logError(pLogger, "Failed to read a cached proxy");
+    return std::nullopt;
+  }
+
+  Model model = std::move(*result.model);
+
+  // The images are decoded now, so their encoded bytes are no longer needed.
+  for (Image& image : model.images) {
+    image.bufferView = -1;
+    image.mimeType.reset();
+  }
+  GltfUtilities::removeUnusedBufferData(model);
+
+  return model;
+}
+} // namespace Cesium3DTilesSelection
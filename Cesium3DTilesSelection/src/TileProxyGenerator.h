@@ -0,0 +1,209 @@
+#pragma once
+
+#include "TileRenderBatcher.h"
+
+#include <CesiumAsync/IAssetResponse.h>
+#include <CesiumGltf/Model.h>
+
+#include <gsl/span>
+#include <spdlog/fwd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+class Tile;
+
+/**
+ * @brief Tracks the simplified proxy content of the tiles of a tileset that
+ * have no content of their own.
+ *
+ * A proxy is first looked up in a cache. If it is not found, it is built from
+ * the children of the tile once they are all loaded. Except for the static
+ * methods, all methods must be called from the main thread.
+ */
+class TileProxyGenerator {
+public:
+  /**
+   * @brief The settings used to build a proxy.
+   */
+  struct Settings {
+    float simplificationRatio;
+    float simplificationError;
+    int32_t maximumTextureSize;
+  };
+
+  /**
+   * @brief A snapshot of the children of a tile, taken in the main thread and
+   * handed to a worker thread to be built into a proxy.
+   */
+  struct BuildInput {
+    TileRenderBatcher::BuildInput children;
+    double childGeometricError;
+  };
+
+  TileProxyGenerator() noexcept;
+
+  /**
+   * @brief Determines whether the given tile is one for which a proxy can be
+   * created: a loaded tile with no content of its own that is replaced by its
+   * children when refined.
+   */
+  static bool canHaveProxy(const Tile& tile) noexcept;
+
+  /**
+   * @brief Determines whether the current content of the given tile is a
+   * proxy installed by this generator.
+   */
+  bool hasProxy(const Tile& tile) const noexcept;
+
+  /**
+   * @brief Starts looking up the proxy of the given tile in the cache, if
+   * nothing is known about it yet.
+   *
+   * @return The ID of the request, or `std::nullopt` if no lookup should be
+   * started.
+   */
+  std::optional<uint64_t> beginLoad(const Tile& tile);
+
+  /**
+   * @brief Starts building the proxy of the given tile, if it was not found
+   * in the cache and all of its children are loaded.
+   *
+   * @return The ID of the request and the input to
+   * {@link buildInWorkerThread}, or `std::nullopt` if no proxy should be
+   * built.
+   */
+  std::optional<std::pair<uint64_t, BuildInput>> beginBuild(Tile& tile);
+
+  /**
+   * @brief Completes a lookup or build started by {@link beginLoad} or
+   * {@link beginBuild}.
+   *
+   * A lookup that found nothing makes the tile eligible for
+   * {@link beginBuild}. A build that produced nothing is not tried again.
+   *
+   * @return True if the request is still current and its proxy, if any,
+   * should be installed.
+   */
+  bool finish(const Tile& tile, uint64_t requestId, bool succeeded) noexcept;
+
+  /**
+   * @brief Determines if a lookup or build of the proxy of the given tile has
+   * been started and not finished, even if the tile has been forgotten since.
+   *
+   * Such a tile and its children must not be destroyed until the request is
+   * finished, because the request refers to them.
+   */
+  bool isRequesting(const Tile& tile) const noexcept;
+
+  /**
+   * @brief Gets the geometric error that the given tile had before anything
+   * was known about its proxy.
+   *
+   * A tile without content of its own is often refined unconditionally, in
+   * which case this is infinite.
+   */
+  double getReplacedGeometricError(const Tile& tile) const noexcept;
+
+  /**
+   * @brief Forgets everything about the given tile, typically because its
+   * proxy has been unloaded.
+   */
+  void forget(const Tile& tile) noexcept;
+
+  /**
+   * @brief Forgets everything about all tiles. Requests in progress will no
+   * longer be current when they finish.
+   */
+  void forgetAll() noexcept;
+
+  /**
+   * @brief Merges, simplifies, and downsamples the models of the children of
+   * a tile.
+   *
+   * The returned model is in the coordinate system of the tile. The geometric
+   * error of the proxy is stored in its extras and can be retrieved with
+   * {@link getGeometricError}.
+   *
+   * @return The proxy model, or `std::nullopt` if the children could not be
+   * merged.
+   */
+  static std::optional<CesiumGltf::Model> buildInWorkerThread(
+      BuildInput&& input,
+      const Settings& settings,
+      const std::shared_ptr<spdlog::logger>& pLogger);
+
+  /**
+   * @brief Gets the geometric error stored in a proxy model by
+   * {@link buildInWorkerThread}.
+   */
+  static std::optional<double>
+  getGeometricError(const CesiumGltf::Model& model);
+
+  /**
+   * @brief Creates the key under which the proxy of the given tile is stored
+   * in the cache.
+   *
+   * The key depends on the tile and on its children so that a proxy is not
+   * reused if the structure of the tileset changes.
+   *
+   * @param tilesetKey A key identifying the tileset, such as its URL along
+   * with the version returned by {@link getTilesetVersion}, so that a proxy
+   * is not reused if the content of the tileset changes.
+   * @param tile The tile.
+   */
+  static std::string
+  createCacheKey(const std::string& tilesetKey, const Tile& tile);
+
+  /**
+   * @brief Identifies the version of a tileset.json for the keys of its
+   * proxies.
+   *
+   * @param response The response with the tileset.json.
+   * @return The `ETag` or `Last-Modified` header of the response, like the
+   * validator of a {@link TileHierarchySnapshot}, or a SHA-256 hash of the
+   * tileset.json if the response has neither.
+   */
+  static std::string
+  getTilesetVersion(const CesiumAsync::IAssetResponse& response);
+
+  /**
+   * @brief Serializes a proxy model as a GLB with PNG-encoded images.
+   *
+   * @return The GLB, or an empty vector if the model could not be written,
+   * such as when it has images that cannot be stored as PNG.
+   */
+  static std::vector<std::byte> writeProxy(
+      const CesiumGltf::Model& model,
+      const std::shared_ptr<spdlog::logger>& pLogger);
+
+  /**
+   * @brief Deserializes a proxy model written by {@link writeProxy}.
+   *
+   * @return The model, or `std::nullopt` if the data could not be read.
+   */
+  static std::optional<CesiumGltf::Model> readProxy(
+      const gsl::span<const std::byte>& data,
+      const std::shared_ptr<spdlog::logger>& pLogger);
+
+private:
+  enum class ProxyState { Loading, Missing, Building, Ready, Failed };
+
+  struct ProxyEntry {
+    ProxyState state;
+    uint64_t requestId;
+    double replacedGeometricError;
+  };
+
+  std::unordered_map<const Tile*, ProxyEntry> _entries;
+  std::unordered_map<const Tile*, int32_t> _tileRequestCounts;
+  uint64_t _nextRequestId;
+};
+} // namespace Cesium3DTilesSelection
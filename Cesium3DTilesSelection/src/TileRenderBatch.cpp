@@ -0,0 +1,36 @@
+#include <Cesium3DTilesSelection/TileRenderBatch.h>
+
+namespace Cesium3DTilesSelection {
+TileRenderBatch::TileRenderBatch(
+    Tile& parent,
+    std::vector<Member>&& members,
+    CesiumGltf::Model&& model,
+    const glm::dmat4x4& transform) noexcept
+    : _pParent{&parent},
+      _members{std::move(members)},
+      _model{std::move(model)},
+      _transform{transform},
+      _pRenderResources{nullptr} {}
+
+int64_t TileRenderBatch::computeByteSize() const noexcept {
+  int64_t bytes = 0;
+
+  for (const CesiumGltf::Buffer& buffer : this->_model.buffers) {
+    bytes += int64_t(buffer.cesium.data.size());
+  }
+
+  const std::vector<CesiumGltf::BufferView>& bufferViews =
+      this->_model.bufferViews;
+  for (const CesiumGltf::Image& image : this->_model.images) {
+    const int32_t bufferView = image.bufferView;
+    if (bufferView >= 0 &&
+        bufferView < static_cast<int32_t>(bufferViews.size())) {
+      bytes -= bufferViews[size_t(bufferView)].byteLength;
+    }
+
+    bytes += image.cesium.sizeBytes;
+  }
+
+  return bytes;
+}
+} // namespace Cesium3DTilesSelection
@@ -0,0 +1,369 @@
+#include "TileRenderBatcher.h"
+
+#include <Cesium3DTilesSelection/IPrepareRendererResources.h>
+#include <Cesium3DTilesSelection/Tile.h>
+#include <Cesium3DTilesSelection/ViewUpdateResult.h>
+#include <CesiumGeometry/Axis.h>
+#include <CesiumGltf/ExtensionCesiumRTC.h>
+#include <CesiumGltfContent/GltfUtilities.h>
+#include <CesiumUtility/Tracing.h>
+
+#include <glm/matrix.hpp>
+#include <spdlog/logger.h>
+
+#include <algorithm>
+
+using namespace CesiumGltf;
+using namespace CesiumGltfContent;
+
+namespace Cesium3DTilesSelection {
+namespace {
+bool isBatchable(const Tile& tile, int64_t maximumTileBytes) {
+  if (tile.getState() != TileLoadState::Done) {
+    return false;
+  }
+
+  if (!tile.getChildren().empty() || !tile.getMappedRasterTiles().empty()) {
+    return false;
+  }
+
+  const TileRenderContent* pRenderContent =
+      tile.getContent().getRenderContent();
+  if (!pRenderContent || pRenderContent->getRenderBatch() != nullptr) {
+    return false;
+  }
+
+  return tile.computeByteSize() <= maximumTileBytes;
+}
+
+/**
+ * @brief Wraps the root nodes of the given model in a single new node that
+ * bakes in the tile's transform, relative to the batch transform, and removes
+ * everything from the model that would otherwise alter that transform.
+ *
+ * @return The index of the new node.
+ */
+int32_t bakeTileTransform(
+    Model& model,
+    const glm::dmat4x4& inverseBatchTransform,
+    const glm::dmat4x4& tileTransform) {
+  glm::dmat4x4 rootTransform =
+      GltfUtilities::applyRtcCenter(model, tileTransform);
+  rootTransform = GltfUtilities::applyGltfUpAxisTransform(model, rootTransform);
+
+  Node wrapper;
+  model.forEachRootNodeInScene(-1, [&wrapper](Model& gltf, Node& node) {
+    wrapper.children.emplace_back(
+        static_cast<int32_t>(&node - gltf.nodes.data()));
+  });
+  GltfUtilities::setNodeTransform(
+      wrapper,
+      inverseBatchTransform * rootTransform);
+
+  const int32_t wrapperIndex = static_cast<int32_t>(model.nodes.size());
+  model.nodes.emplace_back(std::move(wrapper));
+
+  model.scenes.clear();
+  model.scenes.emplace_back().nodes.emplace_back(wrapperIndex);
+  model.scene = 0;
+
+  model.removeExtension<ExtensionCesiumRTC>();
+  model.extensionsUsed.erase(
+      std::remove(
+          model.extensionsUsed.begin(),
+          model.extensionsUsed.end(),
+          ExtensionCesiumRTC::ExtensionName),
+      model.extensionsUsed.end());
+  model.extensionsRequired.erase(
+      std::remove(
+          model.extensionsRequired.begin(),
+          model.extensionsRequired.end(),
+          ExtensionCesiumRTC::ExtensionName),
+      model.extensionsRequired.end());
+
+  return wrapperIndex;
+}
+} // namespace
+
+TileRenderBatcher::TileRenderBatcher() noexcept
+    : _batches{},
+      _pendingBuilds{},
+      _buildTiles{},
+      _tileBuildCounts{},
+      _nextBuildId{0},
+      _batchesDataUsed{0} {}
+
+std::optional<TileRenderBatcher::BuildInput>
+TileRenderBatcher::beginBuild(Tile& parent, int64_t maximumTileBytes) {
+  if (this->_batches.find(&parent) != this->_batches.end() ||
+      this->_pendingBuilds.find(&parent) != this->_pendingBuilds.end()) {
+    return std::nullopt;
+  }
+
+  gsl::span<Tile> children = parent.getChildren();
+  if (children.size() < 2) {
+    return std::nullopt;
+  }
+
+  for (const Tile& child : children) {
+    if (!isBatchable(child, maximumTileBytes)) {
+      return std::nullopt;
+    }
+  }
+
+  CESIUM_TRACE("TileRenderBatcher::beginBuild");
+
+  BuildInput input{
+      &parent,
+      ++this->_nextBuildId,
+      children[0].getTransform(),
+      {},
+      {},
+      {}};
+  input.tiles.reserve(children.size());
+  input.tileTransforms.reserve(children.size());
+  input.models.reserve(children.size());
+
+  std::vector<const Tile*>& buildTiles = this->_buildTiles[input.buildId];
+  buildTiles.reserve(children.size() + 1);
+  buildTiles.emplace_back(&parent);
+
+  for (Tile& child : children) {
+    input.tiles.emplace_back(&child);
+    input.tileTransforms.emplace_back(child.getTransform());
+    buildTiles.emplace_back(&child);
+
+    // The models are copied in the worker thread. Sharing them here keeps
+    // them unchanged until then, even if the tile's content is modified.
+    TileRenderContent* pRenderContent = child.getContent().getRenderContent();
+    input.models.emplace_back(pRenderContent->shareModel());
+  }
+
+  for (const Tile* pTile : buildTiles) {
+    ++this->_tileBuildCounts[pTile];
+  }
+
+  this->_pendingBuilds[&parent] = input.buildId;
+  return input;
+}
+
+/*static*/ std::optional<TileRenderBatcher::BuildResult>
+TileRenderBatcher::mergeInWorkerThread(
+    BuildInput&& input,
+    const std::shared_ptr<spdlog::logger>& pLogger) {
+  CESIUM_TRACE("TileRenderBatcher::mergeInWorkerThread");
+
+  const glm::dmat4x4 inverseBatchTransform = glm::inverse(input.transform);
+
+  BuildResult result{
+      input.pParent,
+      input.buildId,
+      input.transform,
+      {},
+      Model(),
+      nullptr};
+  result.members.reserve(input.tiles.size());
+
+  std::vector<int32_t> memberNodes;
+  memberNodes.reserve(input.tiles.size());
+
+  for (size_t i = 0; i < input.models.size(); ++i) {
+    Model model = *input.models[i];
+    input.models[i].reset();
+
+    const int32_t wrapperIndex = bakeTileTransform(
+        model,
+        inverseBatchTransform,
+        input.tileTransforms[i]);
+
+    const int32_t nodeOffset = static_cast<int32_t>(result.model.nodes.size());
+    const int32_t meshOffset =
+        static_cast<int32_t>(result.model.meshes.size());
+    const int32_t meshCount = static_cast<int32_t>(model.meshes.size());
+
+    if (i == 0) {
+      result.model = std::move(model);
+    } else {
+      CesiumUtility::ErrorList errors = result.model.merge(std::move(model));
+      errors.logWarning(pLogger, "Warnings while merging tiles into a batch");
+      if (errors.hasErrors()) {
+        errors.logError(pLogger, "Failed to merge tiles into a batch");
+        return std::nullopt;
+      }
+    }
+
+    memberNodes.emplace_back(nodeOffset + wrapperIndex);
+    result.members.emplace_back(TileRenderBatch::Member{
+        input.tiles[i],
+        nodeOffset + wrapperIndex,
+        meshOffset,
+        meshCount});
+  }
+
+  // Each merge adds another scene, but a single scene with the member nodes
+  // is all that is needed.
+  result.model.scenes.clear();
+  result.model.scenes.emplace_back().nodes = std::move(memberNodes);
+  result.model.scene = 0;
+
+  result.model.extras.erase("Cesium3DTiles_TileUrl");
+  result.model.extras["gltfUpAxis"] =
+      static_cast<std::underlying_type_t<CesiumGeometry::Axis>>(
+          CesiumGeometry::Axis::Z);
+
+  GltfUtilities::collapseToSingleBuffer(result.model);
+
+  return result;
+}
+
+void TileRenderBatcher::finishBuild(
+    BuildResult&& result,
+    IPrepareRendererResources* pPrepareRendererResources) {
+  this->releaseBuildTiles(result.buildId);
+
+  auto pendingIt = this->_pendingBuilds.find(result.pParent);
+  if (pendingIt == this->_pendingBuilds.end() ||
+      pendingIt->second != result.buildId) {
+    // This build was invalidated while it was in progress.
+    if (pPrepareRendererResources && result.pLoadThreadResult) {
+      TileRenderBatch discarded(
+          *result.pParent,
+          std::move(result.members),
+          std::move(result.model),
+          result.transform);
+      pPrepareRendererResources
+          ->freeBatch(discarded, result.pLoadThreadResult, nullptr);
+    }
+    return;
+  }
+
+  this->_pendingBuilds.erase(pendingIt);
+
+  auto pBatch = std::make_unique<TileRenderBatch>(
+      *result.pParent,
+      std::move(result.members),
+      std::move(result.model),
+      result.transform);
+  if (pPrepareRendererResources) {
+    pBatch->setRenderResources(
+        pPrepareRendererResources->prepareBatchInMainThread(
+            *pBatch,
+            result.pLoadThreadResult));
+  }
+
+  for (const TileRenderBatch::Member& member : pBatch->getMembers()) {
+    member.pTile->getContent().getRenderContent()->setRenderBatch(pBatch.get());
+  }
+
+  this->_batchesDataUsed += pBatch->computeByteSize();
+  this->_batches[result.pParent] = std::move(pBatch);
+}
+
+void TileRenderBatcher::abandonBuild(uint64_t buildId) noexcept {
+  auto buildIt = this->_buildTiles.find(buildId);
+  if (buildIt == this->_buildTiles.end()) {
+    return;
+  }
+
+  // The first tile of a build is its parent.
+  auto pendingIt = this->_pendingBuilds.find(buildIt->second.front());
+  if (pendingIt != this->_pendingBuilds.end() &&
+      pendingIt->second == buildId) {
+    this->_pendingBuilds.erase(pendingIt);
+  }
+
+  this->releaseBuildTiles(buildId);
+}
+
+bool TileRenderBatcher::isBuilding(const Tile& tile) const noexcept {
+  return this->_tileBuildCounts.find(&tile) != this->_tileBuildCounts.end();
+}
+
+void TileRenderBatcher::invalidate(
+    const Tile& parent,
+    IPrepareRendererResources* pPrepareRendererResources) noexcept {
+  this->_pendingBuilds.erase(&parent);
+
+  auto batchIt = this->_batches.find(&parent);
+  if (batchIt == this->_batches.end()) {
+    return;
+  }
+
+  this->freeBatch(*batchIt->second, pPrepareRendererResources);
+  this->_batches.erase(batchIt);
+}
+
+void TileRenderBatcher::unloadAll(
+    IPrepareRendererResources* pPrepareRendererResources) noexcept {
+  this->_pendingBuilds.clear();
+
+  for (auto& [pParent, pBatch] : this->_batches) {
+    this->freeBatch(*pBatch, pPrepareRendererResources);
+  }
+
+  this->_batches.clear();
+}
+
+void TileRenderBatcher::selectBatches(
+    ViewUpdateResult& result,
+    int32_t frameNumber) const {
+  for (const auto& [pParent, pBatch] : this->_batches) {
+    bool allRendered = true;
+    for (const TileRenderBatch::Member& member : pBatch->getMembers()) {
+      const TileRenderContent* pRenderContent =
+          member.pTile->getContent().getRenderContent();
+      if (member.pTile->getLastSelectionState().getResult(frameNumber) !=
+              TileSelectionState::Result::Rendered ||
+          !member.pTile->getMappedRasterTiles().empty() || !pRenderContent ||
+          pRenderContent->getLodTransitionFadePercentage() < 1.0f) {
+        allRendered = false;
+        break;
+      }
+    }
+
+    if (allRendered) {
+      result.batchesToRenderThisFrame.emplace_back(pBatch.get());
+    }
+  }
+}
+
+int64_t TileRenderBatcher::getTotalDataBytes() const noexcept {
+  return this->_batchesDataUsed;
+}
+
+void TileRenderBatcher::freeBatch(
+    TileRenderBatch& batch,
+    IPrepareRendererResources* pPrepareRendererResources) noexcept {
+  for (const TileRenderBatch::Member& member : batch.getMembers()) {
+    TileRenderContent* pRenderContent =
+        member.pTile->getContent().getRenderContent();
+    if (pRenderContent && pRenderContent->getRenderBatch() == &batch) {
+      pRenderContent->setRenderBatch(nullptr);
+    }
+  }
+
+  if (pPrepareRendererResources) {
+    pPrepareRendererResources
+        ->freeBatch(batch, nullptr, batch.getRenderResources());
+  }
+  batch.setRenderResources(nullptr);
+
+  this->_batchesDataUsed -= batch.computeByteSize();
+}
+
+void TileRenderBatcher::releaseBuildTiles(uint64_t buildId) noexcept {
+  auto buildIt = this->_buildTiles.find(buildId);
+  if (buildIt == this->_buildTiles.end()) {
+    return;
+  }
+
+  for (const Tile* pTile : buildIt->second) {
+    auto countIt = this->_tileBuildCounts.find(pTile);
+    if (countIt != this->_tileBuildCounts.end() && --countIt->second == 0) {
+      this->_tileBuildCounts.erase(countIt);
+    }
+  }
+
+  this->_buildTiles.erase(buildIt);
+}
+} // namespace Cesium3DTilesSelection
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <Cesium3DTilesSelection/TileRenderBatch.h>
+#include <CesiumGltf/Model.h>
+
+#include <glm/mat4x4.hpp>
+#include <spdlog/fwd.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+class IPrepareRendererResources;
+class Tile;
+class ViewUpdateResult;
+
+/**
+ * @brief Tracks the {@link TileRenderBatch} instances of a tileset and the
+ * batches that are currently being built.
+ *
+ * A batch is keyed by the parent tile whose children it merges. Except for
+ * {@link mergeInWorkerThread}, all methods must be called from the main
+ * thread.
+ */
+class TileRenderBatcher {
+public:
+  /**
+   * @brief A snapshot of the member tiles of a batch, taken in the main thread
+   * and handed to a worker thread to be merged.
+   */
+  struct BuildInput {
+    Tile* pParent;
+    uint64_t buildId;
+    glm::dmat4x4 transform;
+    std::vector<Tile*> tiles;
+    std::vector<glm::dmat4x4> tileTransforms;
+    std::vector<std::shared_ptr<const CesiumGltf::Model>> models;
+  };
+
+  /**
+   * @brief The merged model of a batch, produced in a worker thread.
+   */
+  struct BuildResult {
+    Tile* pParent;
+    uint64_t buildId;
+    glm::dmat4x4 transform;
+    std::vector<TileRenderBatch::Member> members;
+    CesiumGltf::Model model;
+    void* pLoadThreadResult;
+  };
+
+  TileRenderBatcher() noexcept;
+
+  /**
+   * @brief Starts building a batch for the children of the given tile, if
+   * they are eligible and the tile does not already have a batch.
+   *
+   * @return The input to {@link mergeInWorkerThread}, or `std::nullopt` if no
+   * batch should be built.
+   */
+  std::optional<BuildInput>
+  beginBuild(Tile& parent, int64_t maximumTileBytes);
+
+  /**
+   * @brief Merges the models of a batch into a single model.
+   *
+   * @return The merged batch, or `std::nullopt` if the models could not be
+   * merged.
+   */
+  static std::optional<BuildResult> mergeInWorkerThread(
+      BuildInput&& input,
+      const std::shared_ptr<spdlog::logger>& pLogger);
+
+  /**
+   * @brief Completes a build started by {@link beginBuild}.
+   *
+   * If the build was invalidated in the meantime, its load thread result is
+   * freed and the batch is discarded.
+   */
+  void finishBuild(
+      BuildResult&& result,
+      IPrepareRendererResources* pPrepareRendererResources);
+
+  /**
+   * @brief Forgets a build that failed in a worker thread.
+   */
+  void abandonBuild(uint64_t buildId) noexcept;
+
+  /**
+   * @brief Determines if a build in progress refers to the given tile, either
+   * as the parent or as a member.
+   *
+   * Such a tile must not be destroyed until the build is finished or
+   * abandoned, even if the build has been invalidated.
+   */
+  bool isBuilding(const Tile& tile) const noexcept;
+
+  /**
+   * @brief Frees the batch of the given parent tile, if any, and cancels any
+   * build in progress for it.
+   */
+  void invalidate(
+      const Tile& parent,
+      IPrepareRendererResources* pPrepareRendererResources) noexcept;
+
+  /**
+   * @brief Frees all batches and cancels all builds in progress.
+   */
+  void
+  unloadAll(IPrepareRendererResources* pPrepareRendererResources) noexcept;
+
+  /**
+   * @brief Adds each batch whose members are all rendered and fully faded in
+   * during the given frame to
+   * {@link ViewUpdateResult::batchesToRenderThisFrame}.
+   */
+  void selectBatches(ViewUpdateResult& result, int32_t frameNumber) const;
+
+  /**
+   * @brief Gets the total number of bytes used by the merged models.
+   */
+  int64_t getTotalDataBytes() const noexcept;
+
+private:
+  void freeBatch(
+      TileRenderBatch& batch,
+      IPrepareRendererResources* pPrepareRendererResources) noexcept;
+  void releaseBuildTiles(uint64_t buildId) noexcept;
+
+  std::unordered_map<const Tile*, std::unique_ptr<TileRenderBatch>> _batches;
+  std::unordered_map<const Tile*, uint64_t> _pendingBuilds;
+
+  // The parent and members of each build in progress, including builds that
+  // have been invalidated, and how many of these builds refer to each tile.
+  std::unordered_map<uint64_t, std::vector<const Tile*>> _buildTiles;
+  std::unordered_map<const Tile*, int32_t> _tileBuildCounts;
+  uint64_t _nextBuildId;
+  int64_t _batchesDataUsed;
+};
+} // namespace Cesium3DTilesSelection
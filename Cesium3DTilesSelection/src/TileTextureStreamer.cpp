@@ -0,0 +1,263 @@
+#include "TileTextureStreamer.h"
+
+#include <Cesium3DTilesSelection/Tile.h>
+#include <CesiumGltfContent/ImageManipulation.h>
+#include <CesiumGltfReader/GltfReader.h>
+#include <CesiumGltfReader/SharedImageCache.h>
+#include <CesiumUtility/ErrorList.h>
+#include <CesiumUtility/Tracing.h>
+
+#include <spdlog/logger.h>
+
+#include <algorithm>
+#include <string>
+
+using namespace CesiumGltf;
+using namespace CesiumGltfContent;
+
+namespace Cesium3DTilesSelection {
+namespace {
+const std::string FullTextureSizeKey = "Cesium3DTiles_FullTextureSize";
+
+bool canBeReduced(const ImageCesium& image) noexcept {
+  return !image.getPixelData().empty() && image.mipPositions.empty() &&
+         image.compressedPixelFormat == GpuCompressedPixelFormat::NONE &&
+         image.bytesPerChannel == 1;
+}
+
+// Halves the image, like the levels of a mip chain, until it is no larger
+// than the given size. Returns std::nullopt if it already fits or cannot be
+// scaled.
+std::optional<ImageCesium>
+halveImage(const ImageCesium& source, int32_t maximumSize) {
+  int32_t width = source.width;
+  int32_t height = source.height;
+  while ((width > maximumSize || height > maximumSize) &&
+         (width > 1 || height > 1)) {
+    width = std::max(1, width / 2);
+    height = std::max(1, height / 2);
+  }
+
+  if ((width == source.width && height == source.height) ||
+      !canBeReduced(source)) {
+    return std::nullopt;
+  }
+
+  ImageCesium target;
+  target.width = width;
+  target.height = height;
+  target.channels = source.channels;
+  target.bytesPerChannel = 1;
+  target.pixelData.resize(
+      size_t(target.width) * size_t(target.height) * size_t(target.channels));
+
+  const bool blitted = ImageManipulation::blitImage(
+      target,
+      PixelRectangle{0, 0, target.width, target.height},
+      source,
+      PixelRectangle{0, 0, source.width, source.height});
+  if (!blitted) {
+    return std::nullopt;
+  }
+
+  return target;
+}
+} // namespace
+
+TileTextureStreamer::TileTextureStreamer() noexcept
+    : _entries{}, _tileUpgradeCounts{}, _nextRequestId{0} {}
+
+/*static*/ int32_t TileTextureStreamer::computeTextureSize(
+    double projectedScreenSize,
+    int32_t minimumSize) noexcept {
+  int32_t size = std::max(minimumSize, 1);
+  while (double(size) < projectedScreenSize && size < (1 << 30)) {
+    size *= 2;
+  }
+  return size;
+}
+
+void TileTextureStreamer::setRequiredSize(const Tile& tile, int32_t size) {
+  auto it = this->_entries.find(&tile);
+  if (it == this->_entries.end()) {
+    this->_entries.emplace(&tile, TextureEntry{size, std::nullopt});
+  } else {
+    it->second.requiredSize = size;
+  }
+}
+
+int32_t TileTextureStreamer::getRequiredSize(const Tile& tile) const noexcept {
+  auto it = this->_entries.find(&tile);
+  if (it == this->_entries.end()) {
+    return 0;
+  }
+  return it->second.requiredSize;
+}
+
+std::optional<
+    std::pair<uint64_t, std::vector<TileTextureStreamer::ImageUpgrade>>>
+TileTextureStreamer::beginUpgrade(const Tile& tile) {
+  auto entryIt = this->_entries.find(&tile);
+  if (entryIt == this->_entries.end() ||
+      entryIt->second.upgradeRequestId.has_value() ||
+      tile.getState() != TileLoadState::Done) {
+    return std::nullopt;
+  }
+
+  const TileRenderContent* pRenderContent =
+      tile.getContent().getRenderContent();
+  if (!pRenderContent) {
+    return std::nullopt;
+  }
+
+  const Model& model = pRenderContent->getModel();
+  std::vector<ImageUpgrade> upgrades;
+  for (size_t i = 0; i < model.images.size(); ++i) {
+    const Image& image = model.images[i];
+    auto fullSizeIt = image.extras.find(FullTextureSizeKey);
+    if (fullSizeIt == image.extras.end()) {
+      continue;
+    }
+
+    const int32_t fullSize =
+        fullSizeIt->second.getSafeNumberOrDefault<int32_t>(0);
+    const int32_t targetSize =
+        std::min(entryIt->second.requiredSize, fullSize);
+    if (std::max(image.cesium.width, image.cesium.height) >= targetSize) {
+      continue;
+    }
+
+    const BufferView* pBufferView =
+        Model::getSafe(&model.bufferViews, image.bufferView);
+    const Buffer* pBuffer =
+        pBufferView ? Model::getSafe(&model.buffers, pBufferView->buffer)
+                    : nullptr;
+    if (!pBuffer || pBufferView->byteOffset < 0 ||
+        pBufferView->byteOffset + pBufferView->byteLength >
+            int64_t(pBuffer->cesium.data.size())) {
+      continue;
+    }
+
+    auto begin = pBuffer->cesium.data.begin() + pBufferView->byteOffset;
+    upgrades.emplace_back(ImageUpgrade{
+        int32_t(i),
+        targetSize,
+        std::vector<std::byte>(begin, begin + pBufferView->byteLength)});
+  }
+
+  if (upgrades.empty()) {
+    return std::nullopt;
+  }
+
+  const uint64_t requestId = ++this->_nextRequestId;
+  entryIt->second.upgradeRequestId = requestId;
+  ++this->_tileUpgradeCounts[&tile];
+
+  return std::make_pair(requestId, std::move(upgrades));
+}
+
+bool TileTextureStreamer::finish(
+    const Tile& tile,
+    uint64_t requestId) noexcept {
+  auto countIt = this->_tileUpgradeCounts.find(&tile);
+  if (countIt != this->_tileUpgradeCounts.end() && --countIt->second == 0) {
+    this->_tileUpgradeCounts.erase(countIt);
+  }
+
+  auto entryIt = this->_entries.find(&tile);
+  if (entryIt == this->_entries.end() ||
+      entryIt->second.upgradeRequestId != requestId) {
+    return false;
+  }
+
+  if (entryIt->second.requiredSize == 0) {
+    this->_entries.erase(entryIt);
+  } else {
+    entryIt->second.upgradeRequestId.reset();
+  }
+  return true;
+}
+
+bool TileTextureStreamer::isUpgrading(const Tile& tile) const noexcept {
+  return this->_tileUpgradeCounts.find(&tile) !=
+         this->_tileUpgradeCounts.end();
+}
+
+void TileTextureStreamer::release(const Tile& tile) noexcept {
+  auto entryIt = this->_entries.find(&tile);
+  if (entryIt == this->_entries.end()) {
+    return;
+  }
+
+  if (entryIt->second.upgradeRequestId) {
+    entryIt->second.requiredSize = 0;
+  } else {
+    this->_entries.erase(entryIt);
+  }
+}
+
+void TileTextureStreamer::forget(const Tile& tile) noexcept {
+  this->_entries.erase(&tile);
+}
+
+void TileTextureStreamer::forgetAll() noexcept { this->_entries.clear(); }
+
+/*static*/ void TileTextureStreamer::reduceInWorkerThread(
+    Model& model,
+    int32_t maximumSize) {
+  CESIUM_TRACE("TileTextureStreamer::reduceInWorkerThread");
+
+  for (Image& image : model.images) {
+    if (image.bufferView < 0) {
+      continue;
+    }
+
+    std::optional<ImageCesium> maybeReduced =
+        halveImage(image.cesium, maximumSize);
+    if (!maybeReduced) {
+      continue;
+    }
+
+    image.extras[FullTextureSizeKey] =
+        std::max(image.cesium.width, image.cesium.height);
+    image.cesium = std::move(*maybeReduced);
+
+    // The reduced image is no longer the shared one.
+    image.extras.erase(CesiumGltfReader::SharedImageCache::EXTRAS_KEY);
+  }
+}
+
+/*static*/ std::vector<TileTextureStreamer::UpgradedImage>
+TileTextureStreamer::upgradeInWorkerThread(
+    std::vector<ImageUpgrade>&& upgrades,
+    const Ktx2TranscodeTargets& ktx2TranscodeTargets,
+    const std::shared_ptr<spdlog::logger>& pLogger) {
+  CESIUM_TRACE("TileTextureStreamer::upgradeInWorkerThread");
+
+  std::vector<UpgradedImage> result;
+  result.reserve(upgrades.size());
+  for (ImageUpgrade& upgrade : upgrades) {
+    CesiumGltfReader::ImageReaderResult imageResult =
+        CesiumGltfReader::GltfReader::readImage(
+            upgrade.encodedData,
+            ktx2TranscodeTargets);
+    CesiumUtility::ErrorList errors{
+        std::move(imageResult.errors),
+        std::move(imageResult.warnings)};
+    if (errors.hasErrors() || !imageResult.image) {
+      errors.logError(pLogger, "Failed to decode a texture again");
+      continue;
+    }
+
+    std::optional<ImageCesium> maybeReduced =
+        halveImage(*imageResult.image, upgrade.targetSize);
+    result.emplace_back(UpgradedImage{
+        upgrade.imageIndex,
+        maybeReduced ? std::move(*maybeReduced)
+                     : std::move(*imageResult.image),
+        nullptr});
+  }
+
+  return result;
+}
+} // namespace Cesium3DTilesSelection
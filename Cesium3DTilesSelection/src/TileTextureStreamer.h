@@ -0,0 +1,155 @@
+#pragma once
+
+#include <CesiumGltf/ImageCesium.h>
+#include <CesiumGltf/Ktx2TranscodeTargets.h>
+#include <CesiumGltf/Model.h>
+
+#include <spdlog/fwd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+class Tile;
+
+/**
+ * @brief Tracks the resolution of the textures of the tiles of a tileset, so
+ * that large textures can be loaded at a reduced resolution first and
+ * upgraded as their tiles grow on screen.
+ *
+ * Except for the static methods, all methods must be called from the main
+ * thread.
+ */
+class TileTextureStreamer {
+public:
+  /**
+   * @brief An image to decode again at a higher resolution.
+   */
+  struct ImageUpgrade {
+    int32_t imageIndex;
+    int32_t targetSize;
+    std::vector<std::byte> encodedData;
+  };
+
+  /**
+   * @brief An image decoded by {@link upgradeInWorkerThread}.
+   */
+  struct UpgradedImage {
+    int32_t imageIndex;
+    CesiumGltf::ImageCesium image;
+    void* pRenderResources;
+  };
+
+  TileTextureStreamer() noexcept;
+
+  /**
+   * @brief Computes the texture size needed by a tile that covers the given
+   * number of pixels on screen.
+   *
+   * This is the smallest power of two that is not smaller than the projected
+   * size, but at least the given minimum.
+   */
+  static int32_t
+  computeTextureSize(double projectedScreenSize, int32_t minimumSize) noexcept;
+
+  /**
+   * @brief Records the texture size that the given tile needs in the current
+   * frame.
+   */
+  void setRequiredSize(const Tile& tile, int32_t size);
+
+  /**
+   * @brief Gets the texture size that the given tile was last said to need,
+   * or 0 if nothing is known about it.
+   */
+  int32_t getRequiredSize(const Tile& tile) const noexcept;
+
+  /**
+   * @brief Starts upgrading the reduced textures of the given tile that are
+   * smaller than the tile needs, if no upgrade is in progress yet.
+   *
+   * @return The ID of the request and the images to decode, or
+   * `std::nullopt` if nothing should be upgraded.
+   */
+  std::optional<std::pair<uint64_t, std::vector<ImageUpgrade>>>
+  beginUpgrade(const Tile& tile);
+
+  /**
+   * @brief Completes an upgrade started by {@link beginUpgrade}.
+   *
+   * @return True if the request is still current and its images should be
+   * installed.
+   */
+  bool finish(const Tile& tile, uint64_t requestId) noexcept;
+
+  /**
+   * @brief Determines if an upgrade of the given tile has been started and
+   * not finished, even if the tile has been forgotten since.
+   *
+   * Such a tile must not be destroyed until the upgrade is finished, because
+   * the upgrade refers to it.
+   */
+  bool isUpgrading(const Tile& tile) const noexcept;
+
+  /**
+   * @brief Forgets the texture size that the given tile needs, typically
+   * because it is no longer rendered.
+   *
+   * If an upgrade of the tile is in progress, it is still current when it
+   * finishes, and the tile is forgotten then.
+   */
+  void release(const Tile& tile) noexcept;
+
+  /**
+   * @brief Forgets everything about the given tile, typically because its
+   * content has been unloaded.
+   */
+  void forget(const Tile& tile) noexcept;
+
+  /**
+   * @brief Forgets everything about all tiles. Upgrades in progress will no
+   * longer be current when they finish.
+   */
+  void forgetAll() noexcept;
+
+  /**
+   * @brief Halves the images embedded in a model until they are no larger
+   * than the given size.
+   *
+   * Only uncompressed images with a single mip level that are stored in a
+   * buffer view are reduced, because they are decoded again from there when
+   * they are upgraded. The full size of a reduced image is recorded in its
+   * extras.
+   */
+  static void
+  reduceInWorkerThread(CesiumGltf::Model& model, int32_t maximumSize);
+
+  /**
+   * @brief Decodes images again and halves them until they are no larger
+   * than their target size.
+   *
+   * Images that cannot be decoded are left out of the result.
+   */
+  static std::vector<UpgradedImage> upgradeInWorkerThread(
+      std::vector<ImageUpgrade>&& upgrades,
+      const CesiumGltf::Ktx2TranscodeTargets& ktx2TranscodeTargets,
+      const std::shared_ptr<spdlog::logger>& pLogger);
+
+private:
+  struct TextureEntry {
+    // The texture size the tile needs, or 0 if it was released while an
+    // upgrade was in progress.
+    int32_t requiredSize;
+    std::optional<uint64_t> upgradeRequestId;
+  };
+
+  std::unordered_map<const Tile*, TextureEntry> _entries;
+  std::unordered_map<const Tile*, int32_t> _tileUpgradeCounts;
+  uint64_t _nextRequestId;
+};
+} // namespace Cesium3DTilesSelection
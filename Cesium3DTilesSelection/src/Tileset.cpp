@@ -1,3 +1,5 @@
+#include "MultiViewCuller.h"
+#include "TileTextureStreamer.h"
 #include "TileUtilities.h"
 #include "TilesetContentManager.h"
 
@@ -8,6 +10,8 @@
 #include <Cesium3DTilesSelection/TilesetMetadata.h>
 #include <Cesium3DTilesSelection/spdlog-cesium.h>
 #include <CesiumAsync/AsyncSystem.h>
+#include <CesiumAsync/Promise.h>
+#include <CesiumGeometry/OrientedBoundingBox.h>
 #include <CesiumGeospatial/Cartographic.h>
 #include <CesiumGeospatial/GlobeRectangle.h>
 #include <CesiumRasterOverlays/RasterOverlayTile.h>
@@ -23,8 +27,11 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <exception>
 #include <limits>
+#include <memory>
 #include <unordered_set>
+#include <utility>
 
 using namespace CesiumAsync;
 using namespace CesiumGeometry;
@@ -43,8 +50,20 @@ Tileset::Tileset(
       _asyncSystem(externals.asyncSystem),
       _options(options),
       _previousFrameNumber(0),
-      _distances(),
-      _childOcclusionProxies(),
+      _selectionAllocations(0),
+      _mainThreadLoadQueue(
+          CountingAllocator<TileLoadTask>(&_selectionAllocations)),
+      _workerThreadLoadQueue(
+          CountingAllocator<TileLoadTask>(&_selectionAllocations)),
+      _distances(CountingAllocator<double>(&_selectionAllocations)),
+      _childOcclusionProxies(
+          CountingAllocator<const TileOcclusionRendererProxy*>(
+              &_selectionAllocations)),
+      _fogDensities(CountingAllocator<double>(&_selectionAllocations)),
+      _pCuller(std::make_unique<MultiViewCuller>(&_selectionAllocations)),
+      _visibility(CountingAllocator<uint8_t>(&_selectionAllocations)),
+      _pruningCandidates(CountingAllocator<std::pair<uint32_t, Tile*>>(
+          &_selectionAllocations)),
       _pTilesetContentManager{new TilesetContentManager(
           _externals,
           _options,
@@ -61,8 +80,20 @@ Tileset::Tileset(
       _asyncSystem(externals.asyncSystem),
       _options(options),
       _previousFrameNumber(0),
-      _distances(),
-      _childOcclusionProxies(),
+      _selectionAllocations(0),
+      _mainThreadLoadQueue(
+          CountingAllocator<TileLoadTask>(&_selectionAllocations)),
+      _workerThreadLoadQueue(
+          CountingAllocator<TileLoadTask>(&_selectionAllocations)),
+      _distances(CountingAllocator<double>(&_selectionAllocations)),
+      _childOcclusionProxies(
+          CountingAllocator<const TileOcclusionRendererProxy*>(
+              &_selectionAllocations)),
+      _fogDensities(CountingAllocator<double>(&_selectionAllocations)),
+      _pCuller(std::make_unique<MultiViewCuller>(&_selectionAllocations)),
+      _visibility(CountingAllocator<uint8_t>(&_selectionAllocations)),
+      _pruningCandidates(CountingAllocator<std::pair<uint32_t, Tile*>>(
+          &_selectionAllocations)),
       _pTilesetContentManager{new TilesetContentManager(
           _externals,
           _options,
@@ -79,8 +110,20 @@ Tileset::Tileset(
       _asyncSystem(externals.asyncSystem),
       _options(options),
       _previousFrameNumber(0),
-      _distances(),
-      _childOcclusionProxies(),
+      _selectionAllocations(0),
+      _mainThreadLoadQueue(
+          CountingAllocator<TileLoadTask>(&_selectionAllocations)),
+      _workerThreadLoadQueue(
+          CountingAllocator<TileLoadTask>(&_selectionAllocations)),
+      _distances(CountingAllocator<double>(&_selectionAllocations)),
+      _childOcclusionProxies(
+          CountingAllocator<const TileOcclusionRendererProxy*>(
+              &_selectionAllocations)),
+      _fogDensities(CountingAllocator<double>(&_selectionAllocations)),
+      _pCuller(std::make_unique<MultiViewCuller>(&_selectionAllocations)),
+      _visibility(CountingAllocator<uint8_t>(&_selectionAllocations)),
+      _pruningCandidates(CountingAllocator<std::pair<uint32_t, Tile*>>(
+          &_selectionAllocations)),
       _pTilesetContentManager{new TilesetContentManager(
           _externals,
           _options,
@@ -183,6 +226,85 @@ static double computeFogDensity(
   return density;
 }
 
+/**
+ * @brief Returns whether the camera is above or below a tile with the given
+ * bounding volume.
+ *
+ * This is used to render tiles under the camera even if they are outside of
+ * its frustum (see {@link TilesetOptions::renderTilesUnderCamera}).
+ *
+ * @param viewState The {@link ViewState}
+ * @param boundingVolume The bounding volume of the tile
+ * @param ellipsoid The ellipsoid of the tileset
+ * @return Whether the tile is under the camera
+ */
+static bool isUnderCamera(
+    const ViewState& viewState,
+    const BoundingVolume& boundingVolume,
+    const Ellipsoid& ellipsoid) {
+  const std::optional<CesiumGeospatial::Cartographic>& position =
+      viewState.getPositionCartographic();
+
+  // TODO: it would be better to test a line pointing down (and up?) from the
+  // camera against the bounding volume itself, rather than transforming the
+  // bounding volume to a region.
+  std::optional<GlobeRectangle> maybeRectangle =
+      estimateGlobeRectangle(boundingVolume, ellipsoid);
+  if (position && maybeRectangle) {
+    return maybeRectangle->contains(position.value());
+  }
+  return false;
+}
+
+/**
+ * @brief Sorts the tiles to render into the lists of the cameras that see
+ * them, for {@link TilesetOptions::enablePerViewRenderLists}.
+ */
+static void computeTilesToRenderPerView(
+    const std::vector<ViewState>& frustums,
+    const MultiViewCuller& culler,
+    const Ellipsoid& ellipsoid,
+    bool forceRenderTilesUnderCamera,
+    CountingVector<uint8_t>& visibility,
+    ViewUpdateResult& result) {
+  result.tilesToRenderPerView.resize(frustums.size());
+  for (std::vector<Tile*>& tilesToRender : result.tilesToRenderPerView) {
+    tilesToRender.clear();
+  }
+
+  for (Tile* pTile : result.tilesToRenderThisFrame) {
+    const BoundingVolume& boundingVolume = pTile->getBoundingVolume();
+    culler.computeVisibility(boundingVolume, visibility);
+    for (size_t i = 0; i < frustums.size(); ++i) {
+      if (visibility[i] ||
+          (forceRenderTilesUnderCamera &&
+           isUnderCamera(frustums[i], boundingVolume, ellipsoid))) {
+        result.tilesToRenderPerView[i].push_back(pTile);
+      }
+    }
+  }
+}
+
+void Tileset::_updateTilesToShowAndHide(ViewUpdateResult& result) {
+  this->_tilesRenderedThisFrame.clear();
+  this->_tilesRenderedThisFrame.reserve(result.tilesToRenderThisFrame.size());
+
+  for (Tile* pTile : result.tilesToRenderThisFrame) {
+    if (this->_tilesRenderedThisFrame.insert(pTile).second &&
+        !this->_tilesRenderedLastFrame.contains(pTile)) {
+      result.tilesToShowThisFrame.push_back(pTile);
+    }
+  }
+
+  for (Tile* pTile : this->_tilesRenderedLastFrame) {
+    if (!this->_tilesRenderedThisFrame.contains(pTile)) {
+      result.tilesToHideThisFrame.push_back(pTile);
+    }
+  }
+
+  std::swap(this->_tilesRenderedLastFrame, this->_tilesRenderedThisFrame);
+}
+
 void Tileset::_updateLodTransitions(
     const FrameState& frameState,
     float deltaTime,
@@ -294,8 +416,121 @@ Tileset::updateViewOffline(const std::vector<ViewState>& frustums) {
   return this->_updateResult;
 }
 
+struct Tileset::OfflineViewSets {
+  std::vector<std::vector<ViewState>> viewSets;
+  std::vector<ViewUpdateResult> results;
+
+  // The tiles that each set of views queued for loading in its last
+  // traversal. A set is only traversed again once one of them is no longer
+  // loading, and is finished when it queues no tiles.
+  std::vector<std::vector<Tile*>> tilesToLoad;
+
+  Promise<std::vector<ViewUpdateResult>> promise;
+};
+
+Future<std::vector<ViewUpdateResult>>
+Tileset::updateViewSetsOffline(std::vector<std::vector<ViewState>> viewSets) {
+  Promise<std::vector<ViewUpdateResult>> promise =
+      this->_asyncSystem.createPromise<std::vector<ViewUpdateResult>>();
+  Future<std::vector<ViewUpdateResult>> future = promise.getFuture();
+
+  const size_t viewSetCount = viewSets.size();
+  std::shared_ptr<OfflineViewSets> pState =
+      std::make_shared<OfflineViewSets>(OfflineViewSets{
+          std::move(viewSets),
+          std::vector<ViewUpdateResult>(viewSetCount),
+          std::vector<std::vector<Tile*>>(viewSetCount),
+          std::move(promise)});
+  this->_updateViewSetsOfflineAfter(
+      this->getRootTileAvailableEvent().thenImmediately([]() {}),
+      pState,
+      true);
+
+  return future;
+}
+
+void Tileset::_updateViewSetsOffline(
+    const std::shared_ptr<OfflineViewSets>& pState,
+    bool traverseAll) {
+  this->_externals.pAssetAccessor->tick();
+
+  bool finished = true;
+  bool mainThreadQueuesEmpty = true;
+  for (size_t i = 0; i < pState->viewSets.size(); ++i) {
+    std::vector<Tile*>& tilesToLoad = pState->tilesToLoad[i];
+    const bool needsTraversal =
+        traverseAll ||
+        std::any_of(tilesToLoad.begin(), tilesToLoad.end(), [](Tile* pTile) {
+          return pTile->getState() != TileLoadState::ContentLoading;
+        });
+    if (needsTraversal) {
+      const ViewUpdateResult& result =
+          this->_updateView(pState->viewSets[i], 0.0f, false);
+      mainThreadQueuesEmpty =
+          mainThreadQueuesEmpty && result.mainThreadTileLoadQueueLength == 0;
+
+      ViewUpdateResult& viewSetResult = pState->results[i];
+      viewSetResult = result;
+      viewSetResult.tilesFadingOut.clear();
+
+      tilesToLoad.clear();
+      for (const TileLoadTask& task : this->_workerThreadLoadQueue) {
+        tilesToLoad.emplace_back(task.pTile);
+      }
+      for (const TileLoadTask& task : this->_mainThreadLoadQueue) {
+        tilesToLoad.emplace_back(task.pTile);
+      }
+    }
+
+    finished = finished && tilesToLoad.empty();
+  }
+
+  if (finished) {
+    pState->promise.resolve(std::move(pState->results));
+    return;
+  }
+
+  // Tiles left in a main thread queue did not fit in the time limit or are
+  // waiting for raster overlays, so traverse all sets again soon. Otherwise,
+  // nothing changes until a tile finishes loading.
+  if (!mainThreadQueuesEmpty) {
+    this->_updateViewSetsOfflineAfter(
+        this->_asyncSystem.createResolvedFuture(),
+        pState,
+        true);
+  } else {
+    this->_updateViewSetsOfflineAfter(
+        this->_pTilesetContentManager->waitForNextTileLoad(),
+        pState,
+        false);
+  }
+}
+
+void Tileset::_updateViewSetsOfflineAfter(
+    Future<void>&& future,
+    const std::shared_ptr<OfflineViewSets>& pState,
+    bool traverseAll) {
+  // Tiles finish loading in main thread continuations, which would otherwise
+  // continue right away inside of them, so continue from a worker thread.
+  std::move(future)
+      .thenInWorkerThread([]() {})
+      .thenInMainThread([this, pState, traverseAll]() {
+        this->_updateViewSetsOffline(pState, traverseAll);
+      })
+      .catchInMainThread([pState](std::exception&& e) {
+        pState->promise.reject(std::move(e));
+      });
+}
+
 const ViewUpdateResult&
 Tileset::updateView(const std::vector<ViewState>& frustums, float deltaTime) {
+  return this->_updateView(frustums, deltaTime, true);
+}
+
+const ViewUpdateResult& Tileset::_updateView(
+    const std::vector<ViewState>& frustums,
+    float deltaTime,
+    bool unloadTiles) {
   CESIUM_TRACE("Tileset::updateView");
   // Fixup TilesetOptions to ensure lod transitions works correctly.
   _options.enableFrustumCulling =
@@ -318,6 +553,10 @@ Tileset::updateView(const std::vector<ViewState>& frustums, float deltaTime) {
   result.tilesWaitingForOcclusionResults = 0;
   result.tilesKicked = 0;
   result.maxDepthVisited = 0;
+  result.selectionAllocations = 0;
+  result.tilesToShowThisFrame.clear();
+  result.tilesToHideThisFrame.clear();
+  this->_selectionAllocations = 0;
 
   if (!_options.enableLodTransitionPeriod) {
     result.tilesFadingOut.clear();
@@ -336,7 +575,8 @@ Tileset::updateView(const std::vector<ViewState>& frustums, float deltaTime) {
   this->_workerThreadLoadQueue.clear();
   this->_mainThreadLoadQueue.clear();
 
-  std::vector<double> fogDensities(frustums.size());
+  CountingVector<double>& fogDensities = this->_fogDensities;
+  fogDensities.resize(frustums.size());
   std::transform(
       frustums.begin(),
       frustums.end(),
@@ -346,9 +586,12 @@ Tileset::updateView(const std::vector<ViewState>& frustums, float deltaTime) {
         return computeFogDensity(fogDensityTable, frustum);
       });
 
+  MultiViewCuller& culler = *this->_pCuller;
+  culler.setViews(frustums);
   FrameState frameState{
       frustums,
-      std::move(fogDensities),
+      culler,
+      fogDensities,
       previousFrameNumber,
       currentFrameNumber};
 
@@ -369,11 +612,40 @@ Tileset::updateView(const std::vector<ViewState>& frustums, float deltaTime) {
     pOcclusionPool->pruneOcclusionProxyMappings();
   }
 
-  this->_unloadCachedTiles(this->_options.tileCacheUnloadTimeLimit);
-  this->_processWorkerThreadLoadQueue();
+  this->_updateTilesToShowAndHide(result);
+  if (this->_options.enableProgressiveTextures) {
+    this->_updateTextureResolutions(frustums, result);
+  }
+
+  if (unloadTiles) {
+    this->_unloadCachedTiles(this->_options.tileCacheUnloadTimeLimit);
+    if (this->_options.enableSubtreePruning) {
+      this->_pruneUnusedSubtrees(currentFrameNumber);
+    }
+  }
+  this->_processWorkerThreadLoadQueue(frustums);
   this->_processMainThreadLoadQueue();
   this->_updateLodTransitions(frameState, deltaTime, result);
 
+  if (this->_options.enablePerViewRenderLists) {
+    computeTilesToRenderPerView(
+        frustums,
+        culler,
+        this->getEllipsoid(),
+        this->_options.renderTilesUnderCamera,
+        this->_visibility,
+        result);
+  } else {
+    result.tilesToRenderPerView.clear();
+  }
+
+  result.batchesToRenderThisFrame.clear();
+  if (this->_options.enableTileBatching) {
+    this->_pTilesetContentManager->selectRenderBatches(
+        result,
+        currentFrameNumber);
+  }
+
   // aggregate all the credits needed from this tileset for the current frame
   const std::shared_ptr<CreditSystem>& pCreditSystem =
       this->_externals.pCreditSystem;
@@ -427,6 +699,12 @@ Tileset::updateView(const std::vector<ViewState>& frustums, float deltaTime) {
 
   this->_previousFrameNumber = currentFrameNumber;
 
+  // The culler is kept for the next frame, but the views are the caller's.
+  culler.clearViews();
+
+  result.selectionAllocations =
+      static_cast<uint32_t>(this->_selectionAllocations);
+
   return result;
 }
 int32_t Tileset::getNumberOfTilesLoaded() const {
@@ -585,40 +863,37 @@ static void markTileAndChildrenNonRendered(
 
 /**
  * @brief Returns whether a tile with the given bounding volume is visible for
- * the camera.
+ * at least one of the cameras of the frame.
  *
- * @param viewState The {@link ViewState}
+ * @param frustums The cameras
+ * @param culler The culler for the cameras
  * @param boundingVolume The bounding volume of the tile
+ * @param ellipsoid The ellipsoid of the tileset
  * @param forceRenderTilesUnderCamera Whether tiles under the camera should
  * always be considered visible and rendered (see
  * {@link Cesium3DTilesSelection::TilesetOptions}).
  * @return Whether the tile is visible according to the current camera
  * configuration
  */
-static bool isVisibleFromCamera(
-    const ViewState& viewState,
+static bool isVisibleFromAnyCamera(
+    const std::vector<ViewState>& frustums,
+    const MultiViewCuller& culler,
     const BoundingVolume& boundingVolume,
     const Ellipsoid& ellipsoid,
     bool forceRenderTilesUnderCamera) {
-  if (viewState.isBoundingVolumeVisible(boundingVolume)) {
+  if (culler.isVisibleInAnyView(boundingVolume)) {
     return true;
   }
   if (!forceRenderTilesUnderCamera) {
     return false;
   }
 
-  const std::optional<CesiumGeospatial::Cartographic>& position =
-      viewState.getPositionCartographic();
-
-  // TODO: it would be better to test a line pointing down (and up?) from the
-  // camera against the bounding volume itself, rather than transforming the
-  // bounding volume to a region.
-  std::optional<GlobeRectangle> maybeRectangle =
-      estimateGlobeRectangle(boundingVolume, ellipsoid);
-  if (position && maybeRectangle) {
-    return maybeRectangle->contains(position.value());
-  }
-  return false;
+  return std::any_of(
+      frustums.begin(),
+      frustums.end(),
+      [&boundingVolume, &ellipsoid](const ViewState& frustum) {
+        return isUnderCamera(frustum, boundingVolume, ellipsoid);
+      });
 }
 
 /**
@@ -648,47 +923,29 @@ void Tileset::_frustumCull(
   }
 
   const CesiumGeospatial::Ellipsoid& ellipsoid = this->getEllipsoid();
+  const bool renderTilesUnderCamera = this->_options.renderTilesUnderCamera;
 
-  const std::vector<ViewState>& frustums = frameState.frustums;
   // Frustum cull using the children's bounds.
   if (cullWithChildrenBounds) {
-    if (std::any_of(
-            frustums.begin(),
-            frustums.end(),
-            [&ellipsoid,
-             children = tile.getChildren(),
-             renderTilesUnderCamera = this->_options.renderTilesUnderCamera](
-                const ViewState& frustum) {
-              for (const Tile& child : children) {
-                if (isVisibleFromCamera(
-                        frustum,
-                        child.getBoundingVolume(),
-                        ellipsoid,
-                        renderTilesUnderCamera)) {
-                  return true;
-                }
-              }
-
-              return false;
-            })) {
-      // At least one child is visible in at least one frustum, so don't cull.
-      return;
+    for (const Tile& child : tile.getChildren()) {
+      if (isVisibleFromAnyCamera(
+              frameState.frustums,
+              frameState.culler,
+              child.getBoundingVolume(),
+              ellipsoid,
+              renderTilesUnderCamera)) {
+        // At least one child is visible in at least one frustum, so don't
+        // cull.
+        return;
+      }
     }
     // Frustum cull based on the actual tile's bounds.
-  } else if (std::any_of(
-                 frustums.begin(),
-                 frustums.end(),
-                 [&ellipsoid,
-                  &boundingVolume = tile.getBoundingVolume(),
-                  renderTilesUnderCamera =
-                      this->_options.renderTilesUnderCamera](
-                     const ViewState& frustum) {
-                   return isVisibleFromCamera(
-                       frustum,
-                       boundingVolume,
-                       ellipsoid,
-                       renderTilesUnderCamera);
-                 })) {
+  } else if (isVisibleFromAnyCamera(
+                 frameState.frustums,
+                 frameState.culler,
+                 tile.getBoundingVolume(),
+                 ellipsoid,
+                 renderTilesUnderCamera)) {
     // The tile is visible in at least one frustum, so don't cull.
     return;
   }
@@ -704,7 +961,7 @@ void Tileset::_frustumCull(
 
 void Tileset::_fogCull(
     const FrameState& frameState,
-    const std::vector<double>& distances,
+    const CountingVector<double>& distances,
     CullResult& cullResult) {
 
   if (!cullResult.shouldVisit || cullResult.culled) {
@@ -712,7 +969,7 @@ void Tileset::_fogCull(
   }
 
   const std::vector<ViewState>& frustums = frameState.frustums;
-  const std::vector<double>& fogDensities = frameState.fogDensities;
+  const CountingVector<double>& fogDensities = frameState.fogDensities;
 
   bool isFogCulled = true;
 
@@ -739,7 +996,7 @@ void Tileset::_fogCull(
 static double computeTilePriority(
     const Tile& tile,
     const std::vector<ViewState>& frustums,
-    const std::vector<double>& distances) {
+    const CountingVector<double>& distances) {
   double highestLoadPriority = std::numeric_limits<double>::max();
   const glm::dvec3 boundingVolumeCenter =
       getBoundingVolumeCenter(tile.getBoundingVolume());
@@ -764,10 +1021,33 @@ static double computeTilePriority(
   return highestLoadPriority;
 }
 
+// Estimates how many pixels the largest extent of a tile covers, in the view
+// in which it appears largest.
+static double computeProjectedScreenSize(
+    const Tile& tile,
+    const std::vector<ViewState>& frustums,
+    const CountingVector<double>& distances,
+    const Ellipsoid& ellipsoid) {
+  const OrientedBoundingBox box = getOrientedBoundingBoxFromBoundingVolume(
+      tile.getBoundingVolume(),
+      ellipsoid);
+  const glm::dvec3& lengths = box.getLengths();
+  const double extent = glm::max(lengths.x, glm::max(lengths.y, lengths.z));
+
+  double largestSize = 0.0;
+  for (size_t i = 0; i < frustums.size() && i < distances.size(); ++i) {
+    largestSize = glm::max(
+        largestSize,
+        frustums[i].computeScreenSpaceError(extent, distances[i]));
+  }
+
+  return largestSize;
+}
+
 void computeDistances(
     const Tile& tile,
     const std::vector<ViewState>& frustums,
-    std::vector<double>& distances) {
+    CountingVector<double>& distances) {
   const BoundingVolume& boundingVolume = tile.getBoundingVolume();
 
   distances.clear();
@@ -777,17 +1057,46 @@ void computeDistances(
       frustums.begin(),
       frustums.end(),
       distances.begin(),
-      [boundingVolume](const ViewState& frustum) -> double {
+      [&boundingVolume](const ViewState& frustum) -> double {
         return glm::sqrt(glm::max(
             frustum.computeDistanceSquaredToBoundingVolume(boundingVolume),
             0.0));
       });
 }
 
+void Tileset::_updateTextureResolutions(
+    const std::vector<ViewState>& frustums,
+    const ViewUpdateResult& result) {
+  // Only the rendered tiles with render content are tracked. After
+  // _updateTilesToShowAndHide, _tilesRenderedLastFrame holds the tiles
+  // rendered in this frame.
+  for (Tile* pTile : result.tilesToHideThisFrame) {
+    this->_pTilesetContentManager->forgetTextureResolution(*pTile);
+  }
+
+  CountingVector<double>& distances = this->_distances;
+  for (Tile* pTile : this->_tilesRenderedLastFrame) {
+    if (pTile->getState() != TileLoadState::Done ||
+        !pTile->getContent().isRenderContent()) {
+      continue;
+    }
+
+    computeDistances(*pTile, frustums, distances);
+    this->_pTilesetContentManager->updateTextureResolution(
+        *pTile,
+        computeProjectedScreenSize(
+            *pTile,
+            frustums,
+            distances,
+            this->_options.ellipsoid),
+        this->_options);
+  }
+}
+
 bool Tileset::_meetsSse(
     const std::vector<ViewState>& frustums,
     const Tile& tile,
-    const std::vector<double>& distances,
+    const CountingVector<double>& distances,
     bool culled) const noexcept {
 
   double largestSse = 0.0;
@@ -822,7 +1131,7 @@ Tileset::TraversalDetails Tileset::_visitTileIfNeeded(
     Tile& tile,
     ViewUpdateResult& result) {
 
-  std::vector<double>& distances = this->_distances;
+  CountingVector<double>& distances = this->_distances;
   computeDistances(tile, frameState.frustums, distances);
   double tilePriority =
       computeTilePriority(tile, frameState.frustums, distances);
@@ -1078,13 +1387,11 @@ bool Tileset::_kickDescendantsAndRenderTile(
         _workerThreadLoadQueue.size() + _mainThreadLoadQueue.size();
     this->_workerThreadLoadQueue.erase(
         this->_workerThreadLoadQueue.begin() +
-            static_cast<std::vector<TileLoadTask>::iterator::difference_type>(
-                workerThreadLoadQueueIndex),
+            static_cast<std::ptrdiff_t>(workerThreadLoadQueueIndex),
         this->_workerThreadLoadQueue.end());
     this->_mainThreadLoadQueue.erase(
         this->_mainThreadLoadQueue.begin() +
-            static_cast<std::vector<TileLoadTask>::iterator::difference_type>(
-                mainThreadLoadQueueIndex),
+            static_cast<std::ptrdiff_t>(mainThreadLoadQueueIndex),
         this->_mainThreadLoadQueue.end());
     size_t allQueueEndSize =
         _workerThreadLoadQueue.size() + _mainThreadLoadQueue.size();
@@ -1416,7 +1723,8 @@ Tileset::TraversalDetails Tileset::_visitVisibleChildrenNearToFar(
   return traversalDetails;
 }
 
-void Tileset::_processWorkerThreadLoadQueue() {
+void Tileset::_processWorkerThreadLoadQueue(
+    const std::vector<ViewState>& frustums) {
   CESIUM_TRACE("Tileset::_processWorkerThreadLoadQueue");
 
   int32_t maximumSimultaneousTileLoads =
@@ -1427,11 +1735,29 @@ void Tileset::_processWorkerThreadLoadQueue() {
     return;
   }
 
-  std::vector<TileLoadTask>& queue = this->_workerThreadLoadQueue;
+  CountingVector<TileLoadTask>& queue = this->_workerThreadLoadQueue;
   std::sort(queue.begin(), queue.end());
 
   for (TileLoadTask& task : queue) {
-    this->_pTilesetContentManager->loadTileContent(*task.pTile, _options);
+    // Reduce the textures of the tile to the size it covers on screen now,
+    // rather than to the minimum, so that they do not need to be upgraded as
+    // soon as the tile is loaded.
+    int32_t textureSize = 0;
+    if (this->_options.enableProgressiveTextures) {
+      computeDistances(*task.pTile, frustums, this->_distances);
+      textureSize = TileTextureStreamer::computeTextureSize(
+          computeProjectedScreenSize(
+              *task.pTile,
+              frustums,
+              this->_distances,
+              this->_options.ellipsoid),
+          this->_options.minimumProgressiveTextureSize);
+    }
+
+    this->_pTilesetContentManager->loadTileContent(
+        *task.pTile,
+        _options,
+        textureSize);
     if (this->_pTilesetContentManager->getNumberOfTilesLoading() >=
         maximumSimultaneousTileLoads) {
       break;
@@ -1492,8 +1818,7 @@ void Tileset::_unloadCachedTiles(double timeBudget) noexcept {
     }
 
     // Don't unload this tile if it is still fading out.
-    if (_updateResult.tilesFadingOut.find(pTile) !=
-        _updateResult.tilesFadingOut.end()) {
+    if (_updateResult.tilesFadingOut.contains(pTile)) {
       pTile = this->_loadedTiles.next(*pTile);
       continue;
     }
@@ -1515,6 +1840,85 @@ void Tileset::_unloadCachedTiles(double timeBudget) noexcept {
   }
 }
 
+static uint32_t computeDepth(const Tile& tile) noexcept {
+  uint32_t depth = 0;
+  for (const Tile* pParent = tile.getParent(); pParent;
+       pParent = pParent->getParent()) {
+    ++depth;
+  }
+  return depth;
+}
+
+void Tileset::_pruneUnusedSubtrees(int32_t currentFrameNumber) {
+  // Tiles rendered in the previous frame may still be reported in
+  // ViewUpdateResult::tilesToHideThisFrame, so they are never pruned.
+  const int32_t lastUnusedFrameNumber =
+      currentFrameNumber - 1 - std::max(this->_options.subtreePruningFrames, 1);
+
+  // The least recently visited tiles are at the head of the list. Their
+  // parents are the candidates for losing their children.
+  CountingVector<std::pair<uint32_t, Tile*>>& candidates =
+      this->_pruningCandidates;
+  candidates.clear();
+  const Tile* pRootTile = this->_pTilesetContentManager->getRootTile();
+  for (Tile* pTile = this->_loadedTiles.head(); pTile != nullptr;
+       pTile = this->_loadedTiles.next(*pTile)) {
+    if (pTile->getLastSelectionState().getFrameNumber() >
+        lastUnusedFrameNumber) {
+      break;
+    }
+
+    // The root tile has no parent to lose it, but the tiles after it in the
+    // list may.
+    if (pTile == pRootTile) {
+      continue;
+    }
+
+    Tile* pParent = pTile->getParent();
+    if (pParent &&
+        (candidates.empty() || candidates.back().second != pParent)) {
+      candidates.emplace_back(computeDepth(*pParent), pParent);
+    }
+  }
+
+  // Prune the deepest candidates first, so that no candidate is destroyed
+  // before it is considered.
+  std::sort(candidates.rbegin(), candidates.rend());
+  candidates.erase(
+      std::unique(candidates.begin(), candidates.end()),
+      candidates.end());
+
+  for (const std::pair<uint32_t, Tile*>& candidate : candidates) {
+    Tile& parent = *candidate.second;
+    if (this->_pTilesetContentManager->canPruneTileChildren(parent) &&
+        this->_canPruneDescendants(parent, lastUnusedFrameNumber)) {
+      this->_removeDescendantsFromLoadedTiles(parent);
+      this->_pTilesetContentManager->pruneTileChildren(parent);
+    }
+  }
+}
+
+bool Tileset::_canPruneDescendants(Tile& tile, int32_t lastUnusedFrameNumber) {
+  for (Tile& child : tile.getChildren()) {
+    if (child.getLastSelectionState().getFrameNumber() >
+            lastUnusedFrameNumber ||
+        this->_updateResult.tilesFadingOut.contains(&child) ||
+        !this->_pTilesetContentManager->canPruneTile(child) ||
+        !this->_canPruneDescendants(child, lastUnusedFrameNumber)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void Tileset::_removeDescendantsFromLoadedTiles(Tile& tile) noexcept {
+  for (Tile& child : tile.getChildren()) {
+    this->_loadedTiles.remove(child);
+    this->_removeDescendantsFromLoadedTiles(child);
+  }
+}
+
 void Tileset::_markTileVisited(Tile& tile) noexcept {
   this->_loadedTiles.insertAtTail(tile);
 }
@@ -18,6 +18,13 @@ TileLoadInput::TileLoadInput(
       requestHeaders{requestHeaders_},
       ellipsoid(ellipsoid_) {}
 
+std::string
+TilesetContentLoader::getTileContentKey(const Tile& /*tile*/) const {
+  return std::string();
+}
+
+void TilesetContentLoader::releaseTileChildren(const Tile& /*tile*/) {}
+
 TileLoadResult TileLoadResult::createFailedResult(
     std::shared_ptr<CesiumAsync::IAssetRequest> pCompletedRequest) {
   return TileLoadResult{
@@ -6,6 +6,7 @@
 #include <CesiumUtility/ErrorList.h>
 
 #include <memory>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -55,7 +56,8 @@ template <class TilesetContentLoaderType> struct TilesetContentLoaderResult {
         pRootTile{std::move(rhs.pRootTile)},
         credits{std::move(rhs.credits)},
         requestHeaders{std::move(rhs.requestHeaders)},
-        errors{std::move(rhs.errors)} {}
+        errors{std::move(rhs.errors)},
+        tilesetVersion{std::move(rhs.tilesetVersion)} {}
 
   template <
       class OtherLoaderType,
@@ -73,6 +75,7 @@ template <class TilesetContentLoaderType> struct TilesetContentLoaderResult {
     swap(this->credits, rhs.credits);
     swap(this->requestHeaders, rhs.requestHeaders);
     swap(this->errors, rhs.errors);
+    swap(this->tilesetVersion, rhs.tilesetVersion);
 
     return *this;
   }
@@ -88,5 +91,9 @@ template <class TilesetContentLoaderType> struct TilesetContentLoaderResult {
   CesiumUtility::ErrorList errors;
 
   uint16_t statusCode{200};
+
+  // Identifies the version of the tileset.json, if the tileset has one, so
+  // that data derived from it can be cached.
+  std::string tilesetVersion;
 };
 } // namespace Cesium3DTilesSelection
@@ -3,11 +3,15 @@
 #include "CesiumIonTilesetLoader.h"
 #include "LayerJsonTerrainLoader.h"
 #include "TileContentLoadInfo.h"
+#include "TileHierarchySnapshot.h"
+#include "TileTextureStreamer.h"
 #include "TilesetJsonLoader.h"
 
 #include <Cesium3DTilesSelection/IPrepareRendererResources.h>
+#include <Cesium3DTilesSelection/TileContentRegistry.h>
 #include <CesiumAsync/IAssetRequest.h>
 #include <CesiumAsync/IAssetResponse.h>
+#include <CesiumAsync/ICacheDatabase.h>
 #include <CesiumGltfContent/GltfUtilities.h>
 #include <CesiumGltfReader/GltfReader.h>
 #include <CesiumRasterOverlays/RasterOverlay.h>
@@ -20,7 +24,11 @@
 #include <rapidjson/document.h>
 #include <spdlog/logger.h>
 
+#include <algorithm>
 #include <chrono>
+#include <ctime>
+#include <string>
+#include <utility>
 
 using namespace CesiumGltfContent;
 using namespace CesiumRasterOverlays;
@@ -33,6 +41,18 @@ struct RegionAndCenter {
   CesiumGeospatial::Cartographic center;
 };
 
+void storeImageSizes(CesiumGltf::Model& model) {
+  for (CesiumGltf::Image& image : model.images) {
+    // If the image size hasn't been overridden, store the pixelData
+    // size now. We'll be adding this number to our total memory usage soon,
+    // and remove it when the tile is later unloaded, and we must use
+    // the same size in each case.
+    if (image.cesium.sizeBytes < 0) {
+      image.cesium.sizeBytes = int64_t(image.cesium.getPixelData().size());
+    }
+  }
+}
+
 struct ContentKindSetter {
   void operator()(TileUnknownContent content) {
     tileContent.setContentKind(content);
@@ -48,17 +68,16 @@ struct ContentKindSetter {
   }
 
   void operator()(CesiumGltf::Model&& model) {
-    for (CesiumGltf::Image& image : model.images) {
-      // If the image size hasn't been overridden, store the pixelData
-      // size now. We'll be adding this number to our total memory usage soon,
-      // and remove it when the tile is later unloaded, and we must use
-      // the same size in each case.
-      if (image.cesium.sizeBytes < 0) {
-        image.cesium.sizeBytes = int64_t(image.cesium.pixelData.size());
-      }
+    std::unique_ptr<TileRenderContent> pRenderContent;
+    if (pSharedModel) {
+      // The shared model replaces the renderer's copy of it.
+      pRenderContent =
+          std::make_unique<TileRenderContent>(std::move(pSharedModel));
+    } else {
+      storeImageSizes(model);
+      pRenderContent = std::make_unique<TileRenderContent>(std::move(model));
     }
 
-    auto pRenderContent = std::make_unique<TileRenderContent>(std::move(model));
     pRenderContent->setRenderResources(pRenderResources);
     if (rasterOverlayDetails) {
       pRenderContent->setRasterOverlayDetails(std::move(*rasterOverlayDetails));
@@ -70,6 +89,7 @@ struct ContentKindSetter {
   TileContent& tileContent;
   std::optional<RasterOverlayDetails> rasterOverlayDetails;
   void* pRenderResources;
+  std::shared_ptr<const CesiumGltf::Model> pSharedModel;
 };
 
 void unloadTileRecursively(
@@ -299,10 +319,10 @@ void createQuadtreeSubdividedChildren(
           ellipsoid)));
 
   // set children transforms
-  sw.setTransform(parent.getTransform());
-  se.setTransform(parent.getTransform());
-  nw.setTransform(parent.getTransform());
-  ne.setTransform(parent.getTransform());
+  sw.shareTransform(parent);
+  se.shareTransform(parent);
+  nw.shareTransform(parent);
+  ne.shareTransform(parent);
 }
 
 std::vector<CesiumGeospatial::Projection> mapOverlaysToTile(
@@ -533,14 +553,22 @@ void postProcessGltfInWorkerThread(
   if (tileLoadInfo.contentOptions.generateMissingNormalsSmooth) {
     model.generateMissingNormalsSmooth();
   }
+
+  if (tileLoadInfo.contentOptions.optimizeMeshes) {
+    GltfUtilities::optimizeMeshes(model);
+  }
+
+  if (tileLoadInfo.maximumTextureSize > 0) {
+    TileTextureStreamer::reduceInWorkerThread(
+        model,
+        tileLoadInfo.maximumTextureSize);
+  }
 }
 
-CesiumAsync::Future<TileLoadResultAndRenderResources>
-postProcessContentInWorkerThread(
+CesiumAsync::Future<TileLoadResult> postProcessGltfContentInWorkerThread(
     TileLoadResult&& result,
     std::vector<CesiumGeospatial::Projection>&& projections,
-    TileContentLoadInfo&& tileLoadInfo,
-    const std::any& rendererOptions) {
+    TileContentLoadInfo&& tileLoadInfo) {
   CESIUM_ASSERT(
       result.state == TileLoadResultState::Success &&
       "This function requires result to be success");
@@ -562,6 +590,8 @@ postProcessContentInWorkerThread(
       tileLoadInfo.contentOptions.ktx2TranscodeTargets;
   gltfOptions.applyTextureTransform =
       tileLoadInfo.contentOptions.applyTextureTransform;
+  gltfOptions.pSharedImageCache =
+      tileLoadInfo.contentOptions.pSharedImageCache;
 
   auto asyncSystem = tileLoadInfo.asyncSystem;
   auto pAssetAccessor = tileLoadInfo.pAssetAccessor;
@@ -575,8 +605,7 @@ postProcessContentInWorkerThread(
       .thenInWorkerThread(
           [result = std::move(result),
            projections = std::move(projections),
-           tileLoadInfo = std::move(tileLoadInfo),
-           rendererOptions](
+           tileLoadInfo = std::move(tileLoadInfo)](
               CesiumGltfReader::GltfReaderResult&& gltfResult) mutable {
             if (!gltfResult.errors.empty()) {
               if (result.pCompletedRequest) {
@@ -610,10 +639,7 @@ postProcessContentInWorkerThread(
             }
 
             if (!gltfResult.model) {
-              return tileLoadInfo.asyncSystem.createResolvedFuture(
-                  TileLoadResultAndRenderResources{
-                      TileLoadResult::createFailedResult(nullptr),
-                      nullptr});
+              return TileLoadResult::createFailedResult(nullptr);
             }
 
             result.contentKind = std::move(*gltfResult.model);
@@ -623,14 +649,309 @@ postProcessContentInWorkerThread(
                 std::move(projections),
                 tileLoadInfo);
 
-            // create render resources
-            return tileLoadInfo.pPrepareRendererResources->prepareInLoadThread(
-                tileLoadInfo.asyncSystem,
-                std::move(result),
-                tileLoadInfo.tileTransform,
+            return std::move(result);
+          });
+}
+
+CesiumAsync::Future<TileLoadResultAndRenderResources>
+prepareContentInWorkerThread(
+    TileLoadResult&& result,
+    const TileContentLoadInfo& tileLoadInfo,
+    const std::any& rendererOptions) {
+  if (result.state != TileLoadResultState::Success ||
+      !std::holds_alternative<CesiumGltf::Model>(result.contentKind)) {
+    return tileLoadInfo.asyncSystem.createResolvedFuture(
+        TileLoadResultAndRenderResources{std::move(result), nullptr});
+  }
+
+  // create render resources
+  return tileLoadInfo.pPrepareRendererResources->prepareInLoadThread(
+      tileLoadInfo.asyncSystem,
+      std::move(result),
+      tileLoadInfo.tileTransform,
+      rendererOptions);
+}
+
+CesiumAsync::Future<TileLoadResultAndRenderResources>
+postProcessContentInWorkerThread(
+    TileLoadResult&& result,
+    std::vector<CesiumGeospatial::Projection>&& projections,
+    TileContentLoadInfo&& tileLoadInfo,
+    const std::any& rendererOptions) {
+  return postProcessGltfContentInWorkerThread(
+             std::move(result),
+             std::move(projections),
+             TileContentLoadInfo(tileLoadInfo))
+      .thenInWorkerThread(
+          [tileLoadInfo = std::move(tileLoadInfo),
+           rendererOptions](TileLoadResult&& processedResult) mutable {
+            return prepareContentInWorkerThread(
+                std::move(processedResult),
+                tileLoadInfo,
                 rendererOptions);
           });
 }
+
+/**
+ * @brief The result of loading content through a {@link TileContentRegistry}.
+ */
+struct SharedTileLoadResult {
+  TileLoadResultAndRenderResources loaded;
+
+  /**
+   * @brief The shared model that replaces the renderer's copy of it, or
+   * nullptr if the content is not shared.
+   */
+  std::shared_ptr<const CesiumGltf::Model> pSharedModel;
+};
+
+CesiumAsync::Future<SharedTileLoadResult> prepareSharedContentInWorkerThread(
+    const std::shared_ptr<const TileLoadResult>& pContent,
+    const TileContentLoadInfo& tileLoadInfo,
+    const std::any& rendererOptions) {
+  if (!pContent) {
+    // The tileset that loaded the content could not share it, so this tileset
+    // will load it itself when it tries again.
+    return tileLoadInfo.asyncSystem.createResolvedFuture(SharedTileLoadResult{
+        {TileLoadResult::createRetryLaterResult(nullptr), nullptr},
+        nullptr});
+  }
+
+  std::shared_ptr<const CesiumGltf::Model> pSharedModel(
+      pContent,
+      &std::get<CesiumGltf::Model>(pContent->contentKind));
+
+  // The renderer receives a copy of the shared content to prepare, so that it
+  // can modify it as it does unshared content. The tile holds the shared model
+  // rather than this copy, though, so the renderer's changes to the model,
+  // such as freed pixels and reduced image sizes, are discarded.
+  return prepareContentInWorkerThread(
+             TileLoadResult(*pContent),
+             tileLoadInfo,
+             rendererOptions)
+      .thenImmediately([pSharedModel = std::move(pSharedModel)](
+                           TileLoadResultAndRenderResources&& loaded) mutable {
+        return SharedTileLoadResult{std::move(loaded), std::move(pSharedModel)};
+      });
+}
+
+// Content that is loaded with different content options is processed
+// differently, so the options are a part of the key of shared content. The
+// image cache only avoids loading the same image twice, and is not a part of
+// the key.
+std::string getSharedContentKey(
+    const std::string& contentKey,
+    const TilesetContentOptions& contentOptions) {
+  const CesiumGltf::Ktx2TranscodeTargets& targets =
+      contentOptions.ktx2TranscodeTargets;
+  std::string key = contentKey;
+  key += '#';
+  key += contentOptions.enableWaterMask ? '1' : '0';
+  key += contentOptions.generateMissingNormalsSmooth ? '1' : '0';
+  key += contentOptions.optimizeMeshes ? '1' : '0';
+  key += contentOptions.applyTextureTransform ? '1' : '0';
+  for (CesiumGltf::GpuCompressedPixelFormat format :
+       {targets.ETC1S_R,
+        targets.ETC1S_RG,
+        targets.ETC1S_RGB,
+        targets.ETC1S_RGBA,
+        targets.UASTC_R,
+        targets.UASTC_RG,
+        targets.UASTC_RGB,
+        targets.UASTC_RGBA}) {
+    key += ',';
+    key += std::to_string(int(format));
+  }
+  return key;
+}
+
+CesiumAsync::Future<SharedTileLoadResult> loadSharedContent(
+    const std::shared_ptr<TileContentRegistry>& pRegistry,
+    const std::string& sharedContentKey,
+    TilesetContentLoader& loader,
+    const TileLoadInput& loadInput,
+    TileContentLoadInfo&& tileLoadInfo,
+    const std::any& rendererOptions) {
+  using SharedContent = std::shared_ptr<const TileLoadResult>;
+  std::optional<CesiumAsync::SharedFuture<SharedContent>> maybeLoading =
+      pRegistry->beginLoading(tileLoadInfo.asyncSystem, sharedContentKey);
+  if (maybeLoading) {
+    // Another tileset holds or is loading the content.
+    return maybeLoading->thenInWorkerThread(
+        [tileLoadInfo = std::move(tileLoadInfo),
+         rendererOptions](const SharedContent& pContent) {
+          return prepareSharedContentInWorkerThread(
+              pContent,
+              tileLoadInfo,
+              rendererOptions);
+        });
+  }
+
+  // This tileset loads the content, and shares it if it is a glTF.
+  std::shared_ptr<spdlog::logger> pLogger = tileLoadInfo.pLogger;
+  return loader.loadTileContent(loadInput)
+      .thenImmediately([tileLoadInfo](TileLoadResult&& result) mutable {
+        if (result.state == TileLoadResultState::Success &&
+            std::holds_alternative<CesiumGltf::Model>(result.contentKind)) {
+          auto asyncSystem = tileLoadInfo.asyncSystem;
+          return asyncSystem.runInWorkerThread(
+              [result = std::move(result),
+               tileLoadInfo = std::move(tileLoadInfo)]() mutable {
+                return postProcessGltfContentInWorkerThread(
+                    std::move(result),
+                    {},
+                    std::move(tileLoadInfo));
+              });
+        }
+
+        return tileLoadInfo.asyncSystem.createResolvedFuture(std::move(result));
+      })
+      .catchImmediately([pLogger](std::exception&& e) {
+        SPDLOG_LOGGER_ERROR(
+            pLogger,
+            "An unexpected error occurs when loading tile: {}",
+            e.what());
+        return TileLoadResult::createFailedResult(nullptr);
+      })
+      .thenImmediately([pRegistry,
+                        sharedContentKey,
+                        tileLoadInfo = std::move(tileLoadInfo),
+                        rendererOptions](TileLoadResult&& result) {
+        if (result.state != TileLoadResultState::Success ||
+            !std::holds_alternative<CesiumGltf::Model>(result.contentKind) ||
+            result.tileInitializer) {
+          pRegistry->cancelLoading(sharedContentKey);
+          return prepareContentInWorkerThread(
+                     std::move(result),
+                     tileLoadInfo,
+                     rendererOptions)
+              .thenImmediately([](TileLoadResultAndRenderResources&& loaded) {
+                return SharedTileLoadResult{std::move(loaded), nullptr};
+              });
+        }
+
+        storeImageSizes(std::get<CesiumGltf::Model>(result.contentKind));
+        return prepareSharedContentInWorkerThread(
+            pRegistry->finishLoading(sharedContentKey, std::move(result)),
+            tileLoadInfo,
+            rendererOptions);
+      });
+}
+
+void setCopyrightCredits(
+    TileRenderContent& renderContent,
+    CreditSystem& creditSystem,
+    bool showCreditsOnScreen) {
+  const CesiumGltf::Model& model = renderContent.getModel();
+  std::vector<std::string_view> creditStrings =
+      GltfUtilities::parseGltfCopyright(model);
+
+  std::vector<Credit> credits;
+  credits.reserve(creditStrings.size());
+
+  for (const std::string_view& creditString : creditStrings) {
+    credits.emplace_back(creditSystem.createCredit(
+        std::string(creditString),
+        showCreditsOnScreen));
+  }
+
+  renderContent.setCredits(credits);
+}
+
+// Proxies are derived from the tileset rather than downloaded, so there is no
+// response to take an expiry time from. The key of a proxy includes the
+// version of the tileset.json, so a proxy of another version is never used.
+constexpr std::time_t ProxyCacheLifetimeSeconds = 30 * 24 * 60 * 60;
+
+std::optional<CesiumGltf::Model> loadProxyFromCache(
+    const CesiumAsync::ICacheDatabase& cacheDatabase,
+    const std::string& cacheKey,
+    const std::shared_ptr<spdlog::logger>& pLogger) {
+  std::optional<CesiumAsync::CacheItem> maybeItem =
+      cacheDatabase.getEntry(cacheKey);
+  if (!maybeItem || maybeItem->expiryTime < std::time(nullptr)) {
+    return std::nullopt;
+  }
+
+  return TileProxyGenerator::readProxy(
+      maybeItem->cacheResponse.data,
+      pLogger);
+}
+
+void storeProxyInCache(
+    CesiumAsync::ICacheDatabase& cacheDatabase,
+    const std::string& cacheKey,
+    const CesiumGltf::Model& model,
+    const std::shared_ptr<spdlog::logger>& pLogger) {
+  const std::vector<std::byte> glb =
+      TileProxyGenerator::writeProxy(model, pLogger);
+  if (glb.empty()) {
+    return;
+  }
+
+  cacheDatabase.storeEntry(
+      cacheKey,
+      std::time(nullptr) + ProxyCacheLifetimeSeconds,
+      cacheKey,
+      "GET",
+      {},
+      200,
+      {},
+      glb);
+}
+
+// Snapshots are validated against the ETag or Last-Modified header of the
+// tileset.json, so they only expire to eventually free unused entries.
+constexpr std::time_t TileHierarchyCacheLifetimeSeconds = 30 * 24 * 60 * 60;
+
+std::string getTileHierarchyCacheKey(const std::string& tilesetJsonUrl) {
+  return tilesetJsonUrl + "#tile-hierarchy";
+}
+
+TilesetContentLoaderResult<TilesetJsonLoader> loadTileHierarchyFromCache(
+    const CesiumAsync::ICacheDatabase& cacheDatabase,
+    const std::string& tilesetJsonUrl,
+    const std::string& validator,
+    const CesiumGeospatial::Ellipsoid& ellipsoid) {
+  std::optional<CesiumAsync::CacheItem> maybeItem =
+      cacheDatabase.getEntry(getTileHierarchyCacheKey(tilesetJsonUrl));
+  if (!maybeItem) {
+    return TilesetContentLoaderResult<TilesetJsonLoader>();
+  }
+
+  return TilesetJsonLoader::createLoaderFromSnapshot(
+      tilesetJsonUrl,
+      maybeItem->cacheResponse.data,
+      validator,
+      ellipsoid);
+}
+
+void storeTileHierarchyInCache(
+    CesiumAsync::ICacheDatabase& cacheDatabase,
+    const std::string& tilesetJsonUrl,
+    const std::string& validator,
+    const CesiumGeospatial::Ellipsoid& ellipsoid,
+    const TilesetContentLoaderResult<TilesetJsonLoader>& loaderResult) {
+  const std::vector<std::byte> snapshot = TileHierarchySnapshot::write(
+      *loaderResult.pRootTile,
+      *loaderResult.pLoader,
+      validator,
+      ellipsoid);
+  if (snapshot.empty()) {
+    return;
+  }
+
+  const std::string cacheKey = getTileHierarchyCacheKey(tilesetJsonUrl);
+  cacheDatabase.storeEntry(
+      cacheKey,
+      std::time(nullptr) + TileHierarchyCacheLifetimeSeconds,
+      cacheKey,
+      "GET",
+      {},
+      200,
+      {},
+      snapshot);
+}
 } // namespace
 
 TilesetContentManager::TilesetContentManager(
@@ -653,8 +974,16 @@ TilesetContentManager::TilesetContentManager(
       _tilesetCredits{},
       _overlayCollection{std::move(overlayCollection)},
       _tileLoadsInProgress{0},
+      _tileLoadWaiters{},
       _loadedTilesCount{0},
       _tilesDataUsed{0},
+      _batcher{},
+      _batchBuildsInProgress{0},
+      _proxyGenerator{},
+      _proxyRequestsInProgress{0},
+      _proxyCacheKey{},
+      _textureStreamer{},
+      _textureUpgradesInProgress{0},
       _destructionCompletePromise{externals.asyncSystem.createPromise<void>()},
       _destructionCompleteFuture{
           this->_destructionCompletePromise.getFuture().share()},
@@ -682,8 +1011,16 @@ TilesetContentManager::TilesetContentManager(
       _tilesetCredits{},
       _overlayCollection{std::move(overlayCollection)},
       _tileLoadsInProgress{0},
+      _tileLoadWaiters{},
       _loadedTilesCount{0},
       _tilesDataUsed{0},
+      _batcher{},
+      _batchBuildsInProgress{0},
+      _proxyGenerator{},
+      _proxyRequestsInProgress{0},
+      _proxyCacheKey{url},
+      _textureStreamer{},
+      _textureUpgradesInProgress{0},
       _destructionCompletePromise{externals.asyncSystem.createPromise<void>()},
       _destructionCompleteFuture{
           this->_destructionCompletePromise.getFuture().share()},
@@ -704,6 +1041,9 @@ TilesetContentManager::TilesetContentManager(
              pLogger = externals.pLogger,
              asyncSystem = externals.asyncSystem,
              pAssetAccessor = externals.pAssetAccessor,
+             pHierarchyCache = tilesetOptions.enableTileHierarchyCache
+                                   ? externals.pCacheDatabase
+                                   : nullptr,
              contentOptions = tilesetOptions.contentOptions](
                 const std::shared_ptr<CesiumAsync::IAssetRequest>&
                     pCompletedRequest) {
@@ -729,38 +1069,59 @@ TilesetContentManager::TilesetContentManager(
                 return asyncSystem.createResolvedFuture(std::move(result));
               }
 
-              // Parse Json response
+              // Check if the json is a tileset.json format or layer.json format
+              // and create corresponding loader. The tileset.json format is
+              // tried first, since it is read straight into tiles.
               gsl::span<const std::byte> tilesetJsonBinary = pResponse->data();
+
+              // Rebuild the tiles from a snapshot of this version of the
+              // tileset.json, if there is one.
+              const std::string validator =
+                  pHierarchyCache ? TileHierarchySnapshot::getValidator(
+                                        pResponse->headers())
+                                  : std::string();
+              if (!validator.empty()) {
+                TilesetContentLoaderResult<TilesetJsonLoader> cachedResult =
+                    loadTileHierarchyFromCache(
+                        *pHierarchyCache,
+                        url,
+                        validator,
+                        ellipsoid);
+                if (cachedResult.pRootTile) {
+                  cachedResult.tilesetVersion = validator;
+                  return asyncSystem.createResolvedFuture(
+                      TilesetContentLoaderResult<TilesetContentLoader>(
+                          std::move(cachedResult)));
+                }
+              }
+
+              TilesetContentLoaderResult<TilesetJsonLoader> tilesetJsonResult =
+                  TilesetJsonLoader::createLoader(
+                      pLogger,
+                      url,
+                      tilesetJsonBinary,
+                      ellipsoid);
+              if (tilesetJsonResult.pRootTile) {
+                if (!validator.empty()) {
+                  storeTileHierarchyInCache(
+                      *pHierarchyCache,
+                      url,
+                      validator,
+                      ellipsoid,
+                      tilesetJsonResult);
+                }
+                tilesetJsonResult.tilesetVersion =
+                    TileProxyGenerator::getTilesetVersion(*pResponse);
+                return asyncSystem.createResolvedFuture(
+                    TilesetContentLoaderResult<TilesetContentLoader>(
+                        std::move(tilesetJsonResult)));
+              }
+
               rapidjson::Document tilesetJson;
               tilesetJson.Parse(
                   reinterpret_cast<const char*>(tilesetJsonBinary.data()),
                   tilesetJsonBinary.size());
-              if (tilesetJson.HasParseError()) {
-                TilesetContentLoaderResult<TilesetContentLoader> result;
-                result.errors.emplaceError(fmt::format(
-                    "Error when parsing tileset JSON, error code {} at byte "
-                    "offset {}",
-                    tilesetJson.GetParseError(),
-                    tilesetJson.GetErrorOffset()));
-                return asyncSystem.createResolvedFuture(std::move(result));
-              }
-
-              // Check if the json is a tileset.json format or layer.json format
-              // and create corresponding loader
-              const auto rootIt = tilesetJson.FindMember("root");
-              if (rootIt != tilesetJson.MemberEnd()) {
-                return TilesetJsonLoader::createLoader(
-                           asyncSystem,
-                           pAssetAccessor,
-                           pLogger,
-                           url,
-                           pCompletedRequest->headers(),
-                           tilesetJson,
-                           ellipsoid)
-                    .thenImmediately(
-                        [](TilesetContentLoaderResult<TilesetContentLoader>&&
-                               result) { return std::move(result); });
-              } else {
+              if (!tilesetJson.HasParseError() && tilesetJson.IsObject()) {
                 const auto formatIt = tilesetJson.FindMember("format");
                 bool isLayerJsonFormat = formatIt != tilesetJson.MemberEnd() &&
                                          formatIt->value.IsString();
@@ -785,11 +1146,23 @@ TilesetContentManager::TilesetContentManager(
                           [](TilesetContentLoaderResult<TilesetContentLoader>&&
                                  result) { return std::move(result); });
                 }
+              }
 
-                TilesetContentLoaderResult<TilesetContentLoader> result;
+              TilesetContentLoaderResult<TilesetContentLoader> result;
+              if (tilesetJson.HasParseError()) {
+                result.errors.emplaceError(fmt::format(
+                    "Error when parsing tileset JSON, error code {} at byte "
+                    "offset {}",
+                    tilesetJson.GetParseError(),
+                    tilesetJson.GetErrorOffset()));
+              } else if (
+                  tilesetJson.IsObject() &&
+                  tilesetJson.FindMember("root") != tilesetJson.MemberEnd()) {
+                result.errors = std::move(tilesetJsonResult.errors);
+              } else {
                 result.errors.emplaceError("tileset json has unsupport format");
-                return asyncSystem.createResolvedFuture(std::move(result));
               }
+              return asyncSystem.createResolvedFuture(std::move(result));
             })
         .thenInMainThread(
             [thiz, errorCallback = tilesetOptions.loadErrorCallback](
@@ -833,8 +1206,17 @@ TilesetContentManager::TilesetContentManager(
       _tilesetCredits{},
       _overlayCollection{std::move(overlayCollection)},
       _tileLoadsInProgress{0},
+      _tileLoadWaiters{},
       _loadedTilesCount{0},
       _tilesDataUsed{0},
+      _batcher{},
+      _batchBuildsInProgress{0},
+      _proxyGenerator{},
+      _proxyRequestsInProgress{0},
+      _proxyCacheKey{
+          ionAssetEndpointUrl + "v1/assets/" + std::to_string(ionAssetID)},
+      _textureStreamer{},
+      _textureUpgradesInProgress{0},
       _destructionCompletePromise{externals.asyncSystem.createPromise<void>()},
       _destructionCompleteFuture{
           this->_destructionCompletePromise.getFuture().share()},
@@ -904,6 +1286,9 @@ TilesetContentManager::getRootTileAvailableEvent() {
 
 TilesetContentManager::~TilesetContentManager() noexcept {
   CESIUM_ASSERT(this->_tileLoadsInProgress == 0);
+  CESIUM_ASSERT(this->_batchBuildsInProgress == 0);
+  CESIUM_ASSERT(this->_proxyRequestsInProgress == 0);
+  CESIUM_ASSERT(this->_textureUpgradesInProgress == 0);
   this->unloadAll();
 
   this->_destructionCompletePromise.resolve();
@@ -911,7 +1296,8 @@ TilesetContentManager::~TilesetContentManager() noexcept {
 
 void TilesetContentManager::loadTileContent(
     Tile& tile,
-    const TilesetOptions& tilesetOptions) {
+    const TilesetOptions& tilesetOptions,
+    int32_t textureSize) {
   CESIUM_TRACE("TilesetContentManager::loadTileContent");
 
   if (tile.getState() == TileLoadState::Unloading) {
@@ -999,6 +1385,38 @@ void TilesetContentManager::loadTileContent(
       this->_requestHeaders,
       tilesetOptions.ellipsoid};
 
+  // Tiles without raster overlays may share their content with other tilesets
+  // of the same source.
+  std::string sharedContentKey;
+  if (this->_externals.pTileContentRegistry && projections.empty() &&
+      pLoader == this->_pLoader.get()) {
+    sharedContentKey = pLoader->getTileContentKey(tile);
+    if (!sharedContentKey.empty()) {
+      sharedContentKey = getSharedContentKey(
+          sharedContentKey,
+          tilesetOptions.contentOptions);
+    }
+  }
+
+  if (!sharedContentKey.empty()) {
+    loadSharedTileContent(
+        tile,
+        sharedContentKey,
+        loadInput,
+        std::move(tileLoadInfo),
+        tilesetOptions.rendererOptions);
+    return;
+  }
+
+  // Shared content is loaded in full because it may be used by tilesets that
+  // need different resolutions.
+  if (tilesetOptions.enableProgressiveTextures) {
+    tileLoadInfo.maximumTextureSize = std::max(
+        {this->_textureStreamer.getRequiredSize(tile),
+         textureSize,
+         tilesetOptions.minimumProgressiveTextureSize});
+  }
+
   // Keep the manager alive while the load is in progress.
   CesiumUtility::IntrusivePointer<TilesetContentManager> thiz = this;
 
@@ -1050,9 +1468,50 @@ void TilesetContentManager::loadTileContent(
       });
 }
 
+void TilesetContentManager::loadSharedTileContent(
+    Tile& tile,
+    const std::string& sharedContentKey,
+    const TileLoadInput& loadInput,
+    TileContentLoadInfo&& tileLoadInfo,
+    const std::any& rendererOptions) {
+  CesiumAsync::Future<SharedTileLoadResult> future = loadSharedContent(
+      this->_externals.pTileContentRegistry,
+      sharedContentKey,
+      *this->_pLoader,
+      loadInput,
+      std::move(tileLoadInfo),
+      rendererOptions);
+
+  // Keep the manager alive while the load is in progress.
+  CesiumUtility::IntrusivePointer<TilesetContentManager> thiz = this;
+
+  std::move(future)
+      .thenInMainThread([&tile, thiz](SharedTileLoadResult&& result) {
+        setTileContent(
+            tile,
+            std::move(result.loaded.result),
+            result.loaded.pRenderResources,
+            std::move(result.pSharedModel));
+
+        thiz->notifyTileDoneLoading(&tile);
+      })
+      .catchInMainThread([pLogger = this->_externals.pLogger, &tile, thiz](
+                             std::exception&& e) {
+        thiz->notifyTileDoneLoading(&tile);
+        SPDLOG_LOGGER_ERROR(
+            pLogger,
+            "An unexpected error occurs when loading tile: {}",
+            e.what());
+      });
+}
+
 void TilesetContentManager::updateTileContent(
     Tile& tile,
     const TilesetOptions& tilesetOptions) {
+  const TileLoadState previousState = tile.getState();
+  const bool wasEmptyContent = tile.isEmptyContent();
+  const size_t previousChildCount = tile.getChildren().size();
+
   if (tile.getState() == TileLoadState::Unloading) {
     unloadTileContent(tile);
   }
@@ -1076,6 +1535,14 @@ void TilesetContentManager::updateTileContent(
         childrenResult.state == TileLoadResultState::RetryLater;
     tile.setContentShouldContinueUpdating(shouldTileContinueUpdated);
   }
+
+  // A proxy can only be needed once the tile itself has changed.
+  if (tilesetOptions.enableProxyContent &&
+      (tile.getState() != previousState ||
+       tile.isEmptyContent() != wasEmptyContent ||
+       tile.getChildren().size() != previousChildCount)) {
+    updateProxyContent(tile, tilesetOptions);
+  }
 }
 
 bool TilesetContentManager::unloadTileContent(Tile& tile) {
@@ -1095,6 +1562,14 @@ bool TilesetContentManager::unloadTileContent(Tile& tile) {
     return false;
   }
 
+  // A batch that this tile was merged into, or is being merged into, can no
+  // longer be used.
+  if (content.isRenderContent() && tile.getParent()) {
+    this->_batcher.invalidate(
+        *tile.getParent(),
+        this->_externals.pPrepareRendererResources.get());
+  }
+
   // Detach raster tiles first so that the renderer's tile free
   // process doesn't need to worry about them.
   for (RasterMappedTo3DTile& mapped : tile.getMappedRasterTiles()) {
@@ -1130,26 +1605,127 @@ bool TilesetContentManager::unloadTileContent(Tile& tile) {
     }
   }
 
+  // A proxy is not part of the tileset, so the tile goes back to having no
+  // content rather than being reloaded.
+  if (this->_proxyGenerator.hasProxy(tile)) {
+    this->_tilesDataUsed -= tile.computeByteSize();
+    content.setContentKind(TileEmptyContent{});
+    tile.setGeometricError(
+        this->_proxyGenerator.getReplacedGeometricError(tile));
+    tile.setState(TileLoadState::Done);
+    this->_proxyGenerator.forget(tile);
+    return true;
+  }
+
   // If we make it this far, the tile's content will be fully unloaded.
+  this->_textureStreamer.forget(tile);
   notifyTileUnloading(&tile);
   content.setContentKind(TileUnknownContent{});
   tile.setState(TileLoadState::Unloaded);
   return true;
 }
 
+bool TilesetContentManager::canPruneTileChildren(
+    const Tile& tile) const noexcept {
+  if (tile.getChildren().empty()) {
+    return false;
+  }
+
+  // A proxy request in progress refers to the tile and its children, which
+  // it does not keep alive.
+  if (this->_batcher.isBuilding(tile) ||
+      this->_proxyGenerator.isRequesting(tile) ||
+      this->_textureStreamer.isUpgrading(tile)) {
+    return false;
+  }
+
+  // The children of an external tileset are created again when the tileset
+  // is loaded again, which the root tileset.json cannot be.
+  if (tile.isExternalContent()) {
+    const std::string* pUrl = std::get_if<std::string>(&tile.getTileID());
+    return tile.getParent() && pUrl && !pUrl->empty();
+  }
+
+  // Loaders that subdivide tiles create their children again.
+  const TileID& id = tile.getTileID();
+  if (std::holds_alternative<CesiumGeometry::QuadtreeTileID>(id) ||
+      std::holds_alternative<CesiumGeometry::OctreeTileID>(id)) {
+    return true;
+  }
+
+  // Upsampled children are created again once the tile is done loading.
+  return std::holds_alternative<CesiumGeometry::UpsampledQuadtreeNode>(
+      tile.getChildren()[0].getTileID());
+}
+
+bool TilesetContentManager::canPruneTile(const Tile& tile) const noexcept {
+  // Builds, proxy requests, and texture upgrades in progress refer to the
+  // tile without keeping it alive.
+  if (!tile.getMappedRasterTiles().empty() || this->_batcher.isBuilding(tile) ||
+      this->_proxyGenerator.isRequesting(tile) ||
+      this->_textureStreamer.isUpgrading(tile)) {
+    return false;
+  }
+
+  switch (tile.getState()) {
+  case TileLoadState::Unloaded:
+    return true;
+  case TileLoadState::ContentLoaded:
+  case TileLoadState::Done:
+    // Empty and external content is never unloaded, but it is created again
+    // with the tile.
+    return tile.isEmptyContent() || tile.isExternalContent();
+  default:
+    return false;
+  }
+}
+
+void TilesetContentManager::pruneTileChildren(Tile& tile) {
+  // Tiles that are destroyed with empty or external content are not
+  // subtracted from the number of loaded tiles, because most of them were
+  // created with that content rather than loaded.
+  for (const Tile& child : tile.getChildren()) {
+    this->forgetTileRecursively(child);
+  }
+  this->_batcher.invalidate(
+      tile,
+      this->_externals.pPrepareRendererResources.get());
+  this->_pLoader->releaseTileChildren(tile);
+
+  if (tile.isExternalContent()) {
+    // Loading the tile again creates its children again.
+    notifyTileUnloading(&tile);
+    tile.getContent().setContentKind(TileUnknownContent{});
+    tile.setState(TileLoadState::Unloaded);
+  } else {
+    tile.setContentShouldContinueUpdating(true);
+  }
+
+  tile.clearChildTiles();
+}
+
 void TilesetContentManager::unloadAll() {
+  this->_batcher.unloadAll(this->_externals.pPrepareRendererResources.get());
+
   // TODO: use the linked-list of loaded tiles instead of walking the entire
   // tile tree.
   if (this->_pRootTile) {
     unloadTileRecursively(*this->_pRootTile, *this);
   }
+
+  // Proxies that are still being loaded or built are no longer wanted, and
+  // neither are texture upgrades.
+  this->_proxyGenerator.forgetAll();
+  this->_textureStreamer.forgetAll();
 }
 
 void TilesetContentManager::waitUntilIdle() {
   // Wait for all asynchronous loading to terminate.
   // If you're hanging here, it's most likely caused by _tileLoadsInProgress not
   // being decremented correctly when an async load ends.
-  while (this->_tileLoadsInProgress > 0) {
+  while (this->_tileLoadsInProgress > 0 || this->_batchBuildsInProgress > 0 ||
+         this->_proxyRequestsInProgress > 0 ||
+         this->_textureUpgradesInProgress > 0) {
     this->_externals.pAssetAccessor->tick();
     this->_externals.asyncSystem.dispatchMainThreadTasks();
   }
@@ -1213,12 +1789,24 @@ int32_t TilesetContentManager::getNumberOfTilesLoading() const noexcept {
   return this->_tileLoadsInProgress;
 }
 
+CesiumAsync::Future<void> TilesetContentManager::waitForNextTileLoad() {
+  if (this->_tileLoadsInProgress == 0) {
+    return this->_externals.asyncSystem.createResolvedFuture();
+  }
+
+  CesiumAsync::Promise<void> promise =
+      this->_externals.asyncSystem.createPromise<void>();
+  CesiumAsync::Future<void> future = promise.getFuture();
+  this->_tileLoadWaiters.emplace_back(std::move(promise));
+  return future;
+}
+
 int32_t TilesetContentManager::getNumberOfTilesLoaded() const noexcept {
   return this->_loadedTilesCount;
 }
 
 int64_t TilesetContentManager::getTotalDataUsed() const noexcept {
-  int64_t bytes = this->_tilesDataUsed;
+  int64_t bytes = this->_tilesDataUsed + this->_batcher.getTotalDataBytes();
   for (const auto& pTileProvider :
        this->_overlayCollection.getTileProviders()) {
     bytes += pTileProvider->getTileDataBytes();
@@ -1227,6 +1815,12 @@ int64_t TilesetContentManager::getTotalDataUsed() const noexcept {
   return bytes;
 }
 
+void TilesetContentManager::selectRenderBatches(
+    ViewUpdateResult& result,
+    int32_t frameNumber) const {
+  this->_batcher.selectBatches(result, frameNumber);
+}
+
 bool TilesetContentManager::tileNeedsWorkerThreadLoading(
     const Tile& tile) const noexcept {
   auto state = tile.getState();
@@ -1255,19 +1849,10 @@ void TilesetContentManager::finishLoading(
   // add copyright
   CreditSystem* pCreditSystem = this->_externals.pCreditSystem.get();
   if (pCreditSystem) {
-    std::vector<std::string_view> creditStrings =
-        GltfUtilities::parseGltfCopyright(pRenderContent->getModel());
-
-    std::vector<Credit> credits;
-    credits.reserve(creditStrings.size());
-
-    for (const std::string_view& creditString : creditStrings) {
-      credits.emplace_back(pCreditSystem->createCredit(
-          std::string(creditString),
-          tilesetOptions.showCreditsOnScreen));
-    }
-
-    pRenderContent->setCredits(credits);
+    setCopyrightCredits(
+        *pRenderContent,
+        *pCreditSystem,
+        tilesetOptions.showCreditsOnScreen);
   }
 
   void* pWorkerRenderResources = pRenderContent->getRenderResources();
@@ -1282,12 +1867,23 @@ void TilesetContentManager::finishLoading(
   // This allows the raster tile to be updated and children to be created, if
   // necessary.
   updateTileContent(tile, tilesetOptions);
+
+  // This may have been the last sibling needed to merge the parent's children
+  // into a render batch or a proxy.
+  if (tilesetOptions.enableTileBatching && tile.getParent()) {
+    createRenderBatch(*tile.getParent(), tilesetOptions);
+  }
+
+  if (tilesetOptions.enableProxyContent && tile.getParent()) {
+    updateProxyContent(*tile.getParent(), tilesetOptions);
+  }
 }
 
 void TilesetContentManager::setTileContent(
     Tile& tile,
     TileLoadResult&& result,
-    void* pWorkerRenderResources) {
+    void* pWorkerRenderResources,
+    std::shared_ptr<const CesiumGltf::Model>&& pSharedModel) {
   if (result.state == TileLoadResultState::Failed) {
     tile.getMappedRasterTiles().clear();
     tile.setState(TileLoadState::Failed);
@@ -1309,7 +1905,8 @@ void TilesetContentManager::setTileContent(
         ContentKindSetter{
             content,
             std::move(result.rasterOverlayDetails),
-            pWorkerRenderResources},
+            pWorkerRenderResources,
+            std::move(pSharedModel)},
         std::move(result.contentKind));
 
     if (result.tileInitializer) {
@@ -1504,6 +2101,394 @@ void TilesetContentManager::unloadDoneState(Tile& tile) {
   pRenderContent->setRenderResources(nullptr);
 }
 
+void TilesetContentManager::createRenderBatch(
+    Tile& parent,
+    const TilesetOptions& tilesetOptions) {
+  std::optional<TileRenderBatcher::BuildInput> maybeInput =
+      this->_batcher.beginBuild(parent, tilesetOptions.maximumBatchedTileBytes);
+  if (!maybeInput) {
+    return;
+  }
+
+  CESIUM_TRACE("TilesetContentManager::createRenderBatch");
+
+  ++this->_batchBuildsInProgress;
+
+  // Keep the manager alive while the batch is being built.
+  CesiumUtility::IntrusivePointer<TilesetContentManager> thiz = this;
+
+  const uint64_t buildId = maybeInput->buildId;
+  this->_externals.asyncSystem
+      .runInWorkerThread(
+          [input = std::move(*maybeInput),
+           pLogger = this->_externals.pLogger,
+           pPrepareRendererResources =
+               this->_externals.pPrepareRendererResources,
+           rendererOptions = tilesetOptions.rendererOptions]() mutable {
+            std::optional<TileRenderBatcher::BuildResult> maybeResult =
+                TileRenderBatcher::mergeInWorkerThread(
+                    std::move(input),
+                    pLogger);
+            if (maybeResult && pPrepareRendererResources) {
+              maybeResult->pLoadThreadResult =
+                  pPrepareRendererResources->prepareBatchInLoadThread(
+                      maybeResult->model,
+                      maybeResult->transform,
+                      rendererOptions);
+            }
+            return maybeResult;
+          })
+      .catchInMainThread([thiz](std::exception&& e) {
+        SPDLOG_LOGGER_ERROR(
+            thiz->_externals.pLogger,
+            "An unexpected error occurs when creating a render batch: {}",
+            e.what());
+        return std::optional<TileRenderBatcher::BuildResult>();
+      })
+      .thenInMainThread(
+          [thiz, buildId](
+              std::optional<TileRenderBatcher::BuildResult>&& maybeResult) {
+            --thiz->_batchBuildsInProgress;
+            if (maybeResult) {
+              thiz->_batcher.finishBuild(
+                  std::move(*maybeResult),
+                  thiz->_externals.pPrepareRendererResources.get());
+            } else {
+              thiz->_batcher.abandonBuild(buildId);
+            }
+          });
+}
+
+void TilesetContentManager::updateProxyContent(
+    Tile& tile,
+    const TilesetOptions& tilesetOptions) {
+  // A proxy has no raster overlay texture coordinates, so it would be
+  // rendered without the overlays.
+  if (this->_overlayCollection.size() > 0 ||
+      !TileProxyGenerator::canHaveProxy(tile)) {
+    return;
+  }
+
+  std::optional<uint64_t> maybeLoadId = this->_proxyGenerator.beginLoad(tile);
+  if (maybeLoadId) {
+    requestProxyContent(tile, *maybeLoadId, std::nullopt, tilesetOptions);
+  }
+
+  auto maybeBuild = this->_proxyGenerator.beginBuild(tile);
+  if (maybeBuild) {
+    requestProxyContent(
+        tile,
+        maybeBuild->first,
+        std::move(maybeBuild->second),
+        tilesetOptions);
+  }
+}
+
+void TilesetContentManager::requestProxyContent(
+    Tile& tile,
+    uint64_t requestId,
+    std::optional<TileProxyGenerator::BuildInput>&& maybeBuildInput,
+    const TilesetOptions& tilesetOptions) {
+  std::string cacheKey;
+  if (this->_externals.pCacheDatabase && !this->_proxyCacheKey.empty()) {
+    cacheKey = TileProxyGenerator::createCacheKey(this->_proxyCacheKey, tile);
+  }
+
+  if (!maybeBuildInput && cacheKey.empty()) {
+    // There is nowhere to load the proxy from, so it will have to be built.
+    this->_proxyGenerator.finish(tile, requestId, false);
+    return;
+  }
+
+  CESIUM_TRACE("TilesetContentManager::requestProxyContent");
+
+  ++this->_proxyRequestsInProgress;
+
+  // Keep the manager alive while the proxy is being loaded or built.
+  CesiumUtility::IntrusivePointer<TilesetContentManager> thiz = this;
+
+  TileProxyGenerator::Settings settings{
+      tilesetOptions.proxySimplificationRatio,
+      tilesetOptions.proxySimplificationError,
+      tilesetOptions.maximumProxyTextureSize};
+
+  this->_externals.asyncSystem
+      .runInWorkerThread(
+          [asyncSystem = this->_externals.asyncSystem,
+           maybeBuildInput = std::move(maybeBuildInput),
+           settings,
+           cacheKey = std::move(cacheKey),
+           pCacheDatabase = this->_externals.pCacheDatabase,
+           pLogger = this->_externals.pLogger,
+           pPrepareRendererResources =
+               this->_externals.pPrepareRendererResources,
+           transform = tile.getTransform(),
+           ellipsoid = tilesetOptions.ellipsoid,
+           rendererOptions = tilesetOptions.rendererOptions]() mutable {
+            std::optional<CesiumGltf::Model> maybeModel;
+            if (maybeBuildInput) {
+              maybeModel = TileProxyGenerator::buildInWorkerThread(
+                  std::move(*maybeBuildInput),
+                  settings,
+                  pLogger);
+              if (maybeModel && !cacheKey.empty()) {
+                storeProxyInCache(
+                    *pCacheDatabase,
+                    cacheKey,
+                    *maybeModel,
+                    pLogger);
+              }
+            } else {
+              maybeModel =
+                  loadProxyFromCache(*pCacheDatabase, cacheKey, pLogger);
+            }
+
+            if (!maybeModel) {
+              return asyncSystem.createResolvedFuture<
+                  std::optional<TileLoadResultAndRenderResources>>(
+                  std::nullopt);
+            }
+
+            TileLoadResult result{
+                std::move(*maybeModel),
+                CesiumGeometry::Axis::Z,
+                std::nullopt,
+                std::nullopt,
+                std::nullopt,
+                nullptr,
+                {},
+                TileLoadResultState::Success,
+                ellipsoid};
+            return pPrepareRendererResources
+                ->prepareInLoadThread(
+                    asyncSystem,
+                    std::move(result),
+                    transform,
+                    rendererOptions)
+                .thenImmediately([](TileLoadResultAndRenderResources&& pair) {
+                  return std::optional<TileLoadResultAndRenderResources>(
+                      std::move(pair));
+                });
+          })
+      .catchInMainThread([thiz](std::exception&& e) {
+        SPDLOG_LOGGER_ERROR(
+            thiz->_externals.pLogger,
+            "An unexpected error occurs when creating proxy content: {}",
+            e.what());
+        return std::optional<TileLoadResultAndRenderResources>();
+      })
+      .thenInMainThread(
+          [thiz, &tile, requestId, tilesetOptions](
+              std::optional<TileLoadResultAndRenderResources>&& maybeResult) {
+            --thiz->_proxyRequestsInProgress;
+            const bool startOver = thiz->finishProxyContent(
+                tile,
+                requestId,
+                std::move(maybeResult),
+                tilesetOptions.showCreditsOnScreen);
+            if (startOver && tilesetOptions.enableProxyContent) {
+              thiz->updateProxyContent(tile, tilesetOptions);
+            }
+          });
+}
+
+bool TilesetContentManager::finishProxyContent(
+    Tile& tile,
+    uint64_t requestId,
+    std::optional<TileLoadResultAndRenderResources>&& maybeResult,
+    bool showCreditsOnScreen) {
+  std::optional<double> maybeGeometricError;
+  if (maybeResult) {
+    const CesiumGltf::Model* pModel =
+        std::get_if<CesiumGltf::Model>(&maybeResult->result.contentKind);
+    if (pModel) {
+      maybeGeometricError = TileProxyGenerator::getGeometricError(*pModel);
+    }
+  }
+
+  const bool isCurrent = this->_proxyGenerator.finish(
+      tile,
+      requestId,
+      maybeGeometricError.has_value());
+
+  if (!isCurrent || !maybeGeometricError ||
+      !TileProxyGenerator::canHaveProxy(tile)) {
+    if (isCurrent && maybeGeometricError) {
+      // The tile changed while its proxy was being created, so start over.
+      this->_proxyGenerator.forget(tile);
+    }
+
+    if (maybeResult) {
+      this->_externals.pPrepareRendererResources->free(
+          tile,
+          maybeResult->pRenderResources,
+          nullptr);
+    }
+
+    // A proxy that was not found in the cache can be built right away.
+    return isCurrent;
+  }
+
+  // Keep the geometric error of the tile if it is larger, so that the proxy
+  // is rendered wherever the tile previously rendered nothing.
+  const double replacedGeometricError =
+      this->_proxyGenerator.getReplacedGeometricError(tile);
+  if (!tile.getUnconditionallyRefine()) {
+    maybeGeometricError =
+        std::max(*maybeGeometricError, replacedGeometricError);
+  }
+
+  TileContent& content = tile.getContent();
+  std::visit(
+      ContentKindSetter{
+          content,
+          std::nullopt,
+          maybeResult->pRenderResources,
+          nullptr},
+      std::move(maybeResult->result.contentKind));
+  tile.setGeometricError(*maybeGeometricError);
+
+  TileRenderContent* pRenderContent = content.getRenderContent();
+  CESIUM_ASSERT(pRenderContent != nullptr);
+
+  CreditSystem* pCreditSystem = this->_externals.pCreditSystem.get();
+  if (pCreditSystem) {
+    setCopyrightCredits(*pRenderContent, *pCreditSystem, showCreditsOnScreen);
+  }
+
+  pRenderContent->setRenderResources(
+      this->_externals.pPrepareRendererResources->prepareInMainThread(
+          tile,
+          maybeResult->pRenderResources));
+
+  this->_tilesDataUsed += tile.computeByteSize();
+  return false;
+}
+
+void TilesetContentManager::updateTextureResolution(
+    Tile& tile,
+    double projectedScreenSize,
+    const TilesetOptions& tilesetOptions) {
+  this->_textureStreamer.setRequiredSize(
+      tile,
+      TileTextureStreamer::computeTextureSize(
+          projectedScreenSize,
+          tilesetOptions.minimumProgressiveTextureSize));
+
+  // Upgrades count against the tile loads so that they do not crowd out the
+  // tiles that have nothing to render yet.
+  if (this->_tileLoadsInProgress + this->_textureUpgradesInProgress >=
+      static_cast<int32_t>(tilesetOptions.maximumSimultaneousTileLoads)) {
+    return;
+  }
+
+  auto maybeUpgrade = this->_textureStreamer.beginUpgrade(tile);
+  if (maybeUpgrade) {
+    upgradeTextures(
+        tile,
+        maybeUpgrade->first,
+        std::move(maybeUpgrade->second),
+        tilesetOptions);
+  }
+}
+
+void TilesetContentManager::forgetTextureResolution(
+    const Tile& tile) noexcept {
+  this->_textureStreamer.release(tile);
+}
+
+void TilesetContentManager::upgradeTextures(
+    Tile& tile,
+    uint64_t requestId,
+    std::vector<TileTextureStreamer::ImageUpgrade>&& upgrades,
+    const TilesetOptions& tilesetOptions) {
+  CESIUM_TRACE("TilesetContentManager::upgradeTextures");
+
+  ++this->_textureUpgradesInProgress;
+
+  // Keep the manager alive while the textures are being decoded.
+  CesiumUtility::IntrusivePointer<TilesetContentManager> thiz = this;
+
+  this->_externals.asyncSystem
+      .runInWorkerThread(
+          [upgrades = std::move(upgrades),
+           ktx2TranscodeTargets =
+               tilesetOptions.contentOptions.ktx2TranscodeTargets,
+           pLogger = this->_externals.pLogger,
+           pPrepareRendererResources =
+               this->_externals.pPrepareRendererResources,
+           rendererOptions = tilesetOptions.rendererOptions]() mutable {
+            std::vector<TileTextureStreamer::UpgradedImage> images =
+                TileTextureStreamer::upgradeInWorkerThread(
+                    std::move(upgrades),
+                    ktx2TranscodeTargets,
+                    pLogger);
+            for (TileTextureStreamer::UpgradedImage& upgraded : images) {
+              upgraded.pRenderResources =
+                  pPrepareRendererResources->prepareTextureInLoadThread(
+                      upgraded.image,
+                      rendererOptions);
+            }
+            return images;
+          })
+      .catchInMainThread([thiz](std::exception&& e) {
+        SPDLOG_LOGGER_ERROR(
+            thiz->_externals.pLogger,
+            "An unexpected error occurs when upgrading textures: {}",
+            e.what());
+        return std::vector<TileTextureStreamer::UpgradedImage>();
+      })
+      .thenInMainThread(
+          [thiz, &tile, requestId](
+              std::vector<TileTextureStreamer::UpgradedImage>&& images) {
+            --thiz->_textureUpgradesInProgress;
+            thiz->finishTextureUpgrade(tile, requestId, std::move(images));
+          });
+}
+
+void TilesetContentManager::finishTextureUpgrade(
+    Tile& tile,
+    uint64_t requestId,
+    std::vector<TileTextureStreamer::UpgradedImage>&& images) {
+  IPrepareRendererResources& prepareRendererResources =
+      *this->_externals.pPrepareRendererResources;
+  const bool isCurrent = this->_textureStreamer.finish(tile, requestId);
+  TileRenderContent* pRenderContent = tile.getContent().getRenderContent();
+  if (!isCurrent || images.empty() ||
+      tile.getState() != TileLoadState::Done || !pRenderContent) {
+    for (TileTextureStreamer::UpgradedImage& upgraded : images) {
+      prepareRendererResources.freeTexture(tile, upgraded.pRenderResources);
+    }
+    return;
+  }
+
+  // A batch that this tile was merged into still has the old textures.
+  if (tile.getParent()) {
+    this->_batcher.invalidate(*tile.getParent(), &prepareRendererResources);
+  }
+
+  this->_tilesDataUsed -= tile.computeByteSize();
+
+  CesiumGltf::Model& model = pRenderContent->getMutableModel();
+  for (TileTextureStreamer::UpgradedImage& upgraded : images) {
+    CesiumGltf::Image* pImage =
+        CesiumGltf::Model::getSafe(&model.images, upgraded.imageIndex);
+    if (!pImage) {
+      prepareRendererResources.freeTexture(tile, upgraded.pRenderResources);
+      continue;
+    }
+
+    pImage->cesium = std::move(upgraded.image);
+    pImage->cesium.sizeBytes = int64_t(pImage->cesium.pixelData.size());
+    prepareRendererResources.attachTextureInMainThread(
+        tile,
+        upgraded.imageIndex,
+        upgraded.pRenderResources);
+  }
+
+  this->_tilesDataUsed += tile.computeByteSize();
+}
+
 void TilesetContentManager::notifyTileStartLoading(
     [[maybe_unused]] const Tile* pTile) noexcept {
   ++this->_tileLoadsInProgress;
@@ -1519,6 +2504,12 @@ void TilesetContentManager::notifyTileDoneLoading(const Tile* pTile) noexcept {
   if (pTile) {
     this->_tilesDataUsed += pTile->computeByteSize();
   }
+
+  std::vector<CesiumAsync::Promise<void>> waiters;
+  std::swap(waiters, this->_tileLoadWaiters);
+  for (CesiumAsync::Promise<void>& waiter : waiters) {
+    waiter.resolve();
+  }
 }
 
 void TilesetContentManager::notifyTileUnloading(const Tile* pTile) noexcept {
@@ -1529,6 +2520,24 @@ void TilesetContentManager::notifyTileUnloading(const Tile* pTile) noexcept {
   --this->_loadedTilesCount;
 }
 
+void TilesetContentManager::forgetTileRecursively(const Tile& tile) {
+  for (const Tile& child : tile.getChildren()) {
+    this->forgetTileRecursively(child);
+  }
+
+  // The loaders of external tilesets are destroyed with the tiles that loaded
+  // them, after the tiles below them.
+  if (tile.isExternalContent()) {
+    this->_pLoader->releaseTileChildren(tile);
+  }
+
+  this->_batcher.invalidate(
+      tile,
+      this->_externals.pPrepareRendererResources.get());
+  this->_proxyGenerator.forget(tile);
+  this->_textureStreamer.forget(tile);
+}
+
 template <class TilesetContentLoaderType>
 void TilesetContentManager::propagateTilesetContentLoaderResult(
     TilesetLoadType type,
@@ -1566,6 +2575,14 @@ void TilesetContentManager::propagateTilesetContentLoaderResult(
     this->_requestHeaders = std::move(result.requestHeaders);
     this->_pLoader = std::move(result.pLoader);
     this->_pRootTile = std::move(result.pRootTile);
+
+    // Proxies built from another version of the tileset.json must not be
+    // used, so without a version, proxies are not cached at all.
+    if (!result.tilesetVersion.empty()) {
+      this->_proxyCacheKey += "@" + result.tilesetVersion;
+    } else {
+      this->_proxyCacheKey.clear();
+    }
   }
 }
 } // namespace Cesium3DTilesSelection
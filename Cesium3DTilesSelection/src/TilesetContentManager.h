@@ -1,8 +1,12 @@
 #pragma once
 
 #include "RasterOverlayUpsampler.h"
+#include "TileProxyGenerator.h"
+#include "TileRenderBatcher.h"
+#include "TileTextureStreamer.h"
 #include "TilesetContentLoaderResult.h"
 
+#include <Cesium3DTilesSelection/IPrepareRendererResources.h>
 #include <Cesium3DTilesSelection/RasterOverlayCollection.h>
 #include <Cesium3DTilesSelection/Tile.h>
 #include <Cesium3DTilesSelection/TileContent.h>
@@ -10,13 +14,17 @@
 #include <Cesium3DTilesSelection/TilesetExternals.h>
 #include <Cesium3DTilesSelection/TilesetLoadFailureDetails.h>
 #include <Cesium3DTilesSelection/TilesetOptions.h>
+#include <Cesium3DTilesSelection/ViewUpdateResult.h>
 #include <CesiumAsync/IAssetAccessor.h>
 #include <CesiumUtility/CreditSystem.h>
 #include <CesiumUtility/ReferenceCounted.h>
 
+#include <any>
+#include <string>
 #include <vector>
 
 namespace Cesium3DTilesSelection {
+struct TileContentLoadInfo;
 
 class TilesetContentManager
     : public CesiumUtility::ReferenceCountedNonThreadSafe<
@@ -60,12 +68,63 @@ public:
 
   ~TilesetContentManager() noexcept;
 
-  void loadTileContent(Tile& tile, const TilesetOptions& tilesetOptions);
+  /**
+   * @brief Starts loading the content of the given tile.
+   *
+   * @param tile The tile.
+   * @param tilesetOptions The options of the tileset.
+   * @param textureSize The texture size that the tile needs on screen, as
+   * computed by {@link TileTextureStreamer::computeTextureSize}, or 0 if it is
+   * not known. Only used when
+   * {@link TilesetOptions::enableProgressiveTextures} is true.
+   */
+  void loadTileContent(
+      Tile& tile,
+      const TilesetOptions& tilesetOptions,
+      int32_t textureSize = 0);
 
   void updateTileContent(Tile& tile, const TilesetOptions& tilesetOptions);
 
+  /**
+   * @brief Records how many pixels the given tile covers on screen and starts
+   * upgrading its reduced textures if they are now too small.
+   *
+   * Only applicable when {@link TilesetOptions::enableProgressiveTextures} is
+   * true.
+   */
+  void updateTextureResolution(
+      Tile& tile,
+      double projectedScreenSize,
+      const TilesetOptions& tilesetOptions);
+
+  /**
+   * @brief Stops tracking the texture resolution of a tile that is no longer
+   * rendered. An upgrade in progress still finishes.
+   */
+  void forgetTextureResolution(const Tile& tile) noexcept;
+
   bool unloadTileContent(Tile& tile);
 
+  /**
+   * @brief Determines whether the children of the given tile can be destroyed
+   * and created again when they are needed.
+   */
+  bool canPruneTileChildren(const Tile& tile) const noexcept;
+
+  /**
+   * @brief Determines whether destroying the given tile would lose nothing
+   * that cannot be loaded again, because it has no content of its own.
+   */
+  bool canPruneTile(const Tile& tile) const noexcept;
+
+  /**
+   * @brief Destroys the children of the given tile.
+   *
+   * This must only be called if {@link canPruneTileChildren} is true for the
+   * tile and {@link canPruneTile} is true for all of its descendants.
+   */
+  void pruneTileChildren(Tile& tile);
+
   void waitUntilIdle();
 
   /**
@@ -96,10 +155,22 @@ public:
 
   int32_t getNumberOfTilesLoading() const noexcept;
 
+  /**
+   * @brief Returns a future that resolves in the main thread after the next
+   * tile finishes loading, or right away if no tile is loading.
+   */
+  CesiumAsync::Future<void> waitForNextTileLoad();
+
   int32_t getNumberOfTilesLoaded() const noexcept;
 
   int64_t getTotalDataUsed() const noexcept;
 
+  /**
+   * @brief Adds the render batches that can be drawn in place of their members
+   * in the given frame to {@link ViewUpdateResult::batchesToRenderThisFrame}.
+   */
+  void selectRenderBatches(ViewUpdateResult& result, int32_t frameNumber) const;
+
   bool tileNeedsWorkerThreadLoading(const Tile& tile) const noexcept;
   bool tileNeedsMainThreadLoading(const Tile& tile) const noexcept;
 
@@ -107,10 +178,18 @@ public:
   void finishLoading(Tile& tile, const TilesetOptions& tilesetOptions);
 
 private:
+  void loadSharedTileContent(
+      Tile& tile,
+      const std::string& sharedContentKey,
+      const TileLoadInput& loadInput,
+      TileContentLoadInfo&& tileLoadInfo,
+      const std::any& rendererOptions);
+
   static void setTileContent(
       Tile& tile,
       TileLoadResult&& result,
-      void* pWorkerRenderResources);
+      void* pWorkerRenderResources,
+      std::shared_ptr<const CesiumGltf::Model>&& pSharedModel = nullptr);
 
   void
   updateContentLoadedState(Tile& tile, const TilesetOptions& tilesetOptions);
@@ -121,12 +200,42 @@ private:
 
   void unloadDoneState(Tile& tile);
 
+  void createRenderBatch(Tile& parent, const TilesetOptions& tilesetOptions);
+
+  void updateProxyContent(Tile& tile, const TilesetOptions& tilesetOptions);
+
+  void requestProxyContent(
+      Tile& tile,
+      uint64_t requestId,
+      std::optional<TileProxyGenerator::BuildInput>&& maybeBuildInput,
+      const TilesetOptions& tilesetOptions);
+
+  // Returns true if the proxy of the tile should be reconsidered right away.
+  bool finishProxyContent(
+      Tile& tile,
+      uint64_t requestId,
+      std::optional<TileLoadResultAndRenderResources>&& maybeResult,
+      bool showCreditsOnScreen);
+
+  void upgradeTextures(
+      Tile& tile,
+      uint64_t requestId,
+      std::vector<TileTextureStreamer::ImageUpgrade>&& upgrades,
+      const TilesetOptions& tilesetOptions);
+
+  void finishTextureUpgrade(
+      Tile& tile,
+      uint64_t requestId,
+      std::vector<TileTextureStreamer::UpgradedImage>&& images);
+
   void notifyTileStartLoading(const Tile* pTile) noexcept;
 
   void notifyTileDoneLoading(const Tile* pTile) noexcept;
 
   void notifyTileUnloading(const Tile* pTile) noexcept;
 
+  void forgetTileRecursively(const Tile& tile);
+
   template <class TilesetContentLoaderType>
   void propagateTilesetContentLoaderResult(
       TilesetLoadType type,
@@ -143,8 +252,18 @@ private:
   RasterOverlayUpsampler _upsampler;
   RasterOverlayCollection _overlayCollection;
   int32_t _tileLoadsInProgress;
+  std::vector<CesiumAsync::Promise<void>> _tileLoadWaiters;
   int32_t _loadedTilesCount;
   int64_t _tilesDataUsed;
+  TileRenderBatcher _batcher;
+  int32_t _batchBuildsInProgress;
+
+  TileProxyGenerator _proxyGenerator;
+  int32_t _proxyRequestsInProgress;
+  std::string _proxyCacheKey;
+
+  TileTextureStreamer _textureStreamer;
+  int32_t _textureUpgradesInProgress;
 
   CesiumAsync::Promise<void> _destructionCompletePromise;
   CesiumAsync::SharedFuture<void> _destructionCompleteFuture;
@@ -0,0 +1,629 @@
+#include "TilesetJsonHandler.h"
+
+#include "TilesetJsonLoader.h"
+
+#include <Cesium3DTilesSelection/TileContent.h>
+#include <CesiumGeometry/BoundingSphere.h>
+#include <CesiumGeometry/OrientedBoundingBox.h>
+#include <CesiumGeospatial/BoundingRegion.h>
+#include <CesiumGeospatial/S2CellBoundingVolume.h>
+#include <CesiumUtility/Assert.h>
+
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <spdlog/logger.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+
+using namespace CesiumJsonReader;
+using namespace CesiumUtility;
+
+namespace Cesium3DTilesSelection {
+namespace {
+// Determines if the given array has at least the given number of elements,
+// and if all of these are numbers.
+bool hasNumbers(const std::vector<double>& values, size_t count) {
+  return values.size() >= count &&
+         std::none_of(
+             values.begin(),
+             values.begin() + std::ptrdiff_t(count),
+             [](double value) { return std::isnan(value); });
+}
+} // namespace
+
+NumberArrayJsonHandler::NumberArrayJsonHandler() noexcept : JsonHandler() {}
+
+void NumberArrayJsonHandler::reset(
+    IJsonHandler* pParent,
+    std::vector<double>* pArray) {
+  JsonHandler::reset(pParent);
+  this->_pArray = pArray;
+  this->_arrayIsOpen = false;
+}
+
+IJsonHandler* NumberArrayJsonHandler::readNull() {
+  return this->invalid("A null")->readNull();
+}
+
+IJsonHandler* NumberArrayJsonHandler::readBool(bool b) {
+  return this->invalid("A boolean")->readBool(b);
+}
+
+IJsonHandler* NumberArrayJsonHandler::readInt32(int32_t i) {
+  return this->number(double(i));
+}
+
+IJsonHandler* NumberArrayJsonHandler::readUint32(uint32_t i) {
+  return this->number(double(i));
+}
+
+IJsonHandler* NumberArrayJsonHandler::readInt64(int64_t i) {
+  return this->number(double(i));
+}
+
+IJsonHandler* NumberArrayJsonHandler::readUint64(uint64_t i) {
+  return this->number(double(i));
+}
+
+IJsonHandler* NumberArrayJsonHandler::readDouble(double d) {
+  return this->number(d);
+}
+
+IJsonHandler* NumberArrayJsonHandler::readString(const std::string_view& str) {
+  return this->invalid("A string")->readString(str);
+}
+
+IJsonHandler* NumberArrayJsonHandler::readObjectStart() {
+  return this->invalid("An object")->readObjectStart();
+}
+
+IJsonHandler* NumberArrayJsonHandler::readArrayStart() {
+  if (this->_arrayIsOpen) {
+    return this->invalid("An array")->readArrayStart();
+  }
+
+  this->_arrayIsOpen = true;
+  this->_pArray->clear();
+  return this;
+}
+
+IJsonHandler* NumberArrayJsonHandler::readArrayEnd() { return this->parent(); }
+
+IJsonHandler* NumberArrayJsonHandler::number(double d) {
+  if (!this->_arrayIsOpen) {
+    return this->invalid("A number")->readDouble(d);
+  }
+
+  CESIUM_ASSERT(this->_pArray);
+  this->_pArray->emplace_back(d);
+  return this;
+}
+
+IJsonHandler* NumberArrayJsonHandler::invalid(const std::string& type) {
+  if (this->_arrayIsOpen) {
+    this->reportWarning(
+        type + " value is not allowed in the number array and makes it "
+               "invalid.");
+    this->_pArray->emplace_back(std::numeric_limits<double>::quiet_NaN());
+    return this->ignoreAndContinue();
+  }
+
+  this->reportWarning(type + " is not allowed and has been ignored.");
+  return this->ignoreAndReturnToParent();
+}
+
+void BoundingVolumeJson::clear() noexcept {
+  this->box.clear();
+  this->region.clear();
+  this->sphere.clear();
+  this->s2.reset();
+}
+
+std::optional<BoundingVolume> BoundingVolumeJson::create(
+    const CesiumGeospatial::Ellipsoid& ellipsoid) const {
+  if (this->s2) {
+    return CesiumGeospatial::S2CellBoundingVolume(
+        CesiumGeospatial::S2CellID::fromToken(this->s2->token),
+        this->s2->minimumHeight,
+        this->s2->maximumHeight,
+        ellipsoid);
+  }
+
+  if (this->box.size() >= 12) {
+    if (!hasNumbers(this->box, 12)) {
+      return std::nullopt;
+    }
+
+    const std::vector<double>& a = this->box;
+    return CesiumGeometry::OrientedBoundingBox(
+        glm::dvec3(a[0], a[1], a[2]),
+        glm::dmat3(a[3], a[4], a[5], a[6], a[7], a[8], a[9], a[10], a[11]));
+  }
+
+  if (this->region.size() >= 6) {
+    if (!hasNumbers(this->region, 6)) {
+      return std::nullopt;
+    }
+
+    const std::vector<double>& a = this->region;
+    return CesiumGeospatial::BoundingRegion(
+        CesiumGeospatial::GlobeRectangle(a[0], a[1], a[2], a[3]),
+        a[4],
+        a[5],
+        ellipsoid);
+  }
+
+  if (this->sphere.size() >= 4) {
+    if (!hasNumbers(this->sphere, 4)) {
+      return std::nullopt;
+    }
+
+    const std::vector<double>& a = this->sphere;
+    return CesiumGeometry::BoundingSphere(glm::dvec3(a[0], a[1], a[2]), a[3]);
+  }
+
+  return std::nullopt;
+}
+
+void ContentJson::clear() noexcept {
+  this->uri.clear();
+  this->url.clear();
+  this->boundingVolume.clear();
+}
+
+S2CellBoundingVolumeJsonHandler::S2CellBoundingVolumeJsonHandler() noexcept
+    : ObjectJsonHandler(), _token(), _minimumHeight(), _maximumHeight() {}
+
+void S2CellBoundingVolumeJsonHandler::reset(
+    IJsonHandler* pParent,
+    S2CellBoundingVolumeJson* pObject) {
+  ObjectJsonHandler::reset(pParent);
+  this->_pObject = pObject;
+}
+
+IJsonHandler*
+S2CellBoundingVolumeJsonHandler::readObjectKey(const std::string_view& str) {
+  CESIUM_ASSERT(this->_pObject);
+  using namespace std::string_literals;
+
+  if ("token"s == str)
+    return property("token", this->_token, this->_pObject->token);
+  if ("minimumHeight"s == str)
+    return property(
+        "minimumHeight",
+        this->_minimumHeight,
+        this->_pObject->minimumHeight);
+  if ("maximumHeight"s == str)
+    return property(
+        "maximumHeight",
+        this->_maximumHeight,
+        this->_pObject->maximumHeight);
+
+  return this->ignoreAndContinue();
+}
+
+BoundingVolumeJsonHandler::BoundingVolumeJsonHandler() noexcept
+    : ObjectJsonHandler(),
+      _box(),
+      _region(),
+      _sphere(),
+      _extensions("3DTILES_bounding_volume_S2") {}
+
+void BoundingVolumeJsonHandler::reset(
+    IJsonHandler* pParent,
+    BoundingVolumeJson* pObject) {
+  ObjectJsonHandler::reset(pParent);
+  this->_pObject = pObject;
+}
+
+IJsonHandler*
+BoundingVolumeJsonHandler::readObjectKey(const std::string_view& str) {
+  CESIUM_ASSERT(this->_pObject);
+  using namespace std::string_literals;
+
+  if ("box"s == str)
+    return property("box", this->_box, this->_pObject->box);
+  if ("region"s == str)
+    return property("region", this->_region, this->_pObject->region);
+  if ("sphere"s == str)
+    return property("sphere", this->_sphere, this->_pObject->sphere);
+  if ("extensions"s == str) {
+    // The optional is only engaged if the extension is actually present.
+    this->setCurrentKey("extensions");
+    this->_extensions.reset(this, &this->_pObject->s2);
+    return &this->_extensions;
+  }
+
+  return this->ignoreAndContinue();
+}
+
+ContentJsonHandler::ContentJsonHandler() noexcept
+    : ObjectJsonHandler(), _uri(), _url(), _boundingVolume() {}
+
+void ContentJsonHandler::reset(IJsonHandler* pParent, ContentJson* pObject) {
+  ObjectJsonHandler::reset(pParent);
+  this->_pObject = pObject;
+}
+
+IJsonHandler* ContentJsonHandler::readObjectKey(const std::string_view& str) {
+  CESIUM_ASSERT(this->_pObject);
+  using namespace std::string_literals;
+
+  if ("uri"s == str)
+    return property("uri", this->_uri, this->_pObject->uri);
+  if ("url"s == str)
+    return property("url", this->_url, this->_pObject->url);
+  if ("boundingVolume"s == str)
+    return property(
+        "boundingVolume",
+        this->_boundingVolume,
+        this->_pObject->boundingVolume);
+
+  return this->ignoreAndContinue();
+}
+
+TileChildrenJsonHandler::TileChildrenJsonHandler(
+    const TileJsonContext& context) noexcept
+    : JsonHandler(), _context(context), _pTile() {}
+
+TileChildrenJsonHandler::~TileChildrenJsonHandler() noexcept = default;
+
+void TileChildrenJsonHandler::reset(
+    IJsonHandler* pParent,
+    std::vector<Tile>* pTiles) {
+  JsonHandler::reset(pParent);
+  this->_pTiles = pTiles;
+  this->_arrayIsOpen = false;
+  this->_index = 0;
+}
+
+IJsonHandler* TileChildrenJsonHandler::readNull() {
+  return this->invalid("A null")->readNull();
+}
+
+IJsonHandler* TileChildrenJsonHandler::readBool(bool b) {
+  return this->invalid("A boolean")->readBool(b);
+}
+
+IJsonHandler* TileChildrenJsonHandler::readInt32(int32_t i) {
+  return this->invalid("An integer")->readInt32(i);
+}
+
+IJsonHandler* TileChildrenJsonHandler::readUint32(uint32_t i) {
+  return this->invalid("An integer")->readUint32(i);
+}
+
+IJsonHandler* TileChildrenJsonHandler::readInt64(int64_t i) {
+  return this->invalid("An integer")->readInt64(i);
+}
+
+IJsonHandler* TileChildrenJsonHandler::readUint64(uint64_t i) {
+  return this->invalid("An integer")->readUint64(i);
+}
+
+IJsonHandler* TileChildrenJsonHandler::readDouble(double d) {
+  return this->invalid("A double (floating-point)")->readDouble(d);
+}
+
+IJsonHandler*
+TileChildrenJsonHandler::readString(const std::string_view& str) {
+  return this->invalid("A string")->readString(str);
+}
+
+IJsonHandler* TileChildrenJsonHandler::readObjectStart() {
+  if (!this->_arrayIsOpen) {
+    return this->invalid("An object")->readObjectStart();
+  }
+
+  if (!this->_pTile) {
+    this->_pTile = std::make_unique<TileJsonHandler>(this->_context);
+  }
+
+  ++this->_index;
+  this->_pTile->reset(this, this->_pTiles);
+  return this->_pTile->readObjectStart();
+}
+
+IJsonHandler* TileChildrenJsonHandler::readArrayStart() {
+  if (this->_arrayIsOpen) {
+    return this->invalid("An array")->readArrayStart();
+  }
+
+  this->_arrayIsOpen = true;
+  return this;
+}
+
+IJsonHandler* TileChildrenJsonHandler::readArrayEnd() {
+  return this->parent();
+}
+
+void TileChildrenJsonHandler::reportWarning(
+    const std::string& warning,
+    std::vector<std::string>&& context) {
+  if (this->_arrayIsOpen && this->_index > 0) {
+    context.push_back(
+        std::string("[") + std::to_string(this->_index - 1) + "]");
+  }
+  this->parent()->reportWarning(warning, std::move(context));
+}
+
+IJsonHandler* TileChildrenJsonHandler::invalid(const std::string& type) {
+  if (this->_arrayIsOpen) {
+    ++this->_index;
+    this->reportWarning(
+        type + " value is not allowed in the children array and has been "
+               "ignored.");
+    return this->ignoreAndContinue();
+  } else {
+    this->reportWarning(type + " is not allowed and has been ignored.");
+    return this->ignoreAndReturnToParent();
+  }
+}
+
+TileJsonHandler::TileJsonHandler(const TileJsonContext& context) noexcept
+    : ObjectJsonHandler(),
+      _context(context),
+      _transformValue(),
+      _boundingVolumeValue(),
+      _viewerRequestVolumeValue(),
+      _geometricErrorValue(std::numeric_limits<double>::quiet_NaN()),
+      _refineValue(),
+      _contentValue(),
+      _implicitTilingValue(),
+      _legacyImplicitTilingValue(),
+      _childrenValue(),
+      _transform(),
+      _boundingVolume(),
+      _viewerRequestVolume(),
+      _geometricError(),
+      _refine(),
+      _content(),
+      _implicitTiling(),
+      _extensions("3DTILES_implicit_tiling"),
+      _children(context) {}
+
+void TileJsonHandler::reset(IJsonHandler* pParent, std::vector<Tile>* pTiles) {
+  ObjectJsonHandler::reset(pParent);
+  this->_pTiles = pTiles;
+
+  this->_transformValue.clear();
+  this->_boundingVolumeValue.clear();
+  this->_viewerRequestVolumeValue.clear();
+  this->_geometricErrorValue = std::numeric_limits<double>::quiet_NaN();
+  this->_refineValue.clear();
+  this->_contentValue.clear();
+  this->_implicitTilingValue.reset();
+  this->_legacyImplicitTilingValue.reset();
+  this->_childrenValue.clear();
+}
+
+IJsonHandler* TileJsonHandler::readObjectStart() {
+  // Every other object in the tile is read by another handler, so this is the
+  // start of the tile itself. Reserve its place in the depth-first pre-order
+  // before any of its children take theirs.
+  std::vector<TileJsonProperties>& tileProperties =
+      *this->_context.pTileProperties;
+  this->_propertiesIndex = tileProperties.size();
+  tileProperties.emplace_back();
+
+  return ObjectJsonHandler::readObjectStart();
+}
+
+IJsonHandler* TileJsonHandler::readObjectKey(const std::string_view& str) {
+  using namespace std::string_literals;
+
+  if ("transform"s == str)
+    return property("transform", this->_transform, this->_transformValue);
+  if ("boundingVolume"s == str)
+    return property(
+        "boundingVolume",
+        this->_boundingVolume,
+        this->_boundingVolumeValue);
+  if ("viewerRequestVolume"s == str)
+    return property(
+        "viewerRequestVolume",
+        this->_viewerRequestVolume,
+        this->_viewerRequestVolumeValue);
+  if ("geometricError"s == str)
+    return property(
+        "geometricError",
+        this->_geometricError,
+        this->_geometricErrorValue);
+  if ("refine"s == str)
+    return property("refine", this->_refine, this->_refineValue);
+  if ("content"s == str)
+    return property("content", this->_content, this->_contentValue);
+  if ("implicitTiling"s == str)
+    return property(
+        "implicitTiling",
+        this->_implicitTiling,
+        this->_implicitTilingValue);
+  if ("extensions"s == str) {
+    this->setCurrentKey("extensions");
+    this->_extensions.reset(this, &this->_legacyImplicitTilingValue);
+    return &this->_extensions;
+  }
+  if ("children"s == str)
+    return property("children", this->_children, this->_childrenValue);
+
+  return this->ignoreAndContinue();
+}
+
+IJsonHandler* TileJsonHandler::readObjectEnd() {
+  IJsonHandler* pNext = ObjectJsonHandler::readObjectEnd();
+  this->addTile();
+  return pNext;
+}
+
+void TileJsonHandler::addTile() {
+  const TileJsonContext& context = this->_context;
+  std::vector<TileJsonProperties>& tileProperties = *context.pTileProperties;
+
+  std::optional<BoundingVolume> boundingVolume =
+      this->_boundingVolumeValue.create(context.ellipsoid);
+  if (!boundingVolume) {
+    SPDLOG_LOGGER_ERROR(
+        context.pLogger,
+        "Tile did not contain a boundingVolume");
+
+    // Neither this tile nor its descendants are added.
+    tileProperties.resize(this->_propertiesIndex);
+    return;
+  }
+
+  const bool hasGeometricError = !std::isnan(this->_geometricErrorValue);
+
+  bool hasRefine = false;
+  TileRefine refine = TileRefine::Replace;
+  if (!this->_refineValue.empty()) {
+    const std::string& refineJson = this->_refineValue;
+    if (refineJson == "REPLACE") {
+      hasRefine = true;
+    } else if (refineJson == "ADD") {
+      hasRefine = true;
+      refine = TileRefine::Add;
+    } else {
+      std::string refineUpper = refineJson;
+      std::transform(
+          refineUpper.begin(),
+          refineUpper.end(),
+          refineUpper.begin(),
+          [](unsigned char c) -> unsigned char {
+            return static_cast<unsigned char>(std::toupper(c));
+          });
+      if (refineUpper == "REPLACE" || refineUpper == "ADD") {
+        SPDLOG_LOGGER_WARN(
+            context.pLogger,
+            "Tile refine value '{}' should be uppercase: '{}'",
+            refineJson,
+            refineUpper);
+        hasRefine = true;
+        refine =
+            refineUpper == "REPLACE" ? TileRefine::Replace : TileRefine::Add;
+      } else {
+        SPDLOG_LOGGER_WARN(
+            context.pLogger,
+            "Tile contained an unknown refine value: {}",
+            refineJson);
+      }
+    }
+  }
+
+  const std::string& contentUri = this->_contentValue.uri.empty()
+                                      ? this->_contentValue.url
+                                      : this->_contentValue.uri;
+
+  // An implicitTiling property takes precedence over the legacy 3D Tiles Next
+  // implicit tiling extension.
+  std::optional<JsonValue>* pImplicitTiling = nullptr;
+  if (this->_implicitTilingValue && this->_implicitTilingValue->isObject()) {
+    pImplicitTiling = &this->_implicitTilingValue;
+  } else if (
+      this->_legacyImplicitTilingValue &&
+      this->_legacyImplicitTilingValue->isObject()) {
+    pImplicitTiling = &this->_legacyImplicitTilingValue;
+  }
+
+  Tile* pTile = nullptr;
+  if (pImplicitTiling) {
+    // The children of the tile are replaced by the implicit tiles.
+    tileProperties.resize(this->_propertiesIndex + 1);
+    tileProperties[this->_propertiesIndex].pImplicitTiling =
+        std::make_unique<JsonValue>(std::move(**pImplicitTiling));
+
+    pTile = &this->_pTiles->emplace_back(
+        context.pLoader,
+        std::make_unique<TileExternalContent>());
+    pTile->setTileID(contentUri);
+  } else {
+    if (contentUri.empty()) {
+      pTile =
+          &this->_pTiles->emplace_back(context.pLoader, TileEmptyContent{});
+      pTile->setTileID("");
+    } else {
+      pTile = &this->_pTiles->emplace_back(context.pLoader);
+      pTile->setTileID(contentUri);
+    }
+
+    pTile->setContentBoundingVolume(
+        this->_contentValue.boundingVolume.create(context.ellipsoid));
+    pTile->createChildTiles(std::move(this->_childrenValue));
+  }
+
+  const std::vector<double>& t = this->_transformValue;
+  if (hasNumbers(t, 16)) {
+    pTile->setTransform(glm::dmat4(
+        glm::dvec4(t[0], t[1], t[2], t[3]),
+        glm::dvec4(t[4], t[5], t[6], t[7]),
+        glm::dvec4(t[8], t[9], t[10], t[11]),
+        glm::dvec4(t[12], t[13], t[14], t[15])));
+  }
+
+  pTile->setBoundingVolume(*boundingVolume);
+  pTile->setViewerRequestVolume(
+      this->_viewerRequestVolumeValue.create(context.ellipsoid));
+  pTile->setGeometricError(
+      hasGeometricError ? this->_geometricErrorValue : 0.0);
+  pTile->setRefine(refine);
+
+  TileJsonProperties& properties = tileProperties[this->_propertiesIndex];
+  properties.hasGeometricError = hasGeometricError;
+  properties.hasRefine = hasRefine;
+}
+
+TilesetJsonHandler::TilesetJsonHandler(
+    const std::shared_ptr<spdlog::logger>& pLogger,
+    TilesetJsonLoader& loader,
+    const CesiumGeospatial::Ellipsoid& ellipsoid) noexcept
+    : ObjectJsonHandler(),
+      _context{pLogger, &loader, ellipsoid, nullptr},
+      _asset("gltfUpAxis"),
+      _root(_context),
+      _schemaUri(),
+      _metadata() {}
+
+void TilesetJsonHandler::reset(IJsonHandler* pParent, TilesetJson* pObject) {
+  ObjectJsonHandler::reset(pParent);
+  this->_pObject = pObject;
+  this->_context.pTileProperties = &pObject->tileProperties;
+}
+
+IJsonHandler* TilesetJsonHandler::readObjectKey(const std::string_view& str) {
+  CESIUM_ASSERT(this->_pObject);
+  using namespace std::string_literals;
+
+  if ("asset"s == str) {
+    this->setCurrentKey("asset");
+    this->_asset.reset(this, &this->_pObject->gltfUpAxis);
+    return &this->_asset;
+  }
+  if ("root"s == str) {
+    // Only the last root tile is kept if there are several.
+    this->_pObject->root.clear();
+    this->_pObject->tileProperties.clear();
+    return property("root", this->_root, this->_pObject->root);
+  }
+  if ("schema"s == str) {
+    this->setCurrentKey("schema");
+    return this->_metadata.readSchema(this, this->_pObject->schema.emplace());
+  }
+  if ("schemaUri"s == str)
+    return property("schemaUri", this->_schemaUri, this->_pObject->schemaUri);
+  if ("metadata"s == str) {
+    this->setCurrentKey("metadata");
+    return this->_metadata.readMetadata(
+        this,
+        this->_pObject->metadata.emplace());
+  }
+  if ("groups"s == str) {
+    this->setCurrentKey("groups");
+    return this->_metadata.readGroups(this, this->_pObject->groups.emplace());
+  }
+
+  return this->ignoreAndContinue();
+}
+} // namespace Cesium3DTilesSelection
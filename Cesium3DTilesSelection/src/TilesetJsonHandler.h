@@ -0,0 +1,418 @@
+#pragma once
+
+#include <Cesium3DTiles/GroupMetadata.h>
+#include <Cesium3DTiles/MetadataEntity.h>
+#include <Cesium3DTiles/Schema.h>
+#include <Cesium3DTilesReader/TilesetMetadataJsonHandler.h>
+#include <Cesium3DTilesSelection/Tile.h>
+#include <CesiumGeospatial/Ellipsoid.h>
+#include <CesiumJsonReader/DoubleJsonHandler.h>
+#include <CesiumJsonReader/JsonHandler.h>
+#include <CesiumJsonReader/JsonObjectJsonHandler.h>
+#include <CesiumJsonReader/ObjectJsonHandler.h>
+#include <CesiumJsonReader/StringJsonHandler.h>
+#include <CesiumUtility/JsonValue.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Cesium3DTilesSelection {
+class TilesetJsonLoader;
+
+/**
+ * @brief The properties of a tile in a tileset.json that can only be applied
+ * to its {@link Tile} once the properties of all of its ancestors are known.
+ */
+struct TileJsonProperties {
+  /**
+   * @brief Whether the tile has its own `geometricError`.
+   */
+  bool hasGeometricError = false;
+
+  /**
+   * @brief Whether the tile has its own valid `refine`.
+   */
+  bool hasRefine = false;
+
+  /**
+   * @brief The implicit tiling object of the tile, or nullptr if the tile does
+   * not use implicit tiling.
+   */
+  std::unique_ptr<CesiumUtility::JsonValue> pImplicitTiling;
+};
+
+/**
+ * @brief The parts of a tileset.json read by {@link TilesetJsonHandler}.
+ *
+ * The tiles are created while the JSON is read, but the transform, bounding
+ * volumes, geometric error, and refinement of each tile are those found in
+ * its own JSON. They still need to be combined with the properties of its
+ * ancestors, which may appear after the tile in the JSON, as described by
+ * {@link tileProperties}.
+ *
+ * The tile ID of a tile with implicit tiling is the template of its content
+ * URI rather than an empty string.
+ */
+struct TilesetJson {
+  /**
+   * @brief The root tile. There is at most one, and none if the tileset.json
+   * does not have a valid root tile.
+   */
+  std::vector<Tile> root;
+
+  /**
+   * @brief The properties of {@link root} and each of its descendants, in
+   * depth-first pre-order.
+   *
+   * The children of a tile with implicit tiling are not included, because
+   * they are replaced by the implicit tiles.
+   */
+  std::vector<TileJsonProperties> tileProperties;
+
+  /**
+   * @brief The `asset.gltfUpAxis` property.
+   */
+  std::optional<std::string> gltfUpAxis;
+
+  /**
+   * @brief The `schema` property.
+   */
+  std::optional<Cesium3DTiles::Schema> schema;
+
+  /**
+   * @brief The `schemaUri` property.
+   */
+  std::optional<std::string> schemaUri;
+
+  /**
+   * @brief The `metadata` property.
+   */
+  std::optional<Cesium3DTiles::MetadataEntity> metadata;
+
+  /**
+   * @brief The `groups` property.
+   */
+  std::optional<std::vector<Cesium3DTiles::GroupMetadata>> groups;
+};
+
+/**
+ * @brief The state shared by all handlers reading the tiles of one
+ * tileset.json.
+ */
+struct TileJsonContext {
+  std::shared_ptr<spdlog::logger> pLogger;
+  TilesetJsonLoader* pLoader;
+  CesiumGeospatial::Ellipsoid ellipsoid;
+  std::vector<TileJsonProperties>* pTileProperties;
+};
+
+/**
+ * @brief Reads one property of a JSON object, such as a single extension from
+ * an `extensions` object, and ignores all the others.
+ *
+ * The optional value is only engaged if the property is found, so unlike the
+ * other handlers this one must be reset directly rather than through
+ * `ObjectJsonHandler::property`, which would engage it for the object itself.
+ */
+template <typename TValue, typename THandler>
+class SinglePropertyJsonHandler : public CesiumJsonReader::ObjectJsonHandler {
+public:
+  using ValueType = std::optional<TValue>;
+
+  explicit SinglePropertyJsonHandler(const char* propertyName) noexcept
+      : CesiumJsonReader::ObjectJsonHandler(),
+        _propertyName(propertyName),
+        _handler() {}
+
+  void reset(IJsonHandler* pParent, std::optional<TValue>* pValue) {
+    CesiumJsonReader::ObjectJsonHandler::reset(pParent);
+    this->_pValue = pValue;
+  }
+
+  virtual IJsonHandler* readObjectKey(const std::string_view& str) override {
+    if (str == this->_propertyName) {
+      return this->property(
+          this->_propertyName,
+          this->_handler,
+          *this->_pValue);
+    }
+
+    return this->ignoreAndContinue();
+  }
+
+private:
+  const char* _propertyName;
+  std::optional<TValue>* _pValue = nullptr;
+  THandler _handler;
+};
+
+/**
+ * @brief Reads an array of numbers.
+ *
+ * Unlike `ArrayJsonHandler<double, DoubleJsonHandler>`, which replaces them
+ * with zero, every element that is not a number is read as NaN. This allows
+ * the arrays of bounding volumes and transforms with such elements to be
+ * rejected.
+ */
+class NumberArrayJsonHandler : public CesiumJsonReader::JsonHandler {
+public:
+  using ValueType = std::vector<double>;
+
+  NumberArrayJsonHandler() noexcept;
+  void reset(IJsonHandler* pParent, std::vector<double>* pArray);
+
+  virtual IJsonHandler* readNull() override;
+  virtual IJsonHandler* readBool(bool b) override;
+  virtual IJsonHandler* readInt32(int32_t i) override;
+  virtual IJsonHandler* readUint32(uint32_t i) override;
+  virtual IJsonHandler* readInt64(int64_t i) override;
+  virtual IJsonHandler* readUint64(uint64_t i) override;
+  virtual IJsonHandler* readDouble(double d) override;
+  virtual IJsonHandler* readString(const std::string_view& str) override;
+  virtual IJsonHandler* readObjectStart() override;
+  virtual IJsonHandler* readArrayStart() override;
+  virtual IJsonHandler* readArrayEnd() override;
+
+private:
+  IJsonHandler* number(double d);
+  IJsonHandler* invalid(const std::string& type);
+
+  std::vector<double>* _pArray = nullptr;
+  bool _arrayIsOpen = false;
+};
+
+/**
+ * @brief A `3DTILES_bounding_volume_S2` extension read from a tileset.json.
+ */
+struct S2CellBoundingVolumeJson {
+  std::string token = "1";
+  double minimumHeight = 0.0;
+  double maximumHeight = 0.0;
+};
+
+/**
+ * @brief A bounding volume read from a tileset.json.
+ */
+struct BoundingVolumeJson {
+  std::vector<double> box;
+  std::vector<double> region;
+  std::vector<double> sphere;
+  std::optional<S2CellBoundingVolumeJson> s2;
+
+  /**
+   * @brief Clears all properties, but keeps the memory of the arrays.
+   */
+  void clear() noexcept;
+
+  /**
+   * @brief Creates the bounding volume, or `std::nullopt` if it does not have
+   * a valid box, region, sphere, or S2 cell.
+   *
+   * Like the box, region, or sphere that is used, the bounding volume is
+   * invalid if any of the used elements of its array is not a number.
+   */
+  std::optional<BoundingVolume>
+  create(const CesiumGeospatial::Ellipsoid& ellipsoid) const;
+};
+
+class S2CellBoundingVolumeJsonHandler
+    : public CesiumJsonReader::ObjectJsonHandler {
+public:
+  using ValueType = S2CellBoundingVolumeJson;
+
+  S2CellBoundingVolumeJsonHandler() noexcept;
+  void reset(IJsonHandler* pParent, S2CellBoundingVolumeJson* pObject);
+  virtual IJsonHandler* readObjectKey(const std::string_view& str) override;
+
+private:
+  S2CellBoundingVolumeJson* _pObject = nullptr;
+  CesiumJsonReader::StringJsonHandler _token;
+  CesiumJsonReader::DoubleJsonHandler _minimumHeight;
+  CesiumJsonReader::DoubleJsonHandler _maximumHeight;
+};
+
+class BoundingVolumeJsonHandler : public CesiumJsonReader::ObjectJsonHandler {
+public:
+  using ValueType = BoundingVolumeJson;
+
+  BoundingVolumeJsonHandler() noexcept;
+  void reset(IJsonHandler* pParent, BoundingVolumeJson* pObject);
+  virtual IJsonHandler* readObjectKey(const std::string_view& str) override;
+
+private:
+  BoundingVolumeJson* _pObject = nullptr;
+  NumberArrayJsonHandler _box;
+  NumberArrayJsonHandler _region;
+  NumberArrayJsonHandler _sphere;
+  SinglePropertyJsonHandler<
+      S2CellBoundingVolumeJson,
+      S2CellBoundingVolumeJsonHandler>
+      _extensions;
+};
+
+/**
+ * @brief The content of a tile read from a tileset.json.
+ */
+struct ContentJson {
+  std::string uri;
+  std::string url;
+  BoundingVolumeJson boundingVolume;
+
+  /**
+   * @brief Clears all properties, but keeps the memory of the strings and
+   * arrays.
+   */
+  void clear() noexcept;
+};
+
+class ContentJsonHandler : public CesiumJsonReader::ObjectJsonHandler {
+public:
+  using ValueType = ContentJson;
+
+  ContentJsonHandler() noexcept;
+  void reset(IJsonHandler* pParent, ContentJson* pObject);
+  virtual IJsonHandler* readObjectKey(const std::string_view& str) override;
+
+private:
+  ContentJson* _pObject = nullptr;
+  CesiumJsonReader::StringJsonHandler _uri;
+  CesiumJsonReader::StringJsonHandler _url;
+  BoundingVolumeJsonHandler _boundingVolume;
+};
+
+class TileJsonHandler;
+
+/**
+ * @brief Reads the `children` array of a tile, creating a {@link Tile} for
+ * each valid child.
+ */
+class TileChildrenJsonHandler : public CesiumJsonReader::JsonHandler {
+public:
+  using ValueType = std::vector<Tile>;
+
+  explicit TileChildrenJsonHandler(const TileJsonContext& context) noexcept;
+  ~TileChildrenJsonHandler() noexcept;
+  void reset(IJsonHandler* pParent, std::vector<Tile>* pTiles);
+
+  virtual IJsonHandler* readNull() override;
+  virtual IJsonHandler* readBool(bool b) override;
+  virtual IJsonHandler* readInt32(int32_t i) override;
+  virtual IJsonHandler* readUint32(uint32_t i) override;
+  virtual IJsonHandler* readInt64(int64_t i) override;
+  virtual IJsonHandler* readUint64(uint64_t i) override;
+  virtual IJsonHandler* readDouble(double d) override;
+  virtual IJsonHandler* readString(const std::string_view& str) override;
+  virtual IJsonHandler* readObjectStart() override;
+  virtual IJsonHandler* readArrayStart() override;
+  virtual IJsonHandler* readArrayEnd() override;
+
+  virtual void reportWarning(
+      const std::string& warning,
+      std::vector<std::string>&& context = std::vector<std::string>()) override;
+
+private:
+  IJsonHandler* invalid(const std::string& type);
+
+  const TileJsonContext& _context;
+  std::vector<Tile>* _pTiles = nullptr;
+  bool _arrayIsOpen = false;
+  size_t _index = 0;
+
+  // Created when first needed, because each level of the tree needs its own.
+  std::unique_ptr<TileJsonHandler> _pTile;
+};
+
+/**
+ * @brief Reads a tile of a tileset.json and adds a {@link Tile} for it to a
+ * vector once the tile's JSON ends.
+ *
+ * A tile without a valid bounding volume is not added, and neither are its
+ * descendants.
+ */
+class TileJsonHandler : public CesiumJsonReader::ObjectJsonHandler {
+public:
+  using ValueType = std::vector<Tile>;
+
+  explicit TileJsonHandler(const TileJsonContext& context) noexcept;
+  void reset(IJsonHandler* pParent, std::vector<Tile>* pTiles);
+
+  virtual IJsonHandler* readObjectStart() override;
+  virtual IJsonHandler* readObjectKey(const std::string_view& str) override;
+  virtual IJsonHandler* readObjectEnd() override;
+
+private:
+  void addTile();
+
+  const TileJsonContext& _context;
+  std::vector<Tile>* _pTiles = nullptr;
+  size_t _propertiesIndex = 0;
+
+  // The properties of the tile being read. They are kept between tiles so
+  // that siblings reuse their memory.
+  std::vector<double> _transformValue;
+  BoundingVolumeJson _boundingVolumeValue;
+  BoundingVolumeJson _viewerRequestVolumeValue;
+  double _geometricErrorValue;
+  std::string _refineValue;
+  ContentJson _contentValue;
+  std::optional<CesiumUtility::JsonValue> _implicitTilingValue;
+  std::optional<CesiumUtility::JsonValue> _legacyImplicitTilingValue;
+  std::vector<Tile> _childrenValue;
+
+  NumberArrayJsonHandler _transform;
+  BoundingVolumeJsonHandler _boundingVolume;
+  BoundingVolumeJsonHandler _viewerRequestVolume;
+  CesiumJsonReader::DoubleJsonHandler _geometricError;
+  CesiumJsonReader::StringJsonHandler _refine;
+  ContentJsonHandler _content;
+  CesiumJsonReader::JsonObjectJsonHandler _implicitTiling;
+  SinglePropertyJsonHandler<
+      CesiumUtility::JsonValue,
+      CesiumJsonReader::JsonObjectJsonHandler>
+      _extensions;
+  TileChildrenJsonHandler _children;
+};
+
+/**
+ * @brief Reads a tileset.json in a single pass, creating the {@link Tile}
+ * of each tile as soon as its JSON ends.
+ *
+ * Unlike reading the JSON into a document first, the memory needed besides
+ * the tiles themselves only depends on the depth of the tile tree.
+ */
+class TilesetJsonHandler : public CesiumJsonReader::ObjectJsonHandler {
+public:
+  using ValueType = TilesetJson;
+
+  /**
+   * @brief Creates a new instance.
+   *
+   * @param pLogger The logger receiving problems with the tiles.
+   * @param loader The loader of the created tiles.
+   * @param ellipsoid The ellipsoid of region and S2 bounding volumes.
+   */
+  TilesetJsonHandler(
+      const std::shared_ptr<spdlog::logger>& pLogger,
+      TilesetJsonLoader& loader,
+      const CesiumGeospatial::Ellipsoid& ellipsoid) noexcept;
+
+  void reset(IJsonHandler* pParent, TilesetJson* pObject);
+  virtual IJsonHandler* readObjectKey(const std::string_view& str) override;
+
+private:
+  TileJsonContext _context;
+  TilesetJson* _pObject = nullptr;
+  SinglePropertyJsonHandler<std::string, CesiumJsonReader::StringJsonHandler>
+      _asset;
+  TileJsonHandler _root;
+  CesiumJsonReader::StringJsonHandler _schemaUri;
+  Cesium3DTilesReader::TilesetMetadataJsonHandler _metadata;
+};
+} // namespace Cesium3DTilesSelection
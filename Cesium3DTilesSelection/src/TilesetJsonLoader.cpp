@@ -2,12 +2,13 @@
 
 #include "ImplicitOctreeLoader.h"
 #include "ImplicitQuadtreeLoader.h"
+#include "TileHierarchySnapshot.h"
+#include "TileProxyGenerator.h"
+#include "TilesetJsonHandler.h"
 #include "logTileLoadResult.h"
 
+#include <Cesium3DTiles/ImplicitTiling.h>
 #include <Cesium3DTilesContent/GltfConverters.h>
-#include <Cesium3DTilesReader/GroupMetadataReader.h>
-#include <Cesium3DTilesReader/MetadataEntityReader.h>
-#include <Cesium3DTilesReader/SchemaReader.h>
 #include <Cesium3DTilesSelection/TileID.h>
 #include <CesiumAsync/AsyncSystem.h>
 #include <CesiumAsync/IAssetResponse.h>
@@ -15,14 +16,14 @@
 #include <CesiumGeometry/OrientedBoundingBox.h>
 #include <CesiumGeospatial/BoundingRegion.h>
 #include <CesiumGeospatial/S2CellBoundingVolume.h>
+#include <CesiumJsonReader/JsonReader.h>
 #include <CesiumUtility/Assert.h>
-#include <CesiumUtility/JsonHelpers.h>
 #include <CesiumUtility/Uri.h>
 #include <CesiumUtility/joinToString.h>
 
-#include <rapidjson/document.h>
 #include <spdlog/logger.h>
 
+#include <algorithm>
 #include <cctype>
 
 using namespace CesiumUtility;
@@ -73,19 +74,14 @@ struct ExternalContentInitializer {
  * CesiumGeometry::Axis::Y, or CesiumGeometry::Axis::Z to be returned,
  * respectively.
  *
- * @param tileset The tileset JSON
+ * @param gltfUpAxis The `asset.gltfUpAxis` property of the tileset JSON
+ * @param pLogger The logger receiving a warning for an unknown value
  * @return The up-axis to use for glTF content
  */
 CesiumGeometry::Axis obtainGltfUpAxis(
-    const rapidjson::Document& tileset,
+    const std::optional<std::string>& gltfUpAxis,
     const std::shared_ptr<spdlog::logger>& pLogger) {
-  const auto assetIt = tileset.FindMember("asset");
-  if (assetIt == tileset.MemberEnd()) {
-    return CesiumGeometry::Axis::Y;
-  }
-  const rapidjson::Value& assetJson = assetIt->value;
-  const auto gltfUpAxisIt = assetJson.FindMember("gltfUpAxis");
-  if (gltfUpAxisIt == assetJson.MemberEnd()) {
+  if (!gltfUpAxis) {
     return CesiumGeometry::Axis::Y;
   }
 
@@ -95,8 +91,7 @@ CesiumGeometry::Axis obtainGltfUpAxis(
   //     "This property is not part of the specification. "
   //     "All glTF content should use the Y-axis as the up-axis.");
 
-  const rapidjson::Value& gltfUpAxisJson = gltfUpAxisIt->value;
-  auto gltfUpAxisString = std::string(gltfUpAxisJson.GetString());
+  const std::string& gltfUpAxisString = *gltfUpAxis;
   if (gltfUpAxisString == "X" || gltfUpAxisString == "x") {
     return CesiumGeometry::Axis::X;
   }
@@ -114,104 +109,9 @@ CesiumGeometry::Axis obtainGltfUpAxis(
   return CesiumGeometry::Axis::Y;
 }
 
-std::optional<BoundingVolume> getBoundingVolumeProperty(
-    const CesiumGeospatial::Ellipsoid& ellipsoid,
-    const rapidjson::Value& tileJson,
-    const std::string& key) {
-  const auto bvIt = tileJson.FindMember(key.c_str());
-  if (bvIt == tileJson.MemberEnd() || !bvIt->value.IsObject()) {
-    return std::nullopt;
-  }
-
-  const auto extensionsIt = bvIt->value.FindMember("extensions");
-  if (extensionsIt != bvIt->value.MemberEnd() &&
-      extensionsIt->value.IsObject()) {
-    const auto s2It =
-        extensionsIt->value.FindMember("3DTILES_bounding_volume_S2");
-    if (s2It != extensionsIt->value.MemberEnd() && s2It->value.IsObject()) {
-      std::string token = CesiumUtility::JsonHelpers::getStringOrDefault(
-          s2It->value,
-          "token",
-          "1");
-      double minimumHeight = CesiumUtility::JsonHelpers::getDoubleOrDefault(
-          s2It->value,
-          "minimumHeight",
-          0.0);
-      double maximumHeight = CesiumUtility::JsonHelpers::getDoubleOrDefault(
-          s2It->value,
-          "maximumHeight",
-          0.0);
-      return CesiumGeospatial::S2CellBoundingVolume(
-          CesiumGeospatial::S2CellID::fromToken(token),
-          minimumHeight,
-          maximumHeight,
-          ellipsoid);
-    }
-  }
-
-  const auto boxIt = bvIt->value.FindMember("box");
-  if (boxIt != bvIt->value.MemberEnd() && boxIt->value.IsArray() &&
-      boxIt->value.Size() >= 12) {
-    const auto& a = boxIt->value.GetArray();
-    for (rapidjson::SizeType i = 0; i < 12; ++i) {
-      if (!a[i].IsNumber()) {
-        return std::nullopt;
-      }
-    }
-    return CesiumGeometry::OrientedBoundingBox(
-        glm::dvec3(a[0].GetDouble(), a[1].GetDouble(), a[2].GetDouble()),
-        glm::dmat3(
-            a[3].GetDouble(),
-            a[4].GetDouble(),
-            a[5].GetDouble(),
-            a[6].GetDouble(),
-            a[7].GetDouble(),
-            a[8].GetDouble(),
-            a[9].GetDouble(),
-            a[10].GetDouble(),
-            a[11].GetDouble()));
-  }
-
-  const auto regionIt = bvIt->value.FindMember("region");
-  if (regionIt != bvIt->value.MemberEnd() && regionIt->value.IsArray() &&
-      regionIt->value.Size() >= 6) {
-    const auto& a = regionIt->value;
-    for (rapidjson::SizeType i = 0; i < 6; ++i) {
-      if (!a[i].IsNumber()) {
-        return std::nullopt;
-      }
-    }
-    return CesiumGeospatial::BoundingRegion(
-        CesiumGeospatial::GlobeRectangle(
-            a[0].GetDouble(),
-            a[1].GetDouble(),
-            a[2].GetDouble(),
-            a[3].GetDouble()),
-        a[4].GetDouble(),
-        a[5].GetDouble(),
-        ellipsoid);
-  }
-
-  const auto sphereIt = bvIt->value.FindMember("sphere");
-  if (sphereIt != bvIt->value.MemberEnd() && sphereIt->value.IsArray() &&
-      sphereIt->value.Size() >= 4) {
-    const auto& a = sphereIt->value;
-    for (rapidjson::SizeType i = 0; i < 4; ++i) {
-      if (!a[i].IsNumber()) {
-        return std::nullopt;
-      }
-    }
-    return CesiumGeometry::BoundingSphere(
-        glm::dvec3(a[0].GetDouble(), a[1].GetDouble(), a[2].GetDouble()),
-        a[3].GetDouble());
-  }
-
-  return std::nullopt;
-}
-
 void createImplicitQuadtreeLoader(
-    const char* contentUriTemplate,
-    const char* subtreeUriTemplate,
+    const std::string& contentUriTemplate,
+    const std::string& subtreeUriTemplate,
     uint32_t subtreeLevels,
     uint32_t availableLevels,
     Tile& implicitTile,
@@ -266,7 +166,7 @@ void createImplicitQuadtreeLoader(
   // create an implicit root to associate with the above implicit loader
   std::vector<Tile> implicitRootTile;
   implicitRootTile.emplace_back(pImplicitLoader);
-  implicitRootTile[0].setTransform(implicitTile.getTransform());
+  implicitRootTile[0].shareTransform(implicitTile);
   implicitRootTile[0].setBoundingVolume(implicitTile.getBoundingVolume());
   implicitRootTile[0].setGeometricError(implicitTile.getGeometricError());
   implicitRootTile[0].setRefine(implicitTile.getRefine());
@@ -275,8 +175,8 @@ void createImplicitQuadtreeLoader(
 }
 
 void createImplicitOctreeLoader(
-    const char* contentUriTemplate,
-    const char* subtreeUriTemplate,
+    const std::string& contentUriTemplate,
+    const std::string& subtreeUriTemplate,
     uint32_t subtreeLevels,
     uint32_t availableLevels,
     Tile& implicitTile,
@@ -323,7 +223,7 @@ void createImplicitOctreeLoader(
   // create an implicit root to associate with the above implicit loader
   std::vector<Tile> implicitRootTile;
   implicitRootTile.emplace_back(pImplicitLoader);
-  implicitRootTile[0].setTransform(implicitTile.getTransform());
+  implicitRootTile[0].shareTransform(implicitTile);
   implicitRootTile[0].setBoundingVolume(implicitTile.getBoundingVolume());
   implicitRootTile[0].setGeometricError(implicitTile.getGeometricError());
   implicitRootTile[0].setRefine(implicitTile.getRefine());
@@ -331,110 +231,105 @@ void createImplicitOctreeLoader(
   implicitTile.createChildTiles(std::move(implicitRootTile));
 }
 
+std::optional<uint32_t> getUint32(const CesiumUtility::JsonValue* pValue) {
+  if (!pValue) {
+    return std::nullopt;
+  }
+
+  const int64_t value = pValue->getSafeNumberOrDefault<int64_t>(-1);
+  if (value < 0 || value > int64_t(std::numeric_limits<uint32_t>::max())) {
+    return std::nullopt;
+  }
+
+  return uint32_t(value);
+}
+
 void parseImplicitTileset(
-    const rapidjson::Value& implicitExtensionJson,
-    const char* contentUri,
+    const CesiumUtility::JsonValue& implicitTiling,
+    const std::string& contentUri,
     Tile& tile,
     TilesetJsonLoader& currentLoader) {
-  auto implicitTiling = implicitExtensionJson.GetObject();
-  auto tilingSchemeIt = implicitTiling.FindMember("subdivisionScheme");
-  auto subtreeLevelsIt = implicitTiling.FindMember("subtreeLevels");
-  auto subtreesIt = implicitTiling.FindMember("subtrees");
-  auto availableLevelsIt = implicitTiling.FindMember("availableLevels");
-  if (availableLevelsIt == implicitTiling.MemberEnd()) {
+  const std::string* pSubdivisionScheme =
+      implicitTiling.getValuePtrForKey<std::string>("subdivisionScheme");
+  std::optional<uint32_t> subtreeLevels =
+      getUint32(implicitTiling.getValuePtrForKey("subtreeLevels"));
+  const CesiumUtility::JsonValue* pAvailableLevels =
+      implicitTiling.getValuePtrForKey("availableLevels");
+  if (!pAvailableLevels) {
     // old version of implicit uses maximumLevel instead of availableLevels.
     // They have the same semantic
-    availableLevelsIt = implicitTiling.FindMember("maximumLevel");
+    pAvailableLevels = implicitTiling.getValuePtrForKey("maximumLevel");
   }
+  std::optional<uint32_t> availableLevels = getUint32(pAvailableLevels);
+  const CesiumUtility::JsonValue* pSubtrees =
+      implicitTiling.getValuePtrForKey("subtrees");
+  const std::string* pSubtreesUri =
+      pSubtrees ? pSubtrees->getValuePtrForKey<std::string>("uri") : nullptr;
 
   // check that all the required properties above are available
-  bool hasTilingSchemeProp = tilingSchemeIt != implicitTiling.MemberEnd() &&
-                             tilingSchemeIt->value.IsString();
-  bool hasSubtreeLevelsProp = subtreeLevelsIt != implicitTiling.MemberEnd() &&
-                              subtreeLevelsIt->value.IsUint();
-  bool hasAvailableLevelsProp =
-      availableLevelsIt != implicitTiling.MemberEnd() &&
-      availableLevelsIt->value.IsUint();
-  bool hasSubtreesProp =
-      subtreesIt != implicitTiling.MemberEnd() && subtreesIt->value.IsObject();
-  if (!hasTilingSchemeProp || !hasSubtreeLevelsProp ||
-      !hasAvailableLevelsProp || !hasSubtreesProp) {
-    return;
-  }
-
-  auto subtrees = subtreesIt->value.GetObject();
-  auto subtreesUriIt = subtrees.FindMember("uri");
-  if (subtreesUriIt == subtrees.MemberEnd() ||
-      !subtreesUriIt->value.IsString()) {
+  if (!pSubdivisionScheme || !subtreeLevels || !availableLevels ||
+      !pSubtreesUri) {
     return;
   }
 
-  // create implicit loaders
-  uint32_t subtreeLevels = subtreeLevelsIt->value.GetUint();
-  uint32_t availableLevels = availableLevelsIt->value.GetUint();
-  const char* subtreesUri = subtreesUriIt->value.GetString();
-  const char* subdivisionScheme = tilingSchemeIt->value.GetString();
-
-  if (std::strcmp(subdivisionScheme, "QUADTREE") == 0) {
-    createImplicitQuadtreeLoader(
-        contentUri,
-        subtreesUri,
-        subtreeLevels,
-        availableLevels,
-        tile,
-        currentLoader);
-  } else if (std::strcmp(subdivisionScheme, "OCTREE") == 0) {
-    createImplicitOctreeLoader(
-        contentUri,
-        subtreesUri,
-        subtreeLevels,
-        availableLevels,
-        tile,
-        currentLoader);
-  }
+  currentLoader.addImplicitTileset(
+      tile,
+      *pSubdivisionScheme,
+      contentUri,
+      *pSubtreesUri,
+      *subtreeLevels,
+      *availableLevels);
 }
 
-std::optional<Tile> parseTileJsonRecursively(
+/**
+ * @brief Combines the properties read from the JSON of a tile and its
+ * descendants with those of its ancestors.
+ *
+ * The tiles are visited in the same depth-first pre-order as the one of the
+ * given properties.
+ */
+void resolveTileJsonRecursively(
     const std::shared_ptr<spdlog::logger>& pLogger,
-    const rapidjson::Value& tileJson,
+    Tile& tile,
+    std::vector<TileJsonProperties>::iterator& propertiesIt,
     const glm::dmat4& parentTransform,
     TileRefine parentRefine,
     double parentGeometricError,
-    TilesetJsonLoader& currentLoader,
-    const CesiumGeospatial::Ellipsoid& ellipsoid) {
-  if (!tileJson.IsObject()) {
-    return std::nullopt;
+    TilesetJsonLoader& currentLoader) {
+  const TileJsonProperties& properties = *propertiesIt;
+  ++propertiesIt;
+
+  // tile transform
+  const glm::dmat4x4 tileTransform = parentTransform * tile.getTransform();
+  const Tile* pParent = tile.getParent();
+  if (pParent && pParent->getTransform() == tileTransform) {
+    // Most tiles do not have a transform of their own.
+    tile.shareTransform(*pParent);
+  } else {
+    tile.setTransform(tileTransform);
   }
 
-  // parse tile transform
-  const std::optional<glm::dmat4x4> transform =
-      CesiumUtility::JsonHelpers::getTransformProperty(tileJson, "transform");
-  glm::dmat4x4 tileTransform =
-      parentTransform * transform.value_or(glm::dmat4x4(1.0));
+  // bounding volumes
+  tile.setBoundingVolume(
+      transformBoundingVolume(tileTransform, tile.getBoundingVolume()));
 
-  // parse bounding volume
-  std::optional<BoundingVolume> boundingVolume =
-      getBoundingVolumeProperty(ellipsoid, tileJson, "boundingVolume");
-  if (!boundingVolume) {
-    SPDLOG_LOGGER_ERROR(pLogger, "Tile did not contain a boundingVolume");
-    return std::nullopt;
+  const std::optional<BoundingVolume>& viewerRequestVolume =
+      tile.getViewerRequestVolume();
+  if (viewerRequestVolume) {
+    tile.setViewerRequestVolume(
+        transformBoundingVolume(tileTransform, *viewerRequestVolume));
   }
 
-  auto tileBoundingVolume =
-      transformBoundingVolume(tileTransform, boundingVolume.value());
-
-  // parse viewer request volume
-  std::optional<BoundingVolume> tileViewerRequestVolume =
-      getBoundingVolumeProperty(ellipsoid, tileJson, "viewerRequestVolume");
-  if (tileViewerRequestVolume) {
-    tileViewerRequestVolume =
-        transformBoundingVolume(tileTransform, tileViewerRequestVolume.value());
+  const std::optional<BoundingVolume>& contentBoundingVolume =
+      tile.getContentBoundingVolume();
+  if (contentBoundingVolume) {
+    tile.setContentBoundingVolume(
+        transformBoundingVolume(tileTransform, *contentBoundingVolume));
   }
 
-  // parse geometric error
-  std::optional<double> geometricError =
-      CesiumUtility::JsonHelpers::getScalarProperty(tileJson, "geometricError");
-  if (!geometricError) {
+  // geometric error
+  double geometricError = tile.getGeometricError();
+  if (!properties.hasGeometricError) {
     geometricError = parentGeometricError * 0.5;
     SPDLOG_LOGGER_WARN(
         pLogger,
@@ -448,232 +343,112 @@ std::optional<Tile> parseTileJsonRecursively(
       glm::length(tileTransform[2]));
   const double maxScaleComponent =
       glm::max(scale.x, glm::max(scale.y, scale.z));
-  double tileGeometricError = geometricError.value() * maxScaleComponent;
-
-  // parse refinement
-  TileRefine tileRefine = parentRefine;
-  const auto refineIt = tileJson.FindMember("refine");
-  if (refineIt != tileJson.MemberEnd() && refineIt->value.IsString()) {
-    std::string refine = refineIt->value.GetString();
-    if (refine == "REPLACE") {
-      tileRefine = TileRefine::Replace;
-    } else if (refine == "ADD") {
-      tileRefine = TileRefine::Add;
-    } else {
-      std::string refineUpper = refine;
-      std::transform(
-          refineUpper.begin(),
-          refineUpper.end(),
-          refineUpper.begin(),
-          [](unsigned char c) -> unsigned char {
-            return static_cast<unsigned char>(std::toupper(c));
-          });
-      if (refineUpper == "REPLACE" || refineUpper == "ADD") {
-        SPDLOG_LOGGER_WARN(
-            pLogger,
-            "Tile refine value '{}' should be uppercase: '{}'",
-            refine,
-            refineUpper);
-        tileRefine =
-            refineUpper == "REPLACE" ? TileRefine::Replace : TileRefine::Add;
-      } else {
-        SPDLOG_LOGGER_WARN(
-            pLogger,
-            "Tile contained an unknown refine value: {}",
-            refine);
-      }
-    }
-  } else {
-  }
-
-  // Parse content member to determine tile content Url.
-  const auto contentIt = tileJson.FindMember("content");
-  bool hasContentMember =
-      (contentIt != tileJson.MemberEnd()) && (contentIt->value.IsObject());
-  const char* contentUri = nullptr;
-  if (hasContentMember) {
-    auto uriIt = contentIt->value.FindMember("uri");
-    if (uriIt == contentIt->value.MemberEnd() || !uriIt->value.IsString()) {
-      uriIt = contentIt->value.FindMember("url");
-    }
-
-    if (uriIt != contentIt->value.MemberEnd() && uriIt->value.IsString()) {
-      contentUri = uriIt->value.GetString();
-    }
-  }
+  tile.setGeometricError(geometricError * maxScaleComponent);
 
-  // determine if tile has implicit tiling
-  const rapidjson::Value* implicitTilingJson = nullptr;
-  const auto implicitTilingIt = tileJson.FindMember("implicitTiling");
-  if (implicitTilingIt != tileJson.MemberEnd() &&
-      implicitTilingIt->value.IsObject()) {
-    // this is an external tile pointing to an implicit tileset
-    implicitTilingJson = &implicitTilingIt->value;
-  } else {
-    const auto extensionIt = tileJson.FindMember("extensions");
-    if (extensionIt != tileJson.MemberEnd()) {
-      // this is the legacy 3D Tiles Next implicit tiling extension
-      const auto& extensions = extensionIt->value;
-      const auto implicitExtensionIt =
-          extensions.FindMember("3DTILES_implicit_tiling");
-      if (implicitExtensionIt != extensions.MemberEnd() &&
-          implicitExtensionIt->value.IsObject()) {
-        implicitTilingJson = &implicitExtensionIt->value;
-      }
-    }
+  // refinement
+  if (!properties.hasRefine) {
+    tile.setRefine(parentRefine);
   }
 
-  if (implicitTilingJson) {
-    // mark this tile as external
-    Tile tile{&currentLoader, std::make_unique<TileExternalContent>()};
+  if (properties.pImplicitTiling) {
+    // The tile ID holds the content URI template until now.
+    const std::string* pContentUri =
+        std::get_if<std::string>(&tile.getTileID());
+    const std::string contentUri = pContentUri ? *pContentUri : "";
     tile.setTileID("");
-    tile.setTransform(tileTransform);
-    tile.setBoundingVolume(tileBoundingVolume);
-    tile.setViewerRequestVolume(tileViewerRequestVolume);
-    tile.setGeometricError(tileGeometricError);
-    tile.setRefine(tileRefine);
-
-    parseImplicitTileset(*implicitTilingJson, contentUri, tile, currentLoader);
 
-    return tile;
+    parseImplicitTileset(
+        *properties.pImplicitTiling,
+        contentUri,
+        tile,
+        currentLoader);
+    return;
   }
 
-  // this is a regular tile, then parse the content bounding volume
-  std::optional<BoundingVolume> tileContentBoundingVolume;
-  if (hasContentMember) {
-    tileContentBoundingVolume = getBoundingVolumeProperty(
-        ellipsoid,
-        contentIt->value,
-        "boundingVolume");
-    if (tileContentBoundingVolume) {
-      tileContentBoundingVolume = transformBoundingVolume(
-          tileTransform,
-          tileContentBoundingVolume.value());
-    }
+  for (Tile& child : tile.getChildren()) {
+    resolveTileJsonRecursively(
+        pLogger,
+        child,
+        propertiesIt,
+        tileTransform,
+        tile.getRefine(),
+        tile.getGeometricError(),
+        currentLoader);
   }
+}
 
-  // parse tile's children
-  std::vector<Tile> childTiles;
-  const auto childrenIt = tileJson.FindMember("children");
-  if (childrenIt != tileJson.MemberEnd() && childrenIt->value.IsArray()) {
-    const auto& childrenJson = childrenIt->value;
-    childTiles.reserve(childrenJson.Size());
-    for (rapidjson::SizeType i = 0; i < childrenJson.Size(); ++i) {
-      const auto& childJson = childrenJson[i];
-      auto maybeChild = parseTileJsonRecursively(
-          pLogger,
-          childJson,
-          tileTransform,
-          tileRefine,
-          tileGeometricError,
-          currentLoader,
-          ellipsoid);
+void parseTilesetMetadata(
+    const std::string& baseUrl,
+    TilesetJson& tilesetJson,
+    TileExternalContent& externalContent) {
+  if (tilesetJson.schema) {
+    externalContent.metadata.schema = std::move(*tilesetJson.schema);
+  }
 
-      if (maybeChild) {
-        childTiles.emplace_back(std::move(*maybeChild));
-      }
-    }
+  if (tilesetJson.schemaUri) {
+    externalContent.metadata.schemaUri =
+        CesiumUtility::Uri::resolve(baseUrl, *tilesetJson.schemaUri);
   }
 
-  if (contentUri) {
-    Tile tile{&currentLoader};
-    tile.setTileID(contentUri);
-    tile.setTransform(tileTransform);
-    tile.setBoundingVolume(tileBoundingVolume);
-    tile.setViewerRequestVolume(tileViewerRequestVolume);
-    tile.setGeometricError(tileGeometricError);
-    tile.setRefine(tileRefine);
-    tile.setContentBoundingVolume(tileContentBoundingVolume);
-    tile.createChildTiles(std::move(childTiles));
-
-    return tile;
-  } else {
-    Tile tile{&currentLoader, TileEmptyContent{}};
-    tile.setTileID("");
-    tile.setTransform(tileTransform);
-    tile.setBoundingVolume(tileBoundingVolume);
-    tile.setViewerRequestVolume(tileViewerRequestVolume);
-    tile.setGeometricError(tileGeometricError);
-    tile.setRefine(tileRefine);
-    tile.setContentBoundingVolume(tileContentBoundingVolume);
-    tile.createChildTiles(std::move(childTiles));
+  if (tilesetJson.metadata) {
+    externalContent.metadata.metadata = std::move(*tilesetJson.metadata);
+  }
 
-    return tile;
+  if (tilesetJson.groups) {
+    externalContent.metadata.groups = std::move(*tilesetJson.groups);
   }
 }
 
 TilesetContentLoaderResult<TilesetJsonLoader> parseTilesetJson(
     const std::shared_ptr<spdlog::logger>& pLogger,
     const std::string& baseUrl,
-    const rapidjson::Document& tilesetJson,
+    const gsl::span<const std::byte>& data,
     const glm::dmat4& parentTransform,
     TileRefine parentRefine,
-    const CesiumGeospatial::Ellipsoid& ellipsoid) {
-  std::unique_ptr<Tile> pRootTile;
-  auto gltfUpAxis = obtainGltfUpAxis(tilesetJson, pLogger);
-  auto pLoader =
-      std::make_unique<TilesetJsonLoader>(baseUrl, gltfUpAxis, ellipsoid);
-  const auto rootIt = tilesetJson.FindMember("root");
-  if (rootIt != tilesetJson.MemberEnd()) {
-    const rapidjson::Value& rootJson = rootIt->value;
-    auto maybeRootTile = parseTileJsonRecursively(
-        pLogger,
-        rootJson,
-        parentTransform,
-        parentRefine,
-        10000000.0,
-        *pLoader,
-        ellipsoid);
+    const CesiumGeospatial::Ellipsoid& ellipsoid,
+    TileExternalContent& externalContent) {
+  // The tiles are created while the JSON is read, so the loader must exist
+  // before its up axis is known.
+  auto pLoader = std::make_unique<TilesetJsonLoader>(
+      baseUrl,
+      CesiumGeometry::Axis::Y,
+      ellipsoid);
 
-    if (maybeRootTile) {
-      pRootTile = std::make_unique<Tile>(std::move(*maybeRootTile));
-    }
+  TilesetJsonHandler handler(pLogger, *pLoader, ellipsoid);
+  CesiumJsonReader::ReadJsonResult<TilesetJson> tilesetJson =
+      CesiumJsonReader::JsonReader::readJson(data, handler);
+
+  TilesetContentLoaderResult<TilesetJsonLoader> result;
+  result.errors.errors = std::move(tilesetJson.errors);
+  result.errors.warnings = std::move(tilesetJson.warnings);
+  if (!tilesetJson.value) {
+    return result;
   }
 
-  return {
-      std::move(pLoader),
-      std::move(pRootTile),
-      std::vector<LoaderCreditResult>{},
-      std::vector<CesiumAsync::IAssetAccessor::THeader>{},
-      ErrorList{}};
-}
+  pLoader->setUpAxis(obtainGltfUpAxis(tilesetJson.value->gltfUpAxis, pLogger));
 
-void parseTilesetMetadata(
-    const std::string& baseUrl,
-    const rapidjson::Document& tilesetJson,
-    TileExternalContent& externalContent) {
-  auto schemaIt = tilesetJson.FindMember("schema");
-  if (schemaIt != tilesetJson.MemberEnd()) {
-    Cesium3DTilesReader::SchemaReader schemaReader;
-    auto schemaResult = schemaReader.readFromJson(schemaIt->value);
-    if (schemaResult.value) {
-      externalContent.metadata.schema = std::move(*schemaResult.value);
-    }
-  }
+  std::vector<Tile>& root = tilesetJson.value->root;
+  if (!root.empty()) {
+    std::vector<TileJsonProperties>::iterator propertiesIt =
+        tilesetJson.value->tileProperties.begin();
+    resolveTileJsonRecursively(
+        pLogger,
+        root[0],
+        propertiesIt,
+        parentTransform,
+        parentRefine,
+        10000000.0,
+        *pLoader);
+    CESIUM_ASSERT(propertiesIt == tilesetJson.value->tileProperties.end());
 
-  auto schemaUriIt = tilesetJson.FindMember("schemaUri");
-  if (schemaUriIt != tilesetJson.MemberEnd() && schemaUriIt->value.IsString()) {
-    externalContent.metadata.schemaUri =
-        CesiumUtility::Uri::resolve(baseUrl, schemaUriIt->value.GetString());
+    result.pRootTile = std::make_unique<Tile>(std::move(root[0]));
   }
 
-  const auto metadataIt = tilesetJson.FindMember("metadata");
-  if (metadataIt != tilesetJson.MemberEnd()) {
-    Cesium3DTilesReader::MetadataEntityReader metadataReader;
-    auto metadataResult = metadataReader.readFromJson(metadataIt->value);
-    if (metadataResult.value) {
-      externalContent.metadata.metadata = std::move(*metadataResult.value);
-    }
-  }
+  // Populate the root tile with metadata
+  parseTilesetMetadata(baseUrl, *tilesetJson.value, externalContent);
 
-  const auto groupsIt = tilesetJson.FindMember("groups");
-  if (groupsIt != tilesetJson.MemberEnd()) {
-    Cesium3DTilesReader::GroupMetadataReader groupMetadataReader;
-    auto groupsResult = groupMetadataReader.readArrayFromJson(groupsIt->value);
-    if (groupsResult.value) {
-      externalContent.metadata.groups = std::move(*groupsResult.value);
-    }
-  }
+  result.pLoader = std::move(pLoader);
+  return result;
 }
 
 TileLoadResult parseExternalTilesetInWorkerThread(
@@ -689,19 +464,6 @@ TileLoadResult parseExternalTilesetInWorkerThread(
   const auto& responseData = pResponse->data();
   const auto& tileUrl = pCompletedRequest->url();
 
-  rapidjson::Document tilesetJson;
-  tilesetJson.Parse(
-      reinterpret_cast<const char*>(responseData.data()),
-      responseData.size());
-  if (tilesetJson.HasParseError()) {
-    SPDLOG_LOGGER_ERROR(
-        pLogger,
-        "Error when parsing tileset JSON, error code {} at byte offset {}",
-        tilesetJson.GetParseError(),
-        tilesetJson.GetErrorOffset());
-    return TileLoadResult::createFailedResult(std::move(pCompletedRequest));
-  }
-
   // Save the parsed external tileset into custom data.
   // We will propagate it back to tile later in the main
   // thread
@@ -709,22 +471,16 @@ TileLoadResult parseExternalTilesetInWorkerThread(
       parseTilesetJson(
           pLogger,
           tileUrl,
-          tilesetJson,
+          responseData,
           tileTransform,
           tileRefine,
-          ellipsoid);
-
-  // Populate the root tile with metadata
-  parseTilesetMetadata(
-      tileUrl,
-      tilesetJson,
-      externalContentInitializer.externalContent);
+          ellipsoid,
+          externalContentInitializer.externalContent);
 
   // check and log any errors
   const auto& errors = externalTilesetLoader.errors;
+  logTileLoadResult(pLogger, tileUrl, errors);
   if (errors) {
-    logTileLoadResult(pLogger, tileUrl, errors);
-
     // since the json cannot be parsed, we don't know the content of this tile
     return TileLoadResult::createFailedResult(std::move(pCompletedRequest));
   }
@@ -746,6 +502,28 @@ TileLoadResult parseExternalTilesetInWorkerThread(
       ellipsoid};
 }
 
+/**
+ * @brief Creates the tile representing a tileset.json itself, whose only child
+ * is the root tile of the tileset and whose content holds its metadata.
+ */
+std::unique_ptr<Tile> createTilesetJsonTile(
+    Tile&& rootTile,
+    std::unique_ptr<TileExternalContent>&& pExternal) {
+  std::vector<Tile> children;
+  children.emplace_back(std::move(rootTile));
+
+  auto pTilesetJsonTile =
+      std::make_unique<Tile>(children[0].getLoader(), std::move(pExternal));
+
+  pTilesetJsonTile->setTileID("");
+  pTilesetJsonTile->shareTransform(children[0]);
+  pTilesetJsonTile->setBoundingVolume(children[0].getBoundingVolume());
+  pTilesetJsonTile->setUnconditionallyRefine();
+  pTilesetJsonTile->setRefine(children[0].getRefine());
+  pTilesetJsonTile->createChildTiles(std::move(children));
+
+  return pTilesetJsonTile;
+}
 } // namespace
 
 TilesetJsonLoader::TilesetJsonLoader(
@@ -765,7 +543,6 @@ TilesetJsonLoader::createLoader(
       ->get(externals.asyncSystem, tilesetJsonUrl, requestHeaders)
       .thenInWorkerThread([ellipsoid,
                            asyncSystem = externals.asyncSystem,
-                           pAssetAccessor = externals.pAssetAccessor,
                            pLogger = externals.pLogger](
                               const std::shared_ptr<CesiumAsync::IAssetRequest>&
                                   pCompletedRequest) {
@@ -791,74 +568,75 @@ TilesetJsonLoader::createLoader(
           return asyncSystem.createResolvedFuture(std::move(result));
         }
 
-        gsl::span<const std::byte> data = pResponse->data();
-
-        rapidjson::Document tilesetJson;
-        tilesetJson.Parse(
-            reinterpret_cast<const char*>(data.data()),
-            data.size());
-        if (tilesetJson.HasParseError()) {
-          TilesetContentLoaderResult<TilesetJsonLoader> result;
-          result.errors.emplaceError(fmt::format(
-              "Error when parsing tileset JSON, error code {} at byte offset "
-              "{}",
-              tilesetJson.GetParseError(),
-              tilesetJson.GetErrorOffset()));
-          return asyncSystem.createResolvedFuture(std::move(result));
-        }
-
-        return TilesetJsonLoader::createLoader(
-            asyncSystem,
-            pAssetAccessor,
-            pLogger,
-            pCompletedRequest->url(),
-            pCompletedRequest->headers(),
-            tilesetJson,
-            ellipsoid);
+        TilesetContentLoaderResult<TilesetJsonLoader> result =
+            TilesetJsonLoader::createLoader(
+                pLogger,
+                tileUrl,
+                pResponse->data(),
+                ellipsoid);
+        result.tilesetVersion =
+            TileProxyGenerator::getTilesetVersion(*pResponse);
+        return asyncSystem.createResolvedFuture(std::move(result));
       });
 }
 
-CesiumAsync::Future<TilesetContentLoaderResult<TilesetJsonLoader>>
-TilesetJsonLoader::createLoader(
-    const CesiumAsync::AsyncSystem& asyncSystem,
-    const std::shared_ptr<CesiumAsync::IAssetAccessor>& /*pAssetAccessor*/,
+TilesetContentLoaderResult<TilesetJsonLoader> TilesetJsonLoader::createLoader(
     const std::shared_ptr<spdlog::logger>& pLogger,
     const std::string& tilesetJsonUrl,
-    const CesiumAsync::HttpHeaders& /*requestHeaders*/,
-    const rapidjson::Document& tilesetJson,
+    const gsl::span<const std::byte>& tilesetJsonBinary,
     const CesiumGeospatial::Ellipsoid& ellipsoid) {
+  std::unique_ptr<TileExternalContent> pExternal =
+      std::make_unique<TileExternalContent>();
   TilesetContentLoaderResult<TilesetJsonLoader> result = parseTilesetJson(
       pLogger,
       tilesetJsonUrl,
-      tilesetJson,
+      tilesetJsonBinary,
       glm::dmat4(1.0),
       TileRefine::Replace,
-      ellipsoid);
+      ellipsoid,
+      *pExternal);
+  if (!result.pRootTile) {
+    if (!result.errors.hasErrors()) {
+      result.errors.emplaceError(
+          "Tileset JSON does not contain a valid root tile.");
+    }
+    result.pLoader.reset();
+    return result;
+  }
 
-  // Create a root tile to represent the tileset.json itself.
-  std::vector<Tile> children;
-  children.emplace_back(std::move(*result.pRootTile));
+  result.pRootTile =
+      createTilesetJsonTile(std::move(*result.pRootTile), std::move(pExternal));
+  return result;
+}
 
-  result.pRootTile = std::make_unique<Tile>(
-      children[0].getLoader(),
-      std::make_unique<TileExternalContent>());
+TilesetContentLoaderResult<TilesetJsonLoader>
+TilesetJsonLoader::createLoaderFromSnapshot(
+    const std::string& tilesetJsonUrl,
+    const gsl::span<const std::byte>& snapshot,
+    const std::string& validator,
+    const CesiumGeospatial::Ellipsoid& ellipsoid) {
+  auto pLoader = std::make_unique<TilesetJsonLoader>(
+      tilesetJsonUrl,
+      CesiumGeometry::Axis::Y,
+      ellipsoid);
+  std::unique_ptr<TileExternalContent> pExternal =
+      std::make_unique<TileExternalContent>();
 
-  result.pRootTile->setTileID("");
-  result.pRootTile->setTransform(children[0].getTransform());
-  result.pRootTile->setBoundingVolume(children[0].getBoundingVolume());
-  result.pRootTile->setUnconditionallyRefine();
-  result.pRootTile->setRefine(children[0].getRefine());
-  result.pRootTile->createChildTiles(std::move(children));
+  std::optional<Tile> maybeRootTile = TileHierarchySnapshot::read(
+      snapshot,
+      validator,
+      ellipsoid,
+      *pLoader,
+      *pExternal);
 
-  // Populate the root tile with metadata
-  TileExternalContent* pExternal =
-      result.pRootTile->getContent().getExternalContent();
-  CESIUM_ASSERT(pExternal);
-  if (pExternal) {
-    parseTilesetMetadata(tilesetJsonUrl, tilesetJson, *pExternal);
+  TilesetContentLoaderResult<TilesetJsonLoader> result;
+  if (maybeRootTile) {
+    result.pLoader = std::move(pLoader);
+    result.pRootTile =
+        createTilesetJsonTile(std::move(*maybeRootTile), std::move(pExternal));
   }
 
-  return asyncSystem.createResolvedFuture(std::move(result));
+  return result;
 }
 
 CesiumAsync::Future<TileLoadResult>
@@ -947,6 +725,7 @@ TilesetJsonLoader::loadTileContent(const TileLoadInput& loadInput) {
               contentOptions.ktx2TranscodeTargets;
           gltfOptions.applyTextureTransform =
               contentOptions.applyTextureTransform;
+          gltfOptions.pSharedImageCache = contentOptions.pSharedImageCache;
           return converter(responseData, gltfOptions, assetFetcher)
               .thenImmediately(
                   [ellipsoid, pLogger, upAxis, tileUrl, pCompletedRequest](
@@ -982,6 +761,20 @@ TilesetJsonLoader::loadTileContent(const TileLoadInput& loadInput) {
       });
 }
 
+std::string TilesetJsonLoader::getTileContentKey(const Tile& tile) const {
+  const TilesetContentLoader* pLoader = tile.getLoader();
+  if (pLoader != this) {
+    return pLoader->getTileContentKey(tile);
+  }
+
+  const std::string* pUrl = std::get_if<std::string>(&tile.getTileID());
+  if (!pUrl || pUrl->empty()) {
+    return std::string();
+  }
+
+  return CesiumUtility::Uri::resolve(this->_baseUrl, *pUrl, true);
+}
+
 TileChildrenResult TilesetJsonLoader::createTileChildren(
     const Tile& tile,
     const CesiumGeospatial::Ellipsoid& ellipsoid) {
@@ -1001,6 +794,65 @@ CesiumGeometry::Axis TilesetJsonLoader::getUpAxis() const noexcept {
   return _upAxis;
 }
 
+void TilesetJsonLoader::setUpAxis(CesiumGeometry::Axis upAxis) noexcept {
+  this->_upAxis = upAxis;
+}
+
+void TilesetJsonLoader::addImplicitTileset(
+    Tile& tile,
+    const std::string& subdivisionScheme,
+    const std::string& contentUriTemplate,
+    const std::string& subtreeUriTemplate,
+    uint32_t subtreeLevels,
+    uint32_t availableLevels) {
+  if (subdivisionScheme ==
+      Cesium3DTiles::ImplicitTiling::SubdivisionScheme::QUADTREE) {
+    createImplicitQuadtreeLoader(
+        contentUriTemplate,
+        subtreeUriTemplate,
+        subtreeLevels,
+        availableLevels,
+        tile,
+        *this);
+  } else if (
+      subdivisionScheme ==
+      Cesium3DTiles::ImplicitTiling::SubdivisionScheme::OCTREE) {
+    createImplicitOctreeLoader(
+        contentUriTemplate,
+        subtreeUriTemplate,
+        subtreeLevels,
+        availableLevels,
+        tile,
+        *this);
+  }
+}
+
+void TilesetJsonLoader::releaseTileChildren(const Tile& tile) {
+  auto pLoader = tile.getLoader();
+  if (pLoader != this) {
+    pLoader->releaseTileChildren(tile);
+    return;
+  }
+
+  // The loader of an external tileset is only used by the tiles below the
+  // tile that loaded it.
+  if (!tile.isExternalContent() || tile.getChildren().empty()) {
+    return;
+  }
+
+  const TilesetContentLoader* pExternalLoader =
+      tile.getChildren()[0].getLoader();
+  auto it = std::find_if(
+      this->_children.begin(),
+      this->_children.end(),
+      [pExternalLoader](const std::unique_ptr<TilesetContentLoader>& pChild) {
+        return pChild.get() == pExternalLoader;
+      });
+  if (it != this->_children.end()) {
+    this->_children.erase(it);
+  }
+}
+
 void TilesetJsonLoader::addChildLoader(
     std::unique_ptr<TilesetContentLoader> pLoader) {
   this->_children.emplace_back(std::move(pLoader));
@@ -7,8 +7,10 @@
 #include <CesiumAsync/Future.h>
 #include <CesiumAsync/IAssetAccessor.h>
 
-#include <rapidjson/fwd.h>
+#include <gsl/span>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -29,6 +31,10 @@ public:
       const CesiumGeospatial::Ellipsoid& ellipsoid
           CESIUM_DEFAULT_ELLIPSOID) override;
 
+  std::string getTileContentKey(const Tile& tile) const override;
+
+  void releaseTileChildren(const Tile& tile) override;
+
   const std::string& getBaseUrl() const noexcept;
 
   CesiumGeometry::Axis getUpAxis() const noexcept;
@@ -42,14 +48,62 @@ public:
       const std::vector<CesiumAsync::IAssetAccessor::THeader>& requestHeaders,
       const CesiumGeospatial::Ellipsoid& ellipsoid CESIUM_DEFAULT_ELLIPSOID);
 
-  static CesiumAsync::Future<TilesetContentLoaderResult<TilesetJsonLoader>>
-  createLoader(
-      const CesiumAsync::AsyncSystem& asyncSystem,
-      const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAssetAccessor,
+  /**
+   * @brief Creates a loader from the bytes of a tileset.json.
+   *
+   * The tiles are created while the JSON is read, without first reading it
+   * into a document. If the JSON cannot be read or does not have a valid root
+   * tile, the result has errors and no root tile.
+   */
+  static TilesetContentLoaderResult<TilesetJsonLoader> createLoader(
       const std::shared_ptr<spdlog::logger>& pLogger,
       const std::string& tilesetJsonUrl,
-      const CesiumAsync::HttpHeaders& requestHeaders,
-      const rapidjson::Document& tilesetJson,
+      const gsl::span<const std::byte>& tilesetJsonBinary,
+      const CesiumGeospatial::Ellipsoid& ellipsoid CESIUM_DEFAULT_ELLIPSOID);
+
+  /**
+   * @brief Sets the axis that is declared as the "up-axis" for glTF content.
+   *
+   * This is needed because the tiles referencing this loader are created
+   * before the `asset` of the tileset.json may have been read.
+   */
+  void setUpAxis(CesiumGeometry::Axis upAxis) noexcept;
+
+  /**
+   * @brief Makes the given tile the parent of the root of an implicit tileset,
+   * loaded by a new child loader of this loader.
+   *
+   * Nothing is added if the subdivision scheme is unknown or cannot be used
+   * with the bounding volume of the tile.
+   *
+   * @param tile The tile with implicit tiling, whose transform, bounding
+   * volume, geometric error, and refinement are already final.
+   * @param subdivisionScheme One of the
+   * `Cesium3DTiles::ImplicitTiling::SubdivisionScheme` values.
+   * @param contentUriTemplate The template of the content URIs.
+   * @param subtreeUriTemplate The template of the subtree URIs.
+   * @param subtreeLevels The number of levels in each subtree.
+   * @param availableLevels The number of levels with available tiles.
+   */
+  void addImplicitTileset(
+      Tile& tile,
+      const std::string& subdivisionScheme,
+      const std::string& contentUriTemplate,
+      const std::string& subtreeUriTemplate,
+      uint32_t subtreeLevels,
+      uint32_t availableLevels);
+
+  /**
+   * @brief Creates a loader from a snapshot of a tileset.json written by
+   * {@link TileHierarchySnapshot::write}.
+   *
+   * If the snapshot is invalid or was not written for the given validator and
+   * ellipsoid, the result has no root tile.
+   */
+  static TilesetContentLoaderResult<TilesetJsonLoader> createLoaderFromSnapshot(
+      const std::string& tilesetJsonUrl,
+      const gsl::span<const std::byte>& snapshot,
+      const std::string& validator,
       const CesiumGeospatial::Ellipsoid& ellipsoid CESIUM_DEFAULT_ELLIPSOID);
 
 private:
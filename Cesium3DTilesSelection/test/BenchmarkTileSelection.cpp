@@ -0,0 +1,172 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
+#include "Cesium3DTilesContent/registerAllTileContentTypes.h"
+#include "Cesium3DTilesSelection/Tileset.h"
+#include "Cesium3DTilesSelection/ViewState.h"
+#include "SimplePrepareRendererResource.h"
+
+#include <CesiumGeospatial/Ellipsoid.h>
+#include <CesiumNativeTests/SimpleAssetAccessor.h>
+#include <CesiumNativeTests/SimpleAssetRequest.h>
+#include <CesiumNativeTests/SimpleAssetResponse.h>
+#include <CesiumNativeTests/SimpleTaskProcessor.h>
+#include <CesiumNativeTests/readFile.h>
+#include <CesiumUtility/Math.h>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace CesiumAsync;
+using namespace Cesium3DTilesSelection;
+using namespace CesiumGeospatial;
+using namespace CesiumUtility;
+using namespace CesiumNativeTests;
+
+namespace {
+ViewState createViewState(const glm::dvec3& position, const glm::dvec3& focus) {
+  glm::dvec2 viewPortSize{500.0, 500.0};
+  double aspectRatio = viewPortSize.x / viewPortSize.y;
+  double horizontalFieldOfView = Math::degreesToRadians(60.0);
+  double verticalFieldOfView =
+      std::atan(std::tan(horizontalFieldOfView * 0.5) / aspectRatio) * 2.0;
+  return ViewState::create(
+      position,
+      glm::normalize(focus - position),
+      glm::dvec3(0.0, 0.0, 1.0),
+      viewPortSize,
+      horizontalFieldOfView,
+      verticalFieldOfView,
+      Ellipsoid::WGS84);
+}
+
+// Creates a tileset with all of its tiles loaded for two views, which are
+// added to the given list.
+std::unique_ptr<Tileset> createLoadedTileset(std::vector<ViewState>& views) {
+  Cesium3DTilesContent::registerAllTileContentTypes();
+
+  std::filesystem::path testDataPath = Cesium3DTilesSelection_TEST_DATA_DIR;
+  testDataPath = testDataPath / "ReplaceTileset";
+  std::vector<std::string> files{
+      "tileset.json",
+      "parent.b3dm",
+      "ll.b3dm",
+      "lr.b3dm",
+      "ul.b3dm",
+      "ur.b3dm",
+      "ll_ll.b3dm",
+  };
+
+  std::map<std::string, std::shared_ptr<SimpleAssetRequest>>
+      mockCompletedRequests;
+  for (const auto& file : files) {
+    std::unique_ptr<SimpleAssetResponse> mockCompletedResponse =
+        std::make_unique<SimpleAssetResponse>(
+            static_cast<uint16_t>(200),
+            "doesn't matter",
+            CesiumAsync::HttpHeaders{},
+            readFile(testDataPath / file));
+    mockCompletedRequests.insert(
+        {file,
+         std::make_shared<SimpleAssetRequest>(
+             "GET",
+             file,
+             CesiumAsync::HttpHeaders{},
+             std::move(mockCompletedResponse))});
+  }
+
+  std::shared_ptr<SimpleAssetAccessor> mockAssetAccessor =
+      std::make_shared<SimpleAssetAccessor>(std::move(mockCompletedRequests));
+  TilesetExternals tilesetExternals{
+      mockAssetAccessor,
+      std::make_shared<SimplePrepareRendererResource>(),
+      AsyncSystem(std::make_shared<SimpleTaskProcessor>()),
+      nullptr};
+
+  std::unique_ptr<Tileset> pTileset =
+      std::make_unique<Tileset>(tilesetExternals, "tileset.json");
+  pTileset->getOptions().enablePerViewRenderLists = true;
+
+  // Load the tileset.json so that the views can be placed around its root.
+  const Ellipsoid& ellipsoid = Ellipsoid::WGS84;
+  pTileset->updateView({createViewState(
+      ellipsoid.cartographicToCartesian(
+          Cartographic::fromDegrees(118.0, 32.0, 200.0)),
+      ellipsoid.cartographicToCartesian(
+          Cartographic::fromDegrees(118.5, 32.5, 0.0)))});
+
+  const Tile* pTilesetJson = pTileset->getRootTile();
+  REQUIRE(pTilesetJson);
+  REQUIRE(pTilesetJson->getChildren().size() == 1);
+  const Tile& root = pTilesetJson->getChildren()[0];
+  const BoundingRegion* pRegion =
+      std::get_if<BoundingRegion>(&root.getBoundingVolume());
+  REQUIRE(pRegion);
+
+  Cartographic corner = pRegion->getRectangle().getNorthwest();
+  corner.height = pRegion->getMaximumHeight();
+  const glm::dvec3 position = ellipsoid.cartographicToCartesian(corner);
+  const glm::dvec3 focus = ellipsoid.cartographicToCartesian(
+      pRegion->getRectangle().computeCenter());
+  const glm::dvec3 zoomOutPosition =
+      position - glm::normalize(focus - position) * 2500.0;
+
+  views.emplace_back(createViewState(position, focus));
+  views.emplace_back(createViewState(zoomOutPosition, focus));
+
+  // Load the tiles and let the lists of the tileset grow to size.
+  for (int32_t i = 0; i < 4; ++i) {
+    pTileset->updateView(views);
+  }
+  for (const Tile& child : root.getChildren()) {
+    REQUIRE(child.getState() == TileLoadState::Done);
+  }
+
+  return pTileset;
+}
+} // namespace
+
+TEST_CASE("Tile selection does not allocate once its lists have grown") {
+  std::vector<ViewState> views;
+  std::unique_ptr<Tileset> pTileset = createLoadedTileset(views);
+
+  const ViewUpdateResult& first = pTileset->updateView(views);
+  const Tile* const* pTilesToRender = first.tilesToRenderThisFrame.data();
+  const size_t tilesToRenderCapacity = first.tilesToRenderThisFrame.capacity();
+  REQUIRE(!first.tilesToRenderThisFrame.empty());
+  REQUIRE(first.tilesToRenderPerView.size() == views.size());
+
+  for (int32_t i = 0; i < 8; ++i) {
+    const ViewUpdateResult& result = pTileset->updateView(views);
+    CHECK(result.selectionAllocations == 0);
+    CHECK(result.tilesToRenderThisFrame.data() == pTilesToRender);
+    CHECK(result.tilesToRenderThisFrame.capacity() == tilesToRenderCapacity);
+  }
+
+  SECTION("but counts the allocations when another view is added") {
+    const ViewState extraView = views.front();
+    views.push_back(extraView);
+    const ViewUpdateResult& result = pTileset->updateView(views);
+    CHECK(result.selectionAllocations > 0);
+
+    // and stops again once the lists have grown
+    CHECK(pTileset->updateView(views).selectionAllocations == 0);
+  }
+}
+
+// These are hidden by default. Run them with:
+//   cesium-native-tests "[benchmark]"
+TEST_CASE("Tile selection with several views", "[.][benchmark]") {
+  std::vector<ViewState> views;
+  std::unique_ptr<Tileset> pTileset = createLoadedTileset(views);
+
+  BENCHMARK("updateView with all tiles loaded") {
+    return pTileset->updateView(views).tilesToRenderThisFrame.size();
+  };
+}
+
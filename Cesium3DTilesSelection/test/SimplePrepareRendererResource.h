@@ -2,6 +2,7 @@
 
 #include "Cesium3DTilesSelection/IPrepareRendererResources.h"
 #include "Cesium3DTilesSelection/Tile.h"
+#include "Cesium3DTilesSelection/TileRenderBatch.h"
 #include "CesiumRasterOverlays/RasterOverlayTile.h"
 
 #include <catch2/catch.hpp>
@@ -115,5 +116,41 @@ public:
       int32_t /*overlayTextureCoordinateID*/,
       const CesiumRasterOverlays::RasterOverlayTile& /*rasterTile*/,
       void* /*pMainThreadRendererResources*/) noexcept override {}
+
+  virtual void* prepareBatchInLoadThread(
+      CesiumGltf::Model& /*model*/,
+      const glm::dmat4& /*transform*/,
+      const std::any& /*rendererOptions*/) override {
+    return new AllocationResult{totalAllocation};
+  }
+
+  virtual void* prepareBatchInMainThread(
+      Cesium3DTilesSelection::TileRenderBatch& /*batch*/,
+      void* pLoadThreadResult) override {
+    if (pLoadThreadResult) {
+      AllocationResult* loadThreadResult =
+          reinterpret_cast<AllocationResult*>(pLoadThreadResult);
+      delete loadThreadResult;
+    }
+
+    return new AllocationResult{totalAllocation};
+  }
+
+  virtual void freeBatch(
+      Cesium3DTilesSelection::TileRenderBatch& /*batch*/,
+      void* pLoadThreadResult,
+      void* pMainThreadResult) noexcept override {
+    if (pMainThreadResult) {
+      AllocationResult* mainThreadResult =
+          reinterpret_cast<AllocationResult*>(pMainThreadResult);
+      delete mainThreadResult;
+    }
+
+    if (pLoadThreadResult) {
+      AllocationResult* loadThreadResult =
+          reinterpret_cast<AllocationResult*>(pLoadThreadResult);
+      delete loadThreadResult;
+    }
+  }
 };
 } // namespace Cesium3DTilesSelection
@@ -0,0 +1,172 @@
+#include "CesiumIonTilesetLoader.h"
+
+#include <Cesium3DTilesSelection/Tile.h>
+#include <CesiumNativeTests/SimpleAssetAccessor.h>
+#include <CesiumNativeTests/SimpleAssetRequest.h>
+#include <CesiumNativeTests/SimpleAssetResponse.h>
+#include <CesiumNativeTests/SimpleTaskProcessor.h>
+
+#include <catch2/catch.hpp>
+#include <modp_b64.h>
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace Cesium3DTilesSelection;
+using namespace CesiumAsync;
+using namespace CesiumGeospatial;
+using namespace CesiumNativeTests;
+
+namespace {
+class AuthorizedTilesetContentLoader : public TilesetContentLoader {
+public:
+  AuthorizedTilesetContentLoader(std::set<std::string> acceptedTokens_)
+      : acceptedTokens{std::move(acceptedTokens_)} {}
+
+  CesiumAsync::Future<TileLoadResult>
+  loadTileContent(const TileLoadInput& input) override {
+    ++this->loadCount;
+
+    uint16_t statusCode = 401;
+    for (const IAssetAccessor::THeader& header : input.requestHeaders) {
+      if (header.first == "Authorization" &&
+          this->acceptedTokens.count(header.second.substr(7)) > 0) {
+        statusCode = 200;
+      }
+    }
+
+    TileLoadResult result = TileLoadResult::createFailedResult(
+        std::make_shared<SimpleAssetRequest>(
+            "GET",
+            "tile.glb",
+            HttpHeaders{},
+            std::make_unique<SimpleAssetResponse>(
+                statusCode,
+                "doesn't matter",
+                HttpHeaders{},
+                std::vector<std::byte>{})));
+    if (statusCode == 200) {
+      result.contentKind = TileEmptyContent{};
+      result.state = TileLoadResultState::Success;
+    }
+
+    return input.asyncSystem.createResolvedFuture(std::move(result));
+  }
+
+  TileChildrenResult createTileChildren(
+      [[maybe_unused]] const Tile& tile,
+      [[maybe_unused]] const Ellipsoid& ellipsoid) override {
+    return {{}, TileLoadResultState::Failed};
+  }
+
+  std::set<std::string> acceptedTokens;
+  int32_t loadCount = 0;
+};
+
+std::string createToken(std::chrono::system_clock::time_point expiration) {
+  const std::string payload =
+      "{\"exp\":" +
+      std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+                         expiration.time_since_epoch())
+                         .count()) +
+      "}";
+  std::string encoded(modp_b64_encode_len(payload.size()), '\0');
+  const size_t length =
+      modp_b64_encode(encoded.data(), payload.data(), payload.size());
+  encoded.resize(length);
+  return "e30." + encoded + ".c2ln";
+}
+} // namespace
+
+TEST_CASE("Test the Cesium ion loader's access token refresh") {
+  const std::string endpointUrl =
+      "https://api.cesium.com/v1/assets/1/endpoint?access_token=ion-token";
+  const std::string newToken = "new-token";
+  const std::string endpointJson = "{\"accessToken\":\"" + newToken + "\"}";
+
+  std::map<std::string, std::shared_ptr<SimpleAssetRequest>> mockRequests;
+  mockRequests[endpointUrl] = std::make_shared<SimpleAssetRequest>(
+      "GET",
+      endpointUrl,
+      HttpHeaders{},
+      std::make_unique<SimpleAssetResponse>(
+          static_cast<uint16_t>(200),
+          "doesn't matter",
+          HttpHeaders{},
+          std::vector<std::byte>(
+              reinterpret_cast<const std::byte*>(endpointJson.data()),
+              reinterpret_cast<const std::byte*>(
+                  endpointJson.data() + endpointJson.size()))));
+
+  std::shared_ptr<IAssetAccessor> pAssetAccessor =
+      std::make_shared<SimpleAssetAccessor>(std::move(mockRequests));
+  AsyncSystem asyncSystem{std::make_shared<SimpleTaskProcessor>()};
+  std::shared_ptr<spdlog::logger> pLogger = spdlog::default_logger();
+  TilesetContentOptions contentOptions;
+
+  const auto now = std::chrono::system_clock::now();
+  std::string oldToken;
+  std::set<std::string> acceptedTokens{newToken};
+
+  SECTION("a request rejected with 401 is sent again with the new token") {
+    oldToken = "old-token";
+  }
+
+  SECTION("requests wait for the new token once the old one has expired") {
+    oldToken = createToken(now - std::chrono::seconds(10));
+  }
+
+  SECTION("a token about to expire is renewed while it is still used") {
+    oldToken = createToken(now + std::chrono::seconds(60));
+    acceptedTokens.insert(oldToken);
+  }
+
+  std::vector<IAssetAccessor::THeader> requestHeaders{
+      {"Authorization", "Bearer " + oldToken}};
+
+  auto pAggregatedLoader =
+      std::make_unique<AuthorizedTilesetContentLoader>(acceptedTokens);
+  AuthorizedTilesetContentLoader* pAggregated = pAggregatedLoader.get();
+
+  CesiumIonTilesetLoader loader(
+      1,
+      "ion-token",
+      "https://api.cesium.com/",
+      oldToken,
+      std::move(pAggregatedLoader),
+      [&requestHeaders](
+          const std::string& header,
+          const std::string& headerValue) {
+        requestHeaders = {{header, headerValue}};
+      },
+      std::make_shared<EndpointCache>(),
+      Ellipsoid::WGS84);
+
+  Tile tile(&loader);
+  TileLoadInput loadInput{
+      tile,
+      contentOptions,
+      asyncSystem,
+      pAssetAccessor,
+      pLogger,
+      requestHeaders,
+      Ellipsoid::WGS84};
+
+  TileLoadResult result = loader.loadTileContent(loadInput).waitInMainThread();
+  asyncSystem.dispatchMainThreadTasks();
+
+  CHECK(result.state == TileLoadResultState::Success);
+  REQUIRE(requestHeaders.size() == 1);
+  CHECK(requestHeaders[0].second == "Bearer " + newToken);
+
+  if (oldToken == "old-token") {
+    CHECK(pAggregated->loadCount == 2);
+  } else {
+    // The request was sent only once, with a token that was accepted.
+    CHECK(pAggregated->loadCount == 1);
+  }
+}
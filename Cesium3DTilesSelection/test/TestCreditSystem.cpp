@@ -146,3 +146,54 @@ TEST_CASE("Test setting showOnScreen on credits") {
   CHECK(creditSystem.shouldBeShownOnScreen(credit1) == true);
   CHECK(creditSystem.shouldBeShownOnScreen(credit2) == true);
 }
+
+TEST_CASE("Test creating the same credit again") {
+
+  CreditSystem creditSystem;
+
+  std::vector<Credit> credits;
+  for (int i = 0; i < 100; i++) {
+    credits.emplace_back(creditSystem.createCredit(
+        "<html>Credit" + std::to_string(i) + "</html>"));
+  }
+
+  for (int i = 0; i < 100; i++) {
+    std::string html = "<html>Credit" + std::to_string(i) + "</html>";
+    CHECK(creditSystem.createCredit(html) == credits[size_t(i)]);
+    CHECK(creditSystem.createCredit(std::move(html)) == credits[size_t(i)]);
+    CHECK(
+        creditSystem.getHtml(credits[size_t(i)]) ==
+        "<html>Credit" + std::to_string(i) + "</html>");
+  }
+
+  Credit credit = creditSystem.createCredit("<html>Credit0</html>", true);
+  CHECK(credit == credits[0]);
+  CHECK(creditSystem.shouldBeShownOnScreen(credits[0]));
+}
+
+TEST_CASE("Test credits shown again after the hidden credits are read") {
+
+  CreditSystem creditSystem;
+
+  Credit credit0 = creditSystem.createCredit("<html>Credit0</html>");
+  Credit credit1 = creditSystem.createCredit("<html>Credit1</html>");
+
+  creditSystem.addCreditToFrame(credit0);
+  creditSystem.addCreditToFrame(credit1);
+  creditSystem.startNextFrame();
+
+  std::vector<Credit> expectedHide0{credit0, credit1};
+  REQUIRE(creditSystem.getCreditsToNoLongerShowThisFrame() == expectedHide0);
+
+  creditSystem.addCreditToFrame(credit1);
+
+  std::vector<Credit> expectedHide1{credit0};
+  REQUIRE(creditSystem.getCreditsToNoLongerShowThisFrame() == expectedHide1);
+
+  creditSystem.addCreditToFrame(credit0);
+  creditSystem.addCreditToFrame(credit0);
+
+  std::vector<Credit> expectedShow{credit0, credit1};
+  REQUIRE(creditSystem.getCreditsToShowThisFrame() == expectedShow);
+  REQUIRE(creditSystem.getCreditsToNoLongerShowThisFrame().empty());
+}
@@ -544,4 +544,42 @@ TEST_CASE("Test tile subdivision for implicit quadtree loader") {
         std::get<S2CellBoundingVolume>(tile_1_1_1.getBoundingVolume());
     CHECK(box_1_1_1.getCellID().toToken() == "14");
   }
+
+  SECTION("Children share the transform of their parent") {
+    OrientedBoundingBox loaderBoundingVolume{glm::dvec3(0.0), glm::dmat3(20.0)};
+    ImplicitQuadtreeLoader loader{
+        "tileset.json",
+        "content/{level}.{x}.{y}.b3dm",
+        "subtrees/{level}.{x}.{y}.json",
+        5,
+        5,
+        loaderBoundingVolume};
+
+    loader.addSubtreeAvailability(
+        QuadtreeTileID{0, 0, 0},
+        SubtreeAvailability{
+            ImplicitTileSubdivisionScheme::Quadtree,
+            5,
+            SubtreeAvailability::SubtreeConstantAvailability{true},
+            SubtreeAvailability::SubtreeConstantAvailability{false},
+            {SubtreeAvailability::SubtreeConstantAvailability{true}},
+            {}});
+
+    Tile tile(&loader);
+    tile.setTileID(QuadtreeTileID(0, 0, 0));
+    tile.setBoundingVolume(loaderBoundingVolume);
+    CHECK(tile.getTransform() == glm::dmat4(1.0));
+
+    glm::dmat4 transform(1.0);
+    transform[3] = glm::dvec4(1.0, 2.0, 3.0, 1.0);
+    tile.setTransform(transform);
+
+    auto tileChildrenResult = loader.createTileChildren(tile);
+    CHECK(tileChildrenResult.state == TileLoadResultState::Success);
+    REQUIRE(tileChildrenResult.children.size() == 4);
+    for (const Tile& child : tileChildrenResult.children) {
+      CHECK(child.getTransform() == transform);
+      CHECK(&child.getTransform() == &tile.getTransform());
+    }
+  }
 }
@@ -0,0 +1,183 @@
+#include <Cesium3DTilesSelection/SoftwareOcclusionCuller.h>
+#include <Cesium3DTilesSelection/Tile.h>
+#include <Cesium3DTilesSelection/TileContent.h>
+#include <CesiumGeometry/Axis.h>
+#include <CesiumGeometry/OrientedBoundingBox.h>
+#include <CesiumGeospatial/Ellipsoid.h>
+#include <CesiumGltf/Model.h>
+#include <CesiumUtility/Math.h>
+
+#include <catch2/catch.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace Cesium3DTilesSelection;
+using namespace CesiumGeometry;
+using namespace CesiumGeospatial;
+using namespace CesiumUtility;
+
+namespace {
+// Creates a square of the given half size facing the X axis, at the given
+// distance along it.
+CesiumGltf::Model createWall(double distance, float halfSize) {
+  const std::vector<glm::vec3> positions{
+      {0.0f, -halfSize, -halfSize},
+      {0.0f, halfSize, -halfSize},
+      {0.0f, halfSize, halfSize},
+      {0.0f, -halfSize, halfSize}};
+  const std::vector<uint16_t> indices{0, 1, 2, 0, 2, 3};
+
+  CesiumGltf::Model model;
+  model.extras["gltfUpAxis"] = static_cast<int64_t>(Axis::Z);
+
+  CesiumGltf::Buffer& buffer = model.buffers.emplace_back();
+  const size_t positionsSize = positions.size() * sizeof(glm::vec3);
+  const size_t indicesSize = indices.size() * sizeof(uint16_t);
+  buffer.byteLength = int64_t(positionsSize + indicesSize);
+  buffer.cesium.data.resize(positionsSize + indicesSize);
+  std::memcpy(buffer.cesium.data.data(), positions.data(), positionsSize);
+  std::memcpy(
+      buffer.cesium.data.data() + positionsSize,
+      indices.data(),
+      indicesSize);
+
+  CesiumGltf::BufferView& positionsView = model.bufferViews.emplace_back();
+  positionsView.buffer = 0;
+  positionsView.byteLength = int64_t(positionsSize);
+
+  CesiumGltf::BufferView& indicesView = model.bufferViews.emplace_back();
+  indicesView.buffer = 0;
+  indicesView.byteOffset = int64_t(positionsSize);
+  indicesView.byteLength = int64_t(indicesSize);
+
+  CesiumGltf::Accessor& positionsAccessor = model.accessors.emplace_back();
+  positionsAccessor.bufferView = 0;
+  positionsAccessor.componentType = CesiumGltf::Accessor::ComponentType::FLOAT;
+  positionsAccessor.count = int64_t(positions.size());
+  positionsAccessor.type = CesiumGltf::Accessor::Type::VEC3;
+
+  CesiumGltf::Accessor& indicesAccessor = model.accessors.emplace_back();
+  indicesAccessor.bufferView = 1;
+  indicesAccessor.componentType =
+      CesiumGltf::Accessor::ComponentType::UNSIGNED_SHORT;
+  indicesAccessor.count = int64_t(indices.size());
+  indicesAccessor.type = CesiumGltf::Accessor::Type::SCALAR;
+
+  CesiumGltf::MeshPrimitive& primitive =
+      model.meshes.emplace_back().primitives.emplace_back();
+  primitive.attributes["POSITION"] = 0;
+  primitive.indices = 1;
+
+  CesiumGltf::Node& node = model.nodes.emplace_back();
+  node.translation = {distance, 0.0, 0.0};
+  node.mesh = 0;
+
+  model.scenes.emplace_back().nodes.emplace_back(0);
+  model.scene = 0;
+
+  return model;
+}
+
+ViewState createView(const glm::dvec3& position, const glm::dvec3& direction) {
+  return ViewState::create(
+      position,
+      direction,
+      glm::dvec3(0.0, 0.0, 1.0),
+      glm::dvec2(64.0, 64.0),
+      Math::degreesToRadians(60.0),
+      Math::degreesToRadians(60.0),
+      Ellipsoid::WGS84);
+}
+
+BoundingVolume createBox(const glm::dvec3& center) {
+  return OrientedBoundingBox(center, glm::dmat3(10.0));
+}
+} // namespace
+
+TEST_CASE("Test SoftwareOcclusionCuller") {
+  SoftwareOcclusionCuller culler(16, 64, 64, Ellipsoid::WGS84);
+
+  Tile wall(nullptr);
+  wall.getContent().setContentKind(
+      std::make_unique<TileRenderContent>(createWall(100.0, 30.0f)));
+
+  const std::vector<ViewState> views{
+      createView(glm::dvec3(0.0), glm::dvec3(1.0, 0.0, 0.0))};
+  const std::vector<Tile*> occluders{&wall};
+
+  const BoundingVolume hidden = createBox(glm::dvec3(500.0, 0.0, 0.0));
+  const BoundingVolume inFront = createBox(glm::dvec3(50.0, 0.0, 0.0));
+  const BoundingVolume beside = createBox(glm::dvec3(500.0, 250.0, 0.0));
+
+  SECTION("Nothing is occluded before the first update") {
+    CHECK(
+        culler.computeOcclusionState(hidden) ==
+        TileOcclusionState::NotOccluded);
+  }
+
+  SECTION("Bounding volumes behind occluders are occluded") {
+    culler.update(views, occluders);
+    CHECK(culler.computeOcclusionState(hidden) == TileOcclusionState::Occluded);
+    CHECK(
+        culler.computeOcclusionState(inFront) ==
+        TileOcclusionState::NotOccluded);
+    CHECK(
+        culler.computeOcclusionState(beside) ==
+        TileOcclusionState::NotOccluded);
+  }
+
+  SECTION("Bounding volumes outside of the view are not occluded") {
+    culler.update(views, occluders);
+    const BoundingVolume offScreen = createBox(glm::dvec3(500.0, 1000.0, 0.0));
+    const BoundingVolume behind = createBox(glm::dvec3(-500.0, 0.0, 0.0));
+    CHECK(
+        culler.computeOcclusionState(offScreen) ==
+        TileOcclusionState::NotOccluded);
+    CHECK(
+        culler.computeOcclusionState(behind) ==
+        TileOcclusionState::NotOccluded);
+  }
+
+  SECTION("Pixels along the silhouette of occluders do not occlude") {
+    // The wall covers the center of the pixel that this small box projects
+    // into, but not the part of the pixel where the box is.
+    culler.update(views, occluders);
+    const BoundingVolume besideEdge =
+        OrientedBoundingBox(glm::dvec3(500.0, 151.5, 0.0), glm::dmat3(0.5));
+    CHECK(
+        culler.computeOcclusionState(besideEdge) ==
+        TileOcclusionState::NotOccluded);
+  }
+
+  SECTION("Bounding volumes must be occluded in every view") {
+    std::vector<ViewState> twoViews = views;
+    twoViews.emplace_back(createView(
+        glm::dvec3(500.0, -1000.0, 0.0),
+        glm::dvec3(0.0, 1.0, 0.0)));
+    culler.update(twoViews, occluders);
+    CHECK(
+        culler.computeOcclusionState(hidden) ==
+        TileOcclusionState::NotOccluded);
+  }
+
+  SECTION("Proxies report the occlusion of their tiles") {
+    Tile tile(nullptr);
+    tile.setBoundingVolume(hidden);
+
+    const TileOcclusionRendererProxy* pProxy =
+        culler.fetchOcclusionProxyForTile(tile, 0);
+    REQUIRE(pProxy);
+    CHECK(pProxy->getOcclusionState() == TileOcclusionState::NotOccluded);
+
+    culler.update(views, occluders);
+    CHECK(pProxy->getOcclusionState() == TileOcclusionState::Occluded);
+
+    culler.update(views, {});
+    CHECK(pProxy->getOcclusionState() == TileOcclusionState::NotOccluded);
+  }
+}
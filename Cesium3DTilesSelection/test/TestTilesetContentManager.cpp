@@ -1,14 +1,20 @@
 #include "SimplePrepareRendererResource.h"
+#include "TileProxyGenerator.h"
 #include "TilesetContentManager.h"
 
 #include <Cesium3DTilesContent/registerAllTileContentTypes.h>
 #include <Cesium3DTilesSelection/RasterOverlayCollection.h>
 #include <Cesium3DTilesSelection/Tile.h>
+#include <Cesium3DTilesSelection/TileContentRegistry.h>
+#include <Cesium3DTilesSelection/TileRenderBatch.h>
 #include <Cesium3DTilesSelection/TilesetContentLoader.h>
+#include <Cesium3DTilesSelection/ViewUpdateResult.h>
 #include <CesiumGeometry/QuadtreeTileID.h>
 #include <CesiumGeospatial/Cartographic.h>
 #include <CesiumGltf/AccessorView.h>
 #include <CesiumGltf/AccessorWriter.h>
+#include <CesiumGltfContent/GltfUtilities.h>
+#include <CesiumGltfContent/ImageManipulation.h>
 #include <CesiumGltfReader/GltfReader.h>
 #include <CesiumNativeTests/SimpleAssetAccessor.h>
 #include <CesiumNativeTests/SimpleAssetRequest.h>
@@ -21,6 +27,8 @@
 
 #include <catch2/catch.hpp>
 #include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <spdlog/spdlog.h>
 
 #include <filesystem>
 #include <vector>
@@ -53,6 +61,18 @@ public:
   TileChildrenResult mockCreateTileChildren;
 };
 
+class GlobeGridTilesetContentLoader : public TilesetContentLoader {
+public:
+  CesiumAsync::Future<TileLoadResult>
+  loadTileContent(const TileLoadInput& input) override;
+
+  TileChildrenResult createTileChildren(
+      [[maybe_unused]] const Tile& tile,
+      [[maybe_unused]] const Ellipsoid& ellipsoid) override {
+    return {{}, TileLoadResultState::Failed};
+  }
+};
+
 std::shared_ptr<SimpleAssetRequest>
 createMockRequest(const std::filesystem::path& path) {
   auto pMockCompletedResponse = std::make_unique<SimpleAssetResponse>(
@@ -183,6 +203,40 @@ CesiumGltf::Model createGlobeGrid(
   return model;
 }
 
+CesiumAsync::Future<TileLoadResult>
+GlobeGridTilesetContentLoader::loadTileContent(const TileLoadInput& input) {
+  return input.asyncSystem.createResolvedFuture(TileLoadResult{
+      createGlobeGrid(Cartographic(0.0, 0.0, 0.0), 10, 10, 0.01),
+      CesiumGeometry::Axis::Z,
+      std::nullopt,
+      std::nullopt,
+      std::nullopt,
+      nullptr,
+      {},
+      TileLoadResultState::Success,
+      Ellipsoid::WGS84});
+}
+
+class SharedGlobeGridTilesetContentLoader
+    : public GlobeGridTilesetContentLoader {
+public:
+  SharedGlobeGridTilesetContentLoader(std::shared_ptr<int32_t> pLoadCount_)
+      : pLoadCount{std::move(pLoadCount_)} {}
+
+  CesiumAsync::Future<TileLoadResult>
+  loadTileContent(const TileLoadInput& input) override {
+    ++*this->pLoadCount;
+    return GlobeGridTilesetContentLoader::loadTileContent(input);
+  }
+
+  std::string
+  getTileContentKey([[maybe_unused]] const Tile& tile) const override {
+    return "globe-grid";
+  }
+
+  std::shared_ptr<int32_t> pLoadCount;
+};
+
 // Creates a model with two triangles in opposite corners of the given
 // rectangle. The triangles extend slightly into the other two quadrants.
 CesiumGltf::Model createSparseMesh(const GlobeRectangle& rectangle) {
@@ -1627,3 +1681,681 @@ TEST_CASE("Test the tileset content manager's post processing for gltf") {
     pManager->unloadTileContent(tile);
   }
 }
+
+TEST_CASE("Test the tileset content manager's render batching") {
+  Cesium3DTilesContent::registerAllTileContentTypes();
+
+  // create mock tileset externals
+  auto pMockedAssetAccessor = std::make_shared<SimpleAssetAccessor>(
+      std::map<std::string, std::shared_ptr<SimpleAssetRequest>>{});
+  auto pMockedPrepareRendererResources =
+      std::make_shared<SimplePrepareRendererResource>();
+  CesiumAsync::AsyncSystem asyncSystem{std::make_shared<SimpleTaskProcessor>()};
+  auto pMockedCreditSystem = std::make_shared<CreditSystem>();
+
+  TilesetExternals externals{
+      pMockedAssetAccessor,
+      pMockedPrepareRendererResources,
+      asyncSystem,
+      pMockedCreditSystem};
+
+  // create a root tile with two leaf children at different positions
+  auto pMockedLoader = std::make_unique<GlobeGridTilesetContentLoader>();
+  auto pRootTile = std::make_unique<Tile>(pMockedLoader.get());
+  {
+    std::vector<Tile> children;
+    children.emplace_back(pMockedLoader.get());
+    children.emplace_back(pMockedLoader.get());
+    children.back().setTransform(
+        glm::translate(glm::dmat4x4(1.0), glm::dvec3(100.0, 0.0, 0.0)));
+    pRootTile->createChildTiles(std::move(children));
+  }
+
+  TilesetOptions options{};
+  options.enableTileBatching = true;
+  options.maximumBatchedTileBytes = 1024 * 1024;
+
+  Tile::LoadedLinkedList loadedTiles;
+  IntrusivePointer<TilesetContentManager> pManager = new TilesetContentManager{
+      externals,
+      options,
+      RasterOverlayCollection{loadedTiles, externals},
+      {},
+      std::move(pMockedLoader),
+      std::move(pRootTile)};
+
+  Tile& tile = *pManager->getRootTile();
+  Tile& firstChild = tile.getChildren()[0];
+  Tile& secondChild = tile.getChildren()[1];
+
+  pManager->loadTileContent(firstChild, options);
+  pManager->waitUntilIdle();
+  pManager->updateTileContent(firstChild, options);
+  CHECK(firstChild.getState() == TileLoadState::Done);
+
+  // a batch is not created until all siblings are done
+  pManager->waitUntilIdle();
+  CHECK(!firstChild.getContent().getRenderContent()->getRenderBatch());
+
+  const int64_t tilesDataUsed = pManager->getTotalDataUsed();
+
+  pManager->loadTileContent(secondChild, options);
+  pManager->waitUntilIdle();
+  pManager->updateTileContent(secondChild, options);
+  CHECK(secondChild.getState() == TileLoadState::Done);
+  pManager->waitUntilIdle();
+
+  const TileRenderBatch* pBatch =
+      firstChild.getContent().getRenderContent()->getRenderBatch();
+  REQUIRE(pBatch);
+  CHECK(
+      secondChild.getContent().getRenderContent()->getRenderBatch() == pBatch);
+  CHECK(&pBatch->getParent() == &tile);
+  CHECK(pBatch->getRenderResources());
+  CHECK(pBatch->getTransform() == firstChild.getTransform());
+
+  const CesiumGltf::Model& model = pBatch->getModel();
+  CHECK(model.buffers.size() == 1);
+  CHECK(model.meshes.size() == 2);
+  REQUIRE(model.scenes.size() == 1);
+  CHECK(model.scenes[0].nodes.size() == 2);
+
+  auto gltfUpAxisIt = model.extras.find("gltfUpAxis");
+  REQUIRE(gltfUpAxisIt != model.extras.end());
+  CHECK(gltfUpAxisIt->second.getInt64() == 2);
+
+  gsl::span<const TileRenderBatch::Member> members = pBatch->getMembers();
+  REQUIRE(members.size() == 2);
+  CHECK(members[0].pTile == &firstChild);
+  CHECK(members[0].firstMesh == 0);
+  CHECK(members[0].meshCount == 1);
+  CHECK(members[1].pTile == &secondChild);
+  CHECK(members[1].firstMesh == 1);
+  CHECK(members[1].meshCount == 1);
+
+  // the second member is placed relative to the first one
+  std::optional<glm::dmat4x4> secondTransform =
+      CesiumGltfContent::GltfUtilities::getNodeTransform(
+          model.nodes[size_t(members[1].rootNode)]);
+  REQUIRE(secondTransform);
+  CHECK((*secondTransform)[3] == glm::dvec4(100.0, 0.0, 0.0, 1.0));
+
+  CHECK(
+      pManager->getTotalDataUsed() == tilesDataUsed +
+                                          secondChild.computeByteSize() +
+                                          pBatch->computeByteSize());
+
+  SECTION("Batches are only selected when all members are rendered") {
+    ViewUpdateResult result;
+    firstChild.setLastSelectionState(
+        TileSelectionState(1, TileSelectionState::Result::Rendered));
+    secondChild.setLastSelectionState(
+        TileSelectionState(1, TileSelectionState::Result::Culled));
+    firstChild.getContent().getRenderContent()->setLodTransitionFadePercentage(
+        1.0f);
+    secondChild.getContent().getRenderContent()->setLodTransitionFadePercentage(
+        1.0f);
+
+    pManager->selectRenderBatches(result, 1);
+    CHECK(result.batchesToRenderThisFrame.empty());
+
+    secondChild.setLastSelectionState(
+        TileSelectionState(1, TileSelectionState::Result::Rendered));
+    pManager->selectRenderBatches(result, 1);
+    REQUIRE(result.batchesToRenderThisFrame.size() == 1);
+    CHECK(result.batchesToRenderThisFrame[0] == pBatch);
+  }
+
+  SECTION("Unloading a member frees the batch") {
+    pManager->unloadTileContent(firstChild);
+    CHECK(firstChild.getState() == TileLoadState::Unloaded);
+    CHECK(!secondChild.getContent().getRenderContent()->getRenderBatch());
+    CHECK(pManager->getTotalDataUsed() == secondChild.computeByteSize());
+
+    // reloading the member creates the batch again
+    pManager->loadTileContent(firstChild, options);
+    pManager->waitUntilIdle();
+    pManager->updateTileContent(firstChild, options);
+    pManager->waitUntilIdle();
+    CHECK(firstChild.getContent().getRenderContent()->getRenderBatch());
+    CHECK(
+        firstChild.getContent().getRenderContent()->getRenderBatch() ==
+        secondChild.getContent().getRenderContent()->getRenderBatch());
+  }
+
+  pManager->unloadAll();
+  CHECK(pManager->getTotalDataUsed() == 0);
+}
+
+TEST_CASE("Test the tileset content manager's proxy content") {
+  Cesium3DTilesContent::registerAllTileContentTypes();
+
+  // create mock tileset externals
+  auto pMockedAssetAccessor = std::make_shared<SimpleAssetAccessor>(
+      std::map<std::string, std::shared_ptr<SimpleAssetRequest>>{});
+  auto pMockedPrepareRendererResources =
+      std::make_shared<SimplePrepareRendererResource>();
+  CesiumAsync::AsyncSystem asyncSystem{std::make_shared<SimpleTaskProcessor>()};
+  auto pMockedCreditSystem = std::make_shared<CreditSystem>();
+
+  TilesetExternals externals{
+      pMockedAssetAccessor,
+      pMockedPrepareRendererResources,
+      asyncSystem,
+      pMockedCreditSystem};
+
+  // create a content-less root tile with two leaf children
+  auto pMockedLoader = std::make_unique<GlobeGridTilesetContentLoader>();
+  auto pRootTile =
+      std::make_unique<Tile>(pMockedLoader.get(), TileEmptyContent());
+  pRootTile->setUnconditionallyRefine();
+  {
+    std::vector<Tile> children;
+    children.emplace_back(pMockedLoader.get());
+    children.emplace_back(pMockedLoader.get());
+    children.back().setTransform(
+        glm::translate(glm::dmat4x4(1.0), glm::dvec3(100.0, 0.0, 0.0)));
+    for (Tile& child : children) {
+      child.setGeometricError(10.0);
+    }
+    pRootTile->createChildTiles(std::move(children));
+  }
+
+  TilesetOptions options{};
+  options.enableProxyContent = true;
+
+  Tile::LoadedLinkedList loadedTiles;
+  IntrusivePointer<TilesetContentManager> pManager = new TilesetContentManager{
+      externals,
+      options,
+      RasterOverlayCollection{loadedTiles, externals},
+      {},
+      std::move(pMockedLoader),
+      std::move(pRootTile)};
+
+  Tile& tile = *pManager->getRootTile();
+
+  // no proxy can be built before the children are loaded
+  pManager->updateTileContent(tile, options);
+  pManager->waitUntilIdle();
+  CHECK(tile.getState() == TileLoadState::Done);
+  CHECK(tile.getContent().isEmptyContent());
+  CHECK(tile.getUnconditionallyRefine());
+
+  for (Tile& child : tile.getChildren()) {
+    pManager->loadTileContent(child, options);
+    pManager->waitUntilIdle();
+    pManager->updateTileContent(child, options);
+    CHECK(child.getState() == TileLoadState::Done);
+  }
+
+  const int64_t childrenDataUsed = pManager->getTotalDataUsed();
+
+  pManager->updateTileContent(tile, options);
+  pManager->waitUntilIdle();
+
+  const TileRenderContent* pRenderContent =
+      tile.getContent().getRenderContent();
+  REQUIRE(pRenderContent);
+  CHECK(pRenderContent->getRenderResources());
+  CHECK(!tile.getUnconditionallyRefine());
+  CHECK(tile.getGeometricError() >= 20.0);
+
+  const CesiumGltf::Model& model = pRenderContent->getModel();
+  CHECK(model.meshes.size() == 2);
+  CHECK(model.buffers.size() == 1);
+
+  CHECK(
+      pManager->getTotalDataUsed() ==
+      childrenDataUsed + tile.computeByteSize());
+
+  SECTION("Unloading the proxy restores the empty content") {
+    CHECK(pManager->unloadTileContent(tile));
+    CHECK(tile.getState() == TileLoadState::Done);
+    CHECK(tile.getContent().isEmptyContent());
+    CHECK(tile.getUnconditionallyRefine());
+    CHECK(pManager->getTotalDataUsed() == childrenDataUsed);
+
+    // nothing has changed that would need the proxy again
+    pManager->updateTileContent(tile, options);
+    pManager->waitUntilIdle();
+    CHECK(tile.getContent().isEmptyContent());
+
+    // the proxy is built again once a child is loaded again, because there is
+    // no cache to load it from
+    Tile& child = tile.getChildren()[0];
+    CHECK(pManager->unloadTileContent(child));
+    pManager->loadTileContent(child, options);
+    pManager->waitUntilIdle();
+    pManager->updateTileContent(child, options);
+    pManager->waitUntilIdle();
+    CHECK(tile.getContent().isRenderContent());
+  }
+
+  pManager->unloadAll();
+  CHECK(pManager->getTotalDataUsed() == 0);
+}
+
+TEST_CASE("Test the proxy generator's cache keys and stored images") {
+  SECTION("The tileset version is its validator or a hash of its content") {
+    const std::vector<std::byte> content{std::byte('{'), std::byte('}')};
+    const std::vector<std::byte> otherContent{
+        std::byte('{'),
+        std::byte(' '),
+        std::byte('}')};
+
+    SimpleAssetResponse withETag(
+        200,
+        "application/json",
+        CesiumAsync::HttpHeaders{{"ETag", "\"1\""}},
+        content);
+    CHECK(TileProxyGenerator::getTilesetVersion(withETag) == "ETag \"1\"");
+
+    SimpleAssetResponse first(
+        200,
+        "application/json",
+        CesiumAsync::HttpHeaders{},
+        content);
+    SimpleAssetResponse same(
+        200,
+        "application/json",
+        CesiumAsync::HttpHeaders{},
+        content);
+    SimpleAssetResponse other(
+        200,
+        "application/json",
+        CesiumAsync::HttpHeaders{},
+        otherContent);
+    const std::string version = TileProxyGenerator::getTilesetVersion(first);
+    CHECK(!version.empty());
+    CHECK(version == TileProxyGenerator::getTilesetVersion(same));
+    CHECK(version != TileProxyGenerator::getTilesetVersion(other));
+  }
+
+  SECTION("Only proxies whose images can be stored as PNG are stored") {
+    CesiumGltf::Model model;
+    CesiumGltf::Image& image = model.images.emplace_back();
+    image.cesium.width = 2;
+    image.cesium.height = 2;
+    image.cesium.channels = 4;
+    image.cesium.pixelData.resize(16, std::byte(0xff));
+
+    const std::vector<std::byte> glb =
+        TileProxyGenerator::writeProxy(model, spdlog::default_logger());
+    REQUIRE(!glb.empty());
+    std::optional<CesiumGltf::Model> maybeRead =
+        TileProxyGenerator::readProxy(glb, spdlog::default_logger());
+    REQUIRE(maybeRead);
+    REQUIRE(maybeRead->images.size() == 1);
+    CHECK(maybeRead->images[0].cesium.width == 2);
+    CHECK(maybeRead->images[0].cesium.getPixelData().size() == 16);
+
+    SECTION("but not compressed images") {
+      image.cesium.compressedPixelFormat =
+          CesiumGltf::GpuCompressedPixelFormat::ETC1_RGB;
+      CHECK(
+          TileProxyGenerator::writeProxy(model, spdlog::default_logger())
+              .empty());
+    }
+
+    SECTION("or images with mip levels") {
+      image.cesium.mipPositions = {{0, 16}};
+      CHECK(
+          TileProxyGenerator::writeProxy(model, spdlog::default_logger())
+              .empty());
+    }
+  }
+}
+
+TEST_CASE("Test the tileset content manager's progressive textures") {
+  Cesium3DTilesContent::registerAllTileContentTypes();
+
+  // create mock tileset externals
+  auto pMockedAssetAccessor = std::make_shared<SimpleAssetAccessor>(
+      std::map<std::string, std::shared_ptr<SimpleAssetRequest>>{});
+  auto pMockedPrepareRendererResources =
+      std::make_shared<SimplePrepareRendererResource>();
+  CesiumAsync::AsyncSystem asyncSystem{std::make_shared<SimpleTaskProcessor>()};
+  auto pMockedCreditSystem = std::make_shared<CreditSystem>();
+
+  TilesetExternals externals{
+      pMockedAssetAccessor,
+      pMockedPrepareRendererResources,
+      asyncSystem,
+      pMockedCreditSystem};
+
+  // create a model with a decoded 1024x1024 image that is also embedded as a
+  // PNG in a buffer view
+  CesiumGltf::Model model;
+  {
+    CesiumGltf::ImageCesium decoded;
+    decoded.width = 1024;
+    decoded.height = 1024;
+    decoded.channels = 4;
+    decoded.bytesPerChannel = 1;
+    decoded.pixelData.resize(size_t(1024 * 1024 * 4), std::byte(0x7f));
+
+    std::vector<std::byte> png =
+        CesiumGltfContent::ImageManipulation::savePng(decoded);
+    REQUIRE(!png.empty());
+
+    CesiumGltf::Buffer& buffer = model.buffers.emplace_back();
+    buffer.byteLength = int64_t(png.size());
+    buffer.cesium.data = std::move(png);
+
+    CesiumGltf::BufferView& bufferView = model.bufferViews.emplace_back();
+    bufferView.buffer = 0;
+    bufferView.byteLength = buffer.byteLength;
+
+    CesiumGltf::Image& image = model.images.emplace_back();
+    image.bufferView = 0;
+    image.mimeType = CesiumGltf::Image::MimeType::image_png;
+    image.cesium = std::move(decoded);
+  }
+
+  auto pMockedLoader = std::make_unique<SimpleTilesetContentLoader>();
+  pMockedLoader->mockLoadTileContent = {
+      std::move(model),
+      CesiumGeometry::Axis::Y,
+      std::nullopt,
+      std::nullopt,
+      std::nullopt,
+      nullptr,
+      {},
+      TileLoadResultState::Success,
+      Ellipsoid::WGS84};
+  pMockedLoader->mockCreateTileChildren = {{}, TileLoadResultState::Failed};
+
+  auto pRootTile = std::make_unique<Tile>(pMockedLoader.get());
+
+  TilesetOptions options{};
+  options.enableProgressiveTextures = true;
+  options.minimumProgressiveTextureSize = 256;
+
+  Tile::LoadedLinkedList loadedTiles;
+  IntrusivePointer<TilesetContentManager> pManager = new TilesetContentManager{
+      externals,
+      options,
+      RasterOverlayCollection{loadedTiles, externals},
+      {},
+      std::move(pMockedLoader),
+      std::move(pRootTile)};
+
+  Tile& tile = *pManager->getRootTile();
+
+  // a tile that covers few pixels is loaded with the smallest texture
+  pManager->updateTextureResolution(tile, 100.0, options);
+  pManager->loadTileContent(tile, options);
+  pManager->waitUntilIdle();
+  pManager->updateTileContent(tile, options);
+  REQUIRE(tile.getState() == TileLoadState::Done);
+
+  const TileRenderContent* pRenderContent =
+      tile.getContent().getRenderContent();
+  REQUIRE(pRenderContent);
+  CHECK(pRenderContent->getModel().images[0].cesium.width == 256);
+  CHECK(pRenderContent->getModel().images[0].cesium.height == 256);
+  CHECK(pManager->getTotalDataUsed() == tile.computeByteSize());
+
+  // the texture does not change while the tile stays small
+  pManager->updateTextureResolution(tile, 200.0, options);
+  pManager->waitUntilIdle();
+  CHECK(pRenderContent->getModel().images[0].cesium.width == 256);
+
+  SECTION("A higher resolution is decoded when the tile grows on screen") {
+    pManager->updateTextureResolution(tile, 600.0, options);
+    pManager->waitUntilIdle();
+
+    const CesiumGltf::ImageCesium& image =
+        pRenderContent->getModel().images[0].cesium;
+    CHECK(image.width == 1024);
+    CHECK(image.height == 1024);
+    CHECK(image.pixelData.size() == size_t(1024 * 1024 * 4));
+    CHECK(pManager->getTotalDataUsed() == tile.computeByteSize());
+
+    // the image is never larger than it was originally
+    pManager->updateTextureResolution(tile, 5000.0, options);
+    pManager->waitUntilIdle();
+    CHECK(pRenderContent->getModel().images[0].cesium.width == 1024);
+  }
+
+  SECTION("An upgrade finishing after the tile is unloaded is discarded") {
+    pManager->updateTextureResolution(tile, 600.0, options);
+    CHECK(pManager->unloadTileContent(tile));
+
+    // the upgrade still refers to the tile, so it must not be destroyed yet
+    CHECK(!pManager->canPruneTile(tile));
+
+    pManager->waitUntilIdle();
+    CHECK(tile.getState() == TileLoadState::Unloaded);
+    CHECK(pManager->canPruneTile(tile));
+  }
+
+  SECTION("A tile is loaded with the texture size it needs on screen") {
+    CHECK(pManager->unloadTileContent(tile));
+    pManager->loadTileContent(tile, options, 512);
+    pManager->waitUntilIdle();
+    pManager->updateTileContent(tile, options);
+    REQUIRE(tile.getState() == TileLoadState::Done);
+
+    const TileRenderContent* pReloadedContent =
+        tile.getContent().getRenderContent();
+    REQUIRE(pReloadedContent);
+    CHECK(pReloadedContent->getModel().images[0].cesium.width == 512);
+    CHECK(pReloadedContent->getModel().images[0].cesium.height == 512);
+  }
+
+  pManager->unloadAll();
+  CHECK(pManager->getTotalDataUsed() == 0);
+}
+
+TEST_CASE("Test the tileset content manager's shared content") {
+  Cesium3DTilesContent::registerAllTileContentTypes();
+
+  // create mock tileset externals that share a content registry
+  auto pMockedAssetAccessor = std::make_shared<SimpleAssetAccessor>(
+      std::map<std::string, std::shared_ptr<SimpleAssetRequest>>{});
+  auto pMockedPrepareRendererResources =
+      std::make_shared<SimplePrepareRendererResource>();
+  CesiumAsync::AsyncSystem asyncSystem{std::make_shared<SimpleTaskProcessor>()};
+  auto pMockedCreditSystem = std::make_shared<CreditSystem>();
+
+  TilesetExternals externals{
+      pMockedAssetAccessor,
+      pMockedPrepareRendererResources,
+      asyncSystem,
+      pMockedCreditSystem};
+  externals.pTileContentRegistry = std::make_shared<TileContentRegistry>();
+
+  // create two managers of the same source
+  auto pLoadCount = std::make_shared<int32_t>(0);
+  TilesetOptions options{};
+  Tile::LoadedLinkedList loadedTiles;
+  std::vector<IntrusivePointer<TilesetContentManager>> managers;
+  for (size_t i = 0; i < 2; ++i) {
+    auto pMockedLoader =
+        std::make_unique<SharedGlobeGridTilesetContentLoader>(pLoadCount);
+    auto pRootTile = std::make_unique<Tile>(pMockedLoader.get());
+    managers.emplace_back(new TilesetContentManager{
+        externals,
+        options,
+        RasterOverlayCollection{loadedTiles, externals},
+        {},
+        std::move(pMockedLoader),
+        std::move(pRootTile)});
+  }
+
+  Tile& firstTile = *managers[0]->getRootTile();
+  Tile& secondTile = *managers[1]->getRootTile();
+
+  // the second tileset waits for the content being loaded by the first one
+  managers[0]->loadTileContent(firstTile, options);
+  managers[1]->loadTileContent(secondTile, options);
+  managers[0]->waitUntilIdle();
+  managers[1]->waitUntilIdle();
+
+  CHECK(*pLoadCount == 1);
+  CHECK(externals.pTileContentRegistry->size() == 1);
+  CHECK(firstTile.getState() == TileLoadState::ContentLoaded);
+  CHECK(secondTile.getState() == TileLoadState::ContentLoaded);
+
+  const TileRenderContent* pFirstRenderContent =
+      firstTile.getContent().getRenderContent();
+  const TileRenderContent* pSecondRenderContent =
+      secondTile.getContent().getRenderContent();
+  REQUIRE(pFirstRenderContent);
+  REQUIRE(pSecondRenderContent);
+  CHECK(pFirstRenderContent->isModelShared());
+  CHECK(pSecondRenderContent->isModelShared());
+  CHECK(
+      &pFirstRenderContent->getModel() == &pSecondRenderContent->getModel());
+
+  // each tileset has its own renderer resources
+  CHECK(pFirstRenderContent->getRenderResources());
+  CHECK(pSecondRenderContent->getRenderResources());
+  CHECK(
+      pFirstRenderContent->getRenderResources() !=
+      pSecondRenderContent->getRenderResources());
+
+  SECTION("Content that is still used is not loaded again") {
+    CHECK(managers[0]->unloadTileContent(firstTile));
+    CHECK(externals.pTileContentRegistry->size() == 1);
+
+    managers[0]->loadTileContent(firstTile, options);
+    managers[0]->waitUntilIdle();
+    CHECK(*pLoadCount == 1);
+    CHECK(firstTile.getState() == TileLoadState::ContentLoaded);
+  }
+
+  SECTION("Content is released with its last tile") {
+    CHECK(managers[0]->unloadTileContent(firstTile));
+    CHECK(managers[1]->unloadTileContent(secondTile));
+    CHECK(externals.pTileContentRegistry->size() == 0);
+
+    managers[1]->loadTileContent(secondTile, options);
+    managers[1]->waitUntilIdle();
+    CHECK(*pLoadCount == 2);
+  }
+
+  SECTION("Modifying a shared model copies it") {
+    TileRenderContent* pRenderContent =
+        firstTile.getContent().getRenderContent();
+    pRenderContent->getMutableModel().extras["modified"] = true;
+    CHECK(!pRenderContent->isModelShared());
+    CHECK(pSecondRenderContent->isModelShared());
+    CHECK(
+        pSecondRenderContent->getModel().extras.find("modified") ==
+        pSecondRenderContent->getModel().extras.end());
+  }
+
+  SECTION("Content loaded with other content options is not shared") {
+    CHECK(managers[0]->unloadTileContent(firstTile));
+
+    TilesetOptions smoothOptions = options;
+    smoothOptions.contentOptions.generateMissingNormalsSmooth = true;
+    managers[0]->loadTileContent(firstTile, smoothOptions);
+    managers[0]->waitUntilIdle();
+    CHECK(*pLoadCount == 2);
+    CHECK(externals.pTileContentRegistry->size() == 2);
+    CHECK(firstTile.getState() == TileLoadState::ContentLoaded);
+  }
+
+  for (IntrusivePointer<TilesetContentManager>& pManager : managers) {
+    pManager->unloadAll();
+  }
+  CHECK(externals.pTileContentRegistry->size() == 0);
+}
+
+TEST_CASE("Test the tileset content manager's subtree pruning") {
+  // create mock tileset externals
+  auto pMockedAssetAccessor = std::make_shared<SimpleAssetAccessor>(
+      std::map<std::string, std::shared_ptr<SimpleAssetRequest>>{});
+  auto pMockedPrepareRendererResources =
+      std::make_shared<SimplePrepareRendererResource>();
+  CesiumAsync::AsyncSystem asyncSystem{std::make_shared<SimpleTaskProcessor>()};
+  auto pMockedCreditSystem = std::make_shared<CreditSystem>();
+
+  TilesetExternals externals{
+      pMockedAssetAccessor,
+      pMockedPrepareRendererResources,
+      asyncSystem,
+      pMockedCreditSystem};
+
+  // create a quadtree root tile with four unloaded children
+  auto pMockedLoader = std::make_unique<SimpleTilesetContentLoader>();
+  SimpleTilesetContentLoader* pLoader = pMockedLoader.get();
+  auto createChildren = [pLoader]() {
+    std::vector<Tile> children;
+    for (uint32_t y = 0; y < 2; ++y) {
+      for (uint32_t x = 0; x < 2; ++x) {
+        Tile& child = children.emplace_back(pLoader);
+        child.setTileID(QuadtreeTileID(1, x, y));
+      }
+    }
+    return children;
+  };
+
+  auto pRootTile = std::make_unique<Tile>(pLoader, TileEmptyContent());
+  pRootTile->setTileID(QuadtreeTileID(0, 0, 0));
+  pRootTile->createChildTiles(createChildren());
+
+  TilesetOptions options{};
+
+  Tile::LoadedLinkedList loadedTiles;
+  IntrusivePointer<TilesetContentManager> pManager = new TilesetContentManager{
+      externals,
+      options,
+      RasterOverlayCollection{loadedTiles, externals},
+      {},
+      std::move(pMockedLoader),
+      std::move(pRootTile)};
+
+  pLoader->mockCreateTileChildren = {{}, TileLoadResultState::Failed};
+
+  Tile& tile = *pManager->getRootTile();
+  pManager->updateTileContent(tile, options);
+  CHECK(tile.getState() == TileLoadState::Done);
+  REQUIRE(tile.getChildren().size() == 4);
+
+  SECTION("Unloaded children are pruned and created again") {
+    REQUIRE(pManager->canPruneTileChildren(tile));
+    for (const Tile& child : tile.getChildren()) {
+      CHECK(pManager->canPruneTile(child));
+    }
+
+    pManager->pruneTileChildren(tile);
+    CHECK(tile.getChildren().empty());
+    CHECK(tile.getState() == TileLoadState::Done);
+    CHECK(!pManager->canPruneTileChildren(tile));
+
+    pLoader->mockCreateTileChildren = {
+        createChildren(),
+        TileLoadResultState::Success};
+    pManager->updateTileContent(tile, options);
+    CHECK(tile.getChildren().size() == 4);
+    CHECK(!tile.shouldContentContinueUpdating());
+  }
+
+  SECTION("Children with loaded content are not pruned") {
+    Tile& child = tile.getChildren()[0];
+    pLoader->mockLoadTileContent = {
+        CesiumGltf::Model(),
+        CesiumGeometry::Axis::Y,
+        std::nullopt,
+        std::nullopt,
+        std::nullopt,
+        nullptr,
+        {},
+        TileLoadResultState::Success};
+    pManager->loadTileContent(child, options);
+    pManager->waitUntilIdle();
+    pManager->updateTileContent(child, options);
+    CHECK(child.getState() == TileLoadState::Done);
+    CHECK(!pManager->canPruneTile(child));
+
+    CHECK(pManager->unloadTileContent(child));
+    CHECK(pManager->canPruneTile(child));
+  }
+
+  pManager->unloadAll();
+}
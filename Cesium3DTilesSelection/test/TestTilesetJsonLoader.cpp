@@ -1,5 +1,6 @@
 #include "ImplicitQuadtreeLoader.h"
 #include "SimplePrepareRendererResource.h"
+#include "TileHierarchySnapshot.h"
 #include "TilesetJsonLoader.h"
 
 #include <Cesium3DTilesContent/registerAllTileContentTypes.h>
@@ -10,6 +11,7 @@
 #include <CesiumNativeTests/readFile.h>
 
 #include <catch2/catch.hpp>
+#include <gsl/span>
 
 #include <cstddef>
 #include <memory>
@@ -69,6 +71,34 @@ createLoader(const std::filesystem::path& tilesetPath) {
   return loaderResultFuture.wait();
 }
 
+void checkSameTiles(const Tile& expected, const Tile& actual) {
+  CHECK(
+      TileIdUtilities::createTileIdString(actual.getTileID()) ==
+      TileIdUtilities::createTileIdString(expected.getTileID()));
+  CHECK(actual.isEmptyContent() == expected.isEmptyContent());
+  CHECK(actual.isExternalContent() == expected.isExternalContent());
+  CHECK(actual.getTransform() == expected.getTransform());
+  CHECK(
+      getBoundingVolumeCenter(actual.getBoundingVolume()) ==
+      getBoundingVolumeCenter(expected.getBoundingVolume()));
+  CHECK(
+      actual.getViewerRequestVolume().has_value() ==
+      expected.getViewerRequestVolume().has_value());
+  CHECK(
+      actual.getContentBoundingVolume().has_value() ==
+      expected.getContentBoundingVolume().has_value());
+  CHECK(actual.getGeometricError() == expected.getGeometricError());
+  CHECK(actual.getRefine() == expected.getRefine());
+  CHECK(
+      actual.getUnconditionallyRefine() ==
+      expected.getUnconditionallyRefine());
+
+  REQUIRE(actual.getChildren().size() == expected.getChildren().size());
+  for (size_t i = 0; i < actual.getChildren().size(); ++i) {
+    checkSameTiles(expected.getChildren()[i], actual.getChildren()[i]);
+  }
+}
+
 TileLoadResult loadTileContent(
     const std::filesystem::path& tilePath,
     TilesetContentLoader& loader,
@@ -419,6 +449,114 @@ TEST_CASE("Test creating tileset json loader") {
     REQUIRE(schema);
     CHECK(schema->id == "foo");
   }
+
+  SECTION("Tile properties may follow its children") {
+    const std::string tilesetJson = R"({
+      "asset": { "version": "1.1", "gltfUpAxis": "Z" },
+      "root": {
+        "children": [
+          {
+            "boundingVolume": { "sphere": [0, 0, 0, 5] },
+            "geometricError": 10
+          },
+          42,
+          {
+            "boundingVolume": { "sphere": [0, 0, 0, 5] },
+            "refine": "REPLACE"
+          },
+          {
+            "geometricError": 10
+          }
+        ],
+        "boundingVolume": { "sphere": [0, 0, 0, 10] },
+        "geometricError": 100,
+        "refine": "ADD",
+        "transform": [2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 2, 0, 1, 2, 3, 1]
+      }
+    })";
+
+    auto loaderResult = TilesetJsonLoader::createLoader(
+        spdlog::default_logger(),
+        "tileset.json",
+        gsl::span<const std::byte>(
+            reinterpret_cast<const std::byte*>(tilesetJson.data()),
+            tilesetJson.size()));
+
+    CHECK(!loaderResult.errors.hasErrors());
+    CHECK(loaderResult.errors.warnings.size() == 1);
+    REQUIRE(loaderResult.pLoader);
+    CHECK(loaderResult.pLoader->getUpAxis() == CesiumGeometry::Axis::Z);
+    REQUIRE(loaderResult.pRootTile);
+    REQUIRE(loaderResult.pRootTile->getChildren().size() == 1);
+    const Tile& root = loaderResult.pRootTile->getChildren()[0];
+    CHECK(root.getGeometricError() == Approx(200.0));
+    CHECK(root.getRefine() == TileRefine::Add);
+
+    // the non-object child and the child without a bounding volume are
+    // ignored
+    REQUIRE(root.getChildren().size() == 2);
+    for (const Tile& child : root.getChildren()) {
+      CHECK(child.getTransform() == root.getTransform());
+      const CesiumGeometry::BoundingSphere* pSphere =
+          std::get_if<CesiumGeometry::BoundingSphere>(
+              &child.getBoundingVolume());
+      REQUIRE(pSphere);
+      CHECK(pSphere->getCenter() == glm::dvec3(1.0, 2.0, 3.0));
+      CHECK(pSphere->getRadius() == Approx(10.0));
+    }
+
+    const Tile& firstChild = root.getChildren()[0];
+    CHECK(firstChild.getGeometricError() == Approx(20.0));
+    CHECK(firstChild.getRefine() == TileRefine::Add);
+
+    const Tile& secondChild = root.getChildren()[1];
+    CHECK(secondChild.getGeometricError() == Approx(200.0));
+    CHECK(secondChild.getRefine() == TileRefine::Replace);
+  }
+
+  SECTION("Bounding volumes with non-numeric elements are invalid") {
+    const std::string tilesetJson = R"({
+      "asset": { "version": "1.1" },
+      "root": {
+        "children": [
+          {
+            "boundingVolume": { "sphere": [0, "1", 0, 5] },
+            "geometricError": 10
+          },
+          {
+            "boundingVolume": { "sphere": [0, 0, 0, 5, "extra"] },
+            "geometricError": 10
+          }
+        ],
+        "boundingVolume": { "sphere": [0, 0, 0, 10] },
+        "geometricError": 100,
+        "transform": [2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 2, 0, 1, 2, 3, null]
+      }
+    })";
+
+    auto loaderResult = TilesetJsonLoader::createLoader(
+        spdlog::default_logger(),
+        "tileset.json",
+        gsl::span<const std::byte>(
+            reinterpret_cast<const std::byte*>(tilesetJson.data()),
+            tilesetJson.size()));
+
+    CHECK(!loaderResult.errors.hasErrors());
+    REQUIRE(loaderResult.pRootTile);
+    REQUIRE(loaderResult.pRootTile->getChildren().size() == 1);
+    const Tile& root = loaderResult.pRootTile->getChildren()[0];
+
+    // the transform with a null element is ignored
+    CHECK(root.getTransform() == glm::dmat4(1.0));
+
+    // only the elements of the array that are used must be numbers
+    REQUIRE(root.getChildren().size() == 1);
+    const CesiumGeometry::BoundingSphere* pSphere =
+        std::get_if<CesiumGeometry::BoundingSphere>(
+            &root.getChildren()[0].getBoundingVolume());
+    REQUIRE(pSphere);
+    CHECK(pSphere->getRadius() == Approx(5.0));
+  }
 }
 
 TEST_CASE("Test loading individual tile of tileset json") {
@@ -622,3 +760,102 @@ TEST_CASE("Test loading individual tile of tileset json") {
     CHECK(pLoader->getAvailableLevels() == 2);
   }
 }
+
+TEST_CASE("Test tile hierarchy snapshots") {
+  const std::string validator = "ETag \"1\"";
+
+  auto writeAndRead = [&validator](const std::filesystem::path& tilesetPath) {
+    auto loaderResult = createLoader(tilesetPath);
+    REQUIRE(loaderResult.pLoader);
+    REQUIRE(loaderResult.pRootTile);
+
+    std::vector<std::byte> snapshot = TileHierarchySnapshot::write(
+        *loaderResult.pRootTile,
+        *loaderResult.pLoader,
+        validator,
+        CesiumGeospatial::Ellipsoid::WGS84);
+    REQUIRE(!snapshot.empty());
+
+    auto snapshotResult = TilesetJsonLoader::createLoaderFromSnapshot(
+        "tileset.json",
+        snapshot,
+        validator,
+        CesiumGeospatial::Ellipsoid::WGS84);
+    REQUIRE(snapshotResult.pLoader);
+    REQUIRE(snapshotResult.pRootTile);
+    CHECK(
+        snapshotResult.pLoader->getUpAxis() ==
+        loaderResult.pLoader->getUpAxis());
+    checkSameTiles(*loaderResult.pRootTile, *snapshotResult.pRootTile);
+
+    return snapshot;
+  };
+
+  SECTION("Snapshot of an explicit tileset") {
+    writeAndRead(testDataPath / "ReplaceTileset" / "tileset.json");
+    writeAndRead(
+        testDataPath / "MultipleKindsOfTilesets" / "EmptyTileTileset.json");
+    writeAndRead(
+        testDataPath / "MultipleKindsOfTilesets" /
+        "ScaleGeometricErrorTileset.json");
+  }
+
+  SECTION("Snapshot of an implicit tileset") {
+    writeAndRead(
+        testDataPath / "MultipleKindsOfTilesets" /
+        "QuadtreeImplicitTileset.json");
+    writeAndRead(
+        testDataPath / "MultipleKindsOfTilesets" /
+        "OctreeImplicitTileset.json");
+  }
+
+  SECTION("Snapshot is rejected for another validator or ellipsoid") {
+    std::vector<std::byte> snapshot =
+        writeAndRead(testDataPath / "ReplaceTileset" / "tileset.json");
+
+    auto otherValidator = TilesetJsonLoader::createLoaderFromSnapshot(
+        "tileset.json",
+        snapshot,
+        "ETag \"2\"",
+        CesiumGeospatial::Ellipsoid::WGS84);
+    CHECK(!otherValidator.pRootTile);
+
+    auto otherEllipsoid = TilesetJsonLoader::createLoaderFromSnapshot(
+        "tileset.json",
+        snapshot,
+        validator,
+        CesiumGeospatial::Ellipsoid::UNIT_SPHERE);
+    CHECK(!otherEllipsoid.pRootTile);
+
+    snapshot.pop_back();
+    auto truncated = TilesetJsonLoader::createLoaderFromSnapshot(
+        "tileset.json",
+        snapshot,
+        validator,
+        CesiumGeospatial::Ellipsoid::WGS84);
+    CHECK(!truncated.pRootTile);
+  }
+
+  SECTION("Tilesets with metadata are not snapshotted") {
+    auto loaderResult =
+        createLoader(testDataPath / "WithMetadata" / "tileset.json");
+    REQUIRE(loaderResult.pRootTile);
+    CHECK(TileHierarchySnapshot::write(
+              *loaderResult.pRootTile,
+              *loaderResult.pLoader,
+              validator,
+              CesiumGeospatial::Ellipsoid::WGS84)
+              .empty());
+  }
+
+  SECTION("Validator is taken from the ETag or Last-Modified header") {
+    CHECK(
+        TileHierarchySnapshot::getValidator(
+            {{"ETag", "\"abc\""}, {"Last-Modified", "yesterday"}}) ==
+        "ETag \"abc\"");
+    CHECK(
+        TileHierarchySnapshot::getValidator({{"last-modified", "yesterday"}}) ==
+        "Last-Modified yesterday");
+    CHECK(TileHierarchySnapshot::getValidator({}).empty());
+  }
+}
@@ -206,6 +206,15 @@ TEST_CASE("Test replace refinement for render") {
 
       REQUIRE(result.tilesFadingOut.size() == 0);
 
+      // only the first frame shows the root
+      if (frame == 0) {
+        REQUIRE(result.tilesToShowThisFrame.size() == 1);
+        REQUIRE(result.tilesToShowThisFrame.front() == root);
+      } else {
+        REQUIRE(result.tilesToShowThisFrame.empty());
+      }
+      REQUIRE(result.tilesToHideThisFrame.empty());
+
       REQUIRE(result.tilesVisited == 2);
       REQUIRE(result.workerThreadTileLoadQueueLength == 0);
       REQUIRE(result.mainThreadTileLoadQueueLength == 0);
@@ -291,6 +300,11 @@ TEST_CASE("Test replace refinement for render") {
 
       REQUIRE(result.tilesFadingOut.size() == 1);
 
+      // the children replace the root
+      REQUIRE(result.tilesToShowThisFrame.size() == 4);
+      REQUIRE(result.tilesToHideThisFrame.size() == 1);
+      REQUIRE(result.tilesToHideThisFrame.front() == root);
+
       REQUIRE(result.tilesVisited == 6);
       REQUIRE(result.workerThreadTileLoadQueueLength == 0);
       REQUIRE(result.tilesCulled == 0);
@@ -934,6 +948,121 @@ TEST_CASE("Test multiple frustums") {
       REQUIRE(result.tilesCulled == 2);
     }
   }
+
+  SECTION("Tiles to render are reported for each view") {
+    tileset.getOptions().enablePerViewRenderLists = true;
+    tileset.getOptions().renderTilesUnderCamera = false;
+
+    ViewState lookAwayViewState = ViewState::create(
+        zoomOutPosition,
+        -zoomOutViewState.getDirection(),
+        zoomOutViewState.getUp(),
+        zoomOutViewState.getViewportSize(),
+        zoomOutViewState.getHorizontalFieldOfView(),
+        zoomOutViewState.getVerticalFieldOfView(),
+        Ellipsoid::WGS84);
+
+    ViewUpdateResult result =
+        tileset.updateView({zoomOutViewState, lookAwayViewState});
+
+    REQUIRE(result.tilesToRenderThisFrame.size() == 1);
+    REQUIRE(result.tilesToRenderThisFrame.front() == root);
+    REQUIRE(result.tilesToRenderPerView.size() == 2);
+    REQUIRE(result.tilesToRenderPerView[0] == result.tilesToRenderThisFrame);
+    REQUIRE(result.tilesToRenderPerView[1].empty());
+
+    tileset.getOptions().enablePerViewRenderLists = false;
+    result = tileset.updateView({zoomOutViewState, lookAwayViewState});
+    REQUIRE(result.tilesToRenderPerView.empty());
+  }
+}
+
+TEST_CASE("Test selecting tiles for several view sets offline") {
+  Cesium3DTilesContent::registerAllTileContentTypes();
+
+  std::filesystem::path testDataPath = Cesium3DTilesSelection_TEST_DATA_DIR;
+  testDataPath = testDataPath / "ReplaceTileset";
+  std::vector<std::string> files{
+      "tileset.json",
+      "parent.b3dm",
+      "ll.b3dm",
+      "lr.b3dm",
+      "ul.b3dm",
+      "ur.b3dm",
+      "ll_ll.b3dm",
+  };
+
+  std::map<std::string, std::shared_ptr<SimpleAssetRequest>>
+      mockCompletedRequests;
+  for (const auto& file : files) {
+    std::unique_ptr<SimpleAssetResponse> mockCompletedResponse =
+        std::make_unique<SimpleAssetResponse>(
+            static_cast<uint16_t>(200),
+            "doesn't matter",
+            CesiumAsync::HttpHeaders{},
+            readFile(testDataPath / file));
+    mockCompletedRequests.insert(
+        {file,
+         std::make_shared<SimpleAssetRequest>(
+             "GET",
+             file,
+             CesiumAsync::HttpHeaders{},
+             std::move(mockCompletedResponse))});
+  }
+
+  std::shared_ptr<SimpleAssetAccessor> mockAssetAccessor =
+      std::make_shared<SimpleAssetAccessor>(std::move(mockCompletedRequests));
+  TilesetExternals tilesetExternals{
+      mockAssetAccessor,
+      std::make_shared<SimplePrepareRendererResource>(),
+      AsyncSystem(std::make_shared<SimpleTaskProcessor>()),
+      nullptr};
+
+  // No updateView is needed; waiting in the main thread drives the loading.
+  Tileset tileset(tilesetExternals, "tileset.json");
+  tileset.getRootTileAvailableEvent().waitInMainThread();
+
+  const Tile* pTilesetJson = tileset.getRootTile();
+  REQUIRE(pTilesetJson);
+  REQUIRE(pTilesetJson->getChildren().size() == 1);
+  const Tile* root = &pTilesetJson->getChildren()[0];
+
+  // The root does not meet sse in the first view set, but does in the second.
+  ViewState viewState = zoomToTileset(tileset);
+  glm::dvec3 zoomOutPosition =
+      viewState.getPosition() - viewState.getDirection() * 2500.0;
+  ViewState zoomOutViewState = ViewState::create(
+      zoomOutPosition,
+      viewState.getDirection(),
+      viewState.getUp(),
+      viewState.getViewportSize(),
+      viewState.getHorizontalFieldOfView(),
+      viewState.getVerticalFieldOfView(),
+      Ellipsoid::WGS84);
+
+  std::vector<ViewUpdateResult> results =
+      tileset.updateViewSetsOffline({{viewState}, {zoomOutViewState}})
+          .waitInMainThread();
+  REQUIRE(results.size() == 2);
+
+  const std::vector<Tile*>& zoomedInTiles = results[0].tilesToRenderThisFrame;
+  REQUIRE(!zoomedInTiles.empty());
+  REQUIRE(
+      std::find(zoomedInTiles.begin(), zoomedInTiles.end(), root) ==
+      zoomedInTiles.end());
+
+  const std::vector<Tile*>& zoomedOutTiles = results[1].tilesToRenderThisFrame;
+  REQUIRE(zoomedOutTiles.size() == 1);
+  REQUIRE(zoomedOutTiles.front() == root);
+
+  // The tiles of both view sets are still loaded.
+  for (const ViewUpdateResult& result : results) {
+    REQUIRE(result.workerThreadTileLoadQueueLength == 0);
+    REQUIRE(result.mainThreadTileLoadQueueLength == 0);
+    for (const Tile* pTile : result.tilesToRenderThisFrame) {
+      REQUIRE(pTile->getState() == TileLoadState::Done);
+    }
+  }
 }
 
 TEST_CASE("Can load example tileset.json from 3DTILES_bounding_volume_S2 "
@@ -11,13 +11,41 @@
 
 #include <CesiumUtility/Tracing.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+#include <vector>
 
 namespace CesiumAsync {
 class ITaskProcessor;
 
 class AsyncSystem;
 
+namespace CesiumImpl {
+// Begin omitting doxgen warnings for Impl namespace
+//! @cond Doxygen_Suppress
+
+// The type that AsyncSystem::mapConcurrent resolves to: a vector of the
+// results, or nothing when the function's Futures resolve to nothing.
+template <typename T> struct MapConcurrentResult {
+  typedef std::vector<T> type;
+};
+
+template <> struct MapConcurrentResult<void> {
+  typedef void type;
+};
+
+//! @endcond
+// End omitting doxgen warnings for Impl namespace
+} // namespace CesiumImpl
+
 /**
  * @brief A system for managing asynchronous requests and tasks.
  *
@@ -227,6 +255,327 @@ public:
         std::forward<std::vector<SharedFuture<T>>>(futures));
   }
 
+  /**
+   * @brief Creates a Future that resolves to the results of invoking a
+   * function for each item in a vector, with the Futures of at most a given
+   * number of items pending at a time.
+   *
+   * The function takes an item and returns a `Future` or `SharedFuture`. It
+   * is invoked for the first items before this method returns, and for each
+   * following item when the Future of an earlier item settles, in whichever
+   * thread settled it. So the function should only start the work for the
+   * item, such as a network request, and leave the rest to continuations.
+   *
+   * If the function throws or one of the Futures rejects, the function is not
+   * invoked for any more items. Once the Futures that are already pending have
+   * settled, the returned Future rejects with the exception of the earliest
+   * item in the vector that failed.
+   *
+   * @tparam TItem The type of the items.
+   * @tparam Func The type of the function.
+   * @param items The items.
+   * @param maximumPending The maximum number of items whose Futures are
+   * pending at the same time. Values less than one are treated as one.
+   * @param f The function to invoke for each item.
+   * @return A Future that resolves to the results for the items, in the order
+   * of the items. If the function's Futures resolve to no value, the returned
+   * Future resolves to no value when all of them have resolved.
+   */
+  template <typename TItem, typename Func>
+  Future<typename CesiumImpl::MapConcurrentResult<CesiumImpl::RemoveFuture_t<
+      std::decay_t<std::invoke_result_t<Func&, TItem&&>>>>::type>
+  mapConcurrent(
+      std::vector<TItem>&& items,
+      size_t maximumPending,
+      Func&& f) const {
+    using T = CesiumImpl::RemoveFuture_t<
+        std::decay_t<std::invoke_result_t<Func&, TItem&&>>>;
+    using TResult = typename CesiumImpl::MapConcurrentResult<T>::type;
+    using TState = MapConcurrentState<TItem, T, std::decay_t<Func>>;
+
+    Promise<TResult> promise = this->createPromise<TResult>();
+    Future<TResult> result = promise.getFuture();
+
+    std::shared_ptr<TState> pState = std::make_shared<TState>(
+        std::move(items),
+        std::max(maximumPending, size_t(1)),
+        std::forward<Func>(f),
+        std::move(promise));
+    AsyncSystem::pumpMapConcurrent(pState);
+
+    return result;
+  }
+
+  /**
+   * @brief Creates a Future that settles like the first Future in a vector to
+   * settle, whether it resolves or rejects.
+   *
+   * The other Futures are not canceled, and their results are ignored. If the
+   * vector is empty, the returned Future rejects.
+   *
+   * @tparam T The type that each Future resolves to.
+   * @param futures The futures.
+   * @return A Future that resolves or rejects with the first Future to settle.
+   */
+  template <typename T> Future<T> race(std::vector<Future<T>>&& futures) const {
+    struct State {
+      explicit State(Promise<T>&& promise_) : promise(std::move(promise_)) {}
+
+      Promise<T> promise;
+      std::atomic<bool> settled{false};
+    };
+
+    Promise<T> promise = this->createPromise<T>();
+    Future<T> result = promise.getFuture();
+
+    if (futures.empty()) {
+      promise.reject(
+          std::invalid_argument("Cannot race an empty vector of futures."));
+      return result;
+    }
+
+    std::shared_ptr<State> pState =
+        std::make_shared<State>(std::move(promise));
+    for (Future<T>& future : futures) {
+      future._task.then(
+          async::inline_scheduler(),
+          [pState](async::task<T>&& task) {
+            if (!pState->settled.exchange(true)) {
+              AsyncSystem::settle(pState->promise, std::move(task));
+            }
+          });
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Creates a Future that resolves like the first Future in a vector to
+   * resolve, and rejects only when all of the Futures reject.
+   *
+   * The other Futures are not canceled, and their results are ignored. If all
+   * of the Futures reject, the exception included in the rejection will be
+   * from the first Future in the vector. If the vector is empty, the returned
+   * Future rejects.
+   *
+   * @tparam T The type that each Future resolves to.
+   * @param futures The futures.
+   * @return A Future that resolves with the first Future to resolve.
+   */
+  template <typename T> Future<T> any(std::vector<Future<T>>&& futures) const {
+    struct State {
+      State(Promise<T>&& promise_, size_t size)
+          : promise(std::move(promise_)), pending(size), errors(size) {}
+
+      Promise<T> promise;
+      std::mutex mutex;
+      bool settled = false;
+      size_t pending;
+      std::vector<std::exception_ptr> errors;
+    };
+
+    Promise<T> promise = this->createPromise<T>();
+    Future<T> result = promise.getFuture();
+
+    if (futures.empty()) {
+      promise.reject(std::invalid_argument(
+          "Cannot wait for any of an empty vector of futures."));
+      return result;
+    }
+
+    std::shared_ptr<State> pState =
+        std::make_shared<State>(std::move(promise), futures.size());
+
+    for (size_t i = 0; i < futures.size(); ++i) {
+      futures[i]._task.then(
+          async::inline_scheduler(),
+          [pState, i](async::task<T>&& task) {
+            if (!task.get_exception()) {
+              std::unique_lock<std::mutex> lock(pState->mutex);
+              if (!pState->settled) {
+                pState->settled = true;
+                lock.unlock();
+                AsyncSystem::settle(pState->promise, std::move(task));
+              }
+              return;
+            }
+
+            std::unique_lock<std::mutex> lock(pState->mutex);
+            pState->errors[i] = task.get_exception();
+            if (--pState->pending == 0 && !pState->settled) {
+              pState->settled = true;
+              lock.unlock();
+              pState->promise.reject(pState->errors.front());
+            }
+          });
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Creates a Future that resolves when every Future in a vector
+   * settles, whether it resolves or rejects.
+   *
+   * Unlike {@link all}, the returned Future never rejects. Instead, it
+   * resolves to the value or the exception of each Future.
+   *
+   * @tparam T The type that each Future resolves to.
+   * @param futures The futures.
+   * @return A Future that resolves to the outcome of each Future, in the
+   * order of the vector.
+   */
+  template <typename T>
+  Future<std::vector<std::variant<T, std::exception_ptr>>>
+  whenAllSettled(std::vector<Future<T>>&& futures) const {
+    std::vector<async::task<T>> tasks;
+    tasks.reserve(futures.size());
+
+    for (Future<T>& future : futures) {
+      tasks.emplace_back(std::move(future._task));
+    }
+
+    futures.clear();
+
+    async::task<std::vector<std::variant<T, std::exception_ptr>>> task =
+        async::when_all(tasks.begin(), tasks.end())
+            .then(
+                async::inline_scheduler(),
+                [](std::vector<async::task<T>>&& tasks) {
+                  std::vector<std::variant<T, std::exception_ptr>> results;
+                  results.reserve(tasks.size());
+
+                  for (async::task<T>& task : tasks) {
+                    std::exception_ptr pException = task.get_exception();
+                    if (pException) {
+                      results.emplace_back(std::in_place_index<1>, pException);
+                    } else {
+                      results.emplace_back(std::in_place_index<0>, task.get());
+                    }
+                  }
+                  return results;
+                });
+    return Future<std::vector<std::variant<T, std::exception_ptr>>>(
+        this->_pSchedulers,
+        std::move(task));
+  }
+
+  /**
+   * @brief Creates a Future that resolves when every Future in a vector of
+   * Futures that resolve to no value settles, whether it resolves or rejects.
+   *
+   * Unlike {@link all}, the returned Future never rejects. Instead, it
+   * resolves to the exception of each Future, which is nullptr if the Future
+   * resolved.
+   *
+   * @param futures The futures.
+   * @return A Future that resolves to the exception of each Future, in the
+   * order of the vector.
+   */
+  Future<std::vector<std::exception_ptr>>
+  whenAllSettled(std::vector<Future<void>>&& futures) const {
+    std::vector<async::task<void>> tasks;
+    tasks.reserve(futures.size());
+
+    for (Future<void>& future : futures) {
+      tasks.emplace_back(std::move(future._task));
+    }
+
+    futures.clear();
+
+    async::task<std::vector<std::exception_ptr>> task =
+        async::when_all(tasks.begin(), tasks.end())
+            .then(
+                async::inline_scheduler(),
+                [](std::vector<async::task<void>>&& tasks) {
+                  std::vector<std::exception_ptr> results;
+                  results.reserve(tasks.size());
+
+                  for (async::task<void>& task : tasks) {
+                    results.emplace_back(task.get_exception());
+                  }
+                  return results;
+                });
+    return Future<std::vector<std::exception_ptr>>(
+        this->_pSchedulers,
+        std::move(task));
+  }
+
+  /**
+   * @brief Creates a Future that settles like the given Future, unless it has
+   * not settled by the given time, in which case it rejects with a
+   * `std::runtime_error`.
+   *
+   * The given Future is not canceled when the deadline passes, and its result
+   * is ignored. The deadline is checked while main-thread tasks are
+   * dispatched, for example by {@link dispatchMainThreadTasks} or
+   * {@link Future::waitInMainThread}, and the returned Future rejects in the
+   * main thread. So it does not reject while no thread dispatches main-thread
+   * tasks, such as while waiting for it with {@link Future::wait}.
+   *
+   * @tparam T The type that the Future resolves to.
+   * @param future The future.
+   * @param deadline The time by which the Future must settle.
+   * @return A Future that settles like the given Future, or rejects.
+   */
+  template <typename T>
+  Future<T> withDeadline(
+      Future<T>&& future,
+      std::chrono::steady_clock::time_point deadline) const {
+    struct State {
+      explicit State(Promise<T>&& promise_) : promise(std::move(promise_)) {}
+
+      Promise<T> promise;
+      std::atomic<bool> settled{false};
+      uint64_t timerId = 0;
+    };
+
+    Promise<T> promise = this->createPromise<T>();
+    Future<T> result = promise.getFuture();
+
+    std::shared_ptr<State> pState =
+        std::make_shared<State>(std::move(promise));
+    pState->timerId =
+        this->_pSchedulers->mainThread.scheduleTimer(deadline, [pState]() {
+          if (!pState->settled.exchange(true)) {
+            pState->promise.reject(std::runtime_error(
+                "The operation did not complete before its deadline."));
+          }
+        });
+
+    future._task.then(
+        async::inline_scheduler(),
+        [pState, pSchedulers = this->_pSchedulers](async::task<T>&& task) {
+          if (!pState->settled.exchange(true)) {
+            pSchedulers->mainThread.cancelTimer(pState->timerId);
+            AsyncSystem::settle(pState->promise, std::move(task));
+          }
+        });
+
+    return result;
+  }
+
+  /**
+   * @brief Creates a Future that settles like the given Future, unless it has
+   * not settled within the given time, in which case it rejects with a
+   * `std::runtime_error`.
+   *
+   * See {@link withDeadline} for details.
+   *
+   * @tparam T The type that the Future resolves to.
+   * @param future The future.
+   * @param timeout The time within which the Future must settle.
+   * @return A Future that settles like the given Future, or rejects.
+   */
+  template <typename T>
+  Future<T> withTimeout(
+      Future<T>&& future,
+      std::chrono::steady_clock::duration timeout) const {
+    return this->withDeadline(
+        std::move(future),
+        std::chrono::steady_clock::now() + timeout);
+  }
+
   /**
    * @brief Creates a future that is already resolved.
    *
@@ -252,10 +601,29 @@ public:
   /**
    * @brief Runs all tasks that are currently queued for the main thread.
    *
-   * The tasks are run in the calling thread.
+   * The tasks are run in the calling thread. The main thread tasks must not
+   * be dispatched from more than one thread at a time, whether with this
+   * method, {@link dispatchOneMainThreadTask}, or by waiting for a future in
+   * the main thread.
    */
   void dispatchMainThreadTasks();
 
+  /**
+   * @brief Runs tasks that are currently queued for the main thread until
+   * there are none left or the given time has elapsed.
+   *
+   * At least one task is run if any are queued, even if it takes longer than
+   * the given time. Tasks that are not run remain queued in order, and are
+   * run by a later dispatch.
+   *
+   * The tasks are run in the calling thread.
+   *
+   * @param maxTime The time after which no more tasks are started.
+   * @return true All queued tasks were run.
+   * @return false Some tasks are still waiting.
+   */
+  bool dispatchMainThreadTasks(std::chrono::steady_clock::duration maxTime);
+
   /**
    * @brief Runs a single waiting task that is currently queued for the main
    * thread. If there are no tasks waiting, it returns immediately without
@@ -291,6 +659,146 @@ public:
   bool operator!=(const AsyncSystem& rhs) const noexcept;
 
 private:
+  // Resolves or rejects a promise like a completed task.
+  template <typename T>
+  static void settle(const Promise<T>& promise, async::task<T>&& task) {
+    try {
+      if constexpr (std::is_void_v<T>) {
+        task.get();
+        promise.resolve();
+      } else {
+        promise.resolve(task.get());
+      }
+    } catch (...) {
+      promise.reject(std::current_exception());
+    }
+  }
+
+  template <typename TItem, typename T, typename Func>
+  struct MapConcurrentState {
+    using TResult = typename CesiumImpl::MapConcurrentResult<T>::type;
+
+    // Futures that resolve to no value have no results to keep.
+    using TResults = std::conditional_t<
+        std::is_void_v<T>,
+        std::monostate,
+        std::vector<std::optional<T>>>;
+
+    MapConcurrentState(
+        std::vector<TItem>&& items_,
+        size_t maximumPending_,
+        Func&& f_,
+        Promise<TResult>&& promise_)
+        : items(std::move(items_)),
+          maximumPending(maximumPending_),
+          f(std::move(f_)),
+          promise(std::move(promise_)) {
+      if constexpr (!std::is_void_v<T>) {
+        this->results.resize(this->items.size());
+      }
+    }
+
+    std::vector<TItem> items;
+    size_t maximumPending;
+    Func f;
+    Promise<TResult> promise;
+
+    std::mutex mutex;
+    TResults results;
+    size_t next = 0;
+    size_t pending = 0;
+    bool starting = false;
+    bool settled = false;
+    std::exception_ptr pError;
+    size_t errorIndex = 0;
+  };
+
+  // Starts as many items as allowed, and settles the promise when all items
+  // are done. Only one thread starts items at a time, and a Future that
+  // settles while items are being started leaves it to that thread to start
+  // the next ones, so Futures that are already resolved do not recurse.
+  template <typename TItem, typename T, typename Func>
+  static void pumpMapConcurrent(
+      const std::shared_ptr<MapConcurrentState<TItem, T, Func>>& pState) {
+    std::unique_lock<std::mutex> lock(pState->mutex);
+    if (pState->starting) {
+      return;
+    }
+
+    pState->starting = true;
+    while (!pState->pError && pState->next < pState->items.size() &&
+           pState->pending < pState->maximumPending) {
+      const size_t index = pState->next++;
+      ++pState->pending;
+      lock.unlock();
+      AsyncSystem::startMapConcurrent(pState, index);
+      lock.lock();
+    }
+    pState->starting = false;
+
+    const bool done =
+        pState->pending == 0 &&
+        (pState->pError || pState->next == pState->items.size());
+    if (!done || pState->settled) {
+      return;
+    }
+    pState->settled = true;
+    lock.unlock();
+
+    if (pState->pError) {
+      pState->promise.reject(pState->pError);
+      return;
+    }
+
+    if constexpr (std::is_void_v<T>) {
+      pState->promise.resolve();
+    } else {
+      std::vector<T> results;
+      results.reserve(pState->results.size());
+      for (std::optional<T>& maybeResult : pState->results) {
+        results.emplace_back(std::move(*maybeResult));
+      }
+      pState->promise.resolve(std::move(results));
+    }
+  }
+
+  template <typename TItem, typename T, typename Func>
+  static void startMapConcurrent(
+      const std::shared_ptr<MapConcurrentState<TItem, T, Func>>& pState,
+      size_t index) {
+    const auto fail = [pState, index](const std::exception_ptr& pError) {
+      std::lock_guard<std::mutex> lock(pState->mutex);
+      if (!pState->pError || index < pState->errorIndex) {
+        pState->pError = pError;
+        pState->errorIndex = index;
+      }
+      --pState->pending;
+    };
+
+    try {
+      auto future = pState->f(std::move(pState->items[index]));
+      future._task.then(
+          async::inline_scheduler(),
+          [pState, index, fail](auto&& task) {
+            std::exception_ptr pError = task.get_exception();
+            if (pError) {
+              fail(pError);
+            } else if constexpr (std::is_void_v<T>) {
+              std::lock_guard<std::mutex> lock(pState->mutex);
+              --pState->pending;
+            } else {
+              std::optional<T> result(task.get());
+              std::lock_guard<std::mutex> lock(pState->mutex);
+              pState->results[index] = std::move(result);
+              --pState->pending;
+            }
+            AsyncSystem::pumpMapConcurrent(pState);
+          });
+    } catch (...) {
+      fail(std::current_exception());
+    }
+  }
+
   // Common implementation of 'all' for both Future and SharedFuture.
   template <typename T, typename TFutureType>
   Future<std::vector<T>> all(std::vector<TFutureType>&& futures) const {
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "AsyncSystem.h"
+#include "Future.h"
+#include "Library.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace CesiumAsync {
+class IAssetAccessor;
+class IAssetRequest;
+class ICacheDatabase;
+
+/**
+ * @brief Caches the responses of endpoints that describe how to access a
+ * resource, such as the endpoint of a Cesium ion asset.
+ *
+ * A single instance can be shared by everything that accesses the same
+ * resources, so that each endpoint is only requested once. Successful
+ * responses are kept until they expire, in memory and, if a database is
+ * given, in the database, so that later sessions can use them without
+ * requesting the endpoint again. A response expires as indicated by its
+ * `Cache-Control` or `Expires` header or, if it has neither, after the
+ * default lifetime of the cache. Responses with a `Cache-Control` header of
+ * `no-store` or `no-cache` are not kept at all.
+ *
+ * Responses to requests that were authorized with an access token, in an
+ * `access_token` query parameter or an `Authorization` header, and responses
+ * with an `accessToken` property are only kept in memory unless the cache is
+ * allowed to persist them. Every response of a Cesium ion asset endpoint has
+ * an `accessToken` property, so by default none of them are persisted, and
+ * the database is only of use for them when `persistAccessTokens` is true.
+ *
+ * A response that is about to expire is still used, but the endpoint is
+ * requested again in the background to replace it. Concurrent requests for
+ * the same endpoint are coalesced into a single request.
+ *
+ * All methods may be called from any thread.
+ */
+class CESIUMASYNC_API EndpointCache final {
+public:
+  /**
+   * @brief Creates a new instance.
+   *
+   * @param pCacheDatabase The database in which to persist responses, or
+   * `nullptr` to only keep them in memory.
+   * @param defaultLifetime How long responses without a `Cache-Control` or
+   * `Expires` header are used. Endpoints often include access tokens in their
+   * responses, so this should be shorter than the lifetime of those tokens.
+   * @param refreshMargin How long before a response expires to request the
+   * endpoint again.
+   * @param persistAccessTokens Whether responses that hold or were authorized
+   * with an access token may be stored in the database. This includes the
+   * responses of all Cesium ion asset endpoints, so when it is false, which is
+   * the default, they are only kept in memory whether a database is given or
+   * not. Only set it to true if the database is stored where the access
+   * tokens of the application may be kept.
+   */
+  EndpointCache(
+      const std::shared_ptr<ICacheDatabase>& pCacheDatabase = nullptr,
+      std::chrono::seconds defaultLifetime = std::chrono::minutes(30),
+      std::chrono::seconds refreshMargin = std::chrono::minutes(5),
+      bool persistAccessTokens = false);
+
+  /**
+   * @brief Gets an instance that only keeps responses in memory and is shared
+   * by the whole process.
+   *
+   * It is used by the Cesium ion tilesets and raster overlays that are not
+   * given a cache of their own.
+   */
+  static const std::shared_ptr<EndpointCache>& getDefault();
+
+  /**
+   * @brief Gets the response of an endpoint.
+   *
+   * If the cache holds a response that has not expired, the returned future
+   * resolves to it. Otherwise, the endpoint is requested with the given asset
+   * accessor, and the future resolves to the completed request, whether it
+   * was successful or not.
+   *
+   * @param asyncSystem The async system.
+   * @param pAssetAccessor The asset accessor with which to request the
+   * endpoint.
+   * @param url The URL of the endpoint.
+   * @return A future that resolves to the request.
+   */
+  Future<std::shared_ptr<IAssetRequest>>
+  get(const AsyncSystem& asyncSystem,
+      const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
+      const std::string& url);
+
+  /**
+   * @brief Discards the response of an endpoint, such as after the access
+   * token in it was rejected, so that the next {@link get} requests the
+   * endpoint again.
+   *
+   * The response is removed from the database, if any, before this method
+   * returns. A request for the endpoint that is in progress still resolves
+   * the futures that are waiting for it, but its response is not kept.
+   *
+   * @param url The URL of the endpoint.
+   */
+  void invalidate(const std::string& url);
+
+private:
+  struct State;
+
+  std::shared_ptr<State> _pState;
+};
+
+} // namespace CesiumAsync
@@ -62,6 +62,15 @@ public:
    */
   virtual bool prune() = 0;
 
+  /**
+   * @brief Removes a single cache entry from the database.
+   *
+   * @param key The unique key associated with the cache entry.
+   * @return `true` if the entry was removed or did not exist, or `false` if it
+   * could not be removed due to an error.
+   */
+  virtual bool removeEntry(const std::string& key) = 0;
+
   /**
    * @brief Removes all cache entries from the database.
    *
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Library.h"
+#include "TaskFunction.h"
 
 #include <functional>
 
@@ -11,7 +12,7 @@ namespace CesiumAsync {
  *
  * Not supposed to be used by clients.
  */
-class ITaskProcessor {
+class CESIUMASYNC_API ITaskProcessor {
 public:
   /**
    * @brief Default destructor
@@ -25,5 +26,23 @@ public:
    * @param f The function to execute
    */
   virtual void startTask(std::function<void()> f) = 0;
+
+  /**
+   * @brief Starts a task that executes the given move-only function in a
+   * background thread.
+   *
+   * This is how an {@link AsyncSystem} starts its worker thread tasks. The
+   * function owns its task and stores it in place, so if the function is
+   * destroyed without being invoked, the task is canceled and its future is
+   * rejected.
+   *
+   * The default implementation moves the function into reference-counted
+   * storage, recycled like the storage of the function itself, and passes a
+   * `std::function` that invokes it once to {@link startTask}. Override it to
+   * pass the function to a thread without that extra step.
+   *
+   * @param f The function to execute.
+   */
+  virtual void startTaskFunction(TaskFunction&& f);
 };
 } // namespace CesiumAsync
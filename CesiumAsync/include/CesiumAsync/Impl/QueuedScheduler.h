@@ -4,6 +4,10 @@
 #include "cesium-async++.h"
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
 
 namespace CesiumAsync {
 namespace CesiumImpl {
@@ -14,7 +18,17 @@ public:
   ~QueuedScheduler();
 
   void schedule(async::task_run_handle t);
+
+  // Schedules a function to be invoked by the thread that dispatches the
+  // queued continuations, once the deadline has passed. Returns an ID that
+  // can be passed to cancelTimer.
+  uint64_t scheduleTimer(
+      std::chrono::steady_clock::time_point deadline,
+      std::function<void()>&& f);
+  void cancelTimer(uint64_t id);
+
   void dispatchQueuedContinuations();
+  bool dispatchQueuedContinuations(std::chrono::steady_clock::duration maxTime);
   bool dispatchZeroOrOneContinuation();
 
   template <typename T> T dispatchUntilTaskCompletes(async::task<T>&& task) {
@@ -81,6 +95,7 @@ public:
 
 private:
   bool dispatchInternal(bool blockIfNoTasks);
+  bool dispatchExpiredTimers();
   void unblock();
 
   struct Impl;
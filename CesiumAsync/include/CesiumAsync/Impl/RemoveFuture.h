@@ -39,6 +39,8 @@ template <typename T> struct RemoveFuture<const async::shared_task<T>> {
   typedef T type;
 };
 
+template <typename T> using RemoveFuture_t = typename RemoveFuture<T>::type;
+
 //! @endcond
 // End omitting doxgen warnings for Impl namespace
 } // namespace CesiumImpl
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace CesiumAsync {
+namespace CesiumImpl {
+// Begin omitting doxgen warnings for Impl namespace
+//! @cond Doxygen_Suppress
+
+// Holds functions to be invoked once their deadlines have passed. The queue
+// has no thread of its own. Instead, the thread that dispatches main-thread
+// tasks invokes the functions whose deadlines have passed.
+class TimerQueue {
+public:
+  TimerQueue() = default;
+
+  TimerQueue(const TimerQueue&) = delete;
+  TimerQueue& operator=(const TimerQueue&) = delete;
+
+  // Schedules a function to be invoked by dispatchExpired at or after the
+  // deadline. May be called from any thread. The returned ID can be used to
+  // cancel it. Functions that have not been invoked when the queue is
+  // destroyed are destroyed without being invoked.
+  uint64_t schedule(
+      std::chrono::steady_clock::time_point deadline,
+      std::function<void()>&& f);
+
+  // Cancels a function so that it is never invoked. Does nothing if the
+  // function was already invoked or canceled. May be called from any thread.
+  void cancel(uint64_t id);
+
+  // Gets the earliest deadline of the scheduled functions, if any.
+  std::optional<std::chrono::steady_clock::time_point> nextDeadline();
+
+  // Invokes, in the calling thread, the functions whose deadlines have
+  // passed, in order of deadline. Returns true if any function was invoked.
+  bool dispatchExpired();
+
+private:
+  std::mutex _mutex;
+  uint64_t _nextId = 1;
+
+  // The number of scheduled functions, so that an empty queue can be checked
+  // without taking the lock.
+  std::atomic<size_t> _size{0};
+
+  // The functions to invoke, ordered by deadline and then by ID so that
+  // functions with the same deadline run in the order they were scheduled.
+  std::map<
+      std::pair<std::chrono::steady_clock::time_point, uint64_t>,
+      std::function<void()>>
+      _timers;
+  std::map<uint64_t, std::chrono::steady_clock::time_point> _deadlines;
+};
+
+//! @endcond
+// End omitting doxgen warnings for Impl namespace
+} // namespace CesiumImpl
+} // namespace CesiumAsync
@@ -52,6 +52,9 @@ public:
   /** @copydoc ICacheDatabase::prune*/
   virtual bool prune() override;
 
+  /** @copydoc ICacheDatabase::removeEntry*/
+  virtual bool removeEntry(const std::string& key) override;
+
   /** @copydoc ICacheDatabase::clearAll*/
   virtual bool clearAll() override;
 
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Library.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace CesiumAsync {
+//! @cond Doxygen_Suppress
+namespace CesiumImpl {
+// Allocates and frees the storage of callables that are too large to be
+// stored in place in a TaskFunction. Blocks of common sizes are recycled
+// rather than returned to the heap.
+CESIUMASYNC_API void* allocateTaskStorage(size_t size);
+CESIUMASYNC_API void freeTaskStorage(void* p, size_t size) noexcept;
+} // namespace CesiumImpl
+//! @endcond
+
+/**
+ * @brief A function that takes no parameters and returns nothing, and that
+ * can be moved but not copied.
+ *
+ * Unlike a `std::function`, it can hold a callable that cannot be copied,
+ * such as one that owns a task. A callable of no more than
+ * {@link TaskFunction::InlineSize} bytes that can be moved without throwing
+ * is stored in place. A larger one is stored in a block that is recycled when
+ * the function is destroyed, so that creating a function rarely allocates.
+ */
+class TaskFunction {
+public:
+  /**
+   * @brief The size in bytes of the largest callable stored in place.
+   */
+  static constexpr size_t InlineSize = 4 * sizeof(void*);
+
+  /**
+   * @brief Creates an empty function.
+   */
+  TaskFunction() noexcept : _pVTable(nullptr) {}
+
+  /**
+   * @brief Creates a function that invokes the given callable.
+   *
+   * @param f The callable, which is moved or copied into the function.
+   */
+  template <
+      typename Func,
+      typename = std::enable_if_t<
+          !std::is_same_v<std::decay_t<Func>, TaskFunction>>>
+  TaskFunction(Func&& f) : _pVTable(&vtableFor<std::decay_t<Func>>) {
+    using F = std::decay_t<Func>;
+    static_assert(
+        alignof(F) <= alignof(std::max_align_t),
+        "Over-aligned callables are not supported.");
+
+    if constexpr (isStoredInPlace<F>) {
+      new (this->_storage) F(std::forward<Func>(f));
+    } else {
+      void* pCallable = CesiumImpl::allocateTaskStorage(sizeof(F));
+      try {
+        new (pCallable) F(std::forward<Func>(f));
+      } catch (...) {
+        CesiumImpl::freeTaskStorage(pCallable, sizeof(F));
+        throw;
+      }
+      new (this->_storage) F*(static_cast<F*>(pCallable));
+    }
+  }
+
+  /**
+   * @brief Moves the callable of another function into a new one, leaving
+   * the other function empty.
+   */
+  TaskFunction(TaskFunction&& rhs) noexcept : _pVTable(rhs._pVTable) {
+    if (this->_pVTable) {
+      this->_pVTable->move(rhs._storage, this->_storage);
+      rhs._pVTable = nullptr;
+    }
+  }
+
+  /**
+   * @brief Destroys the callable of this function and moves the callable of
+   * another function into it, leaving the other function empty.
+   */
+  TaskFunction& operator=(TaskFunction&& rhs) noexcept {
+    if (this != &rhs) {
+      this->reset();
+      if (rhs._pVTable) {
+        rhs._pVTable->move(rhs._storage, this->_storage);
+        this->_pVTable = rhs._pVTable;
+        rhs._pVTable = nullptr;
+      }
+    }
+    return *this;
+  }
+
+  TaskFunction(const TaskFunction&) = delete;
+  TaskFunction& operator=(const TaskFunction&) = delete;
+
+  /**
+   * @brief Destroys the callable without invoking it.
+   */
+  ~TaskFunction() noexcept { this->reset(); }
+
+  /**
+   * @brief Determines if this function has a callable.
+   */
+  explicit operator bool() const noexcept { return this->_pVTable != nullptr; }
+
+  /**
+   * @brief Invokes the callable. The function must not be empty.
+   */
+  void operator()() { this->_pVTable->invoke(this->_storage); }
+
+  /**
+   * @brief Destroys the callable, leaving this function empty.
+   */
+  void reset() noexcept {
+    if (this->_pVTable) {
+      this->_pVTable->destroy(this->_storage);
+      this->_pVTable = nullptr;
+    }
+  }
+
+private:
+  struct VTable {
+    void (*invoke)(std::byte* pStorage);
+    void (*move)(std::byte* pFrom, std::byte* pTo) noexcept;
+    void (*destroy)(std::byte* pStorage) noexcept;
+  };
+
+  template <typename F>
+  static constexpr bool isStoredInPlace =
+      sizeof(F) <= InlineSize && std::is_nothrow_move_constructible_v<F>;
+
+  template <typename F> static F* getCallable(std::byte* pStorage) noexcept {
+    if constexpr (isStoredInPlace<F>) {
+      return std::launder(reinterpret_cast<F*>(pStorage));
+    } else {
+      return *std::launder(reinterpret_cast<F**>(pStorage));
+    }
+  }
+
+  template <typename F> static void invoke(std::byte* pStorage) {
+    (*getCallable<F>(pStorage))();
+  }
+
+  template <typename F>
+  static void move(std::byte* pFrom, std::byte* pTo) noexcept {
+    F* pCallable = getCallable<F>(pFrom);
+    if constexpr (isStoredInPlace<F>) {
+      new (pTo) F(std::move(*pCallable));
+      pCallable->~F();
+    } else {
+      new (pTo) F*(pCallable);
+    }
+  }
+
+  template <typename F> static void destroy(std::byte* pStorage) noexcept {
+    F* pCallable = getCallable<F>(pStorage);
+    pCallable->~F();
+    if constexpr (!isStoredInPlace<F>) {
+      CesiumImpl::freeTaskStorage(pCallable, sizeof(F));
+    }
+  }
+
+  template <typename F>
+  static constexpr VTable vtableFor{&invoke<F>, &move<F>, &destroy<F>};
+
+  const VTable* _pVTable;
+  alignas(std::max_align_t) std::byte _storage[InlineSize];
+};
+} // namespace CesiumAsync
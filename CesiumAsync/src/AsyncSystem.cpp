@@ -13,6 +13,11 @@ void AsyncSystem::dispatchMainThreadTasks() {
   this->_pSchedulers->mainThread.dispatchQueuedContinuations();
 }
 
+bool AsyncSystem::dispatchMainThreadTasks(
+    std::chrono::steady_clock::duration maxTime) {
+  return this->_pSchedulers->mainThread.dispatchQueuedContinuations(maxTime);
+}
+
 bool AsyncSystem::dispatchOneMainThreadTask() {
   return this->_pSchedulers->mainThread.dispatchZeroOrOneContinuation();
 }
@@ -0,0 +1,401 @@
+#include "CesiumAsync/EndpointCache.h"
+
+#include "CesiumAsync/CacheItem.h"
+#include "CesiumAsync/IAssetAccessor.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumAsync/ICacheDatabase.h"
+#include "CesiumAsync/Promise.h"
+#include "CesiumAsync/SharedFuture.h"
+#include "InternalTimegm.h"
+#include "ResponseCacheControl.h"
+
+#include <CesiumUtility/Uri.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <exception>
+#include <iomanip>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <unordered_map>
+
+namespace CesiumAsync {
+namespace {
+class CachedEndpointResponse : public IAssetResponse {
+public:
+  CachedEndpointResponse(CacheResponse&& response) noexcept
+      : _response(std::move(response)) {}
+
+  virtual uint16_t statusCode() const noexcept override {
+    return this->_response.statusCode;
+  }
+
+  virtual std::string contentType() const override {
+    auto it = this->_response.headers.find("Content-Type");
+    if (it == this->_response.headers.end()) {
+      return std::string();
+    }
+    return it->second;
+  }
+
+  virtual const HttpHeaders& headers() const noexcept override {
+    return this->_response.headers;
+  }
+
+  virtual gsl::span<const std::byte> data() const noexcept override {
+    return gsl::span<const std::byte>(
+        this->_response.data.data(),
+        this->_response.data.size());
+  }
+
+private:
+  CacheResponse _response;
+};
+
+class CachedEndpointRequest : public IAssetRequest {
+public:
+  CachedEndpointRequest(CacheItem&& cacheItem)
+      : _request(std::move(cacheItem.cacheRequest)),
+        _response(std::move(cacheItem.cacheResponse)) {}
+
+  virtual const std::string& method() const noexcept override {
+    return this->_request.method;
+  }
+
+  virtual const std::string& url() const noexcept override {
+    return this->_request.url;
+  }
+
+  virtual const HttpHeaders& headers() const noexcept override {
+    return this->_request.headers;
+  }
+
+  virtual const IAssetResponse* response() const noexcept override {
+    return &this->_response;
+  }
+
+private:
+  CacheRequest _request;
+  CachedEndpointResponse _response;
+};
+
+bool isSuccessful(const IAssetRequest& request) {
+  const IAssetResponse* pResponse = request.response();
+  return pResponse && pResponse->statusCode() >= 200 &&
+         pResponse->statusCode() < 300;
+}
+
+// Determines if a request for an endpoint was authorized with an access
+// token, or if its response holds one, as the endpoints of Cesium ion assets
+// do.
+bool holdsAccessToken(const IAssetRequest& request) {
+  if (!CesiumUtility::Uri::getQueryValue(request.url(), "access_token")
+           .empty() ||
+      request.headers().find("Authorization") != request.headers().end()) {
+    return true;
+  }
+
+  static const std::string accessToken = "\"accessToken\"";
+  gsl::span<const std::byte> data = request.response()->data();
+  return std::search(
+             data.begin(),
+             data.end(),
+             accessToken.begin(),
+             accessToken.end(),
+             [](std::byte b, char c) { return b == std::byte(c); }) !=
+         data.end();
+}
+
+// Returns the time at which the response expires, which is not after the
+// current time if it must not be cached.
+std::time_t calculateExpiryTime(
+    const IAssetResponse& response,
+    std::chrono::seconds defaultLifetime) {
+  const std::time_t now = std::time(nullptr);
+  const HttpHeaders& headers = response.headers();
+
+  std::optional<ResponseCacheControl> cacheControl =
+      ResponseCacheControl::parseFromResponseHeaders(headers);
+  if (cacheControl && (cacheControl->noStore() || cacheControl->noCache())) {
+    return now;
+  }
+
+  if (cacheControl && cacheControl->maxAgeExists()) {
+    return now + cacheControl->maxAgeValue();
+  }
+
+  HttpHeaders::const_iterator expiresHeader = headers.find("Expires");
+  if (expiresHeader != headers.end()) {
+    std::tm tm = {};
+    std::stringstream ss(expiresHeader->second);
+    ss >> std::get_time(&tm, "%a, %d %b %Y %H:%M:%S");
+    if (!ss.fail()) {
+      return internalTimegm(&tm);
+    }
+  }
+
+  return now + static_cast<std::time_t>(defaultLifetime.count());
+}
+} // namespace
+
+struct EndpointCache::State {
+  struct Entry {
+    // The last successful response that has not been invalidated, if any.
+    std::shared_ptr<IAssetRequest> pRequest;
+    std::time_t expiryTime = 0;
+
+    // The request for the endpoint that is in progress, if any, and the
+    // number that identifies it.
+    std::optional<SharedFuture<std::shared_ptr<IAssetRequest>>> pending;
+    uint64_t fetchID = 0;
+  };
+
+  struct FetchResult {
+    std::shared_ptr<IAssetRequest> pRequest;
+    std::time_t expiryTime;
+  };
+
+  std::shared_ptr<ICacheDatabase> pCacheDatabase;
+  std::chrono::seconds defaultLifetime;
+  std::chrono::seconds refreshMargin;
+  bool persistAccessTokens;
+
+  std::mutex mutex;
+  std::unordered_map<std::string, Entry> entries;
+  uint64_t lastFetchID = 0;
+
+  static void fetch(
+      const std::shared_ptr<State>& pState,
+      const AsyncSystem& asyncSystem,
+      const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
+      const std::string& url,
+      const Promise<std::shared_ptr<IAssetRequest>>& promise,
+      uint64_t fetchID,
+      bool checkDatabase);
+
+  // Gets the entry that the given request for an endpoint belongs to, or
+  // nullptr if the entry was invalidated while it was in progress.
+  Entry* findFetchEntry(const std::string& url, uint64_t fetchID);
+
+  // Removes the entries whose response has expired, unless they are being
+  // requested.
+  void evictExpiredEntries(std::time_t now);
+};
+
+EndpointCache::State::Entry*
+EndpointCache::State::findFetchEntry(const std::string& url, uint64_t fetchID) {
+  auto it = this->entries.find(url);
+  if (it == this->entries.end() || it->second.fetchID != fetchID) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+void EndpointCache::State::evictExpiredEntries(std::time_t now) {
+  for (auto it = this->entries.begin(); it != this->entries.end();) {
+    const Entry& entry = it->second;
+    if (!entry.pending && entry.expiryTime <= now) {
+      it = this->entries.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+/*static*/ void EndpointCache::State::fetch(
+    const std::shared_ptr<State>& pState,
+    const AsyncSystem& asyncSystem,
+    const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
+    const std::string& url,
+    const Promise<std::shared_ptr<IAssetRequest>>& promise,
+    uint64_t fetchID,
+    bool checkDatabase) {
+  std::shared_ptr<ICacheDatabase> pCacheDatabase =
+      checkDatabase ? pState->pCacheDatabase : nullptr;
+
+  asyncSystem
+      .runInWorkerThread([pCacheDatabase, url]() -> std::optional<CacheItem> {
+        if (!pCacheDatabase) {
+          return std::nullopt;
+        }
+
+        std::optional<CacheItem> maybeItem = pCacheDatabase->getEntry(url);
+        if (!maybeItem) {
+          return std::nullopt;
+        }
+
+        if (maybeItem->expiryTime <= std::time(nullptr)) {
+          pCacheDatabase->prune();
+          return std::nullopt;
+        }
+
+        return maybeItem;
+      })
+      .thenImmediately([pState, asyncSystem, pAssetAccessor, url](
+                           std::optional<CacheItem>&& maybeItem)
+                           -> Future<FetchResult> {
+        if (maybeItem) {
+          const std::time_t expiryTime = maybeItem->expiryTime;
+          return asyncSystem.createResolvedFuture(FetchResult{
+              std::make_shared<CachedEndpointRequest>(std::move(*maybeItem)),
+              expiryTime});
+        }
+
+        return pAssetAccessor->get(asyncSystem, url)
+            .thenInWorkerThread(
+                [pState, url](std::shared_ptr<IAssetRequest>&& pRequest) {
+                  if (!isSuccessful(*pRequest)) {
+                    return FetchResult{std::move(pRequest), 0};
+                  }
+
+                  const IAssetResponse* pResponse = pRequest->response();
+                  const std::time_t expiryTime = calculateExpiryTime(
+                      *pResponse,
+                      pState->defaultLifetime);
+                  if (pState->pCacheDatabase &&
+                      expiryTime > std::time(nullptr) &&
+                      (pState->persistAccessTokens ||
+                       !holdsAccessToken(*pRequest))) {
+                    pState->pCacheDatabase->storeEntry(
+                        url,
+                        expiryTime,
+                        pRequest->url(),
+                        pRequest->method(),
+                        pRequest->headers(),
+                        pResponse->statusCode(),
+                        pResponse->headers(),
+                        pResponse->data());
+                  }
+
+                  return FetchResult{std::move(pRequest), expiryTime};
+                });
+      })
+      .thenImmediately([pState, url, promise, fetchID](FetchResult&& result) {
+        {
+          // The response of a request that was in progress when the endpoint
+          // was invalidated is given to those waiting for it, but not kept.
+          std::lock_guard<std::mutex> lock(pState->mutex);
+          Entry* pEntry = pState->findFetchEntry(url, fetchID);
+          if (pEntry) {
+            pEntry->pending.reset();
+
+            // A failed request does not replace a response that is still
+            // valid, so that a failed background refresh goes unnoticed. A
+            // successful response that must not be cached does.
+            const std::time_t now = std::time(nullptr);
+            if (result.expiryTime > now) {
+              pEntry->pRequest = result.pRequest;
+              pEntry->expiryTime = result.expiryTime;
+            } else if (isSuccessful(*result.pRequest)) {
+              pEntry->pRequest.reset();
+              pEntry->expiryTime = 0;
+            }
+
+            pState->evictExpiredEntries(now);
+          }
+        }
+
+        promise.resolve(std::move(result.pRequest));
+      })
+      .catchImmediately([pState, url, promise, fetchID](std::exception&& e) {
+        {
+          std::lock_guard<std::mutex> lock(pState->mutex);
+          Entry* pEntry = pState->findFetchEntry(url, fetchID);
+          if (pEntry) {
+            pEntry->pending.reset();
+          }
+        }
+
+        promise.reject(std::move(e));
+      });
+}
+
+EndpointCache::EndpointCache(
+    const std::shared_ptr<ICacheDatabase>& pCacheDatabase,
+    std::chrono::seconds defaultLifetime,
+    std::chrono::seconds refreshMargin,
+    bool persistAccessTokens)
+    : _pState(std::make_shared<State>()) {
+  this->_pState->pCacheDatabase = pCacheDatabase;
+  this->_pState->defaultLifetime = defaultLifetime;
+  this->_pState->refreshMargin = refreshMargin;
+  this->_pState->persistAccessTokens = persistAccessTokens;
+}
+
+/*static*/ const std::shared_ptr<EndpointCache>& EndpointCache::getDefault() {
+  static const std::shared_ptr<EndpointCache> pDefault =
+      std::make_shared<EndpointCache>();
+  return pDefault;
+}
+
+Future<std::shared_ptr<IAssetRequest>> EndpointCache::get(
+    const AsyncSystem& asyncSystem,
+    const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
+    const std::string& url) {
+  const std::time_t now = std::time(nullptr);
+  const std::time_t refreshMargin =
+      static_cast<std::time_t>(this->_pState->refreshMargin.count());
+
+  std::shared_ptr<IAssetRequest> pCached;
+  std::optional<SharedFuture<std::shared_ptr<IAssetRequest>>> pending;
+  std::optional<Promise<std::shared_ptr<IAssetRequest>>> fetched;
+  uint64_t fetchID = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(this->_pState->mutex);
+    State::Entry& entry = this->_pState->entries[url];
+    if (entry.pRequest && now < entry.expiryTime) {
+      pCached = entry.pRequest;
+    }
+
+    // Refresh a response that is about to expire in the background, but
+    // only look for a persisted one when there is nothing to use meanwhile.
+    const bool needsRequest =
+        !pCached || now >= entry.expiryTime - refreshMargin;
+    if (needsRequest && !entry.pending) {
+      fetched = asyncSystem.createPromise<std::shared_ptr<IAssetRequest>>();
+      entry.pending = fetched->getFuture().share();
+      entry.fetchID = fetchID = ++this->_pState->lastFetchID;
+    }
+
+    if (!pCached) {
+      pending = entry.pending;
+    }
+  }
+
+  // Start the request without holding the lock, because it may complete
+  // synchronously.
+  if (fetched) {
+    State::fetch(
+        this->_pState,
+        asyncSystem,
+        pAssetAccessor,
+        url,
+        *fetched,
+        fetchID,
+        !pCached);
+  }
+
+  if (pCached) {
+    return asyncSystem.createResolvedFuture(std::move(pCached));
+  }
+
+  return pending->thenImmediately(
+      [](const std::shared_ptr<IAssetRequest>& pRequest) { return pRequest; });
+}
+
+void EndpointCache::invalidate(const std::string& url) {
+  {
+    std::lock_guard<std::mutex> lock(this->_pState->mutex);
+    this->_pState->entries.erase(url);
+  }
+
+  if (this->_pState->pCacheDatabase) {
+    this->_pState->pCacheDatabase->removeEntry(url);
+  }
+}
+
+} // namespace CesiumAsync
@@ -0,0 +1,59 @@
+#include "CesiumAsync/ITaskProcessor.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace CesiumAsync {
+
+namespace {
+// Allocates the control block and function of a shared_ptr<TaskFunction> from
+// the recycled storage of TaskFunction.
+template <typename T> struct TaskStorageAllocator {
+  using value_type = T;
+
+  TaskStorageAllocator() noexcept = default;
+
+  template <typename U>
+  TaskStorageAllocator(const TaskStorageAllocator<U>&) noexcept {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(CesiumImpl::allocateTaskStorage(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t n) noexcept {
+    CesiumImpl::freeTaskStorage(p, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const TaskStorageAllocator<U>&) const noexcept {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const TaskStorageAllocator<U>&) const noexcept {
+    return false;
+  }
+};
+} // namespace
+
+void ITaskProcessor::startTaskFunction(TaskFunction&& f) {
+  // std::function must be copyable, so the move-only function is shared by
+  // all copies of it. The first copy invoked moves the function out and
+  // invokes it, and the function is destroyed with the last copy if none is
+  // invoked.
+  std::shared_ptr<TaskFunction> pFunction = std::allocate_shared<TaskFunction>(
+      TaskStorageAllocator<TaskFunction>(),
+      std::move(f));
+
+  this->startTask([pFunction = std::move(pFunction)]() {
+    if (!*pFunction) {
+      return;
+    }
+
+    TaskFunction function = std::move(*pFunction);
+    function();
+  });
+}
+
+} // namespace CesiumAsync
@@ -1,32 +1,183 @@
 #include "CesiumAsync/Impl/QueuedScheduler.h"
 
+#include "CesiumAsync/Impl/TimerQueue.h"
+
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
-
-// Hackily use Async++'s internal fifo_queue. We could copy it instead - it's
-// not much code - but why create the duplication? However, we are assuming that
-// Async++'s source (not just headers) are available while building
-// cesium-native. If that's a problem in some context, we'll need to do that
-// duplication of fifo_queue after all.
-#include <async++/../../src/fifo_queue.h>
+#include <optional>
 
 namespace CesiumAsync::CesiumImpl {
 
+// Tasks are scheduled from any number of threads but dispatched from only
+// one thread at a time, normally the main thread. So scheduling pushes onto a
+// lock-free stack, and dispatching takes the entire stack at once and puts it
+// back in scheduling order in a list that only the dispatching thread uses.
+// The mutex and condition variable are only used to wake a dispatching
+// thread that is blocked waiting for tasks.
+//
+// The nodes of the stack are recycled rather than allocated for each task.
+// The dispatching thread returns the node of each task it takes to a stack
+// shared by all schedulers, and a scheduling thread that runs out of nodes
+// takes that whole stack for its own use. The shared stack is only pushed
+// onto and emptied at once, so it does not suffer from the ABA problem.
+//
+// Timers are dispatched by the same thread as the tasks, and a thread blocked
+// waiting for tasks wakes up when the earliest timer is due.
 struct QueuedScheduler::Impl {
-  async::detail::fifo_queue queue;
+  struct Node {
+    void* pTask;
+    Node* pNext;
+  };
+
+  struct LocalNodes {
+    Node* pFirst = nullptr;
+
+    ~LocalNodes() noexcept {
+      while (this->pFirst) {
+        Node* pNext = this->pFirst->pNext;
+        delete this->pFirst;
+        this->pFirst = pNext;
+      }
+    }
+  };
+
+  // The nodes that the current thread may use.
+  static LocalNodes& getLocalNodes() noexcept {
+    static thread_local LocalNodes localNodes;
+    return localNodes;
+  }
+
+  // The nodes released by dispatching threads. This is never destroyed, so
+  // that threads that exit late can still release nodes.
+  static std::atomic<Node*>& getSharedNodes() noexcept {
+    static std::atomic<Node*> sharedNodes{nullptr};
+    return sharedNodes;
+  }
+
+  static Node* allocateNode(void* pTask, Node* pNext) {
+    LocalNodes& localNodes = getLocalNodes();
+    if (!localNodes.pFirst) {
+      localNodes.pFirst = getSharedNodes().exchange(nullptr);
+    }
+
+    Node* pNode = localNodes.pFirst;
+    if (!pNode) {
+      return new Node{pTask, pNext};
+    }
+
+    localNodes.pFirst = pNode->pNext;
+    pNode->pTask = pTask;
+    pNode->pNext = pNext;
+    return pNode;
+  }
+
+  static void releaseNode(Node* pNode) noexcept {
+    std::atomic<Node*>& sharedNodes = getSharedNodes();
+    pNode->pNext = sharedNodes.load();
+    while (!sharedNodes.compare_exchange_weak(pNode->pNext, pNode)) {
+    }
+  }
+
+  ~Impl() {
+    freeNodes(this->pIncoming.exchange(nullptr));
+    freeNodes(this->pPending);
+  }
+
+  static void freeNodes(Node* pNode) noexcept {
+    while (pNode) {
+      Node* pNext = pNode->pNext;
+      // Destroying the handle without running it cancels the task.
+      async::task_run_handle::from_void_ptr(pNode->pTask);
+      releaseNode(pNode);
+      pNode = pNext;
+    }
+  }
+
+  void push(async::task_run_handle&& t) {
+    Node* pNode = allocateNode(t.to_void_ptr(), this->pIncoming.load());
+    while (!this->pIncoming.compare_exchange_weak(pNode->pNext, pNode)) {
+    }
+  }
+
+  async::task_run_handle pop() {
+    if (!this->pPending) {
+      // Take everything scheduled so far, and reverse it so that the oldest
+      // task is first.
+      Node* pNode = this->pIncoming.exchange(nullptr);
+      while (pNode) {
+        Node* pNext = pNode->pNext;
+        pNode->pNext = this->pPending;
+        this->pPending = pNode;
+        pNode = pNext;
+      }
+    }
+
+    if (!this->pPending) {
+      return async::task_run_handle();
+    }
+
+    Node* pNode = this->pPending;
+    this->pPending = pNode->pNext;
+    async::task_run_handle t =
+        async::task_run_handle::from_void_ptr(pNode->pTask);
+    releaseNode(pNode);
+    return t;
+  }
+
+  bool empty() const noexcept {
+    return !this->pPending && !this->pIncoming.load();
+  }
+
+  // Newly scheduled tasks, most recent first.
+  std::atomic<Node*> pIncoming{nullptr};
+
+  // Tasks taken from pIncoming, oldest first. Only used by the dispatching
+  // thread.
+  Node* pPending = nullptr;
+
+  // The number of threads blocked waiting for tasks.
+  std::atomic<int32_t> waitingThreads{0};
+
   std::mutex mutex;
   std::condition_variable conditionVariable;
+
+  TimerQueue timers;
 };
 
 QueuedScheduler::QueuedScheduler() : _pImpl(std::make_unique<Impl>()) {}
 QueuedScheduler::~QueuedScheduler() = default;
 
 void QueuedScheduler::schedule(async::task_run_handle t) {
-  std::unique_lock<std::mutex> guard(this->_pImpl->mutex);
-  this->_pImpl->queue.push(std::move(t));
+  this->_pImpl->push(std::move(t));
 
-  // Notify listeners that there is new work.
-  this->_pImpl->conditionVariable.notify_all();
+  // Notify listeners that there is new work, but only take the lock if
+  // someone is listening. Both this load and the push above are sequentially
+  // consistent, so a thread that starts waiting after this load is guaranteed
+  // to see the new task before it blocks.
+  if (this->_pImpl->waitingThreads.load() > 0) {
+    std::unique_lock<std::mutex> guard(this->_pImpl->mutex);
+    this->_pImpl->conditionVariable.notify_all();
+  }
+}
+
+uint64_t QueuedScheduler::scheduleTimer(
+    std::chrono::steady_clock::time_point deadline,
+    std::function<void()>&& f) {
+  const uint64_t id = this->_pImpl->timers.schedule(deadline, std::move(f));
+
+  // A blocked thread may be waiting for a later timer, or for no timer at
+  // all, so wake it up to wait for this one instead.
+  if (this->_pImpl->waitingThreads.load() > 0) {
+    std::unique_lock<std::mutex> guard(this->_pImpl->mutex);
+    this->_pImpl->conditionVariable.notify_all();
+  }
+
+  return id;
+}
+
+void QueuedScheduler::cancelTimer(uint64_t id) {
+  this->_pImpl->timers.cancel(id);
 }
 
 void QueuedScheduler::dispatchQueuedContinuations() {
@@ -34,19 +185,48 @@ void QueuedScheduler::dispatchQueuedContinuations() {
   }
 }
 
+bool QueuedScheduler::dispatchQueuedContinuations(
+    std::chrono::steady_clock::duration maxTime) {
+  const std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + maxTime;
+
+  // Always run at least one task, so that progress is made even with a tiny
+  // budget.
+  do {
+    if (!this->dispatchZeroOrOneContinuation()) {
+      return true;
+    }
+  } while (std::chrono::steady_clock::now() < deadline);
+
+  return this->_pImpl->empty();
+}
+
 bool QueuedScheduler::dispatchZeroOrOneContinuation() {
   return this->dispatchInternal(false);
 }
 
 bool QueuedScheduler::dispatchInternal(bool blockIfNoTasks) {
-  async::task_run_handle t;
+  if (this->dispatchExpiredTimers()) {
+    return true;
+  }
 
-  {
+  async::task_run_handle t = this->_pImpl->pop();
+
+  if (blockIfNoTasks && !t) {
     std::unique_lock<std::mutex> guard(this->_pImpl->mutex);
-    t = this->_pImpl->queue.pop();
-    if (blockIfNoTasks && !t) {
-      this->_pImpl->conditionVariable.wait(guard);
+    ++this->_pImpl->waitingThreads;
+    if (this->_pImpl->empty()) {
+      // Check for timers only after announcing that this thread is waiting,
+      // so that a timer scheduled from here on notifies it.
+      const std::optional<std::chrono::steady_clock::time_point> deadline =
+          this->_pImpl->timers.nextDeadline();
+      if (deadline) {
+        this->_pImpl->conditionVariable.wait_until(guard, *deadline);
+      } else {
+        this->_pImpl->conditionVariable.wait(guard);
+      }
     }
+    --this->_pImpl->waitingThreads;
   }
 
   if (t) {
@@ -58,6 +238,17 @@ bool QueuedScheduler::dispatchInternal(bool blockIfNoTasks) {
   }
 }
 
+bool QueuedScheduler::dispatchExpiredTimers() {
+  const std::optional<std::chrono::steady_clock::time_point> deadline =
+      this->_pImpl->timers.nextDeadline();
+  if (!deadline || std::chrono::steady_clock::now() < *deadline) {
+    return false;
+  }
+
+  auto scope = this->immediate.scope();
+  return this->_pImpl->timers.dispatchExpired();
+}
+
 void QueuedScheduler::unblock() {
   std::unique_lock<std::mutex> guard(this->_pImpl->mutex);
   this->_pImpl->conditionVariable.notify_all();
@@ -88,6 +88,10 @@ const std::string DELETE_LRU_ITEMS_SQL =
     CACHE_TABLE + " ORDER BY " + CACHE_TABLE_LAST_ACCESSED_TIME_COLUMN +
     " ASC " + " LIMIT ?)";
 
+// Sql commands for removing a single item
+const std::string REMOVE_ENTRY_SQL =
+    "DELETE FROM " + CACHE_TABLE + " WHERE " + CACHE_TABLE_KEY_COLUMN + "=?";
+
 // Sql commands for clean all items
 const std::string CLEAR_ALL_SQL = "DELETE FROM " + CACHE_TABLE;
 
@@ -182,6 +186,7 @@ struct SqliteCache::Impl {
         _totalItemsQueryStmtWrapper(),
         _deleteExpiredStmtWrapper(),
         _deleteLRUStmtWrapper(),
+        _removeEntryStmtWrapper(),
         _clearAllStmtWrapper() {}
 
   std::shared_ptr<spdlog::logger> _pLogger;
@@ -195,6 +200,7 @@ struct SqliteCache::Impl {
   SqliteStatementPtr _totalItemsQueryStmtWrapper;
   SqliteStatementPtr _deleteExpiredStmtWrapper;
   SqliteStatementPtr _deleteLRUStmtWrapper;
+  SqliteStatementPtr _removeEntryStmtWrapper;
   SqliteStatementPtr _clearAllStmtWrapper;
 };
 
@@ -300,6 +306,10 @@ void SqliteCache::createConnection() const {
   this->_pImpl->_deleteLRUStmtWrapper =
       prepareStatement(this->_pImpl->_pConnection, DELETE_LRU_ITEMS_SQL);
 
+  // remove a single item
+  this->_pImpl->_removeEntryStmtWrapper =
+      prepareStatement(this->_pImpl->_pConnection, REMOVE_ENTRY_SQL);
+
   // clear all items
   this->_pImpl->_clearAllStmtWrapper =
       prepareStatement(this->_pImpl->_pConnection, CLEAR_ALL_SQL);
@@ -755,6 +765,56 @@ bool SqliteCache::prune() {
   return true;
 }
 
+bool SqliteCache::removeEntry(const std::string& key) {
+  CESIUM_TRACE("SqliteCache::removeEntry");
+  std::lock_guard<std::mutex> guard(this->_pImpl->_mutex);
+
+  int status =
+      CESIUM_SQLITE(sqlite3_reset)(this->_pImpl->_removeEntryStmtWrapper.get());
+  if (status != SQLITE_OK) {
+    SPDLOG_LOGGER_ERROR(
+        this->_pImpl->_pLogger,
+        CESIUM_SQLITE(sqlite3_errstr)(status));
+    return false;
+  }
+
+  status = CESIUM_SQLITE(sqlite3_clear_bindings)(
+      this->_pImpl->_removeEntryStmtWrapper.get());
+  if (status != SQLITE_OK) {
+    SPDLOG_LOGGER_ERROR(
+        this->_pImpl->_pLogger,
+        CESIUM_SQLITE(sqlite3_errstr)(status));
+    return false;
+  }
+
+  status = CESIUM_SQLITE(sqlite3_bind_text)(
+      this->_pImpl->_removeEntryStmtWrapper.get(),
+      1,
+      key.c_str(),
+      -1,
+      SQLITE_STATIC);
+  if (status != SQLITE_OK) {
+    SPDLOG_LOGGER_ERROR(
+        this->_pImpl->_pLogger,
+        CESIUM_SQLITE(sqlite3_errstr)(status));
+    return false;
+  }
+
+  status =
+      CESIUM_SQLITE(sqlite3_step)(this->_pImpl->_removeEntryStmtWrapper.get());
+  if (status != SQLITE_DONE) {
+    if (status == SQLITE_CORRUPT) {
+      destroyDatabase();
+    }
+    SPDLOG_LOGGER_ERROR(
+        this->_pImpl->_pLogger,
+        CESIUM_SQLITE(sqlite3_errstr)(status));
+    return false;
+  }
+
+  return true;
+}
+
 bool SqliteCache::clearAll() {
   std::lock_guard<std::mutex> guard(this->_pImpl->_mutex);
 
@@ -0,0 +1,96 @@
+#include "CesiumAsync/TaskFunction.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace CesiumAsync::CesiumImpl {
+
+namespace {
+// Blocks are recycled in a few size classes, and larger ones are allocated
+// and freed every time. A task is usually started in one thread and destroyed
+// in another, so, like the nodes of QueuedScheduler, a freed block is pushed
+// onto a stack shared by all threads, and a thread that runs out of blocks of
+// a size takes that whole stack for its own use. The shared stacks are only
+// pushed onto and emptied at once, so they do not suffer from the ABA
+// problem.
+constexpr std::array<size_t, 3> blockSizes{64, 128, 256};
+
+struct Block {
+  Block* pNext;
+};
+
+size_t getSizeClass(size_t size) noexcept {
+  size_t sizeClass = 0;
+  while (sizeClass < blockSizes.size() && blockSizes[sizeClass] < size) {
+    ++sizeClass;
+  }
+  return sizeClass;
+}
+
+using SharedBlocks = std::array<std::atomic<Block*>, blockSizes.size()>;
+
+struct LocalBlocks {
+  std::array<Block*, blockSizes.size()> pFirst{};
+
+  ~LocalBlocks() noexcept {
+    for (Block* pBlock : this->pFirst) {
+      while (pBlock) {
+        Block* pNext = pBlock->pNext;
+        ::operator delete(pBlock);
+        pBlock = pNext;
+      }
+    }
+  }
+};
+
+// The blocks that the current thread may use.
+LocalBlocks& getLocalBlocks() noexcept {
+  static thread_local LocalBlocks localBlocks;
+  return localBlocks;
+}
+
+// The blocks freed by any thread. This is never destroyed, so that threads
+// that exit late can still free blocks.
+SharedBlocks& getSharedBlocks() noexcept {
+  static SharedBlocks sharedBlocks{};
+  return sharedBlocks;
+}
+} // namespace
+
+void* allocateTaskStorage(size_t size) {
+  const size_t sizeClass = getSizeClass(size);
+  if (sizeClass == blockSizes.size()) {
+    return ::operator new(size);
+  }
+
+  Block*& pFirst = getLocalBlocks().pFirst[sizeClass];
+  if (!pFirst) {
+    pFirst = getSharedBlocks()[sizeClass].exchange(nullptr);
+  }
+
+  Block* pBlock = pFirst;
+  if (!pBlock) {
+    return ::operator new(blockSizes[sizeClass]);
+  }
+
+  pFirst = pBlock->pNext;
+  pBlock->~Block();
+  return pBlock;
+}
+
+void freeTaskStorage(void* p, size_t size) noexcept {
+  const size_t sizeClass = getSizeClass(size);
+  if (sizeClass == blockSizes.size()) {
+    ::operator delete(p);
+    return;
+  }
+
+  std::atomic<Block*>& sharedBlocks = getSharedBlocks()[sizeClass];
+  Block* pBlock = new (p) Block{sharedBlocks.load()};
+  while (!sharedBlocks.compare_exchange_weak(pBlock->pNext, pBlock)) {
+  }
+}
+
+} // namespace CesiumAsync::CesiumImpl
@@ -7,21 +7,20 @@ TaskScheduler::TaskScheduler(
     : _pTaskProcessor(pTaskProcessor) {}
 
 void TaskScheduler::schedule(async::task_run_handle t) {
-  // std::function must be copyable, so we can't put a move-only
-  // task_run_handle in the capture list of a lambda we want to use with it.
-  // So, we wrap it with a copyable type (shared_ptr).
-  // https://riptutorial.com/cplusplus/example/1950/generalized-capture has
-  // a good explanation of this problem.
-
+  // The task is moved into a TaskFunction, which is small enough to store it
+  // in place, so starting a task does not allocate. The function owns the
+  // task, so if the task processor destroys it without invoking it, the task
+  // is canceled and its future is rejected rather than leaked.
   struct Receiver {
+    TaskScheduler* pScheduler;
     async::task_run_handle taskHandle;
-  };
 
-  std::shared_ptr<Receiver> pReceiver = std::make_shared<Receiver>();
-  pReceiver->taskHandle = std::move(t);
+    void operator()() {
+      auto scope = this->pScheduler->immediate.scope();
+      this->taskHandle.run();
+    }
+  };
 
-  this->_pTaskProcessor->startTask([this, pReceiver]() mutable {
-    auto scope = this->immediate.scope();
-    pReceiver->taskHandle.run();
-  });
+  this->_pTaskProcessor->startTaskFunction(
+      CesiumAsync::TaskFunction(Receiver{this, std::move(t)}));
 }
@@ -0,0 +1,83 @@
+#include "CesiumAsync/Impl/TimerQueue.h"
+
+#include <vector>
+
+namespace CesiumAsync::CesiumImpl {
+
+uint64_t TimerQueue::schedule(
+    std::chrono::steady_clock::time_point deadline,
+    std::function<void()>&& f) {
+  std::lock_guard<std::mutex> lock(this->_mutex);
+  const uint64_t id = this->_nextId++;
+  this->_timers.emplace(std::make_pair(deadline, id), std::move(f));
+  this->_deadlines.emplace(id, deadline);
+  ++this->_size;
+  return id;
+}
+
+void TimerQueue::cancel(uint64_t id) {
+  std::function<void()> f;
+
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    auto it = this->_deadlines.find(id);
+    if (it == this->_deadlines.end()) {
+      return;
+    }
+
+    auto timerIt = this->_timers.find(std::make_pair(it->second, id));
+    if (timerIt != this->_timers.end()) {
+      f = std::move(timerIt->second);
+      this->_timers.erase(timerIt);
+    }
+    this->_deadlines.erase(it);
+    --this->_size;
+  }
+
+  // The function is destroyed here, without the lock held.
+}
+
+std::optional<std::chrono::steady_clock::time_point>
+TimerQueue::nextDeadline() {
+  if (this->_size.load() == 0) {
+    return std::nullopt;
+  }
+
+  std::lock_guard<std::mutex> lock(this->_mutex);
+  if (this->_timers.empty()) {
+    return std::nullopt;
+  }
+  return this->_timers.begin()->first.first;
+}
+
+bool TimerQueue::dispatchExpired() {
+  if (this->_size.load() == 0) {
+    return false;
+  }
+
+  std::vector<std::function<void()>> expired;
+
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    const std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    while (!this->_timers.empty() &&
+           this->_timers.begin()->first.first <= now) {
+      auto it = this->_timers.begin();
+      expired.emplace_back(std::move(it->second));
+      this->_deadlines.erase(it->first.second);
+      this->_timers.erase(it);
+      --this->_size;
+    }
+  }
+
+  // Invoke and destroy the functions without the lock held.
+  for (std::function<void()>& f : expired) {
+    f();
+    f = nullptr;
+  }
+
+  return !expired.empty();
+}
+
+} // namespace CesiumAsync::CesiumImpl
@@ -0,0 +1,86 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
+#include "CesiumAsync/AsyncSystem.h"
+#include "MockTaskProcessor.h"
+
+#include <CesiumNativeTests/ThreadTaskProcessor.h>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <vector>
+
+using namespace CesiumAsync;
+
+// These are hidden by default. Run them with:
+//   cesium-native-tests "[benchmark]"
+TEST_CASE("AsyncSystem scheduling overhead", "[.][benchmark]") {
+  AsyncSystem asyncSystem(std::make_shared<MockTaskProcessor>());
+
+  // A chain of hops between threads, like the one used to load a tile.
+  const auto hops = [&asyncSystem]() {
+    return asyncSystem.runInWorkerThread([]() { return 1; })
+        .thenInMainThread([](int32_t value) { return value + 1; })
+        .thenInWorkerThread([](int32_t value) { return value + 1; })
+        .thenInMainThread([](int32_t value) { return value + 1; })
+        .thenInWorkerThread([](int32_t value) { return value + 1; })
+        .thenInMainThread([](int32_t value) { return value + 1; });
+  };
+
+  BENCHMARK("worker thread task") {
+    return asyncSystem.runInWorkerThread([]() { return 1; }).wait();
+  };
+
+  BENCHMARK("main thread task") {
+    Future<int32_t> future =
+        asyncSystem.runInWorkerThread([]() { return 1; })
+            .thenInMainThread([](int32_t value) { return value; });
+    asyncSystem.dispatchMainThreadTasks();
+    return future.wait();
+  };
+
+  BENCHMARK("chain of six hops") {
+    Future<int32_t> future = hops();
+    while (!future.isReady()) {
+      asyncSystem.dispatchMainThreadTasks();
+    }
+    return future.wait();
+  };
+
+  BENCHMARK("1000 chains of six hops") {
+    std::vector<Future<int32_t>> futures;
+    futures.reserve(1000);
+    for (int32_t i = 0; i < 1000; ++i) {
+      futures.emplace_back(hops());
+    }
+
+    int32_t result = 0;
+    for (Future<int32_t>& future : futures) {
+      while (!future.isReady()) {
+        asyncSystem.dispatchMainThreadTasks();
+      }
+      result += future.wait();
+    }
+    return result;
+  };
+}
+
+TEST_CASE(
+    "AsyncSystem scheduling overhead with threads",
+    "[.][benchmark]") {
+  // Unlike the MockTaskProcessor, which runs tasks right away in the calling
+  // thread, this starts a thread for each task, like a real task processor
+  // hands each task to another thread.
+  AsyncSystem asyncSystem(
+      std::make_shared<CesiumNativeTests::ThreadTaskProcessor>());
+
+  BENCHMARK("worker thread task") {
+    return asyncSystem.runInWorkerThread([]() { return 1; }).wait();
+  };
+
+  BENCHMARK("main thread task") {
+    return asyncSystem.runInWorkerThread([]() { return 1; })
+        .thenInMainThread([](int32_t value) { return value; })
+        .waitInMainThread();
+  };
+}
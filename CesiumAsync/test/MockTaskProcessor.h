@@ -7,4 +7,8 @@
 class MockTaskProcessor : public CesiumAsync::ITaskProcessor {
 public:
   virtual void startTask(std::function<void()> f) override { f(); }
+
+  virtual void startTaskFunction(CesiumAsync::TaskFunction&& f) override {
+    f();
+  }
 };
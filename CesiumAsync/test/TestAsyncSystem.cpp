@@ -4,7 +4,10 @@
 
 #include <chrono>
 #include <memory>
+#include <stdexcept>
 #include <thread>
+#include <variant>
+#include <vector>
 
 using namespace CesiumAsync;
 
@@ -73,6 +76,53 @@ TEST_CASE("AsyncSystem") {
     CHECK(pTaskProcessor->tasksStarted == 0);
   }
 
+  SECTION("main thread tasks stop being dispatched when time runs out") {
+    using namespace std::chrono_literals;
+
+    int32_t executed = 0;
+    for (int32_t i = 0; i < 3; ++i) {
+      asyncSystem.runInMainThread([&executed]() {
+        std::this_thread::sleep_for(5ms);
+        ++executed;
+      });
+    }
+
+    // At least one task is run, even when it takes longer than allowed.
+    CHECK(!asyncSystem.dispatchMainThreadTasks(1ms));
+    CHECK(executed == 1);
+
+    CHECK(asyncSystem.dispatchMainThreadTasks(10s));
+    CHECK(executed == 3);
+    CHECK(asyncSystem.dispatchMainThreadTasks(0ms));
+  }
+
+  SECTION("main thread tasks scheduled from many threads run in order") {
+    const int32_t tasksPerThread = 100;
+    std::vector<std::vector<int32_t>> results(4);
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); ++i) {
+      threads.emplace_back([&asyncSystem, &results, i]() {
+        for (int32_t j = 0; j < tasksPerThread; ++j) {
+          asyncSystem.runInMainThread(
+              [&results, i, j]() { results[i].emplace_back(j); });
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+
+    asyncSystem.dispatchMainThreadTasks();
+
+    for (const std::vector<int32_t>& result : results) {
+      REQUIRE(result.size() == size_t(tasksPerThread));
+      for (int32_t j = 0; j < tasksPerThread; ++j) {
+        CHECK(result[size_t(j)] == j);
+      }
+    }
+  }
+
   SECTION("worker continuations following a worker run immediately") {
     bool executed1 = false;
     bool executed2 = false;
@@ -356,6 +406,202 @@ TEST_CASE("AsyncSystem") {
     CHECK(rejected);
   }
 
+  SECTION("mapConcurrent limits the number of pending futures") {
+    std::vector<Promise<int>> promises;
+    for (int i = 0; i < 5; ++i) {
+      promises.emplace_back(asyncSystem.createPromise<int>());
+    }
+
+    std::vector<int> started;
+    Future<std::vector<int>> future = asyncSystem.mapConcurrent(
+        std::vector<int>{0, 1, 2, 3, 4},
+        2,
+        [&promises, &started](int i) {
+          started.emplace_back(i);
+          return promises[size_t(i)].getFuture().thenImmediately(
+              [i](int value) { return value * 10 + i; });
+        });
+
+    CHECK(started == std::vector<int>{0, 1});
+
+    promises[1].resolve(1);
+    CHECK(started == std::vector<int>{0, 1, 2});
+
+    // Futures that are already resolved start the next item right away.
+    promises[3].resolve(3);
+    promises[4].resolve(4);
+    promises[2].resolve(2);
+    CHECK(started == std::vector<int>{0, 1, 2, 3, 4});
+    CHECK(!future.isReady());
+
+    promises[0].resolve(0);
+    REQUIRE(future.isReady());
+    CHECK(future.wait() == std::vector<int>{0, 11, 22, 33, 44});
+  }
+
+  SECTION("mapConcurrent stops starting items when one rejects") {
+    std::vector<Promise<int>> promises;
+    for (int i = 0; i < 4; ++i) {
+      promises.emplace_back(asyncSystem.createPromise<int>());
+    }
+
+    std::vector<int> started;
+    Future<std::vector<int>> future = asyncSystem.mapConcurrent(
+        std::vector<int>{0, 1, 2, 3},
+        2,
+        [&promises, &started](int i) {
+          started.emplace_back(i);
+          return promises[size_t(i)].getFuture();
+        });
+
+    promises[1].reject(std::runtime_error("second"));
+    CHECK(started == std::vector<int>{0, 1});
+    CHECK(!future.isReady());
+
+    promises[0].resolve(0);
+    CHECK(started == std::vector<int>{0, 1});
+    REQUIRE(future.isReady());
+    CHECK_THROWS_WITH(future.wait(), "second");
+  }
+
+  SECTION("mapConcurrent resolves to no value for void futures") {
+    std::vector<Promise<void>> promises;
+    for (int i = 0; i < 3; ++i) {
+      promises.emplace_back(asyncSystem.createPromise<void>());
+    }
+
+    std::vector<int> started;
+    Future<void> future = asyncSystem.mapConcurrent(
+        std::vector<int>{0, 1, 2},
+        2,
+        [&promises, &started](int i) {
+          started.emplace_back(i);
+          return promises[size_t(i)].getFuture();
+        });
+
+    promises[0].resolve();
+    promises[2].resolve();
+    CHECK(started == std::vector<int>{0, 1, 2});
+    CHECK(!future.isReady());
+
+    promises[1].resolve();
+    REQUIRE(future.isReady());
+    CHECK_NOTHROW(future.wait());
+  }
+
+  SECTION("race settles with the first future to settle") {
+    auto one = asyncSystem.createPromise<int>();
+    auto two = asyncSystem.createPromise<int>();
+
+    std::vector<Future<int>> futures;
+    futures.emplace_back(one.getFuture());
+    futures.emplace_back(two.getFuture());
+    Future<int> future = asyncSystem.race(std::move(futures));
+
+    two.reject(std::runtime_error("second"));
+    one.resolve(1);
+    CHECK_THROWS_WITH(future.wait(), "second");
+
+    CHECK_THROWS(asyncSystem.race(std::vector<Future<int>>()).wait());
+  }
+
+  SECTION("any resolves with the first future to resolve") {
+    auto one = asyncSystem.createPromise<int>();
+    auto two = asyncSystem.createPromise<int>();
+
+    std::vector<Future<int>> futures;
+    futures.emplace_back(one.getFuture());
+    futures.emplace_back(two.getFuture());
+    Future<int> future = asyncSystem.any(std::move(futures));
+
+    one.reject(std::runtime_error("first"));
+    CHECK(!future.isReady());
+    two.resolve(2);
+    CHECK(future.wait() == 2);
+  }
+
+  SECTION("any rejects when all futures reject") {
+    auto one = asyncSystem.createPromise<int>();
+    auto two = asyncSystem.createPromise<int>();
+
+    std::vector<Future<int>> futures;
+    futures.emplace_back(one.getFuture());
+    futures.emplace_back(two.getFuture());
+    Future<int> future = asyncSystem.any(std::move(futures));
+
+    two.reject(std::runtime_error("second"));
+    one.reject(std::runtime_error("first"));
+    CHECK_THROWS_WITH(future.wait(), "first");
+  }
+
+  SECTION("whenAllSettled resolves with the outcome of each future") {
+    std::vector<Future<int>> futures;
+    futures.emplace_back(asyncSystem.createResolvedFuture(1));
+    futures.emplace_back(asyncSystem.runInWorkerThread(
+        []() -> int { throw std::runtime_error("second"); }));
+    futures.emplace_back(asyncSystem.createResolvedFuture(3));
+
+    std::vector<std::variant<int, std::exception_ptr>> results =
+        asyncSystem.whenAllSettled(std::move(futures)).wait();
+    REQUIRE(results.size() == 3);
+    CHECK(std::get<int>(results[0]) == 1);
+    REQUIRE(std::holds_alternative<std::exception_ptr>(results[1]));
+    CHECK_THROWS_WITH(
+        std::rethrow_exception(std::get<std::exception_ptr>(results[1])),
+        "second");
+    CHECK(std::get<int>(results[2]) == 3);
+  }
+
+  SECTION("whenAllSettled resolves with the exception of each void future") {
+    std::vector<Future<void>> futures;
+    futures.emplace_back(asyncSystem.createResolvedFuture());
+    futures.emplace_back(asyncSystem.runInWorkerThread(
+        []() { throw std::runtime_error("second"); }));
+    futures.emplace_back(asyncSystem.runInWorkerThread([]() {}));
+
+    std::vector<std::exception_ptr> results =
+        asyncSystem.whenAllSettled(std::move(futures)).wait();
+    REQUIRE(results.size() == 3);
+    CHECK(!results[0]);
+    REQUIRE(results[1]);
+    CHECK_THROWS_WITH(std::rethrow_exception(results[1]), "second");
+    CHECK(!results[2]);
+  }
+
+  SECTION("withTimeout rejects when the future does not settle in time") {
+    using namespace std::chrono_literals;
+
+    auto promise = asyncSystem.createPromise<int>();
+    Future<int> future = asyncSystem.withTimeout(promise.getFuture(), 10ms);
+    CHECK_THROWS_AS(future.waitInMainThread(), std::runtime_error);
+
+    // Resolving afterward has no effect.
+    promise.resolve(1);
+  }
+
+  SECTION("withDeadline rejects when main thread tasks are dispatched") {
+    using namespace std::chrono_literals;
+
+    auto promise = asyncSystem.createPromise<int>();
+    Future<int> future = asyncSystem.withDeadline(
+        promise.getFuture(),
+        std::chrono::steady_clock::now() - 1ms);
+    CHECK(!future.isReady());
+
+    asyncSystem.dispatchMainThreadTasks();
+    REQUIRE(future.isReady());
+    CHECK_THROWS_AS(future.wait(), std::runtime_error);
+  }
+
+  SECTION("withTimeout settles like the future when it settles in time") {
+    using namespace std::chrono_literals;
+
+    auto promise = asyncSystem.createPromise<int>();
+    Future<int> future = asyncSystem.withTimeout(promise.getFuture(), 10s);
+    promise.resolve(1);
+    CHECK(future.wait() == 1);
+  }
+
   SECTION("conversion to SharedFuture") {
     auto promise = asyncSystem.createPromise<int>();
     auto sharedFuture = promise.getFuture().share();
@@ -70,6 +70,10 @@ public:
     return true;
   }
 
+  virtual bool removeEntry(const std::string& /*key*/) override {
+    return true;
+  }
+
   virtual bool clearAll() override {
     this->clearAllCall = true;
     return true;
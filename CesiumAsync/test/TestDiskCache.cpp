@@ -171,6 +171,43 @@ TEST_CASE("Test disk cache with Sqlite") {
     }
   }
 
+  SECTION("Test remove entry") {
+    HttpHeaders responseHeaders{{"Content-Type", "text/html"}};
+    std::vector<std::byte> responseData = {std::byte(0), std::byte(1)};
+    std::unique_ptr<MockAssetResponse> response =
+        std::make_unique<MockAssetResponse>(
+            static_cast<uint16_t>(200),
+            "text/html",
+            responseHeaders,
+            responseData);
+
+    std::unique_ptr<MockAssetRequest> request =
+        std::make_unique<MockAssetRequest>(
+            "GET",
+            "test.com",
+            HttpHeaders{},
+            std::move(response));
+
+    for (const std::string& key : {"TestKey0", "TestKey1"}) {
+      REQUIRE(diskCache.storeEntry(
+          key,
+          std::time(nullptr) + 60,
+          request->url(),
+          request->method(),
+          request->headers(),
+          request->response()->statusCode(),
+          request->response()->headers(),
+          request->response()->data()));
+    }
+
+    REQUIRE(diskCache.removeEntry("TestKey0"));
+    REQUIRE(diskCache.getEntry("TestKey0") == std::nullopt);
+    REQUIRE(diskCache.getEntry("TestKey1") != std::nullopt);
+
+    // Removing an entry that does not exist is not an error.
+    REQUIRE(diskCache.removeEntry("TestKey0"));
+  }
+
   SECTION("Test clear all") {
     // store data in the cache first
     HttpHeaders responseHeaders{
@@ -0,0 +1,349 @@
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/EndpointCache.h"
+#include "CesiumAsync/ICacheDatabase.h"
+#include "CesiumAsync/Promise.h"
+#include "MockAssetRequest.h"
+#include "MockAssetResponse.h"
+#include "MockTaskProcessor.h"
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace CesiumAsync;
+
+namespace {
+
+class DeferredAssetAccessor : public IAssetAccessor {
+public:
+  DeferredAssetAccessor(uint16_t statusCode_, const HttpHeaders& headers_)
+      : statusCode{statusCode_}, headers{headers_} {}
+
+  virtual Future<std::shared_ptr<IAssetRequest>>
+  get(const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& /* headers */) override {
+    ++this->requestCount;
+    this->lastUrl = url;
+    this->pending.emplace_back(
+        asyncSystem.createPromise<std::shared_ptr<IAssetRequest>>());
+    return this->pending.back().getFuture();
+  }
+
+  virtual Future<std::shared_ptr<IAssetRequest>> request(
+      const AsyncSystem& asyncSystem,
+      const std::string& /* verb */,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const gsl::span<const std::byte>& /* contentPayload */) override {
+    return this->get(asyncSystem, url, headers);
+  }
+
+  virtual void tick() noexcept override {}
+
+  void completeRequests() {
+    std::vector<Promise<std::shared_ptr<IAssetRequest>>> promises =
+        std::move(this->pending);
+    this->pending.clear();
+    for (const Promise<std::shared_ptr<IAssetRequest>>& promise : promises) {
+      completeRequest(promise);
+    }
+  }
+
+  void
+  completeRequest(const Promise<std::shared_ptr<IAssetRequest>>& promise) {
+    promise.resolve(std::make_shared<MockAssetRequest>(
+        "GET",
+        this->lastUrl,
+        HttpHeaders{},
+        std::make_unique<MockAssetResponse>(
+            this->statusCode,
+            "application/json",
+            this->headers,
+            std::vector<std::byte>(4))));
+  }
+
+  uint16_t statusCode;
+  HttpHeaders headers;
+  int32_t requestCount = 0;
+  std::string lastUrl;
+  std::vector<Promise<std::shared_ptr<IAssetRequest>>> pending;
+};
+
+class InMemoryCacheDatabase : public ICacheDatabase {
+public:
+  virtual std::optional<CacheItem>
+  getEntry(const std::string& key) const override {
+    auto it = this->entries.find(key);
+    if (it == this->entries.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  virtual bool storeEntry(
+      const std::string& key,
+      std::time_t expiryTime,
+      const std::string& url,
+      const std::string& requestMethod,
+      const HttpHeaders& requestHeaders,
+      uint16_t statusCode,
+      const HttpHeaders& responseHeaders,
+      const gsl::span<const std::byte>& responseData) override {
+    this->entries.insert_or_assign(
+        key,
+        CacheItem(
+            expiryTime,
+            CacheRequest(
+                HttpHeaders(requestHeaders),
+                std::string(requestMethod),
+                std::string(url)),
+            CacheResponse(
+                statusCode,
+                HttpHeaders(responseHeaders),
+                std::vector<std::byte>(
+                    responseData.begin(),
+                    responseData.end()))));
+    return true;
+  }
+
+  virtual bool prune() override { return true; }
+
+  virtual bool removeEntry(const std::string& key) override {
+    this->entries.erase(key);
+    return true;
+  }
+
+  virtual bool clearAll() override {
+    this->entries.clear();
+    return true;
+  }
+
+  std::map<std::string, CacheItem> entries;
+};
+
+} // namespace
+
+TEST_CASE("Test EndpointCache") {
+  const std::string url = "https://example.com/endpoint";
+  AsyncSystem asyncSystem(std::make_shared<MockTaskProcessor>());
+
+  SECTION("requests an endpoint once while its response is valid") {
+    auto pAccessor =
+        std::make_shared<DeferredAssetAccessor>(uint16_t(200), HttpHeaders{});
+    EndpointCache cache;
+
+    Future<std::shared_ptr<IAssetRequest>> first =
+        cache.get(asyncSystem, pAccessor, url);
+    Future<std::shared_ptr<IAssetRequest>> second =
+        cache.get(asyncSystem, pAccessor, url);
+    CHECK(pAccessor->requestCount == 1);
+
+    pAccessor->completeRequests();
+    std::shared_ptr<IAssetRequest> pFirst = first.wait();
+    std::shared_ptr<IAssetRequest> pSecond = second.wait();
+    CHECK(pFirst == pSecond);
+    CHECK(pFirst->response()->statusCode() == 200);
+
+    std::shared_ptr<IAssetRequest> pThird =
+        cache.get(asyncSystem, pAccessor, url).wait();
+    CHECK(pThird == pFirst);
+    CHECK(pAccessor->requestCount == 1);
+  }
+
+  SECTION("requests an endpoint again after it is invalidated") {
+    auto pAccessor =
+        std::make_shared<DeferredAssetAccessor>(uint16_t(200), HttpHeaders{});
+    EndpointCache cache;
+
+    Future<std::shared_ptr<IAssetRequest>> first =
+        cache.get(asyncSystem, pAccessor, url);
+    pAccessor->completeRequests();
+    first.wait();
+
+    cache.invalidate(url);
+    Future<std::shared_ptr<IAssetRequest>> second =
+        cache.get(asyncSystem, pAccessor, url);
+    CHECK(pAccessor->requestCount == 2);
+    pAccessor->completeRequests();
+    second.wait();
+  }
+
+  SECTION("removes an invalidated response from the database") {
+    auto pAccessor =
+        std::make_shared<DeferredAssetAccessor>(uint16_t(200), HttpHeaders{});
+    auto pDatabase = std::make_shared<InMemoryCacheDatabase>();
+    EndpointCache cache(pDatabase);
+
+    Future<std::shared_ptr<IAssetRequest>> first =
+        cache.get(asyncSystem, pAccessor, url);
+    pAccessor->completeRequests();
+    first.wait();
+    REQUIRE(pDatabase->entries.count(url) == 1);
+
+    cache.invalidate(url);
+    CHECK(pDatabase->entries.empty());
+
+    Future<std::shared_ptr<IAssetRequest>> second =
+        cache.get(asyncSystem, pAccessor, url);
+    CHECK(pAccessor->requestCount == 2);
+    pAccessor->completeRequests();
+    second.wait();
+  }
+
+  SECTION("does not keep a response requested before it was invalidated") {
+    auto pAccessor =
+        std::make_shared<DeferredAssetAccessor>(uint16_t(200), HttpHeaders{});
+    EndpointCache cache;
+
+    Future<std::shared_ptr<IAssetRequest>> first =
+        cache.get(asyncSystem, pAccessor, url);
+    cache.invalidate(url);
+    Future<std::shared_ptr<IAssetRequest>> second =
+        cache.get(asyncSystem, pAccessor, url);
+    CHECK(pAccessor->requestCount == 2);
+
+    // Complete the request made before the invalidation last, so that it
+    // would replace the newer response if it were kept.
+    REQUIRE(pAccessor->pending.size() == 2);
+    pAccessor->completeRequest(pAccessor->pending[1]);
+    std::shared_ptr<IAssetRequest> pSecond = second.wait();
+    pAccessor->completeRequest(pAccessor->pending[0]);
+    CHECK(first.wait() != pSecond);
+
+    std::shared_ptr<IAssetRequest> pThird =
+        cache.get(asyncSystem, pAccessor, url).wait();
+    CHECK(pThird == pSecond);
+    CHECK(pAccessor->requestCount == 2);
+  }
+
+  SECTION("does not keep failed responses") {
+    auto pAccessor =
+        std::make_shared<DeferredAssetAccessor>(uint16_t(404), HttpHeaders{});
+    EndpointCache cache;
+
+    Future<std::shared_ptr<IAssetRequest>> first =
+        cache.get(asyncSystem, pAccessor, url);
+    pAccessor->completeRequests();
+    CHECK(first.wait()->response()->statusCode() == 404);
+
+    Future<std::shared_ptr<IAssetRequest>> second =
+        cache.get(asyncSystem, pAccessor, url);
+    CHECK(pAccessor->requestCount == 2);
+    pAccessor->completeRequests();
+    second.wait();
+  }
+
+  SECTION("refreshes a response that is about to expire in the background") {
+    auto pAccessor = std::make_shared<DeferredAssetAccessor>(
+        uint16_t(200),
+        HttpHeaders{{"Cache-Control", "max-age=60"}});
+    EndpointCache cache(
+        nullptr,
+        std::chrono::hours(1),
+        std::chrono::minutes(5));
+
+    Future<std::shared_ptr<IAssetRequest>> first =
+        cache.get(asyncSystem, pAccessor, url);
+    pAccessor->completeRequests();
+    std::shared_ptr<IAssetRequest> pFirst = first.wait();
+
+    // The response is still used, but a new one is already requested.
+    std::shared_ptr<IAssetRequest> pSecond =
+        cache.get(asyncSystem, pAccessor, url).wait();
+    CHECK(pSecond == pFirst);
+    CHECK(pAccessor->requestCount == 2);
+
+    pAccessor->completeRequests();
+    std::shared_ptr<IAssetRequest> pThird =
+        cache.get(asyncSystem, pAccessor, url).wait();
+    CHECK(pThird != pFirst);
+  }
+
+  SECTION("persists responses in the database") {
+    auto pAccessor =
+        std::make_shared<DeferredAssetAccessor>(uint16_t(200), HttpHeaders{});
+    auto pDatabase = std::make_shared<InMemoryCacheDatabase>();
+
+    {
+      EndpointCache cache(pDatabase, std::chrono::minutes(30));
+      Future<std::shared_ptr<IAssetRequest>> future =
+          cache.get(asyncSystem, pAccessor, url);
+      pAccessor->completeRequests();
+      future.wait();
+    }
+
+    REQUIRE(pDatabase->entries.count(url) == 1);
+    const std::time_t expiryTime = pDatabase->entries.at(url).expiryTime;
+    CHECK(expiryTime > std::time(nullptr) + 29 * 60);
+    CHECK(expiryTime <= std::time(nullptr) + 30 * 60);
+
+    // A new session uses the persisted response without a request.
+    EndpointCache cache(pDatabase, std::chrono::minutes(30));
+    std::shared_ptr<IAssetRequest> pRequest =
+        cache.get(asyncSystem, pAccessor, url).wait();
+    CHECK(pAccessor->requestCount == 1);
+    CHECK(pRequest->url() == url);
+    CHECK(pRequest->response()->statusCode() == 200);
+    CHECK(pRequest->response()->data().size() == 4);
+  }
+
+  SECTION("does not keep responses that must not be stored") {
+    auto pAccessor = std::make_shared<DeferredAssetAccessor>(
+        uint16_t(200),
+        HttpHeaders{{"Cache-Control", "no-store"}});
+    auto pDatabase = std::make_shared<InMemoryCacheDatabase>();
+    EndpointCache cache(pDatabase);
+
+    Future<std::shared_ptr<IAssetRequest>> first =
+        cache.get(asyncSystem, pAccessor, url);
+    pAccessor->completeRequests();
+    CHECK(first.wait()->response()->statusCode() == 200);
+    CHECK(pDatabase->entries.empty());
+
+    Future<std::shared_ptr<IAssetRequest>> second =
+        cache.get(asyncSystem, pAccessor, url);
+    CHECK(pAccessor->requestCount == 2);
+    pAccessor->completeRequests();
+    second.wait();
+  }
+
+  SECTION("only persists responses with access tokens if allowed") {
+    const std::string tokenUrl = url + "?access_token=abc";
+    auto pAccessor =
+        std::make_shared<DeferredAssetAccessor>(uint16_t(200), HttpHeaders{});
+    auto pDatabase = std::make_shared<InMemoryCacheDatabase>();
+
+    {
+      EndpointCache cache(pDatabase);
+      Future<std::shared_ptr<IAssetRequest>> future =
+          cache.get(asyncSystem, pAccessor, tokenUrl);
+      pAccessor->completeRequests();
+      future.wait();
+
+      // The response is still kept in memory.
+      cache.get(asyncSystem, pAccessor, tokenUrl).wait();
+      CHECK(pAccessor->requestCount == 1);
+    }
+    CHECK(pDatabase->entries.empty());
+
+    EndpointCache cache(
+        pDatabase,
+        std::chrono::minutes(30),
+        std::chrono::minutes(5),
+        true);
+    Future<std::shared_ptr<IAssetRequest>> future =
+        cache.get(asyncSystem, pAccessor, tokenUrl);
+    pAccessor->completeRequests();
+    future.wait();
+    CHECK(pDatabase->entries.count(tokenUrl) == 1);
+  }
+}
@@ -0,0 +1,165 @@
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/ITaskProcessor.h"
+#include "CesiumAsync/TaskFunction.h"
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace CesiumAsync;
+
+namespace {
+
+// Keeps the tasks it is given and only runs them when asked to, long after
+// they were scheduled.
+class DeferredTaskProcessor : public ITaskProcessor {
+public:
+  std::vector<TaskFunction> functions;
+
+  virtual void startTask(std::function<void()>) override {
+    FAIL("startTask should not be used when startTaskFunction is overridden.");
+  }
+
+  virtual void startTaskFunction(TaskFunction&& f) override {
+    this->functions.emplace_back(std::move(f));
+  }
+
+  void runAll() {
+    std::vector<TaskFunction> toRun = std::move(this->functions);
+    this->functions.clear();
+    for (TaskFunction& f : toRun) {
+      f();
+    }
+  }
+};
+
+// Like DeferredTaskProcessor, but only implements startTask, so tasks are
+// started with the default implementation of startTaskFunction.
+class DeferredStdFunctionTaskProcessor : public ITaskProcessor {
+public:
+  std::vector<std::function<void()>> functions;
+
+  virtual void startTask(std::function<void()> f) override {
+    this->functions.emplace_back(std::move(f));
+  }
+};
+
+} // namespace
+
+TEST_CASE("TaskFunction") {
+  SECTION("invokes a move-only callable stored in place") {
+    int32_t value = 0;
+    std::unique_ptr<int32_t> pValue = std::make_unique<int32_t>(42);
+    TaskFunction f([&value, pValue = std::move(pValue)]() { value = *pValue; });
+    REQUIRE(f);
+
+    TaskFunction moved = std::move(f);
+    CHECK(!f);
+    REQUIRE(moved);
+
+    moved();
+    CHECK(value == 42);
+  }
+
+  SECTION("invokes a callable too large to be stored in place") {
+    std::array<int64_t, 32> values{};
+    values[31] = 42;
+    int64_t value = 0;
+    TaskFunction f([&value, values]() { value = values[31]; });
+
+    TaskFunction moved;
+    moved = std::move(f);
+    CHECK(!f);
+    REQUIRE(moved);
+
+    moved();
+    CHECK(value == 42);
+  }
+
+  SECTION("destroys a callable that is not invoked") {
+    std::shared_ptr<int32_t> pSmall = std::make_shared<int32_t>(1);
+    std::shared_ptr<int32_t> pLarge = std::make_shared<int32_t>(2);
+
+    {
+      TaskFunction small([pSmall]() {});
+      std::array<int64_t, 32> padding{};
+      TaskFunction large([pLarge, padding]() {});
+      CHECK(pSmall.use_count() == 2);
+      CHECK(pLarge.use_count() == 2);
+    }
+
+    CHECK(pSmall.use_count() == 1);
+    CHECK(pLarge.use_count() == 1);
+  }
+}
+
+TEST_CASE("Worker thread tasks outlive their scheduling") {
+  SECTION("with a task processor that takes TaskFunctions") {
+    std::shared_ptr<DeferredTaskProcessor> pTaskProcessor =
+        std::make_shared<DeferredTaskProcessor>();
+    AsyncSystem asyncSystem(pTaskProcessor);
+
+    int32_t value = 42;
+    Future<int32_t> future =
+        asyncSystem.runInWorkerThread([value]() { return value; });
+
+    // The scheduling call has returned, and only the task processor owns the
+    // task.
+    REQUIRE(pTaskProcessor->functions.size() == 1);
+    pTaskProcessor->runAll();
+    CHECK(future.wait() == 42);
+  }
+
+  SECTION("with a task processor that takes TaskFunctions and drops them") {
+    std::shared_ptr<DeferredTaskProcessor> pTaskProcessor =
+        std::make_shared<DeferredTaskProcessor>();
+    AsyncSystem asyncSystem(pTaskProcessor);
+
+    bool executed = false;
+    Future<void> future =
+        asyncSystem.runInWorkerThread([&executed]() { executed = true; });
+
+    REQUIRE(pTaskProcessor->functions.size() == 1);
+    pTaskProcessor->functions.clear();
+    CHECK_THROWS(future.wait());
+    CHECK(!executed);
+  }
+
+  SECTION("with a task processor that only takes std::functions") {
+    std::shared_ptr<DeferredStdFunctionTaskProcessor> pTaskProcessor =
+        std::make_shared<DeferredStdFunctionTaskProcessor>();
+    AsyncSystem asyncSystem(pTaskProcessor);
+
+    int32_t executed = 0;
+    Future<int32_t> future = asyncSystem.runInWorkerThread([&executed]() {
+      ++executed;
+      return 42;
+    });
+
+    REQUIRE(pTaskProcessor->functions.size() == 1);
+    std::function<void()> copy = pTaskProcessor->functions[0];
+    pTaskProcessor->functions[0]();
+    CHECK(future.wait() == 42);
+
+    // Invoking another copy of the function does not run the task again.
+    copy();
+    CHECK(executed == 1);
+  }
+
+  SECTION("with a task processor that only takes std::functions and drops "
+          "them") {
+    std::shared_ptr<DeferredStdFunctionTaskProcessor> pTaskProcessor =
+        std::make_shared<DeferredStdFunctionTaskProcessor>();
+    AsyncSystem asyncSystem(pTaskProcessor);
+
+    Future<void> future = asyncSystem.runInWorkerThread([]() {});
+
+    REQUIRE(pTaskProcessor->functions.size() == 1);
+    pTaskProcessor->functions.clear();
+    CHECK_THROWS(future.wait());
+  }
+}
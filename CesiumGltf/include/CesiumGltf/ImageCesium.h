@@ -5,6 +5,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -93,9 +94,24 @@ struct CESIUMGLTF_API ImageCesium final {
    * | 2                  | grey, alpha               |
    * | 3                  | red, green, blue          |
    * | 4                  | red, green, blue, alpha   |
+   *
+   * This is empty when {@link pSharedPixelData} is set. Use
+   * {@link getPixelData} to read the pixels in either case.
    */
   std::vector<std::byte> pixelData;
 
+  /**
+   * @brief Pixel data that is shared with other images, or nullptr if the
+   * pixels are in {@link pixelData}.
+   *
+   * A `CesiumGltfReader::SharedImageCache` sets this instead of
+   * {@link pixelData}, so that all models with images decoded from the same
+   * bytes reference a single copy of the pixels. The shared pixels must not be
+   * modified. Call {@link unsharePixelData} to get a copy of them in
+   * {@link pixelData} first.
+   */
+  std::shared_ptr<const std::vector<std::byte>> pSharedPixelData;
+
   /**
    * @brief The effective size of this image, in bytes, for estimating resource
    * usage for caching purposes.
@@ -110,5 +126,24 @@ struct CESIUMGLTF_API ImageCesium final {
    * this image.
    */
   int64_t sizeBytes = -1;
+
+  /**
+   * @brief Gets the pixel data, which is in {@link pSharedPixelData} if it is
+   * set, and in {@link pixelData} otherwise.
+   */
+  const std::vector<std::byte>& getPixelData() const noexcept {
+    return this->pSharedPixelData ? *this->pSharedPixelData : this->pixelData;
+  }
+
+  /**
+   * @brief Copies the shared pixel data, if any, into {@link pixelData} and
+   * stops referencing the shared pixels, so that they may be modified.
+   */
+  void unsharePixelData() {
+    if (this->pSharedPixelData) {
+      this->pixelData = *this->pSharedPixelData;
+      this->pSharedPixelData.reset();
+    }
+  }
 };
 } // namespace CesiumGltf
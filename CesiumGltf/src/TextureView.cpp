@@ -157,8 +157,8 @@ std::vector<uint8_t> TextureView::sampleNearestPixel(
 
   // TODO: Currently stb only outputs uint8 pixel types. If that
   // changes this should account for additional pixel byte sizes.
-  const uint8_t* pValue =
-      reinterpret_cast<const uint8_t*>(image.pixelData.data() + pixelIndex);
+  const uint8_t* pValue = reinterpret_cast<const uint8_t*>(
+      image.getPixelData().data() + pixelIndex);
   for (size_t i = 0; i < result.size(); i++) {
     result[i] = *(pValue + channels[i]);
   }
@@ -181,6 +181,20 @@ struct CESIUMGLTFCONTENT_API GltfUtilities {
       CesiumGltf::Model& gltf,
       const std::vector<int32_t>& extraUsedMaterialIndices = {});
 
+  /**
+   * @brief Removes the accessors, buffer views, and buffers that are not
+   * used, and then removes the bytes that are not used from the remaining
+   * buffers.
+   *
+   * This has the same result as calling {@link removeUnusedAccessors},
+   * {@link removeUnusedBufferViews}, {@link removeUnusedBuffers}, and
+   * {@link compactBuffers}, in that order, but the glTF is traversed once to
+   * find everything that is used and each index is remapped only once.
+   *
+   * @param gltf The glTF to modify.
+   */
+  static void removeUnusedBufferData(CesiumGltf::Model& gltf);
+
   /**
    * @brief Shrink buffers by removing any sections that are not referenced by
    * any BufferView.
@@ -198,6 +212,44 @@ struct CESIUMGLTFCONTENT_API GltfUtilities {
    */
   static void compactBuffer(CesiumGltf::Model& gltf, int32_t bufferIndex);
 
+  /**
+   * @brief Reduces the number of triangles in each triangle-list primitive of
+   * the glTF using meshoptimizer's topology-preserving simplifier.
+   *
+   * Each simplified primitive gets new index and vertex attribute accessors
+   * that contain only the vertices that are still referenced. The previous
+   * accessors, buffer views, and buffer bytes are removed if nothing else
+   * uses them. Primitives with morph targets or skirts, and primitives
+   * without a `POSITION` attribute, are left unchanged.
+   *
+   * @param gltf The glTF to modify.
+   * @param targetIndexRatio The fraction of each primitive's indices to aim
+   * for, in the range 0.0 to 1.0.
+   * @param targetError The largest error to allow, relative to the extent of
+   * each primitive. For example, 0.01 allows an error of 1% of the extent.
+   * @return The largest error introduced into any primitive, in the units of
+   * its vertex positions.
+   */
+  static double simplifyMeshes(
+      CesiumGltf::Model& gltf,
+      float targetIndexRatio,
+      float targetError);
+
+  /**
+   * @brief Reorders the triangles and vertices of each triangle-list primitive
+   * of the glTF so that the GPU processes them efficiently.
+   *
+   * This runs meshoptimizer's vertex cache, overdraw, and vertex fetch
+   * optimizations, in that order. The triangles that are drawn do not change.
+   * Each optimized primitive gets new index and vertex attribute accessors,
+   * and the previous ones are removed if nothing else uses them. Primitives
+   * with morph targets or skirts, and primitives without a `POSITION`
+   * attribute, are left unchanged.
+   *
+   * @param gltf The glTF to modify.
+   */
+  static void optimizeMeshes(CesiumGltf::Model& gltf);
+
   /**
    * @brief Data describing a hit from a ray / gltf intersection test
    */
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "Library.h"
+
+#include <CesiumUtility/ErrorList.h>
+
+#include <gsl/span>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Forward declarations
+namespace CesiumGltf {
+struct MeshPrimitive;
+struct Model;
+} // namespace CesiumGltf
+
+namespace CesiumGltfContent {
+
+/**
+ * @brief The format in which each component of a vertex attribute is written
+ * by {@link VertexPacker}.
+ */
+enum class VertexComponentFormat : uint8_t {
+  /**
+   * @brief A 32-bit float.
+   */
+  Float32,
+
+  /**
+   * @brief A 16-bit (half precision) float.
+   */
+  Float16,
+
+  /**
+   * @brief A signed 16-bit integer mapping -1.0 to 1.0 onto -32767 to 32767.
+   */
+  Snorm16,
+
+  /**
+   * @brief A signed 8-bit integer mapping -1.0 to 1.0 onto -127 to 127.
+   */
+  Snorm8,
+
+  /**
+   * @brief An unsigned 16-bit integer mapping 0.0 to 1.0 onto 0 to 65535.
+   */
+  Unorm16,
+
+  /**
+   * @brief An unsigned 8-bit integer mapping 0.0 to 1.0 onto 0 to 255.
+   */
+  Unorm8
+};
+
+/**
+ * @brief Describes where and how one glTF vertex attribute is written in an
+ * interleaved vertex.
+ */
+struct CESIUMGLTFCONTENT_API VertexAttributeLayout {
+  /**
+   * @brief The glTF attribute semantic to read, such as `POSITION`, `NORMAL`,
+   * or `TEXCOORD_0`.
+   */
+  std::string semantic;
+
+  /**
+   * @brief The format of each written component.
+   */
+  VertexComponentFormat format = VertexComponentFormat::Float32;
+
+  /**
+   * @brief The number of components to write, from 1 to 4.
+   *
+   * If the glTF attribute has more components, the extra ones are dropped. If
+   * it has fewer, the remaining ones are taken from {@link defaultValue}.
+   */
+  uint8_t componentCount = 3;
+
+  /**
+   * @brief The offset of the attribute from the start of each vertex, in
+   * bytes.
+   */
+  uint32_t offset = 0;
+
+  /**
+   * @brief The components written when the glTF attribute does not provide
+   * them, including when the primitive does not have the attribute at all.
+   */
+  std::array<float, 4> defaultValue{0.0f, 0.0f, 0.0f, 1.0f};
+};
+
+/**
+ * @brief Describes the interleaved vertices produced by {@link VertexPacker}.
+ */
+struct CESIUMGLTFCONTENT_API VertexLayout {
+  /**
+   * @brief The attributes of each vertex.
+   */
+  std::vector<VertexAttributeLayout> attributes;
+
+  /**
+   * @brief The number of bytes from the start of one vertex to the start of
+   * the next.
+   */
+  uint32_t stride = 0;
+
+  /**
+   * @brief Adds an attribute after the existing ones and grows the
+   * {@link stride} to fit it.
+   *
+   * The attribute and the stride are aligned to four bytes, as most graphics
+   * APIs require.
+   *
+   * @param semantic The glTF attribute semantic to read.
+   * @param format The format of each written component.
+   * @param componentCount The number of components to write, from 1 to 4.
+   * @return The new attribute, so that its default value can be changed.
+   */
+  VertexAttributeLayout& addAttribute(
+      const std::string& semantic,
+      VertexComponentFormat format,
+      uint8_t componentCount);
+};
+
+/**
+ * @brief The interleaved vertices of a primitive, packed by
+ * {@link VertexPacker}.
+ */
+struct CESIUMGLTFCONTENT_API PackedVertices {
+  /**
+   * @brief The vertices, each {@link VertexLayout::stride} bytes long.
+   */
+  std::vector<std::byte> data;
+
+  /**
+   * @brief The number of vertices.
+   */
+  int64_t vertexCount = 0;
+
+  /**
+   * @brief The errors and warnings that occurred while packing. If there are
+   * errors, {@link data} is empty.
+   */
+  CesiumUtility::ErrorList errors;
+};
+
+/**
+ * @brief Packs the vertex attributes of a glTF primitive into the interleaved,
+ * optionally quantized layout expected by a renderer.
+ *
+ * Rather than having each renderer read every attribute separately and then
+ * repack it, the vertices are produced in a single pass over the source
+ * accessors and the destination. Vertices are processed in small blocks so
+ * that the conversion of each attribute is a tight loop specialized for its
+ * source and target types, while each block of the destination stays in
+ * cache until all of its attributes are written.
+ *
+ * Integer glTF attributes are converted to floats before being written,
+ * honoring their `normalized` flag. Writing to a normalized integer format
+ * clamps each component to the representable range.
+ */
+class CESIUMGLTFCONTENT_API VertexPacker {
+public:
+  /**
+   * @brief Gets the size of a component in the given format, in bytes.
+   */
+  static uint32_t getComponentSize(VertexComponentFormat format) noexcept;
+
+  /**
+   * @brief Gets the number of vertices of the given primitive.
+   *
+   * This is the count of its `POSITION` accessor or, if it has none, of any
+   * other attribute accessor, since glTF requires them all to have the same
+   * count.
+   */
+  static int64_t getVertexCount(
+      const CesiumGltf::Model& model,
+      const CesiumGltf::MeshPrimitive& primitive) noexcept;
+
+  /**
+   * @brief Packs the vertices of a primitive into the given memory, such as a
+   * mapped GPU buffer.
+   *
+   * @param model The model containing the primitive.
+   * @param primitive The primitive whose vertices are packed.
+   * @param layout The layout of each vertex.
+   * @param destination The memory to write, which must hold at least
+   * {@link getVertexCount} times {@link VertexLayout::stride} bytes. Bytes
+   * not covered by any attribute of the layout are left unchanged.
+   * @return The errors and warnings that occurred. If there are errors,
+   * nothing is written.
+   */
+  static CesiumUtility::ErrorList pack(
+      const CesiumGltf::Model& model,
+      const CesiumGltf::MeshPrimitive& primitive,
+      const VertexLayout& layout,
+      const gsl::span<std::byte>& destination);
+
+  /**
+   * @brief Packs the vertices of a primitive into a new buffer.
+   *
+   * Bytes not covered by any attribute of the layout are zero.
+   *
+   * @param model The model containing the primitive.
+   * @param primitive The primitive whose vertices are packed.
+   * @param layout The layout of each vertex.
+   * @return The packed vertices.
+   */
+  static PackedVertices pack(
+      const CesiumGltf::Model& model,
+      const CesiumGltf::MeshPrimitive& primitive,
+      const VertexLayout& layout);
+};
+
+} // namespace CesiumGltfContent
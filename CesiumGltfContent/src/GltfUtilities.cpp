@@ -20,10 +20,15 @@
 #include <CesiumGltfContent/GltfUtilities.h>
 #include <CesiumGltfContent/SkirtMeshMetadata.h>
 #include <CesiumUtility/Assert.h>
+#include <CesiumUtility/Tracing.h>
 
 #include <glm/gtc/quaternion.hpp>
+#include <meshoptimizer.h>
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
+#include <numeric>
 #include <unordered_set>
 #include <vector>
 
@@ -870,14 +875,24 @@ struct VisitAccessorIds {
 struct VisitBufferViewIds {
   template <typename Func> void operator()(Model& gltf, Func&& callback) {
     for (Accessor& accessor : gltf.accessors) {
-      callback(accessor.bufferView);
+      visitAccessor(accessor, callback);
+    }
 
-      if (accessor.sparse) {
-        callback(accessor.sparse->indices.bufferView);
-        callback(accessor.sparse->values.bufferView);
-      }
+    visitNonAccessors(gltf, callback);
+  }
+
+  template <typename Func>
+  static void visitAccessor(Accessor& accessor, Func&& callback) {
+    callback(accessor.bufferView);
+
+    if (accessor.sparse) {
+      callback(accessor.sparse->indices.bufferView);
+      callback(accessor.sparse->values.bufferView);
     }
+  }
 
+  template <typename Func>
+  static void visitNonAccessors(Model& gltf, Func&& callback) {
     for (Image& image : gltf.images) {
       callback(image.bufferView);
     }
@@ -909,13 +924,18 @@ struct VisitBufferViewIds {
 struct VisitBufferIds {
   template <typename Func> void operator()(Model& gltf, Func&& callback) {
     for (BufferView& bufferView : gltf.bufferViews) {
-      callback(bufferView.buffer);
+      visitBufferView(bufferView, callback);
+    }
+  }
 
-      ExtensionBufferViewExtMeshoptCompression* pMeshOpt =
-          bufferView.getExtension<ExtensionBufferViewExtMeshoptCompression>();
-      if (pMeshOpt) {
-        callback(pMeshOpt->buffer);
-      }
+  template <typename Func>
+  static void visitBufferView(BufferView& bufferView, Func&& callback) {
+    callback(bufferView.buffer);
+
+    ExtensionBufferViewExtMeshoptCompression* pMeshOpt =
+        bufferView.getExtension<ExtensionBufferViewExtMeshoptCompression>();
+    if (pMeshOpt) {
+      callback(pMeshOpt->buffer);
     }
   }
 };
@@ -938,6 +958,43 @@ struct VisitMaterialIds {
   }
 };
 
+// Get a callback that marks the IDs it is given as used.
+auto markUsed(std::vector<bool>& usedIndices) {
+  return [&usedIndices](int32_t index) {
+    if (index >= 0 && size_t(index) < usedIndices.size())
+      usedIndices[size_t(index)] = true;
+  };
+}
+
+// Get a callback that replaces the IDs it is given with their new values from
+// an index map created by getIndexMap.
+auto remapIndex(const std::vector<int32_t>& indexMap) {
+  return [&indexMap](int32_t& index) {
+    if (index >= 0 && size_t(index) < indexMap.size()) {
+      int32_t newIndex = indexMap[size_t(index)];
+      CESIUM_ASSERT(newIndex >= 0);
+      index = newIndex;
+    }
+  };
+}
+
+// Remove the unused elements, preserving the order of the others.
+template <typename T>
+void eraseUnused(std::vector<T>& elements, const std::vector<bool>& used) {
+  CESIUM_ASSERT(used.size() == elements.size());
+
+  size_t count = 0;
+  for (size_t i = 0; i < elements.size(); ++i) {
+    if (used[i]) {
+      if (count != i)
+        elements[count] = std::move(elements[i]);
+      ++count;
+    }
+  }
+
+  elements.erase(elements.begin() + int64_t(count), elements.end());
+}
+
 template <typename T, typename TVisitFunction>
 void removeUnusedElements(
     Model& gltf,
@@ -947,37 +1004,17 @@ void removeUnusedElements(
   std::vector<bool> usedElements(elements.size(), false);
 
   for (int32_t index : extraUsedIndices) {
-    if (index >= 0 && size_t(index) < usedElements.size())
-      usedElements[size_t(index)] = true;
+    markUsed(usedElements)(index);
   }
 
   // Determine which elements are used.
-  visitFunction(gltf, [&usedElements](int32_t elementIndex) {
-    if (elementIndex >= 0 && size_t(elementIndex) < usedElements.size())
-      usedElements[size_t(elementIndex)] = true;
-  });
+  visitFunction(gltf, markUsed(usedElements));
 
   // Update the element indices based on the unused indices being removed.
   std::vector<int32_t> indexMap = getIndexMap(usedElements);
-  visitFunction(gltf, [&indexMap](int32_t& elementIndex) {
-    if (elementIndex >= 0 && size_t(elementIndex) < indexMap.size()) {
-      int32_t newIndex = indexMap[size_t(elementIndex)];
-      CESIUM_ASSERT(newIndex >= 0);
-      elementIndex = newIndex;
-    }
-  });
+  visitFunction(gltf, remapIndex(indexMap));
 
-  // Remove the unused elements.
-  elements.erase(
-      std::remove_if(
-          elements.begin(),
-          elements.end(),
-          [&usedElements, &elements](T& element) {
-            int64_t index = &element - &elements[0];
-            CESIUM_ASSERT(index >= 0 && size_t(index) < usedElements.size());
-            return !usedElements[size_t(index)];
-          }),
-      elements.end());
+  eraseUnused(elements, usedElements);
 }
 
 } // namespace
@@ -1058,164 +1095,618 @@ void GltfUtilities::removeUnusedMaterials(
       VisitMaterialIds());
 }
 
-void GltfUtilities::compactBuffers(CesiumGltf::Model& gltf) {
-  for (size_t i = 0;
-       i < gltf.buffers.size() && i < std::numeric_limits<int32_t>::max();
-       ++i) {
-    GltfUtilities::compactBuffer(gltf, int32_t(i));
+void GltfUtilities::removeUnusedBufferData(CesiumGltf::Model& gltf) {
+  CESIUM_TRACE("GltfUtilities::removeUnusedBufferData");
+
+  // Mark everything that is reachable, following references from accessors
+  // to buffer views to buffers. Only the elements that are used themselves
+  // can keep the elements they refer to.
+  std::vector<bool> usedAccessors(gltf.accessors.size(), false);
+  VisitAccessorIds()(gltf, markUsed(usedAccessors));
+
+  std::vector<bool> usedBufferViews(gltf.bufferViews.size(), false);
+  for (size_t i = 0; i < gltf.accessors.size(); ++i) {
+    if (usedAccessors[i]) {
+      VisitBufferViewIds::visitAccessor(
+          gltf.accessors[i],
+          markUsed(usedBufferViews));
+    }
+  }
+  VisitBufferViewIds::visitNonAccessors(gltf, markUsed(usedBufferViews));
+
+  std::vector<bool> usedBuffers(gltf.buffers.size(), false);
+  for (size_t i = 0; i < gltf.bufferViews.size(); ++i) {
+    if (usedBufferViews[i]) {
+      VisitBufferIds::visitBufferView(
+          gltf.bufferViews[i],
+          markUsed(usedBuffers));
+    }
   }
-}
 
-namespace {
+  // Remap the references held by the elements that are kept.
+  const std::vector<int32_t> accessorMap = getIndexMap(usedAccessors);
+  VisitAccessorIds()(gltf, remapIndex(accessorMap));
 
-void deleteBufferRange(
-    CesiumGltf::Model& gltf,
-    int32_t bufferIndex,
-    int64_t start,
-    int64_t end) {
-  Buffer* pBuffer = gltf.getSafe(&gltf.buffers, bufferIndex);
-  if (pBuffer == nullptr)
-    return;
+  const std::vector<int32_t> bufferViewMap = getIndexMap(usedBufferViews);
+  for (size_t i = 0; i < gltf.accessors.size(); ++i) {
+    if (usedAccessors[i]) {
+      VisitBufferViewIds::visitAccessor(
+          gltf.accessors[i],
+          remapIndex(bufferViewMap));
+    }
+  }
+  VisitBufferViewIds::visitNonAccessors(gltf, remapIndex(bufferViewMap));
+
+  const std::vector<int32_t> bufferMap = getIndexMap(usedBuffers);
+  for (size_t i = 0; i < gltf.bufferViews.size(); ++i) {
+    if (usedBufferViews[i]) {
+      VisitBufferIds::visitBufferView(
+          gltf.bufferViews[i],
+          remapIndex(bufferMap));
+    }
+  }
 
-  CESIUM_ASSERT(size_t(pBuffer->byteLength) == pBuffer->cesium.data.size());
+  eraseUnused(gltf.accessors, usedAccessors);
+  eraseUnused(gltf.bufferViews, usedBufferViews);
+  eraseUnused(gltf.buffers, usedBuffers);
 
-  int64_t bytesToRemove = end - start;
+  GltfUtilities::compactBuffers(gltf);
+}
 
-  // In order to ensure that we can't disrupt glTF's alignment requirements,
-  // only remove multiples of 8 bytes from within the buffer (removing any
-  // number of bytes from the end is fine).
-  if (end < pBuffer->byteLength) {
-    // Round down to the nearest multiple of 8 by clearing the low three bits.
-    bytesToRemove = bytesToRemove & ~0b111;
-    if (bytesToRemove == 0)
-      return;
+namespace {
 
-    end = start + bytesToRemove;
-  }
+struct BufferRange {
+  int64_t start; // first byte
+  int64_t end;   // one past last byte
 
-  // Adjust bufferView offsets for the removed bytes.
+  // The number of bytes removed before this range when the buffer is
+  // compacted.
+  int64_t shift;
+};
+
+// Invokes the callback with the buffer index, byte offset, and byte length of
+// every buffer section that is referenced by a bufferView, including the
+// compressed data of EXT_meshopt_compression.
+template <typename Func>
+void forEachBufferViewRange(Model& gltf, Func&& callback) {
   for (BufferView& bufferView : gltf.bufferViews) {
-    if (bufferView.buffer == bufferIndex) {
-      // Sanity check that we're not removing a part of the buffer used by this
-      // bufferView.
-      assert(
-          bufferView.byteOffset >= end ||
-          (bufferView.byteOffset + bufferView.byteLength) <= start);
-
-      // If this bufferView starts after the bytes we're removing, adjust the
-      // start position accordingly.
-      if (bufferView.byteOffset >= start) {
-        bufferView.byteOffset -= bytesToRemove;
-      }
-    }
+    callback(bufferView.buffer, bufferView.byteOffset, bufferView.byteLength);
 
     ExtensionBufferViewExtMeshoptCompression* pMeshOpt =
         bufferView.getExtension<ExtensionBufferViewExtMeshoptCompression>();
-    if (pMeshOpt && pMeshOpt->buffer == bufferIndex) {
-      // Sanity check that we're not removing a part of the buffer used by this
-      // meshopt extension.
-      assert(
-          pMeshOpt->byteOffset >= end ||
-          (pMeshOpt->byteOffset + pMeshOpt->byteLength) <= start);
-
-      // If this meshopt extension starts after the bytes we're removing, adjust
-      // the start position accordingly.
-      if (pMeshOpt->byteOffset >= start) {
-        pMeshOpt->byteOffset -= bytesToRemove;
-      }
+    if (pMeshOpt) {
+      callback(pMeshOpt->buffer, pMeshOpt->byteOffset, pMeshOpt->byteLength);
+    }
+  }
+}
+
+// Removes the bytes of a buffer that are not within any of the given used
+// ranges, moving each contiguous section of used bytes only once. On return,
+// the ranges are sorted, merged, and know how far they were moved.
+void compactBufferRanges(Buffer& buffer, std::vector<BufferRange>& ranges) {
+  CESIUM_ASSERT(size_t(buffer.byteLength) == buffer.cesium.data.size());
+
+  std::sort(
+      ranges.begin(),
+      ranges.end(),
+      [](const BufferRange& a, const BufferRange& b) {
+        return a.start < b.start;
+      });
+
+  // Merge the ranges that overlap or touch.
+  size_t rangeCount = 0;
+  for (const BufferRange& range : ranges) {
+    if (rangeCount > 0 && ranges[rangeCount - 1].end >= range.start) {
+      BufferRange& previous = ranges[rangeCount - 1];
+      previous.end = std::max(previous.end, range.end);
+    } else {
+      ranges[rangeCount] = range;
+      ++rangeCount;
     }
   }
+  ranges.resize(rangeCount);
+
+  std::byte* pData = buffer.cesium.data.data();
+  int64_t removed = 0;
+  int64_t previousEnd = 0;
+  for (BufferRange& range : ranges) {
+    // In order to ensure that we can't disrupt glTF's alignment requirements,
+    // only remove multiples of 8 bytes from within the buffer (removing any
+    // number of bytes from the end is fine). The bytes at the start of the
+    // gap are the ones removed.
+    int64_t bytesToRemove = range.start - previousEnd;
+    if (range.start < buffer.byteLength) {
+      bytesToRemove &= ~int64_t(0b111);
+    }
+
+    const int64_t keptStart = previousEnd + bytesToRemove;
+    removed += bytesToRemove;
+    range.shift = removed;
+
+    if (removed > 0 && range.end > keptStart) {
+      std::memmove(
+          pData + keptStart - removed,
+          pData + keptStart,
+          size_t(range.end - keptStart));
+    }
+
+    previousEnd = range.end;
+  }
+
+  // Everything after the last used range is removed.
+  buffer.byteLength = previousEnd - removed;
+  buffer.cesium.data.resize(size_t(buffer.byteLength));
+}
+
+// Gets the number of bytes removed before the given offset by
+// compactBufferRanges.
+int64_t getShift(const std::vector<BufferRange>& ranges, int64_t byteOffset) {
+  auto it = std::upper_bound(
+      ranges.begin(),
+      ranges.end(),
+      byteOffset,
+      [](int64_t offset, const BufferRange& range) {
+        return offset < range.start;
+      });
+  if (it == ranges.begin()) {
+    return 0;
+  }
+  return (it - 1)->shift;
+}
+
+void compactBufferIndices(
+    Model& gltf,
+    size_t firstBufferIndex,
+    size_t endBufferIndex) {
+  endBufferIndex = std::min(endBufferIndex, gltf.buffers.size());
+  if (firstBufferIndex >= endBufferIndex) {
+    return;
+  }
+
+  // Find the used bytes of every buffer in one pass over the bufferViews.
+  std::vector<std::vector<BufferRange>> usedRanges(
+      endBufferIndex - firstBufferIndex);
+  forEachBufferViewRange(
+      gltf,
+      [&gltf, &usedRanges, firstBufferIndex, endBufferIndex](
+          int32_t bufferIndex,
+          int64_t byteOffset,
+          int64_t byteLength) {
+        if (bufferIndex < 0 || size_t(bufferIndex) < firstBufferIndex ||
+            size_t(bufferIndex) >= endBufferIndex) {
+          return;
+        }
 
-  // Actually remove the bytes from the buffer.
-  pBuffer->byteLength -= bytesToRemove;
-  pBuffer->cesium.data.erase(
-      pBuffer->cesium.data.begin() + start,
-      pBuffer->cesium.data.begin() + end);
+        // Ranges outside of the buffer do not keep any of its bytes.
+        const int64_t bufferLength =
+            gltf.buffers[size_t(bufferIndex)].byteLength;
+        const int64_t start = std::clamp(byteOffset, int64_t(0), bufferLength);
+        const int64_t end =
+            std::clamp(byteOffset + byteLength, start, bufferLength);
+        usedRanges[size_t(bufferIndex) - firstBufferIndex].push_back(
+            BufferRange{start, end, 0});
+      });
+
+  for (size_t i = firstBufferIndex; i < endBufferIndex; ++i) {
+    compactBufferRanges(gltf.buffers[i], usedRanges[i - firstBufferIndex]);
+  }
+
+  // Move the bufferViews along with the bytes they refer to.
+  forEachBufferViewRange(
+      gltf,
+      [&usedRanges, firstBufferIndex, endBufferIndex](
+          int32_t bufferIndex,
+          int64_t& byteOffset,
+          int64_t /* byteLength */) {
+        if (bufferIndex < 0 || size_t(bufferIndex) < firstBufferIndex ||
+            size_t(bufferIndex) >= endBufferIndex) {
+          return;
+        }
+
+        byteOffset -= getShift(
+            usedRanges[size_t(bufferIndex) - firstBufferIndex],
+            byteOffset);
+      });
 }
 
 } // namespace
 
+void GltfUtilities::compactBuffers(CesiumGltf::Model& gltf) {
+  CESIUM_TRACE("GltfUtilities::compactBuffers");
+  compactBufferIndices(gltf, 0, gltf.buffers.size());
+}
+
 void GltfUtilities::compactBuffer(
     CesiumGltf::Model& gltf,
     int32_t bufferIndex) {
-  Buffer* pBuffer = gltf.getSafe(&gltf.buffers, bufferIndex);
-  if (!pBuffer)
+  if (bufferIndex < 0)
     return;
 
-  CESIUM_ASSERT(size_t(pBuffer->byteLength) == pBuffer->cesium.data.size());
+  compactBufferIndices(gltf, size_t(bufferIndex), size_t(bufferIndex) + 1);
+}
 
-  struct BufferRange {
-    int64_t start; // first byte
-    int64_t end;   // one past last byte
+namespace {
 
-    // Order ranges by their start
-    bool operator<(const BufferRange& rhs) const {
-      return this->start < rhs.start;
+template <typename T>
+bool copyIndices(const AccessorView<T>& view, std::vector<uint32_t>& indices) {
+  if (view.status() != AccessorViewStatus::Valid) {
+    return false;
+  }
+
+  indices.resize(size_t(view.size()));
+  for (int64_t i = 0; i < view.size(); ++i) {
+    indices[size_t(i)] = uint32_t(view[i]);
+  }
+
+  return true;
+}
+
+bool readIndices(
+    const Model& gltf,
+    const MeshPrimitive& primitive,
+    size_t vertexCount,
+    std::vector<uint32_t>& indices) {
+  if (primitive.indices < 0) {
+    indices.resize(vertexCount);
+    std::iota(indices.begin(), indices.end(), 0U);
+    return true;
+  }
+
+  const Accessor* pAccessor =
+      Model::getSafe(&gltf.accessors, primitive.indices);
+  if (!pAccessor) {
+    return false;
+  }
+
+  switch (pAccessor->componentType) {
+  case Accessor::ComponentType::UNSIGNED_BYTE:
+    return copyIndices(AccessorView<uint8_t>(gltf, *pAccessor), indices);
+  case Accessor::ComponentType::UNSIGNED_SHORT:
+    return copyIndices(AccessorView<uint16_t>(gltf, *pAccessor), indices);
+  case Accessor::ComponentType::UNSIGNED_INT:
+    return copyIndices(AccessorView<uint32_t>(gltf, *pAccessor), indices);
+  default:
+    return false;
+  }
+}
+
+int32_t addAccessorWithData(
+    Model& gltf,
+    std::vector<std::byte>&& data,
+    int32_t target,
+    std::optional<int64_t> byteStride,
+    Accessor&& accessor) {
+  const int32_t bufferIndex = int32_t(gltf.buffers.size());
+  Buffer& buffer = gltf.buffers.emplace_back();
+  buffer.byteLength = int64_t(data.size());
+  buffer.cesium.data = std::move(data);
+
+  const int32_t bufferViewIndex = int32_t(gltf.bufferViews.size());
+  BufferView& bufferView = gltf.bufferViews.emplace_back();
+  bufferView.buffer = bufferIndex;
+  bufferView.byteLength = buffer.byteLength;
+  bufferView.byteStride = byteStride;
+  bufferView.target = target;
+
+  accessor.bufferView = bufferViewIndex;
+  accessor.byteOffset = 0;
+  gltf.accessors.emplace_back(std::move(accessor));
+  return int32_t(gltf.accessors.size() - 1);
+}
+
+/**
+ * Replaces the primitive's indices with new ones, using 16-bit indices when
+ * all of them fit.
+ */
+void setIndices(
+    Model& gltf,
+    MeshPrimitive& primitive,
+    const std::vector<uint32_t>& indices,
+    size_t vertexCount) {
+  Accessor accessor;
+  accessor.type = Accessor::Type::SCALAR;
+  accessor.count = int64_t(indices.size());
+
+  std::vector<std::byte> data;
+  if (vertexCount <= size_t(std::numeric_limits<uint16_t>::max())) {
+    accessor.componentType = Accessor::ComponentType::UNSIGNED_SHORT;
+    data.resize(indices.size() * sizeof(uint16_t));
+    uint16_t* pIndices = reinterpret_cast<uint16_t*>(data.data());
+    for (size_t i = 0; i < indices.size(); ++i) {
+      pIndices[i] = uint16_t(indices[i]);
     }
-  };
+  } else {
+    accessor.componentType = Accessor::ComponentType::UNSIGNED_INT;
+    data.resize(indices.size() * sizeof(uint32_t));
+    std::memcpy(data.data(), indices.data(), data.size());
+  }
 
-  std::vector<BufferRange> usedRanges;
-
-  auto addUsedRange = [&usedRanges](int64_t start, int64_t end) {
-    auto it = std::lower_bound(
-        usedRanges.begin(),
-        usedRanges.end(),
-        BufferRange{start, end});
-    it = usedRanges.insert(it, BufferRange{start, end});
-
-    // Check if we can merge with the previous range.
-    if (it != usedRanges.begin()) {
-      auto previousIt = it - 1;
-      if (previousIt->end >= it->start) {
-        // New range overlaps the previous, so combine them.
-        previousIt->end = std::max(previousIt->end, it->end);
-        it = usedRanges.erase(it) - 1;
-      }
+  primitive.indices = addAccessorWithData(
+      gltf,
+      std::move(data),
+      BufferView::Target::ELEMENT_ARRAY_BUFFER,
+      std::nullopt,
+      std::move(accessor));
+}
+
+/**
+ * Copies the vertices of the primitive that are kept by `remap` into new
+ * accessors, in their new order. If any attribute cannot be remapped, nothing
+ * is changed and false is returned.
+ */
+bool remapVertexAttributes(
+    Model& gltf,
+    MeshPrimitive& primitive,
+    const std::vector<uint32_t>& remap,
+    size_t newVertexCount) {
+  const size_t vertexCount = remap.size();
+
+  for (const auto& [name, accessorIndex] : primitive.attributes) {
+    const Accessor* pAccessor = Model::getSafe(&gltf.accessors, accessorIndex);
+    if (!pAccessor || pAccessor->sparse ||
+        pAccessor->count != int64_t(vertexCount)) {
+      return false;
     }
 
-    // Check if we can merge with the next range.
-    auto nextIt = it + 1;
-    if (nextIt != usedRanges.end()) {
-      if (it->end >= nextIt->start) {
-        // New range overlaps the next, so combine them.
-        it->end = std::max(it->end, nextIt->end);
-        it = usedRanges.erase(nextIt) - 1;
-      }
+    const BufferView* pBufferView =
+        Model::getSafe(&gltf.bufferViews, pAccessor->bufferView);
+    if (!pBufferView) {
+      return false;
     }
-  };
 
-  for (BufferView& bufferView : gltf.bufferViews) {
-    if (bufferView.buffer == bufferIndex) {
-      addUsedRange(
-          bufferView.byteOffset,
-          bufferView.byteOffset + bufferView.byteLength);
+    const Buffer* pBuffer = Model::getSafe(&gltf.buffers, pBufferView->buffer);
+    const int64_t elementSize = pAccessor->computeBytesPerVertex();
+    if (!pBuffer || elementSize <= 0 || vertexCount == 0) {
+      return false;
     }
 
-    ExtensionBufferViewExtMeshoptCompression* pMeshOpt =
-        bufferView.getExtension<ExtensionBufferViewExtMeshoptCompression>();
-    if (pMeshOpt && pMeshOpt->buffer == bufferIndex) {
-      addUsedRange(
-          pMeshOpt->byteOffset,
-          pMeshOpt->byteOffset + pMeshOpt->byteLength);
+    const int64_t end = pBufferView->byteOffset + pAccessor->byteOffset +
+                        int64_t(vertexCount - 1) *
+                            pAccessor->computeByteStride(gltf) +
+                        elementSize;
+    if (end > int64_t(pBuffer->cesium.data.size())) {
+      return false;
+    }
+  }
+
+  for (auto& [name, accessorIndex] : primitive.attributes) {
+    const Accessor& source = gltf.accessors[size_t(accessorIndex)];
+    const BufferView& sourceBufferView =
+        gltf.bufferViews[size_t(source.bufferView)];
+    const std::byte* pSource =
+        gltf.buffers[size_t(sourceBufferView.buffer)].cesium.data.data() +
+        sourceBufferView.byteOffset + source.byteOffset;
+    const size_t sourceStride = size_t(source.computeByteStride(gltf));
+    const size_t elementSize = size_t(source.computeBytesPerVertex());
+
+    // Vertex attribute strides must be a multiple of four bytes.
+    const size_t stride = (elementSize + 3) & ~size_t(3);
+
+    std::vector<std::byte> data(newVertexCount * stride);
+    for (size_t i = 0; i < vertexCount; ++i) {
+      if (remap[i] != std::numeric_limits<uint32_t>::max()) {
+        std::memcpy(
+            data.data() + size_t(remap[i]) * stride,
+            pSource + i * sourceStride,
+            elementSize);
+      }
+    }
+
+    Accessor accessor;
+    accessor.componentType = source.componentType;
+    accessor.type = source.type;
+    accessor.normalized = source.normalized;
+    accessor.count = int64_t(newVertexCount);
+    accessor.min = source.min;
+    accessor.max = source.max;
+
+    accessorIndex = addAccessorWithData(
+        gltf,
+        std::move(data),
+        BufferView::Target::ARRAY_BUFFER,
+        stride != elementSize ? std::optional<int64_t>(int64_t(stride))
+                              : std::nullopt,
+        std::move(accessor));
+  }
+
+  return true;
+}
+
+/**
+ * Reads the positions and indices of a triangle-list primitive whose vertices
+ * can be freely reordered. Returns false if the primitive has morph targets or
+ * skirts, or if it has no valid float `POSITION` attribute or triangles.
+ */
+bool readTriangles(
+    const Model& gltf,
+    const MeshPrimitive& primitive,
+    std::vector<glm::vec3>& positions,
+    std::vector<uint32_t>& indices) {
+  if (primitive.mode != MeshPrimitive::Mode::TRIANGLES ||
+      !primitive.targets.empty() ||
+      SkirtMeshMetadata::parseFromGltfExtras(primitive.extras)) {
+    return false;
+  }
+
+  auto positionIt = primitive.attributes.find("POSITION");
+  if (positionIt == primitive.attributes.end()) {
+    return false;
+  }
+
+  const Accessor* pPositionAccessor =
+      Model::getSafe(&gltf.accessors, positionIt->second);
+  if (!pPositionAccessor) {
+    return false;
+  }
+
+  AccessorView<AccessorTypes::VEC3<float>> positionView(
+      gltf,
+      *pPositionAccessor);
+  if (positionView.status() != AccessorViewStatus::Valid ||
+      positionView.size() == 0) {
+    return false;
+  }
+
+  positions.resize(size_t(positionView.size()));
+  for (int64_t i = 0; i < positionView.size(); ++i) {
+    const AccessorTypes::VEC3<float>& position = positionView[i];
+    positions[size_t(i)] =
+        glm::vec3(position.value[0], position.value[1], position.value[2]);
+  }
+
+  return readIndices(gltf, primitive, positions.size(), indices) &&
+         indices.size() >= 3;
+}
+
+/**
+ * Replaces the primitive's triangles with the given ones, first reordering
+ * its vertices into the order in which the triangles use them and dropping
+ * the vertices they do not use.
+ */
+void setTriangles(
+    Model& gltf,
+    MeshPrimitive& primitive,
+    std::vector<uint32_t>& indices,
+    size_t vertexCount,
+    std::vector<uint32_t>& remap) {
+  remap.resize(vertexCount);
+  const size_t newVertexCount = meshopt_optimizeVertexFetchRemap(
+      remap.data(),
+      indices.data(),
+      indices.size(),
+      vertexCount);
+  if (remapVertexAttributes(gltf, primitive, remap, newVertexCount)) {
+    meshopt_remapIndexBuffer(
+        indices.data(),
+        indices.data(),
+        indices.size(),
+        remap.data());
+    vertexCount = newVertexCount;
+  }
+
+  setIndices(gltf, primitive, indices, vertexCount);
+}
+
+/**
+ * Removes the accessors, buffer views, and buffer bytes that are no longer
+ * used after primitives have been given new ones, and gathers what remains
+ * into a single buffer.
+ */
+void removeReplacedData(Model& gltf) {
+  GltfUtilities::removeUnusedBufferData(gltf);
+  GltfUtilities::collapseToSingleBuffer(gltf);
+}
+} // namespace
+
+/*static*/ double GltfUtilities::simplifyMeshes(
+    CesiumGltf::Model& gltf,
+    float targetIndexRatio,
+    float targetError) {
+  CESIUM_TRACE("GltfUtilities::simplifyMeshes");
+
+  double maximumError = 0.0;
+  bool changed = false;
+
+  std::vector<glm::vec3> positions;
+  std::vector<uint32_t> indices;
+  std::vector<uint32_t> simplified;
+  std::vector<uint32_t> remap;
+
+  for (Mesh& mesh : gltf.meshes) {
+    for (MeshPrimitive& primitive : mesh.primitives) {
+      if (!readTriangles(gltf, primitive, positions, indices)) {
+        continue;
+      }
+
+      const size_t targetIndexCount =
+          size_t(double(indices.size()) * double(targetIndexRatio)) / 3 * 3;
+
+      float resultError = 0.0f;
+      simplified.resize(indices.size());
+      const size_t indexCount = meshopt_simplify(
+          simplified.data(),
+          indices.data(),
+          indices.size(),
+          &positions[0].x,
+          positions.size(),
+          sizeof(glm::vec3),
+          targetIndexCount,
+          targetError,
+          0,
+          &resultError);
+      if (indexCount >= indices.size()) {
+        continue;
+      }
+      simplified.resize(indexCount);
+
+      const float scale = meshopt_simplifyScale(
+          &positions[0].x,
+          positions.size(),
+          sizeof(glm::vec3));
+      maximumError =
+          glm::max(maximumError, double(resultError) * double(scale));
+
+      setTriangles(gltf, primitive, simplified, positions.size(), remap);
+      changed = true;
     }
   }
 
-  // At this point, any gaps in the usedRanges represent buffer bytes that are
-  // not referenced by any bufferView. Work through it backwards so that we
-  // don't need to update the ranges as we delete unused data from the buffer.
-  BufferRange nextRange{pBuffer->byteLength, pBuffer->byteLength};
-  for (int64_t i = int64_t(usedRanges.size()) - 1; i >= 0; --i) {
-    BufferRange& usedRange = usedRanges[size_t(i)];
-    if (usedRange.end < nextRange.start) {
-      // This is a gap.
-      deleteBufferRange(gltf, bufferIndex, usedRange.end, nextRange.start);
+  if (changed) {
+    removeReplacedData(gltf);
+  }
+
+  return maximumError;
+}
+
+/*static*/ void GltfUtilities::optimizeMeshes(CesiumGltf::Model& gltf) {
+  CESIUM_TRACE("GltfUtilities::optimizeMeshes");
+
+  bool changed = false;
+
+  std::vector<glm::vec3> positions;
+  std::vector<uint32_t> indices;
+  std::vector<uint32_t> remap;
+
+  for (Mesh& mesh : gltf.meshes) {
+    for (MeshPrimitive& primitive : mesh.primitives) {
+      if (!readTriangles(gltf, primitive, positions, indices)) {
+        continue;
+      }
+
+      {
+        CESIUM_TRACE("GltfUtilities::optimizeMeshes vertex cache");
+        meshopt_optimizeVertexCache(
+            indices.data(),
+            indices.data(),
+            indices.size(),
+            positions.size());
+      }
+
+      {
+        CESIUM_TRACE("GltfUtilities::optimizeMeshes overdraw");
+        // Allow the vertex cache efficiency to get up to 5% worse in exchange
+        // for less overdraw, as recommended by meshoptimizer.
+        meshopt_optimizeOverdraw(
+            indices.data(),
+            indices.data(),
+            indices.size(),
+            &positions[0].x,
+            positions.size(),
+            sizeof(glm::vec3),
+            1.05f);
+      }
+
+      {
+        CESIUM_TRACE("GltfUtilities::optimizeMeshes vertex fetch");
+        setTriangles(gltf, primitive, indices, positions.size(), remap);
+      }
+
+      changed = true;
     }
-    nextRange = usedRange;
   }
 
-  if (nextRange.start > 0) {
-    // There is a gap at the start of the buffer.
-    deleteBufferRange(gltf, bufferIndex, 0, nextRange.start);
+  if (changed) {
+    removeReplacedData(gltf);
   }
 }
 
@@ -78,13 +78,13 @@ bool ImageManipulation::blitImage(
   const size_t requiredSourceSize =
       size_t(sourcePixels.height) * bytesPerSourceRow;
   if (target.pixelData.size() < requiredTargetSize ||
-      source.pixelData.size() < requiredSourceSize) {
+      source.getPixelData().size() < requiredSourceSize) {
     return false;
   }
 
   // Position both pointers at the start of the first row.
   std::byte* pTarget = target.pixelData.data();
-  const std::byte* pSource = source.pixelData.data();
+  const std::byte* pSource = source.getPixelData().data();
   pTarget += size_t(targetPixels.y) * bytesPerTargetRow +
              size_t(targetPixels.x) * bytesPerPixel;
   pSource += size_t(sourcePixels.y) * bytesPerSourceRow +
@@ -147,7 +147,7 @@ void writePngToVector(void* context, void* data, int size) {
       image.width,
       image.height,
       image.channels,
-      image.pixelData.data(),
+      image.getPixelData().data(),
       0);
 }
 
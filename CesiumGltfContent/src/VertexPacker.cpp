@@ -0,0 +1,516 @@
+#include <CesiumGltf/AccessorView.h>
+#include <CesiumGltf/Model.h>
+#include <CesiumGltfContent/VertexPacker.h>
+#include <CesiumUtility/Tracing.h>
+
+#include <meshoptimizer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+using namespace CesiumGltf;
+using namespace CesiumUtility;
+
+namespace CesiumGltfContent {
+namespace {
+// The number of vertices packed at a time. All attributes of a block are
+// written before moving on to the next, so that the block stays in cache.
+constexpr int64_t BlockSize = 256;
+
+struct SourceAttribute {
+  AccessorViewStatus status;
+  const std::byte* pData;
+  int64_t stride;
+  int64_t size;
+  int32_t componentType;
+  int64_t componentCount;
+  bool normalized;
+};
+
+uint32_t alignToFourBytes(uint32_t value) { return (value + 3) / 4 * 4; }
+
+// Invokes the callback with the number of components, from 1 to 4, as a
+// compile-time constant so that the loops over the components of each vertex
+// are unrolled.
+template <typename Callback>
+void withComponentCount(int64_t componentCount, Callback&& callback) {
+  switch (componentCount) {
+  case 1:
+    callback(std::integral_constant<int64_t, 1>());
+    break;
+  case 2:
+    callback(std::integral_constant<int64_t, 2>());
+    break;
+  case 3:
+    callback(std::integral_constant<int64_t, 3>());
+    break;
+  case 4:
+    callback(std::integral_constant<int64_t, 4>());
+    break;
+  }
+}
+
+void copyFloats(
+    const SourceAttribute& source,
+    int64_t firstVertex,
+    int64_t vertexCount,
+    int64_t componentCount,
+    std::byte* pTarget,
+    int64_t stride) {
+  const std::byte* pSource = source.pData + firstVertex * source.stride;
+  withComponentCount(componentCount, [&](auto count) {
+    constexpr size_t size = size_t(decltype(count)::value) * sizeof(float);
+    for (int64_t i = 0; i < vertexCount; ++i) {
+      std::memcpy(pTarget + i * stride, pSource + i * source.stride, size);
+    }
+  });
+}
+
+template <typename TTarget, typename Convert>
+void fillDefaults(
+    const std::array<float, 4>& defaultValue,
+    int64_t vertexCount,
+    int64_t componentCount,
+    std::byte* pTarget,
+    int64_t stride,
+    Convert&& convert) {
+  std::array<TTarget, 4> value;
+  for (size_t c = 0; c < value.size(); ++c) {
+    value[c] = convert(defaultValue[c]);
+  }
+
+  const size_t size = size_t(componentCount) * sizeof(TTarget);
+  for (int64_t i = 0; i < vertexCount; ++i) {
+    std::memcpy(pTarget + i * stride, value.data(), size);
+  }
+}
+
+template <typename TSource, typename TTarget, typename Convert>
+void packComponents(
+    const SourceAttribute& source,
+    const std::array<float, 4>& defaultValue,
+    int64_t firstVertex,
+    int64_t vertexCount,
+    int64_t componentCount,
+    std::byte* pTarget,
+    int64_t stride,
+    Convert&& convert) {
+  float scale = 1.0f;
+  float minimum = std::numeric_limits<float>::lowest();
+  if constexpr (std::is_integral_v<TSource>) {
+    if (source.normalized) {
+      scale = 1.0f / float(std::numeric_limits<TSource>::max());
+      if constexpr (std::is_signed_v<TSource>) {
+        minimum = -1.0f;
+      }
+    }
+  }
+
+  const int64_t sourceComponentCount =
+      std::min(source.componentCount, componentCount);
+  const std::byte* pSource = source.pData + firstVertex * source.stride;
+
+  withComponentCount(sourceComponentCount, [&](auto count) {
+    for (int64_t i = 0; i < vertexCount; ++i) {
+      const std::byte* pSourceVertex = pSource + i * source.stride;
+      std::byte* pTargetVertex = pTarget + i * stride;
+      for (int64_t c = 0; c < decltype(count)::value; ++c) {
+        TSource component;
+        std::memcpy(
+            &component,
+            pSourceVertex + c * int64_t(sizeof(TSource)),
+            sizeof(TSource));
+
+        const TTarget target =
+            convert(std::max(float(component) * scale, minimum));
+        std::memcpy(
+            pTargetVertex + c * int64_t(sizeof(TTarget)),
+            &target,
+            sizeof(TTarget));
+      }
+    }
+  });
+
+  // Fill the components that the source does not have.
+  if (sourceComponentCount < componentCount) {
+    std::array<float, 4> remainingDefaults{};
+    std::copy(
+        defaultValue.begin() + sourceComponentCount,
+        defaultValue.end(),
+        remainingDefaults.begin());
+    fillDefaults<TTarget>(
+        remainingDefaults,
+        vertexCount,
+        componentCount - sourceComponentCount,
+        pTarget + sourceComponentCount * int64_t(sizeof(TTarget)),
+        stride,
+        convert);
+  }
+}
+
+template <typename TTarget, typename Convert>
+void packAttribute(
+    const VertexAttributeLayout& attribute,
+    const std::optional<SourceAttribute>& source,
+    int64_t firstVertex,
+    int64_t vertexCount,
+    std::byte* pTarget,
+    int64_t stride,
+    Convert&& convert) {
+  const int64_t componentCount = int64_t(attribute.componentCount);
+  if (!source) {
+    fillDefaults<TTarget>(
+        attribute.defaultValue,
+        vertexCount,
+        componentCount,
+        pTarget,
+        stride,
+        convert);
+    return;
+  }
+
+  switch (source->componentType) {
+  case Accessor::ComponentType::BYTE:
+    packComponents<int8_t, TTarget>(
+        *source,
+        attribute.defaultValue,
+        firstVertex,
+        vertexCount,
+        componentCount,
+        pTarget,
+        stride,
+        convert);
+    break;
+  case Accessor::ComponentType::UNSIGNED_BYTE:
+    packComponents<uint8_t, TTarget>(
+        *source,
+        attribute.defaultValue,
+        firstVertex,
+        vertexCount,
+        componentCount,
+        pTarget,
+        stride,
+        convert);
+    break;
+  case Accessor::ComponentType::SHORT:
+    packComponents<int16_t, TTarget>(
+        *source,
+        attribute.defaultValue,
+        firstVertex,
+        vertexCount,
+        componentCount,
+        pTarget,
+        stride,
+        convert);
+    break;
+  case Accessor::ComponentType::UNSIGNED_SHORT:
+    packComponents<uint16_t, TTarget>(
+        *source,
+        attribute.defaultValue,
+        firstVertex,
+        vertexCount,
+        componentCount,
+        pTarget,
+        stride,
+        convert);
+    break;
+  case Accessor::ComponentType::UNSIGNED_INT:
+    packComponents<uint32_t, TTarget>(
+        *source,
+        attribute.defaultValue,
+        firstVertex,
+        vertexCount,
+        componentCount,
+        pTarget,
+        stride,
+        convert);
+    break;
+  case Accessor::ComponentType::FLOAT:
+    packComponents<float, TTarget>(
+        *source,
+        attribute.defaultValue,
+        firstVertex,
+        vertexCount,
+        componentCount,
+        pTarget,
+        stride,
+        convert);
+    break;
+  }
+}
+
+float clamp(float value, float minimum, float maximum) {
+  return std::min(std::max(value, minimum), maximum);
+}
+
+// Rounds to the nearest integer after scaling, with halfway cases rounded away
+// from zero.
+int32_t quantize(float value, float scale) {
+  return int32_t(value * scale + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+void packBlock(
+    const VertexAttributeLayout& attribute,
+    const std::optional<SourceAttribute>& source,
+    int64_t firstVertex,
+    int64_t vertexCount,
+    std::byte* pTarget,
+    int64_t stride) {
+  switch (attribute.format) {
+  case VertexComponentFormat::Float32:
+    // Floats that are written unchanged need no conversion.
+    if (source && source->componentType == Accessor::ComponentType::FLOAT &&
+        source->componentCount >= int64_t(attribute.componentCount)) {
+      copyFloats(
+          *source,
+          firstVertex,
+          vertexCount,
+          int64_t(attribute.componentCount),
+          pTarget,
+          stride);
+      break;
+    }
+    packAttribute<float>(
+        attribute,
+        source,
+        firstVertex,
+        vertexCount,
+        pTarget,
+        stride,
+        [](float value) { return value; });
+    break;
+  case VertexComponentFormat::Float16:
+    packAttribute<uint16_t>(
+        attribute,
+        source,
+        firstVertex,
+        vertexCount,
+        pTarget,
+        stride,
+        [](float value) { return uint16_t(meshopt_quantizeHalf(value)); });
+    break;
+  case VertexComponentFormat::Snorm16:
+    packAttribute<int16_t>(
+        attribute,
+        source,
+        firstVertex,
+        vertexCount,
+        pTarget,
+        stride,
+        [](float value) {
+          return int16_t(quantize(clamp(value, -1.0f, 1.0f), 32767.0f));
+        });
+    break;
+  case VertexComponentFormat::Snorm8:
+    packAttribute<int8_t>(
+        attribute,
+        source,
+        firstVertex,
+        vertexCount,
+        pTarget,
+        stride,
+        [](float value) {
+          return int8_t(quantize(clamp(value, -1.0f, 1.0f), 127.0f));
+        });
+    break;
+  case VertexComponentFormat::Unorm16:
+    packAttribute<uint16_t>(
+        attribute,
+        source,
+        firstVertex,
+        vertexCount,
+        pTarget,
+        stride,
+        [](float value) {
+          return uint16_t(quantize(clamp(value, 0.0f, 1.0f), 65535.0f));
+        });
+    break;
+  case VertexComponentFormat::Unorm8:
+    packAttribute<uint8_t>(
+        attribute,
+        source,
+        firstVertex,
+        vertexCount,
+        pTarget,
+        stride,
+        [](float value) {
+          return uint8_t(quantize(clamp(value, 0.0f, 1.0f), 255.0f));
+        });
+    break;
+  }
+}
+} // namespace
+
+VertexAttributeLayout& VertexLayout::addAttribute(
+    const std::string& semantic,
+    VertexComponentFormat format,
+    uint8_t componentCount) {
+  VertexAttributeLayout& attribute = this->attributes.emplace_back();
+  attribute.semantic = semantic;
+  attribute.format = format;
+  attribute.componentCount = componentCount;
+  attribute.offset = alignToFourBytes(this->stride);
+
+  this->stride = alignToFourBytes(
+      attribute.offset +
+      uint32_t(componentCount) * VertexPacker::getComponentSize(format));
+
+  return attribute;
+}
+
+/*static*/ uint32_t
+VertexPacker::getComponentSize(VertexComponentFormat format) noexcept {
+  switch (format) {
+  case VertexComponentFormat::Float32:
+    return 4;
+  case VertexComponentFormat::Float16:
+  case VertexComponentFormat::Snorm16:
+  case VertexComponentFormat::Unorm16:
+    return 2;
+  case VertexComponentFormat::Snorm8:
+  case VertexComponentFormat::Unorm8:
+    return 1;
+  }
+  return 0;
+}
+
+/*static*/ int64_t VertexPacker::getVertexCount(
+    const Model& model,
+    const MeshPrimitive& primitive) noexcept {
+  auto it = primitive.attributes.find("POSITION");
+  if (it == primitive.attributes.end()) {
+    it = primitive.attributes.begin();
+  }
+  if (it == primitive.attributes.end()) {
+    return 0;
+  }
+
+  const Accessor* pAccessor = Model::getSafe(&model.accessors, it->second);
+  return pAccessor ? std::max(pAccessor->count, int64_t(0)) : 0;
+}
+
+/*static*/ ErrorList VertexPacker::pack(
+    const Model& model,
+    const MeshPrimitive& primitive,
+    const VertexLayout& layout,
+    const gsl::span<std::byte>& destination) {
+  CESIUM_TRACE("VertexPacker::pack");
+
+  ErrorList errors;
+
+  const int64_t vertexCount = getVertexCount(model, primitive);
+  const int64_t stride = int64_t(layout.stride);
+  if (int64_t(destination.size()) < vertexCount * stride) {
+    errors.emplaceError("The destination is too small for the vertices.");
+    return errors;
+  }
+
+  // Validate every attribute before writing anything.
+  std::vector<std::optional<SourceAttribute>> sources;
+  sources.reserve(layout.attributes.size());
+  for (const VertexAttributeLayout& attribute : layout.attributes) {
+    std::optional<SourceAttribute>& source = sources.emplace_back();
+
+    if (attribute.componentCount < 1 || attribute.componentCount > 4) {
+      errors.emplaceError(
+          "Vertex attribute " + attribute.semantic +
+          " must have from 1 to 4 components.");
+      continue;
+    }
+
+    const uint32_t end =
+        attribute.offset + uint32_t(attribute.componentCount) *
+                               getComponentSize(attribute.format);
+    if (end > layout.stride) {
+      errors.emplaceError(
+          "Vertex attribute " + attribute.semantic +
+          " does not fit in the vertex stride.");
+      continue;
+    }
+
+    auto it = primitive.attributes.find(attribute.semantic);
+    if (it == primitive.attributes.end()) {
+      // Written entirely from the default value.
+      continue;
+    }
+
+    const Accessor* pAccessor = Model::getSafe(&model.accessors, it->second);
+    if (!pAccessor) {
+      errors.emplaceError(
+          "Vertex attribute " + attribute.semantic +
+          " refers to an invalid accessor.");
+      continue;
+    }
+
+    source = createAccessorView(model, *pAccessor, [](const auto& view) {
+      return SourceAttribute{
+          view.status(),
+          view.data(),
+          view.stride(),
+          view.size(),
+          0,
+          0,
+          false};
+    });
+    source->componentType = pAccessor->componentType;
+    source->componentCount = pAccessor->computeNumberOfComponents();
+    source->normalized = pAccessor->normalized;
+
+    if (source->status != AccessorViewStatus::Valid) {
+      errors.emplaceError(
+          "Vertex attribute " + attribute.semantic + " could not be read.");
+    } else if (source->componentCount > 4) {
+      errors.emplaceError(
+          "Vertex attribute " + attribute.semantic +
+          " is not a scalar or a vector.");
+    } else if (source->size != vertexCount) {
+      errors.emplaceError(
+          "Vertex attribute " + attribute.semantic + " has " +
+          std::to_string(source->size) + " vertices, but the primitive has " +
+          std::to_string(vertexCount) + ".");
+    }
+  }
+
+  if (errors.hasErrors()) {
+    return errors;
+  }
+
+  for (int64_t first = 0; first < vertexCount; first += BlockSize) {
+    const int64_t count = std::min(BlockSize, vertexCount - first);
+    std::byte* pBlock = destination.data() + first * stride;
+    for (size_t i = 0; i < layout.attributes.size(); ++i) {
+      const VertexAttributeLayout& attribute = layout.attributes[i];
+      packBlock(
+          attribute,
+          sources[i],
+          first,
+          count,
+          pBlock + attribute.offset,
+          stride);
+    }
+  }
+
+  return errors;
+}
+
+/*static*/ PackedVertices VertexPacker::pack(
+    const Model& model,
+    const MeshPrimitive& primitive,
+    const VertexLayout& layout) {
+  PackedVertices result;
+  result.vertexCount = getVertexCount(model, primitive);
+  result.data.resize(size_t(result.vertexCount) * size_t(layout.stride));
+
+  result.errors =
+      pack(model, primitive, layout, gsl::span<std::byte>(result.data));
+  if (result.errors.hasErrors()) {
+    result.data.clear();
+  }
+
+  return result;
+}
+
+} // namespace CesiumGltfContent
@@ -0,0 +1,41 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
+#include "ReferenceCompactBuffer.h"
+
+#include <CesiumGltf/Model.h>
+#include <CesiumGltfContent/GltfUtilities.h>
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace CesiumGltf;
+using namespace CesiumGltfContent;
+
+// These are hidden by default. Run them with:
+//   cesium-native-tests "[benchmark]"
+TEST_CASE("Compact a buffer with many bufferViews", "[.][benchmark]") {
+  // About 10,000 bufferViews in a buffer of about 4 MB, with half of the
+  // bytes unused.
+  std::mt19937 random(42);
+  const Model model = createRandomBufferViews(random, 10000, 400);
+
+  BENCHMARK_ADVANCED("GltfUtilities::compactBuffers")
+  (Catch::Benchmark::Chronometer meter) {
+    std::vector<Model> models(size_t(meter.runs()), model);
+    meter.measure([&models](int i) {
+      GltfUtilities::compactBuffers(models[size_t(i)]);
+    });
+  };
+
+  // The previous implementation takes hundreds of milliseconds for a single
+  // run, so run this with a small number of samples, such as with
+  // --benchmark-samples 3.
+  BENCHMARK_ADVANCED("previous implementation of compactBuffers")
+  (Catch::Benchmark::Chronometer meter) {
+    std::vector<Model> models(size_t(meter.runs()), model);
+    meter.measure(
+        [&models](int i) { referenceCompactBuffer(models[size_t(i)], 0); });
+  };
+}
@@ -0,0 +1,134 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
+#include <CesiumGltf/AccessorView.h>
+#include <CesiumGltf/Model.h>
+#include <CesiumGltfContent/VertexPacker.h>
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace CesiumGltf;
+using namespace CesiumGltfContent;
+
+namespace {
+constexpr int64_t VertexCount = 1 << 20;
+
+template <typename T>
+void addAttribute(
+    Model& model,
+    MeshPrimitive& primitive,
+    const std::string& semantic,
+    const std::vector<T>& values,
+    const std::string& type) {
+  Buffer& buffer = model.buffers.emplace_back();
+  buffer.cesium.data.resize(values.size() * sizeof(T));
+  std::memcpy(
+      buffer.cesium.data.data(),
+      values.data(),
+      values.size() * sizeof(T));
+  buffer.byteLength = int64_t(buffer.cesium.data.size());
+
+  BufferView& bufferView = model.bufferViews.emplace_back();
+  bufferView.buffer = int32_t(model.buffers.size() - 1);
+  bufferView.byteLength = buffer.byteLength;
+
+  Accessor& accessor = model.accessors.emplace_back();
+  accessor.bufferView = int32_t(model.bufferViews.size() - 1);
+  accessor.componentType = Accessor::ComponentType::FLOAT;
+  accessor.type = type;
+  accessor.count = int64_t(values.size());
+
+  primitive.attributes[semantic] = int32_t(model.accessors.size() - 1);
+}
+
+template <typename T>
+void copyAttribute(
+    const Model& model,
+    const MeshPrimitive& primitive,
+    const std::string& semantic,
+    std::vector<std::byte>& vertices,
+    size_t stride,
+    size_t offset) {
+  AccessorView<T> view(model, primitive.attributes.at(semantic));
+  for (int64_t i = 0; i < view.size(); ++i) {
+    std::memcpy(
+        vertices.data() + size_t(i) * stride + offset,
+        &view[i],
+        sizeof(T));
+  }
+}
+} // namespace
+
+// These are hidden by default. Run them with:
+//   cesium-native-tests "[benchmark]"
+TEST_CASE("VertexPacker throughput", "[.][benchmark]") {
+  std::vector<AccessorTypes::VEC3<float>> positions;
+  std::vector<AccessorTypes::VEC3<float>> normals;
+  std::vector<AccessorTypes::VEC2<float>> texCoords;
+  positions.reserve(size_t(VertexCount));
+  normals.reserve(size_t(VertexCount));
+  texCoords.reserve(size_t(VertexCount));
+  for (int64_t i = 0; i < VertexCount; ++i) {
+    const float x = float(i);
+    positions.push_back({{x, x * 2.0f, x * 3.0f}});
+    normals.push_back({{0.0f, i % 2 == 0 ? 1.0f : -1.0f, 0.0f}});
+    texCoords.push_back({{float(i % 4) * 0.25f, 0.5f}});
+  }
+
+  Model model;
+  MeshPrimitive& primitive =
+      model.meshes.emplace_back().primitives.emplace_back();
+  addAttribute(model, primitive, "POSITION", positions, Accessor::Type::VEC3);
+  addAttribute(model, primitive, "NORMAL", normals, Accessor::Type::VEC3);
+  addAttribute(model, primitive, "TEXCOORD_0", texCoords, Accessor::Type::VEC2);
+
+  VertexLayout floatLayout;
+  floatLayout.addAttribute("POSITION", VertexComponentFormat::Float32, 3);
+  floatLayout.addAttribute("NORMAL", VertexComponentFormat::Float32, 3);
+  floatLayout.addAttribute("TEXCOORD_0", VertexComponentFormat::Float32, 2);
+
+  VertexLayout quantizedLayout;
+  quantizedLayout.addAttribute("POSITION", VertexComponentFormat::Float32, 3);
+  quantizedLayout.addAttribute("NORMAL", VertexComponentFormat::Snorm8, 3);
+  quantizedLayout.addAttribute(
+      "TEXCOORD_0",
+      VertexComponentFormat::Float16,
+      2);
+
+  BENCHMARK("per-attribute AccessorView copies") {
+    std::vector<std::byte> vertices(size_t(VertexCount) * floatLayout.stride);
+    copyAttribute<AccessorTypes::VEC3<float>>(
+        model,
+        primitive,
+        "POSITION",
+        vertices,
+        floatLayout.stride,
+        0);
+    copyAttribute<AccessorTypes::VEC3<float>>(
+        model,
+        primitive,
+        "NORMAL",
+        vertices,
+        floatLayout.stride,
+        12);
+    copyAttribute<AccessorTypes::VEC2<float>>(
+        model,
+        primitive,
+        "TEXCOORD_0",
+        vertices,
+        floatLayout.stride,
+        24);
+    return vertices;
+  };
+
+  BENCHMARK("pack float32 layout") {
+    return VertexPacker::pack(model, primitive, floatLayout);
+  };
+
+  BENCHMARK("pack quantized layout") {
+    return VertexPacker::pack(model, primitive, quantizedLayout);
+  };
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <CesiumGltf/Buffer.h>
+#include <CesiumGltf/BufferView.h>
+#include <CesiumGltf/Model.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace CesiumGltfContent {
+
+// The implementation of GltfUtilities::compactBuffer before it was made to
+// run in linear time, which erases every unused range of bytes separately.
+// It is kept to check that the current implementation gives the same results
+// and to measure how much faster it is. Like the original, it only supports
+// bufferViews that do not overlap more than one other range, and it ignores
+// EXT_meshopt_compression.
+inline void
+referenceCompactBuffer(CesiumGltf::Model& gltf, size_t bufferIndex) {
+  CesiumGltf::Buffer& buffer = gltf.buffers[bufferIndex];
+
+  struct BufferRange {
+    int64_t start;
+    int64_t end;
+
+    bool operator<(const BufferRange& rhs) const {
+      return this->start < rhs.start;
+    }
+  };
+
+  std::vector<BufferRange> usedRanges;
+
+  auto addUsedRange = [&usedRanges](int64_t start, int64_t end) {
+    auto it = std::lower_bound(
+        usedRanges.begin(),
+        usedRanges.end(),
+        BufferRange{start, end});
+    it = usedRanges.insert(it, BufferRange{start, end});
+
+    if (it != usedRanges.begin()) {
+      auto previousIt = it - 1;
+      if (previousIt->end >= it->start) {
+        previousIt->end = std::max(previousIt->end, it->end);
+        it = usedRanges.erase(it) - 1;
+      }
+    }
+
+    auto nextIt = it + 1;
+    if (nextIt != usedRanges.end()) {
+      if (it->end >= nextIt->start) {
+        it->end = std::max(it->end, nextIt->end);
+        it = usedRanges.erase(nextIt) - 1;
+      }
+    }
+  };
+
+  for (const CesiumGltf::BufferView& bufferView : gltf.bufferViews) {
+    if (bufferView.buffer == int32_t(bufferIndex)) {
+      addUsedRange(
+          bufferView.byteOffset,
+          bufferView.byteOffset + bufferView.byteLength);
+    }
+  }
+
+  auto deleteBufferRange = [&gltf, &buffer, bufferIndex](
+                               int64_t start,
+                               int64_t end) {
+    int64_t bytesToRemove = end - start;
+    if (end < buffer.byteLength) {
+      bytesToRemove = bytesToRemove & ~0b111;
+      if (bytesToRemove == 0)
+        return;
+
+      end = start + bytesToRemove;
+    }
+
+    for (CesiumGltf::BufferView& bufferView : gltf.bufferViews) {
+      if (bufferView.buffer == int32_t(bufferIndex) &&
+          bufferView.byteOffset >= start) {
+        bufferView.byteOffset -= bytesToRemove;
+      }
+    }
+
+    buffer.byteLength -= bytesToRemove;
+    buffer.cesium.data.erase(
+        buffer.cesium.data.begin() + start,
+        buffer.cesium.data.begin() + end);
+  };
+
+  BufferRange nextRange{buffer.byteLength, buffer.byteLength};
+  for (int64_t i = int64_t(usedRanges.size()) - 1; i >= 0; --i) {
+    BufferRange& usedRange = usedRanges[size_t(i)];
+    if (usedRange.end < nextRange.start) {
+      deleteBufferRange(usedRange.end, nextRange.start);
+    }
+    nextRange = usedRange;
+  }
+
+  if (nextRange.start > 0) {
+    deleteBufferRange(0, nextRange.start);
+  }
+}
+
+// Creates a glTF with a single buffer of random bytes, and with bufferViews
+// of random lengths separated by gaps of random lengths. Some bufferViews
+// refer to the same bytes as the previous one, and the bufferViews are
+// shuffled.
+inline CesiumGltf::Model createRandomBufferViews(
+    std::mt19937& random,
+    size_t bufferViewCount,
+    int64_t maximumLength) {
+  std::uniform_int_distribution<int64_t> lengthDistribution(1, maximumLength);
+  std::uniform_int_distribution<int64_t> gapDistribution(0, maximumLength);
+  std::uniform_int_distribution<int32_t> byteDistribution(0, 255);
+  std::bernoulli_distribution repeatDistribution(0.1);
+
+  CesiumGltf::Model model;
+  int64_t byteOffset = gapDistribution(random);
+  for (size_t i = 0; i < bufferViewCount; ++i) {
+    CesiumGltf::BufferView& bufferView = model.bufferViews.emplace_back();
+    bufferView.buffer = 0;
+    if (i > 0 && repeatDistribution(random)) {
+      const CesiumGltf::BufferView& previous = model.bufferViews[i - 1];
+      bufferView.byteOffset = previous.byteOffset;
+      bufferView.byteLength = previous.byteLength;
+      continue;
+    }
+
+    bufferView.byteOffset = byteOffset;
+    bufferView.byteLength = lengthDistribution(random);
+    byteOffset += bufferView.byteLength + gapDistribution(random);
+  }
+
+  std::shuffle(model.bufferViews.begin(), model.bufferViews.end(), random);
+
+  CesiumGltf::Buffer& buffer = model.buffers.emplace_back();
+  buffer.byteLength = byteOffset;
+  buffer.cesium.data.resize(size_t(byteOffset));
+  for (std::byte& b : buffer.cesium.data) {
+    b = std::byte(byteDistribution(random));
+  }
+
+  return model;
+}
+
+} // namespace CesiumGltfContent
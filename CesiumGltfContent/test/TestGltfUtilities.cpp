@@ -1,3 +1,6 @@
+#include "ReferenceCompactBuffer.h"
+
+#include <CesiumGltf/AccessorView.h>
 #include <CesiumGltf/ExtensionBufferExtMeshoptCompression.h>
 #include <CesiumGltf/ExtensionBufferViewExtMeshoptCompression.h>
 #include <CesiumGltf/Model.h>
@@ -8,6 +11,13 @@
 #include <catch2/catch.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <tuple>
+#include <vector>
+
 using namespace CesiumGltf;
 using namespace CesiumGltfContent;
 using namespace CesiumUtility;
@@ -573,6 +583,181 @@ TEST_CASE("GltfUtilities::compactBuffers") {
       CHECK(buffer.cesium.data[i] == std::byte(i));
     }
   }
+
+  SECTION("removes several gaps and moves bufferViews of multiple buffers") {
+    Buffer& buffer2 = m.buffers.emplace_back();
+    buffer2.byteLength = 64;
+    buffer2.cesium.data.resize(64);
+    for (size_t i = 0; i < buffer2.cesium.data.size(); ++i) {
+      buffer2.cesium.data[i] = std::byte(100 + i);
+    }
+
+    // Overlapping bufferViews in the first buffer, listed out of order.
+    BufferView& bv1 = m.bufferViews.emplace_back();
+    bv1.buffer = 0;
+    bv1.byteOffset = 60;
+    bv1.byteLength = 10;
+
+    BufferView& bv2 = m.bufferViews.emplace_back();
+    bv2.buffer = 0;
+    bv2.byteOffset = 20;
+    bv2.byteLength = 20;
+
+    BufferView& bv3 = m.bufferViews.emplace_back();
+    bv3.buffer = 0;
+    bv3.byteOffset = 30;
+    bv3.byteLength = 15;
+
+    BufferView& bv4 = m.bufferViews.emplace_back();
+    bv4.buffer = 1;
+    bv4.byteOffset = 16;
+    bv4.byteLength = 16;
+
+    GltfUtilities::compactBuffers(m);
+
+    // First buffer: [0, 20) loses 16 bytes, [45, 60) loses 8 bytes, and
+    // everything after 70 is removed.
+    REQUIRE(m.buffers.size() == 2);
+    CHECK(m.buffers[0].byteLength == 70 - 16 - 8);
+    REQUIRE(m.buffers[0].cesium.data.size() == 70 - 16 - 8);
+    CHECK(m.bufferViews[0].byteOffset == 60 - 16 - 8);
+    CHECK(m.bufferViews[1].byteOffset == 20 - 16);
+    CHECK(m.bufferViews[2].byteOffset == 30 - 16);
+
+    for (int64_t i = 0; i < m.bufferViews[1].byteLength; ++i) {
+      CHECK(
+          m.buffers[0].cesium.data[size_t(m.bufferViews[1].byteOffset + i)] ==
+          std::byte(20 + i));
+    }
+    for (int64_t i = 0; i < m.bufferViews[0].byteLength; ++i) {
+      CHECK(
+          m.buffers[0].cesium.data[size_t(m.bufferViews[0].byteOffset + i)] ==
+          std::byte(60 + i));
+    }
+
+    // Second buffer: [0, 16) is removed, as is everything after 32.
+    CHECK(m.buffers[1].byteLength == 16);
+    REQUIRE(m.buffers[1].cesium.data.size() == 16);
+    CHECK(m.bufferViews[3].byteOffset == 0);
+    for (size_t i = 0; i < m.buffers[1].cesium.data.size(); ++i) {
+      CHECK(m.buffers[1].cesium.data[i] == std::byte(116 + i));
+    }
+  }
+
+  SECTION("removes all bytes of a buffer without bufferViews") {
+    GltfUtilities::compactBuffer(m, 0);
+
+    CHECK(buffer.byteLength == 0);
+    CHECK(buffer.cesium.data.empty());
+  }
+}
+
+TEST_CASE("GltfUtilities::compactBuffers gives the same results as the "
+          "previous implementation") {
+  std::mt19937 random(42);
+  for (size_t i = 0; i < 200; ++i) {
+    std::uniform_int_distribution<size_t> countDistribution(0, 64);
+    Model expected =
+        createRandomBufferViews(random, countDistribution(random), 40);
+    Model actual = expected;
+
+    referenceCompactBuffer(expected, 0);
+    GltfUtilities::compactBuffers(actual);
+
+    REQUIRE(actual.buffers[0].byteLength == expected.buffers[0].byteLength);
+    REQUIRE(actual.buffers[0].cesium.data == expected.buffers[0].cesium.data);
+    REQUIRE(actual.bufferViews.size() == expected.bufferViews.size());
+    for (size_t j = 0; j < actual.bufferViews.size(); ++j) {
+      CHECK(
+          actual.bufferViews[j].byteOffset ==
+          expected.bufferViews[j].byteOffset);
+      CHECK(
+          actual.bufferViews[j].byteLength ==
+          expected.bufferViews[j].byteLength);
+    }
+  }
+}
+
+TEST_CASE("GltfUtilities::removeUnusedBufferData") {
+  Model m;
+
+  for (size_t i = 0; i < 3; ++i) {
+    Buffer& buffer = m.buffers.emplace_back();
+    buffer.byteLength = 256;
+    buffer.cesium.data.resize(256);
+    for (size_t j = 0; j < buffer.cesium.data.size(); ++j) {
+      buffer.cesium.data[j] = std::byte((i * 7 + j) % 256);
+    }
+  }
+
+  auto addBufferView = [&m](int32_t buffer, int64_t offset, int64_t length) {
+    BufferView& bufferView = m.bufferViews.emplace_back();
+    bufferView.buffer = buffer;
+    bufferView.byteOffset = offset;
+    bufferView.byteLength = length;
+  };
+
+  addBufferView(0, 0, 40);   // used only by an unused accessor
+  addBufferView(0, 48, 30);  // used by POSITION and by sparse values
+  addBufferView(1, 0, 64);   // used only by an unused accessor
+  addBufferView(0, 100, 20); // used by sparse indices
+  addBufferView(2, 8, 32);   // used by an image
+  addBufferView(0, 200, 56); // not used at all
+
+  m.accessors.emplace_back().bufferView = 1;
+  m.accessors.emplace_back().bufferView = 0;
+  m.accessors.emplace_back().bufferView = 2;
+  Accessor& sparseAccessor = m.accessors.emplace_back();
+  sparseAccessor.sparse.emplace();
+  sparseAccessor.sparse->indices.bufferView = 3;
+  sparseAccessor.sparse->values.bufferView = 1;
+
+  MeshPrimitive& primitive =
+      m.meshes.emplace_back().primitives.emplace_back();
+  primitive.attributes["POSITION"] = 0;
+  primitive.indices = 3;
+
+  m.images.emplace_back().bufferView = 4;
+
+  Model expected = m;
+  GltfUtilities::removeUnusedAccessors(expected);
+  GltfUtilities::removeUnusedBufferViews(expected);
+  GltfUtilities::removeUnusedBuffers(expected);
+  GltfUtilities::compactBuffers(expected);
+
+  GltfUtilities::removeUnusedBufferData(m);
+
+  REQUIRE(m.accessors.size() == 2);
+  REQUIRE(m.bufferViews.size() == 3);
+  REQUIRE(m.buffers.size() == 2);
+
+  const MeshPrimitive& resultPrimitive = m.meshes[0].primitives[0];
+  CHECK(resultPrimitive.attributes.at("POSITION") == 0);
+  CHECK(resultPrimitive.indices == 1);
+  CHECK(m.accessors[0].bufferView == 0);
+  CHECK(m.accessors[1].bufferView == -1);
+  REQUIRE(m.accessors[1].sparse);
+  CHECK(m.accessors[1].sparse->indices.bufferView == 1);
+  CHECK(m.accessors[1].sparse->values.bufferView == 0);
+  CHECK(m.images[0].bufferView == 2);
+  CHECK(m.bufferViews[2].buffer == 1);
+
+  // The result is the same as removing each kind of element separately.
+  REQUIRE(expected.accessors.size() == m.accessors.size());
+  for (size_t i = 0; i < m.accessors.size(); ++i) {
+    CHECK(m.accessors[i].bufferView == expected.accessors[i].bufferView);
+  }
+  REQUIRE(expected.bufferViews.size() == m.bufferViews.size());
+  for (size_t i = 0; i < m.bufferViews.size(); ++i) {
+    CHECK(m.bufferViews[i].buffer == expected.bufferViews[i].buffer);
+    CHECK(m.bufferViews[i].byteOffset == expected.bufferViews[i].byteOffset);
+    CHECK(m.bufferViews[i].byteLength == expected.bufferViews[i].byteLength);
+  }
+  REQUIRE(expected.buffers.size() == m.buffers.size());
+  for (size_t i = 0; i < m.buffers.size(); ++i) {
+    CHECK(m.buffers[i].byteLength == expected.buffers[i].byteLength);
+    CHECK(m.buffers[i].cesium.data == expected.buffers[i].cesium.data);
+  }
 }
 
 TEST_CASE("GltfUtilities::collapseToSingleBuffer") {
@@ -704,3 +889,204 @@ TEST_CASE("GltfUtilities::collapseToSingleBuffer") {
     CHECK(m.bufferViews[2].byteLength == 100);
   }
 }
+
+namespace {
+// Gets the triangles of a primitive as position triples, each starting with
+// its smallest vertex so that triangles can be compared regardless of which
+// vertex comes first.
+std::vector<std::array<glm::vec3, 3>>
+getSortedTriangles(const Model& model, const MeshPrimitive& primitive) {
+  AccessorView<glm::vec3> positions(
+      model,
+      primitive.attributes.at("POSITION"));
+  const Accessor& indexAccessor =
+      Model::getSafe(model.accessors, primitive.indices);
+
+  std::vector<uint32_t> indices;
+  if (indexAccessor.componentType == Accessor::ComponentType::UNSIGNED_SHORT) {
+    AccessorView<uint16_t> view(model, indexAccessor);
+    for (int64_t i = 0; i < view.size(); ++i) {
+      indices.emplace_back(view[i]);
+    }
+  } else {
+    AccessorView<uint32_t> view(model, indexAccessor);
+    for (int64_t i = 0; i < view.size(); ++i) {
+      indices.emplace_back(view[i]);
+    }
+  }
+
+  auto less = [](const glm::vec3& a, const glm::vec3& b) {
+    return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+  };
+
+  std::vector<std::array<glm::vec3, 3>> triangles;
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    std::array<glm::vec3, 3> triangle{
+        positions[int64_t(indices[i])],
+        positions[int64_t(indices[i + 1])],
+        positions[int64_t(indices[i + 2])]};
+    std::rotate(
+        triangle.begin(),
+        std::min_element(triangle.begin(), triangle.end(), less),
+        triangle.end());
+    triangles.emplace_back(triangle);
+  }
+
+  std::sort(
+      triangles.begin(),
+      triangles.end(),
+      [&less](const auto& a, const auto& b) {
+        return std::lexicographical_compare(
+            a.begin(),
+            a.end(),
+            b.begin(),
+            b.end(),
+            less);
+      });
+  return triangles;
+}
+
+Model createFlatGrid(uint32_t size) {
+  Model model;
+
+  std::vector<glm::vec3> positions;
+  std::vector<uint32_t> indices;
+  for (uint32_t y = 0; y < size; ++y) {
+    for (uint32_t x = 0; x < size; ++x) {
+      positions.emplace_back(float(x), float(y), 0.0f);
+      if (x + 1 < size && y + 1 < size) {
+        indices.insert(
+            indices.end(),
+            {y * size + x,
+             y * size + x + 1,
+             (y + 1) * size + x,
+             y * size + x + 1,
+             (y + 1) * size + x + 1,
+             (y + 1) * size + x});
+      }
+    }
+  }
+
+  Buffer& buffer = model.buffers.emplace_back();
+  buffer.cesium.data.resize(
+      positions.size() * sizeof(glm::vec3) + indices.size() * sizeof(uint32_t));
+  buffer.byteLength = int64_t(buffer.cesium.data.size());
+  std::memcpy(
+      buffer.cesium.data.data(),
+      positions.data(),
+      positions.size() * sizeof(glm::vec3));
+  std::memcpy(
+      buffer.cesium.data.data() + positions.size() * sizeof(glm::vec3),
+      indices.data(),
+      indices.size() * sizeof(uint32_t));
+
+  BufferView& positionBufferView = model.bufferViews.emplace_back();
+  positionBufferView.buffer = 0;
+  positionBufferView.byteLength =
+      int64_t(positions.size() * sizeof(glm::vec3));
+
+  BufferView& indexBufferView = model.bufferViews.emplace_back();
+  indexBufferView.buffer = 0;
+  indexBufferView.byteOffset = positionBufferView.byteLength;
+  indexBufferView.byteLength = int64_t(indices.size() * sizeof(uint32_t));
+
+  Accessor& positionAccessor = model.accessors.emplace_back();
+  positionAccessor.bufferView = 0;
+  positionAccessor.componentType = Accessor::ComponentType::FLOAT;
+  positionAccessor.type = Accessor::Type::VEC3;
+  positionAccessor.count = int64_t(positions.size());
+
+  Accessor& indexAccessor = model.accessors.emplace_back();
+  indexAccessor.bufferView = 1;
+  indexAccessor.componentType = Accessor::ComponentType::UNSIGNED_INT;
+  indexAccessor.type = Accessor::Type::SCALAR;
+  indexAccessor.count = int64_t(indices.size());
+
+  MeshPrimitive& primitive =
+      model.meshes.emplace_back().primitives.emplace_back();
+  primitive.attributes["POSITION"] = 0;
+  primitive.indices = 1;
+
+  return model;
+}
+} // namespace
+
+TEST_CASE("GltfUtilities::simplifyMeshes") {
+  Model model = createFlatGrid(16);
+  const int64_t originalIndexCount = model.accessors[1].count;
+  const int64_t originalVertexCount = model.accessors[0].count;
+
+  double error = GltfUtilities::simplifyMeshes(model, 0.1f, 0.01f);
+
+  // A flat grid can be simplified without any error.
+  CHECK(error == Approx(0.0).margin(1e-6));
+
+  REQUIRE(model.meshes.size() == 1);
+  const MeshPrimitive& primitive = model.meshes[0].primitives[0];
+
+  const Accessor* pIndices =
+      Model::getSafe(&model.accessors, primitive.indices);
+  REQUIRE(pIndices);
+  CHECK(pIndices->count < originalIndexCount);
+  CHECK(pIndices->count % 3 == 0);
+  CHECK(pIndices->componentType == Accessor::ComponentType::UNSIGNED_SHORT);
+
+  const Accessor* pPositions =
+      Model::getSafe(&model.accessors, primitive.attributes.at("POSITION"));
+  REQUIRE(pPositions);
+  CHECK(pPositions->count < originalVertexCount);
+
+  // Only the new accessors remain, and every index refers to a kept vertex.
+  CHECK(model.accessors.size() == 2);
+  CHECK(model.buffers.size() == 1);
+  AccessorView<uint16_t> indices(model, *pIndices);
+  REQUIRE(indices.status() == AccessorViewStatus::Valid);
+  for (int64_t i = 0; i < indices.size(); ++i) {
+    CHECK(int64_t(indices[i]) < pPositions->count);
+  }
+
+  SECTION("leaves primitives it cannot simplify unchanged") {
+    Model points = createFlatGrid(4);
+    points.meshes[0].primitives[0].mode = MeshPrimitive::Mode::POINTS;
+    CHECK(GltfUtilities::simplifyMeshes(points, 0.1f, 0.01f) == 0.0);
+    CHECK(points.accessors.size() == 2);
+    CHECK(points.meshes[0].primitives[0].indices == 1);
+  }
+}
+
+TEST_CASE("GltfUtilities::optimizeMeshes") {
+  Model model = createFlatGrid(16);
+  const std::vector<std::array<glm::vec3, 3>> originalTriangles =
+      getSortedTriangles(model, model.meshes[0].primitives[0]);
+
+  GltfUtilities::optimizeMeshes(model);
+
+  REQUIRE(model.meshes.size() == 1);
+  const MeshPrimitive& primitive = model.meshes[0].primitives[0];
+
+  // The same triangles are drawn, with the same winding.
+  CHECK(getSortedTriangles(model, primitive) == originalTriangles);
+
+  const Accessor* pPositions =
+      Model::getSafe(&model.accessors, primitive.attributes.at("POSITION"));
+  REQUIRE(pPositions);
+  CHECK(pPositions->count == 16 * 16);
+
+  // The replaced accessors and their data are removed.
+  CHECK(model.accessors.size() == 2);
+  CHECK(model.buffers.size() == 1);
+
+  // Vertices are stored in the order in which the triangles first use them.
+  const Accessor* pIndices =
+      Model::getSafe(&model.accessors, primitive.indices);
+  REQUIRE(pIndices);
+  AccessorView<uint16_t> indices(model, *pIndices);
+  REQUIRE(indices.status() == AccessorViewStatus::Valid);
+  uint16_t nextNewVertex = 0;
+  for (int64_t i = 0; i < indices.size(); ++i) {
+    CHECK(indices[i] <= nextNewVertex);
+    if (indices[i] == nextNewVertex) {
+      ++nextNewVertex;
+    }
+  }
+}
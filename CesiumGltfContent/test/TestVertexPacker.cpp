@@ -0,0 +1,296 @@
+#include <CesiumGltf/AccessorView.h>
+#include <CesiumGltf/Model.h>
+#include <CesiumGltfContent/VertexPacker.h>
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace CesiumGltf;
+using namespace CesiumGltfContent;
+
+namespace {
+// More than one block of vertices, and not a multiple of the block size.
+constexpr int64_t VertexCount = 1000;
+
+template <typename T>
+void addAttribute(
+    Model& model,
+    MeshPrimitive& primitive,
+    const std::string& semantic,
+    const std::vector<T>& values,
+    const std::string& type,
+    int32_t componentType,
+    int64_t byteStride = 0) {
+  Buffer& buffer = model.buffers.emplace_back();
+  const int64_t elementSize = int64_t(sizeof(T));
+  const int64_t stride = byteStride > 0 ? byteStride : elementSize;
+  buffer.cesium.data.resize(size_t(stride * int64_t(values.size())));
+  for (size_t i = 0; i < values.size(); ++i) {
+    std::memcpy(
+        buffer.cesium.data.data() + int64_t(i) * stride,
+        &values[i],
+        sizeof(T));
+  }
+  buffer.byteLength = int64_t(buffer.cesium.data.size());
+
+  BufferView& bufferView = model.bufferViews.emplace_back();
+  bufferView.buffer = int32_t(model.buffers.size() - 1);
+  bufferView.byteLength = buffer.byteLength;
+  if (byteStride > 0) {
+    bufferView.byteStride = byteStride;
+  }
+
+  Accessor& accessor = model.accessors.emplace_back();
+  accessor.bufferView = int32_t(model.bufferViews.size() - 1);
+  accessor.componentType = componentType;
+  accessor.type = type;
+  accessor.count = int64_t(values.size());
+
+  primitive.attributes[semantic] = int32_t(model.accessors.size() - 1);
+}
+
+Model createModel() {
+  std::vector<AccessorTypes::VEC3<float>> positions;
+  std::vector<AccessorTypes::VEC3<float>> normals;
+  std::vector<AccessorTypes::VEC2<float>> texCoords;
+  std::vector<AccessorTypes::VEC4<uint8_t>> colors;
+  for (int64_t i = 0; i < VertexCount; ++i) {
+    const float x = float(i);
+    positions.push_back({{x, x * 2.0f, x * 3.0f}});
+
+    const float sign = i % 2 == 0 ? 1.0f : -1.0f;
+    normals.push_back({{0.0f, sign, 0.0f}});
+
+    texCoords.push_back({{float(i % 4) * 0.25f, 0.5f}});
+
+    const uint8_t value = uint8_t(i % 256);
+    colors.push_back({{value, uint8_t(255 - value), 0, 255}});
+  }
+
+  Model model;
+  MeshPrimitive& primitive =
+      model.meshes.emplace_back().primitives.emplace_back();
+  addAttribute(
+      model,
+      primitive,
+      "POSITION",
+      positions,
+      Accessor::Type::VEC3,
+      Accessor::ComponentType::FLOAT);
+  addAttribute(
+      model,
+      primitive,
+      "NORMAL",
+      normals,
+      Accessor::Type::VEC3,
+      Accessor::ComponentType::FLOAT);
+  // Texture coordinates are read from a strided buffer view.
+  addAttribute(
+      model,
+      primitive,
+      "TEXCOORD_0",
+      texCoords,
+      Accessor::Type::VEC2,
+      Accessor::ComponentType::FLOAT,
+      12);
+  addAttribute(
+      model,
+      primitive,
+      "COLOR_0",
+      colors,
+      Accessor::Type::VEC4,
+      Accessor::ComponentType::UNSIGNED_BYTE);
+  model.accessors.back().normalized = true;
+
+  return model;
+}
+
+template <typename T>
+T readComponent(
+    const std::vector<std::byte>& data,
+    const VertexLayout& layout,
+    int64_t vertex,
+    size_t attribute,
+    int64_t component) {
+  T value;
+  std::memcpy(
+      &value,
+      data.data() + vertex * int64_t(layout.stride) +
+          layout.attributes[attribute].offset +
+          component * int64_t(sizeof(T)),
+      sizeof(T));
+  return value;
+}
+} // namespace
+
+TEST_CASE("VertexPacker::pack") {
+  Model model = createModel();
+  const MeshPrimitive& primitive = model.meshes[0].primitives[0];
+
+  SECTION("produces the same vertices as per-attribute copying") {
+    VertexLayout layout;
+    layout.addAttribute("POSITION", VertexComponentFormat::Float32, 3);
+    layout.addAttribute("NORMAL", VertexComponentFormat::Float32, 3);
+    layout.addAttribute("TEXCOORD_0", VertexComponentFormat::Float32, 2);
+    CHECK(layout.stride == 32);
+
+    PackedVertices packed = VertexPacker::pack(model, primitive, layout);
+    CHECK(packed.errors.errors.empty());
+    CHECK(packed.errors.warnings.empty());
+    CHECK(packed.vertexCount == VertexCount);
+    REQUIRE(packed.data.size() == size_t(VertexCount) * layout.stride);
+
+    // This is what each renderer used to do: read every attribute through an
+    // AccessorView and copy it into its place in the interleaved vertices.
+    std::vector<std::byte> expected(packed.data.size());
+    AccessorView<AccessorTypes::VEC3<float>> positions(
+        model,
+        primitive.attributes.at("POSITION"));
+    for (int64_t i = 0; i < positions.size(); ++i) {
+      std::memcpy(
+          expected.data() + i * 32,
+          &positions[i],
+          sizeof(AccessorTypes::VEC3<float>));
+    }
+    AccessorView<AccessorTypes::VEC3<float>> normals(
+        model,
+        primitive.attributes.at("NORMAL"));
+    for (int64_t i = 0; i < normals.size(); ++i) {
+      std::memcpy(
+          expected.data() + i * 32 + 12,
+          &normals[i],
+          sizeof(AccessorTypes::VEC3<float>));
+    }
+    AccessorView<AccessorTypes::VEC2<float>> texCoords(
+        model,
+        primitive.attributes.at("TEXCOORD_0"));
+    for (int64_t i = 0; i < texCoords.size(); ++i) {
+      std::memcpy(
+          expected.data() + i * 32 + 24,
+          &texCoords[i],
+          sizeof(AccessorTypes::VEC2<float>));
+    }
+
+    CHECK(packed.data == expected);
+  }
+
+  SECTION("quantizes normals, texture coordinates, and colors") {
+    VertexLayout layout;
+    layout.addAttribute("POSITION", VertexComponentFormat::Float32, 3);
+    layout.addAttribute("NORMAL", VertexComponentFormat::Snorm8, 3);
+    layout.addAttribute("TEXCOORD_0", VertexComponentFormat::Float16, 2);
+    layout.addAttribute("COLOR_0", VertexComponentFormat::Unorm8, 4);
+    CHECK(layout.attributes[1].offset == 12);
+    CHECK(layout.attributes[2].offset == 16);
+    CHECK(layout.attributes[3].offset == 20);
+    CHECK(layout.stride == 24);
+
+    PackedVertices packed = VertexPacker::pack(model, primitive, layout);
+    CHECK(packed.errors.errors.empty());
+    REQUIRE(packed.data.size() == size_t(VertexCount) * layout.stride);
+
+    const uint16_t halves[] = {0x0000, 0x3400, 0x3800, 0x3a00};
+    for (int64_t i = 0; i < VertexCount; ++i) {
+      CHECK(readComponent<float>(packed.data, layout, i, 0, 2) == float(i * 3));
+
+      CHECK(readComponent<int8_t>(packed.data, layout, i, 1, 0) == 0);
+      CHECK(
+          readComponent<int8_t>(packed.data, layout, i, 1, 1) ==
+          (i % 2 == 0 ? 127 : -127));
+
+      CHECK(
+          readComponent<uint16_t>(packed.data, layout, i, 2, 0) ==
+          halves[i % 4]);
+      CHECK(readComponent<uint16_t>(packed.data, layout, i, 2, 1) == 0x3800);
+
+      CHECK(
+          readComponent<uint8_t>(packed.data, layout, i, 3, 0) ==
+          uint8_t(i % 256));
+      CHECK(
+          readComponent<uint8_t>(packed.data, layout, i, 3, 1) ==
+          uint8_t(255 - i % 256));
+    }
+  }
+
+  SECTION("converts normalized integers to floats") {
+    VertexLayout layout;
+    layout.addAttribute("COLOR_0", VertexComponentFormat::Float32, 4);
+
+    PackedVertices packed = VertexPacker::pack(model, primitive, layout);
+    CHECK(packed.errors.errors.empty());
+    REQUIRE(packed.data.size() == size_t(VertexCount) * 16);
+
+    CHECK(readComponent<float>(packed.data, layout, 0, 0, 0) == 0.0f);
+    CHECK(readComponent<float>(packed.data, layout, 0, 0, 1) == 1.0f);
+    CHECK(readComponent<float>(packed.data, layout, 0, 0, 3) == 1.0f);
+    CHECK(
+        readComponent<float>(packed.data, layout, 51, 0, 0) ==
+        Approx(0.2f));
+  }
+
+  SECTION("fills missing attributes and components with defaults") {
+    VertexLayout layout;
+    layout.addAttribute("POSITION", VertexComponentFormat::Float32, 4);
+    layout.addAttribute("TANGENT", VertexComponentFormat::Snorm16, 4)
+        .defaultValue = {1.0f, 0.0f, 0.0f, -1.0f};
+
+    PackedVertices packed = VertexPacker::pack(model, primitive, layout);
+    CHECK(packed.errors.errors.empty());
+    REQUIRE(packed.data.size() == size_t(VertexCount) * 24);
+
+    for (int64_t i = 0; i < VertexCount; ++i) {
+      CHECK(readComponent<float>(packed.data, layout, i, 0, 0) == float(i));
+      CHECK(readComponent<float>(packed.data, layout, i, 0, 3) == 1.0f);
+      CHECK(readComponent<int16_t>(packed.data, layout, i, 1, 0) == 32767);
+      CHECK(readComponent<int16_t>(packed.data, layout, i, 1, 1) == 0);
+      CHECK(readComponent<int16_t>(packed.data, layout, i, 1, 3) == -32767);
+    }
+  }
+
+  SECTION("writes into existing memory and leaves the padding alone") {
+    VertexLayout layout;
+    layout.addAttribute("NORMAL", VertexComponentFormat::Snorm8, 3);
+    CHECK(layout.stride == 4);
+
+    std::vector<std::byte> destination(
+        size_t(VertexCount) * layout.stride,
+        std::byte(0xcd));
+    CesiumUtility::ErrorList errors =
+        VertexPacker::pack(model, primitive, layout, destination);
+    CHECK(errors.errors.empty());
+
+    for (int64_t i = 0; i < VertexCount; ++i) {
+      CHECK(destination[size_t(i) * 4 + 3] == std::byte(0xcd));
+    }
+  }
+
+  SECTION("reports errors without writing anything") {
+    VertexLayout layout;
+    layout.addAttribute("POSITION", VertexComponentFormat::Float32, 3);
+
+    SECTION("destination too small") {
+      std::vector<std::byte> destination(size_t(VertexCount) * 12 - 1);
+      CesiumUtility::ErrorList errors =
+          VertexPacker::pack(model, primitive, layout, destination);
+      CHECK(errors.hasErrors());
+    }
+
+    SECTION("attribute outside of the stride") {
+      layout.stride = 8;
+      PackedVertices packed = VertexPacker::pack(model, primitive, layout);
+      CHECK(packed.errors.hasErrors());
+      CHECK(packed.data.empty());
+    }
+
+    SECTION("attribute with the wrong number of vertices") {
+      model.accessors[size_t(primitive.attributes.at("NORMAL"))].count = 10;
+      layout.addAttribute("NORMAL", VertexComponentFormat::Snorm8, 3);
+      PackedVertices packed = VertexPacker::pack(model, primitive, layout);
+      CHECK(packed.errors.hasErrors());
+      CHECK(packed.data.empty());
+    }
+  }
+}
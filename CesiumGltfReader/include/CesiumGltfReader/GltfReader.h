@@ -22,6 +22,8 @@
 
 namespace CesiumGltfReader {
 
+class SharedImageCache;
+
 /**
  * @brief The result of reading a glTF model with
  * {@link GltfReader::readGltf}.
@@ -126,6 +128,14 @@ struct CESIUMGLTFREADER_API GltfReaderOptions {
    * the ideal target gpu-compressed pixel format to transcode to.
    */
   CesiumGltf::Ktx2TranscodeTargets ktx2TranscodeTargets;
+
+  /**
+   * @brief The cache through which identical images are fetched and decoded
+   * only once, shared by all the glTFs read with it.
+   *
+   * If not specified, each image is fetched and decoded separately.
+   */
+  std::shared_ptr<SharedImageCache> pSharedImageCache = nullptr;
 };
 
 /**
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "CesiumGltfReader/GltfReader.h"
+#include "CesiumGltfReader/Library.h"
+
+#include <CesiumGltf/ImageCesium.h>
+#include <CesiumGltf/Ktx2TranscodeTargets.h>
+
+#include <gsl/span>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace CesiumGltfReader {
+
+/**
+ * @brief Shares decoded images between the glTFs read with the same cache, so
+ * that textures that are used by many models, such as facade atlases or
+ * vegetation sprites, are fetched, decoded, and kept in memory only once.
+ *
+ * Give the cache to {@link GltfReaderOptions::pSharedImageCache}. Images are
+ * identified by a SHA-256 hash of their encoded bytes and by the KTX2
+ * transcode targets, so identical images are shared whether they are
+ * embedded in a buffer, in a `data:` URL, or referenced by an external URL.
+ * External images that were fetched before are not fetched again.
+ *
+ * The models do not get their own copy of the decoded pixels. Instead,
+ * {@link CesiumGltf::ImageCesium::pSharedPixelData} of their images
+ * references the pixels of the shared image. The key of a shared image is
+ * also recorded in the extras of the image under {@link EXTRAS_KEY}, so that
+ * renderers can create a single texture for all images with the same key.
+ *
+ * A decoded image is kept for as long as a model or anyone else references
+ * its pixels, or holds a reference returned by {@link getImage}. By default,
+ * the cache itself keeps nothing else, so that using it never takes more
+ * memory than reading the images without it. Give it a number of bytes to
+ * also keep the most recently used images that are no longer referenced.
+ *
+ * The methods of this class may be called from any thread.
+ */
+class CESIUMGLTFREADER_API SharedImageCache final {
+public:
+  /**
+   * @brief The key under which the key of a shared image is stored in the
+   * extras of a {@link CesiumGltf::Image}.
+   */
+  static const std::string EXTRAS_KEY;
+
+  /**
+   * @brief Creates an empty cache.
+   *
+   * @param maximumRetainedBytes The number of bytes of pixel data of recently
+   * used images to keep even when nothing else references them.
+   */
+  explicit SharedImageCache(int64_t maximumRetainedBytes = 0);
+
+  /**
+   * @brief Computes the key of an encoded image.
+   *
+   * @param data The encoded image.
+   * @param ktx2TranscodeTargets The targets that KTX2 images are transcoded
+   * to, which affect the decoded image.
+   */
+  static std::string computeKey(
+      const gsl::span<const std::byte>& data,
+      const CesiumGltf::Ktx2TranscodeTargets& ktx2TranscodeTargets);
+
+  /**
+   * @brief Gets the decoded image with the given key, or nullptr if it is not
+   * in the cache.
+   */
+  std::shared_ptr<const CesiumGltf::ImageCesium>
+  getImage(const std::string& key);
+
+  /**
+   * @brief Creates an image that references the pixels of a shared image
+   * instead of copying them.
+   *
+   * @param pImage The shared image, which is kept alive by the result.
+   */
+  static CesiumGltf::ImageCesium
+  referenceImage(const std::shared_ptr<const CesiumGltf::ImageCesium>& pImage);
+
+  /**
+   * @brief Reads an image like {@link GltfReader::readImage}, but only
+   * decodes it if no image with the same key is in the cache yet.
+   *
+   * @param key The key of the image, computed by {@link computeKey}.
+   * @param data The encoded image.
+   * @param ktx2TranscodeTargets The targets that KTX2 images are transcoded
+   * to.
+   * @return The result of reading the image, with an image that references
+   * the pixels of the shared image, as created by {@link referenceImage}.
+   */
+  ImageReaderResult readImage(
+      const std::string& key,
+      const gsl::span<const std::byte>& data,
+      const CesiumGltf::Ktx2TranscodeTargets& ktx2TranscodeTargets);
+
+  /**
+   * @brief Gets the key of the image last read from the given URL, if that
+   * image is still in the cache.
+   *
+   * @param url The absolute URL of the image.
+   * @param ktx2TranscodeTargets The targets that KTX2 images are transcoded
+   * to.
+   */
+  std::optional<std::string> getKeyForUrl(
+      const std::string& url,
+      const CesiumGltf::Ktx2TranscodeTargets& ktx2TranscodeTargets);
+
+  /**
+   * @brief Records that the image with the given key was read from the given
+   * URL, so that it is not fetched again while the image is in the cache.
+   *
+   * @param url The absolute URL of the image.
+   * @param ktx2TranscodeTargets The targets that KTX2 images are transcoded
+   * to.
+   * @param key The key of the image, computed by {@link computeKey}.
+   */
+  void setKeyForUrl(
+      const std::string& url,
+      const CesiumGltf::Ktx2TranscodeTargets& ktx2TranscodeTargets,
+      const std::string& key);
+
+  /**
+   * @brief Gets the number of bytes of pixel data that are kept by the
+   * cache itself.
+   */
+  int64_t getRetainedBytes() const;
+
+  /**
+   * @brief Gets the number of images in the cache.
+   */
+  size_t size() const;
+
+private:
+  struct State;
+  std::shared_ptr<State> _pState;
+};
+
+} // namespace CesiumGltfReader
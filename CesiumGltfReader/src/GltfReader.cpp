@@ -1,11 +1,13 @@
 #include "CesiumGltfReader/GltfReader.h"
 
+#include "CesiumGltfReader/SharedImageCache.h"
 #include "ModelJsonHandler.h"
 #include "applyKhrTextureTransform.h"
 #include "decodeDataUrls.h"
 #include "decodeDraco.h"
 #include "decodeMeshOpt.h"
 #include "dequantizeMeshData.h"
+#include "readImageWithOptions.h"
 #include "registerReaderExtensions.h"
 
 #include <CesiumAsync/IAssetRequest.h>
@@ -277,7 +279,7 @@ void postprocess(
       }
 
       // Image has already been decoded
-      if (!image.cesium.pixelData.empty()) {
+      if (!image.cesium.getPixelData().empty()) {
         continue;
       }
 
@@ -302,7 +304,7 @@ void postprocess(
           static_cast<size_t>(bufferView.byteOffset),
           static_cast<size_t>(bufferView.byteLength));
       ImageReaderResult imageResult =
-          GltfReader::readImage(bufferViewSpan, options.ktx2TranscodeTargets);
+          readImageWithOptions(bufferViewSpan, options, image.extras);
       readGltf.warnings.insert(
           readGltf.warnings.end(),
           imageResult.warnings.begin(),
@@ -537,12 +539,32 @@ void CesiumGltfReader::GltfReader::postprocessGltf(
 
   for (Image& image : pResult->model->images) {
     if (image.uri && image.uri->substr(0, dataPrefixLength) != dataPrefix) {
+      std::string imageUrl = Uri::resolve(baseUrl, *image.uri);
+
+      // Don't fetch an image again that is still in the shared image cache.
+      const std::shared_ptr<SharedImageCache>& pSharedImageCache =
+          options.pSharedImageCache;
+      std::optional<std::string> maybeKey =
+          pSharedImageCache ? pSharedImageCache->getKeyForUrl(
+                                  imageUrl,
+                                  options.ktx2TranscodeTargets)
+                            : std::nullopt;
+      std::shared_ptr<const ImageCesium> pSharedImage =
+          maybeKey ? pSharedImageCache->getImage(*maybeKey) : nullptr;
+      if (pSharedImage) {
+        std::string imageUri = *image.uri;
+        image.uri = std::nullopt;
+        image.cesium = SharedImageCache::referenceImage(pSharedImage);
+        image.extras[SharedImageCache::EXTRAS_KEY] = *maybeKey;
+        resolvedBuffers.push_back(asyncSystem.createResolvedFuture(
+            ExternalBufferLoadResult{true, imageUri}));
+        continue;
+      }
+
       resolvedBuffers.push_back(
-          pAssetAccessor
-              ->get(asyncSystem, Uri::resolve(baseUrl, *image.uri), tHeaders)
+          pAssetAccessor->get(asyncSystem, imageUrl, tHeaders)
               .thenInWorkerThread(
-                  [pImage = &image,
-                   ktx2TranscodeTargets = options.ktx2TranscodeTargets](
+                  [pImage = &image, options, imageUrl](
                       std::shared_ptr<IAssetRequest>&& pRequest) {
                     const IAssetResponse* pResponse = pRequest->response();
 
@@ -551,10 +573,19 @@ void CesiumGltfReader::GltfReader::postprocessGltf(
                     if (pResponse) {
                       pImage->uri = std::nullopt;
 
-                      ImageReaderResult imageResult =
-                          readImage(pResponse->data(), ktx2TranscodeTargets);
+                      ImageReaderResult imageResult = readImageWithOptions(
+                          pResponse->data(),
+                          options,
+                          pImage->extras);
                       if (imageResult.image) {
                         pImage->cesium = std::move(*imageResult.image);
+                        if (options.pSharedImageCache) {
+                          options.pSharedImageCache->setKeyForUrl(
+                              imageUrl,
+                              options.ktx2TranscodeTargets,
+                              pImage->extras[SharedImageCache::EXTRAS_KEY]
+                                  .getStringOrDefault(""));
+                        }
                         return ExternalBufferLoadResult{true, imageUri};
                       }
                     }
@@ -903,10 +934,13 @@ std::optional<std::string> GltfReader::generateMipMaps(ImageCesium& image) {
     return std::nullopt;
   }
 
-  if (image.pixelData.empty()) {
+  if (image.getPixelData().empty()) {
     return "Unable to generate mipmaps, an empty image was provided.";
   }
 
+  // The mip levels are appended to the pixel data, so it must not be shared.
+  image.unsharePixelData();
+
   CESIUM_TRACE(
       "generate mipmaps " + std::to_string(image.width) + "x" +
       std::to_string(image.height) + "x" + std::to_string(image.channels) +
@@ -0,0 +1,307 @@
+#include "CesiumGltfReader/SharedImageCache.h"
+
+#include <CesiumUtility/Tracing.h>
+
+#include <picosha2.h>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace CesiumGltf;
+
+namespace CesiumGltfReader {
+namespace {
+std::string
+computeTargetsKey(const Ktx2TranscodeTargets& ktx2TranscodeTargets) {
+  const GpuCompressedPixelFormat formats[] = {
+      ktx2TranscodeTargets.ETC1S_R,
+      ktx2TranscodeTargets.ETC1S_RG,
+      ktx2TranscodeTargets.ETC1S_RGB,
+      ktx2TranscodeTargets.ETC1S_RGBA,
+      ktx2TranscodeTargets.UASTC_R,
+      ktx2TranscodeTargets.UASTC_RG,
+      ktx2TranscodeTargets.UASTC_RGB,
+      ktx2TranscodeTargets.UASTC_RGBA};
+
+  std::string result;
+  for (const GpuCompressedPixelFormat format : formats) {
+    result += std::to_string(int32_t(format));
+    result += ',';
+  }
+  return result;
+}
+
+int64_t getImageBytes(const ImageCesium& image) noexcept {
+  return int64_t(image.pixelData.size());
+}
+} // namespace
+
+const std::string SharedImageCache::EXTRAS_KEY = "Cesium_SharedImageKey";
+
+struct SharedImageCache::State {
+  using SharedImage = std::shared_ptr<const ImageCesium>;
+  using RetainedList = std::list<std::pair<std::string, SharedImage>>;
+
+  struct Entry {
+    // The image, while the cache or anyone else references it.
+    std::weak_ptr<const ImageCesium> pImage;
+
+    // The position of the image in the retained list, if the cache keeps it.
+    std::optional<RetainedList::iterator> retained;
+
+    // The keys in urlKeys that map to this image, so that they are removed
+    // along with it.
+    std::vector<std::string> urlKeys;
+  };
+
+  using EntryMap = std::unordered_map<std::string, Entry>;
+
+  State(int64_t maximumRetainedBytes_)
+      : maximumRetainedBytes(maximumRetainedBytes_) {}
+
+  // The following methods must be called with the mutex locked.
+
+  SharedImage find(const std::string& key) {
+    auto it = this->entries.find(key);
+    if (it == this->entries.end()) {
+      return nullptr;
+    }
+
+    SharedImage pImage = it->second.pImage.lock();
+    if (!pImage) {
+      this->erase(it);
+      return nullptr;
+    }
+
+    if (it->second.retained) {
+      this->retained.splice(
+          this->retained.begin(),
+          this->retained,
+          *it->second.retained);
+    } else {
+      this->retain(it->first, it->second, pImage);
+    }
+
+    return pImage;
+  }
+
+  void insert(const std::string& key, const SharedImage& pImage) {
+    // Images that nobody references anymore are only noticed when they are
+    // looked up, so look for them whenever the number of entries has doubled.
+    if (this->entries.size() >= 2 * this->entriesAfterPruning + 16) {
+      this->pruneExpired();
+    }
+
+    Entry& entry = this->entries[key];
+    entry.pImage = pImage;
+    this->retain(key, entry, pImage);
+  }
+
+  void erase(EntryMap::iterator it) {
+    for (const std::string& urlKey : it->second.urlKeys) {
+      this->urlKeys.erase(urlKey);
+    }
+    this->entries.erase(it);
+  }
+
+  void pruneExpired() {
+    for (auto it = this->entries.begin(); it != this->entries.end();) {
+      auto next = std::next(it);
+      if (it->second.pImage.expired()) {
+        this->erase(it);
+      }
+      it = next;
+    }
+    this->entriesAfterPruning = this->entries.size();
+  }
+
+  void
+  retain(const std::string& key, Entry& entry, const SharedImage& pImage) {
+    const int64_t bytes = getImageBytes(*pImage);
+    if (bytes > this->maximumRetainedBytes) {
+      return;
+    }
+
+    this->retained.emplace_front(key, pImage);
+    entry.retained = this->retained.begin();
+    this->retainedBytes += bytes;
+
+    // Let go of the least recently used images. Those that are still
+    // referenced elsewhere can still be found.
+    while (this->retainedBytes > this->maximumRetainedBytes) {
+      auto [evictedKey, pEvicted] = std::move(this->retained.back());
+      this->retained.pop_back();
+      this->retainedBytes -= getImageBytes(*pEvicted);
+      pEvicted.reset();
+
+      auto evictedIt = this->entries.find(evictedKey);
+      if (evictedIt != this->entries.end()) {
+        evictedIt->second.retained.reset();
+        if (evictedIt->second.pImage.expired()) {
+          this->erase(evictedIt);
+        }
+      }
+    }
+  }
+
+  void setKeyForUrl(const std::string& urlKey, const std::string& key) {
+    auto entryIt = this->entries.find(key);
+    if (entryIt == this->entries.end()) {
+      return;
+    }
+
+    auto [it, inserted] = this->urlKeys.try_emplace(urlKey, key);
+    if (!inserted) {
+      if (it->second == key) {
+        return;
+      }
+
+      // The URL now refers to another image.
+      auto previousIt = this->entries.find(it->second);
+      if (previousIt != this->entries.end()) {
+        std::vector<std::string>& previousUrlKeys =
+            previousIt->second.urlKeys;
+        previousUrlKeys.erase(
+            std::remove(previousUrlKeys.begin(), previousUrlKeys.end(), urlKey),
+            previousUrlKeys.end());
+      }
+      it->second = key;
+    }
+
+    entryIt->second.urlKeys.emplace_back(urlKey);
+  }
+
+  mutable std::mutex mutex;
+  int64_t maximumRetainedBytes;
+  int64_t retainedBytes = 0;
+  EntryMap entries;
+  size_t entriesAfterPruning = 0;
+  RetainedList retained;
+  std::unordered_map<std::string, std::string> urlKeys;
+};
+
+SharedImageCache::SharedImageCache(int64_t maximumRetainedBytes)
+    : _pState{std::make_shared<State>(maximumRetainedBytes)} {}
+
+/*static*/ std::string SharedImageCache::computeKey(
+    const gsl::span<const std::byte>& data,
+    const Ktx2TranscodeTargets& ktx2TranscodeTargets) {
+  CESIUM_TRACE("SharedImageCache::computeKey");
+  const unsigned char* pBegin =
+      reinterpret_cast<const unsigned char*>(data.data());
+  std::array<unsigned char, picosha2::k_digest_size> digest;
+  picosha2::hash256(pBegin, pBegin + data.size(), digest.begin(), digest.end());
+  return picosha2::bytes_to_hex_string(digest.begin(), digest.end()) + "-" +
+         computeTargetsKey(ktx2TranscodeTargets);
+}
+
+/*static*/ ImageCesium SharedImageCache::referenceImage(
+    const std::shared_ptr<const ImageCesium>& pImage) {
+  ImageCesium result;
+  result.width = pImage->width;
+  result.height = pImage->height;
+  result.channels = pImage->channels;
+  result.bytesPerChannel = pImage->bytesPerChannel;
+  result.compressedPixelFormat = pImage->compressedPixelFormat;
+  result.mipPositions = pImage->mipPositions;
+  result.sizeBytes = pImage->sizeBytes;
+  result.pSharedPixelData = std::shared_ptr<const std::vector<std::byte>>(
+      pImage,
+      &pImage->getPixelData());
+  return result;
+}
+
+std::shared_ptr<const ImageCesium>
+SharedImageCache::getImage(const std::string& key) {
+  std::lock_guard<std::mutex> lock(this->_pState->mutex);
+  return this->_pState->find(key);
+}
+
+ImageReaderResult SharedImageCache::readImage(
+    const std::string& key,
+    const gsl::span<const std::byte>& data,
+    const Ktx2TranscodeTargets& ktx2TranscodeTargets) {
+  std::shared_ptr<const ImageCesium> pImage = this->getImage(key);
+  if (pImage) {
+    return ImageReaderResult{referenceImage(pImage), {}, {}};
+  }
+
+  // Decode without holding the lock. If another thread decodes the same
+  // image at the same time, the first one to finish is shared.
+  ImageReaderResult result =
+      GltfReader::readImage(data, ktx2TranscodeTargets);
+  if (!result.image) {
+    return result;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->_pState->mutex);
+    pImage = this->_pState->find(key);
+    if (!pImage) {
+      pImage = std::make_shared<const ImageCesium>(std::move(*result.image));
+      this->_pState->insert(key, pImage);
+    }
+  }
+
+  result.image = referenceImage(pImage);
+  return result;
+}
+
+std::optional<std::string> SharedImageCache::getKeyForUrl(
+    const std::string& url,
+    const Ktx2TranscodeTargets& ktx2TranscodeTargets) {
+  std::lock_guard<std::mutex> lock(this->_pState->mutex);
+
+  const std::string urlKey =
+      url + "\n" + computeTargetsKey(ktx2TranscodeTargets);
+  auto it = this->_pState->urlKeys.find(urlKey);
+  if (it == this->_pState->urlKeys.end()) {
+    return std::nullopt;
+  }
+
+  // Finding an image that is gone removes it along with its URLs.
+  std::string key = it->second;
+  if (!this->_pState->find(key)) {
+    this->_pState->urlKeys.erase(urlKey);
+    return std::nullopt;
+  }
+
+  return key;
+}
+
+void SharedImageCache::setKeyForUrl(
+    const std::string& url,
+    const Ktx2TranscodeTargets& ktx2TranscodeTargets,
+    const std::string& key) {
+  std::lock_guard<std::mutex> lock(this->_pState->mutex);
+  this->_pState->setKeyForUrl(
+      url + "\n" + computeTargetsKey(ktx2TranscodeTargets),
+      key);
+}
+
+int64_t SharedImageCache::getRetainedBytes() const {
+  std::lock_guard<std::mutex> lock(this->_pState->mutex);
+  return this->_pState->retainedBytes;
+}
+
+size_t SharedImageCache::size() const {
+  std::lock_guard<std::mutex> lock(this->_pState->mutex);
+
+  size_t result = 0;
+  for (const auto& pair : this->_pState->entries) {
+    if (!pair.second.pImage.expired()) {
+      ++result;
+    }
+  }
+  return result;
+}
+
+} // namespace CesiumGltfReader
@@ -1,6 +1,7 @@
 #include "decodeDataUrls.h"
 
 #include "CesiumGltfReader/GltfReader.h"
+#include "readImageWithOptions.h"
 
 #include <CesiumGltf/Model.h>
 #include <CesiumUtility/Tracing.h>
@@ -87,7 +88,7 @@ std::optional<DecodeResult> tryDecode(const std::string& uri) {
 } // namespace
 
 void decodeDataUrls(
-    const GltfReader& reader,
+    const GltfReader& /* reader */,
     GltfReaderResult& readGltf,
     const GltfReaderOptions& options) {
   CESIUM_TRACE("CesiumGltfReader::decodeDataUrls");
@@ -135,7 +136,7 @@ void decodeDataUrls(
     }
 
     ImageReaderResult imageResult =
-        reader.readImage(decoded.value().data, options.ktx2TranscodeTargets);
+        readImageWithOptions(decoded.value().data, options, image.extras);
 
     if (!imageResult.image) {
       continue;
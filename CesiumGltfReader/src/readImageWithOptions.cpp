@@ -0,0 +1,31 @@
+#include "readImageWithOptions.h"
+
+#include "CesiumGltfReader/GltfReader.h"
+#include "CesiumGltfReader/SharedImageCache.h"
+
+#include <string>
+
+namespace CesiumGltfReader {
+
+ImageReaderResult readImageWithOptions(
+    const gsl::span<const std::byte>& data,
+    const GltfReaderOptions& options,
+    CesiumUtility::JsonValue::Object& extras) {
+  if (!options.pSharedImageCache) {
+    return GltfReader::readImage(data, options.ktx2TranscodeTargets);
+  }
+
+  const std::string key =
+      SharedImageCache::computeKey(data, options.ktx2TranscodeTargets);
+  ImageReaderResult result = options.pSharedImageCache->readImage(
+      key,
+      data,
+      options.ktx2TranscodeTargets);
+  if (result.image) {
+    extras[SharedImageCache::EXTRAS_KEY] = key;
+  }
+
+  return result;
+}
+
+} // namespace CesiumGltfReader
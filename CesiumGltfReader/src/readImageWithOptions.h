@@ -0,0 +1,22 @@
+#pragma once
+
+#include <CesiumUtility/JsonValue.h>
+
+#include <gsl/span>
+
+#include <cstddef>
+
+namespace CesiumGltfReader {
+struct GltfReaderOptions;
+struct ImageReaderResult;
+
+/**
+ * Reads an image with GltfReader::readImage, or from the shared image cache
+ * of the options if there is one. When the cache is used, the key of the
+ * image is recorded in the given extras.
+ */
+ImageReaderResult readImageWithOptions(
+    const gsl::span<const std::byte>& data,
+    const GltfReaderOptions& options,
+    CesiumUtility::JsonValue::Object& extras);
+} // namespace CesiumGltfReader
@@ -0,0 +1,208 @@
+#include "CesiumGltfReader/GltfReader.h"
+#include "CesiumGltfReader/SharedImageCache.h"
+
+#include <CesiumAsync/AsyncSystem.h>
+#include <CesiumNativeTests/SimpleAssetAccessor.h>
+#include <CesiumNativeTests/SimpleTaskProcessor.h>
+#include <CesiumNativeTests/readFile.h>
+#include <CesiumNativeTests/waitForFuture.h>
+
+#include <catch2/catch.hpp>
+#include <gsl/span>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace CesiumAsync;
+using namespace CesiumGltf;
+using namespace CesiumGltfReader;
+using namespace CesiumNativeTests;
+
+namespace {
+
+GltfReaderResult readExternalImageGltf(
+    AsyncSystem& asyncSystem,
+    const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
+    const GltfReaderOptions& options) {
+  const std::string s = R"(
+    {
+      "asset": { "version": "2.0" },
+      "images": [{ "uri": "kota.jpg" }]
+    }
+  )";
+
+  GltfReader reader;
+  GltfReaderResult result = reader.readGltf(
+      gsl::span(reinterpret_cast<const std::byte*>(s.c_str()), s.size()),
+      options);
+  return waitForFuture(
+      asyncSystem,
+      GltfReader::resolveExternalData(
+          asyncSystem,
+          "https://example.com/model.gltf",
+          HttpHeaders{},
+          pAssetAccessor,
+          options,
+          std::move(result)));
+}
+
+} // namespace
+
+TEST_CASE("SharedImageCache") {
+  const std::vector<std::byte> jpeg = readFile(
+      CesiumGltfReader_TEST_DATA_DIR + std::string("/ktx2/kota.jpg"));
+
+  SECTION("computes keys from the bytes and the transcode targets") {
+    const std::string key = SharedImageCache::computeKey(jpeg, {});
+    CHECK(key == SharedImageCache::computeKey(jpeg, {}));
+
+    std::vector<std::byte> modified = jpeg;
+    modified.back() = std::byte(~std::to_integer<uint8_t>(modified.back()));
+    CHECK(key != SharedImageCache::computeKey(modified, {}));
+
+    Ktx2TranscodeTargets targets;
+    targets.ETC1S_RGBA = GpuCompressedPixelFormat::BC3_RGBA;
+    CHECK(key != SharedImageCache::computeKey(jpeg, targets));
+  }
+
+  SECTION("shares images decoded from identical bytes") {
+    SharedImageCache cache;
+    const std::string key = SharedImageCache::computeKey(jpeg, {});
+
+    ImageReaderResult first = cache.readImage(key, jpeg, {});
+    REQUIRE(first.image);
+    CHECK(first.errors.empty());
+    CHECK(first.image->pixelData.empty());
+    REQUIRE(first.image->pSharedPixelData);
+    CHECK(cache.size() == 1);
+
+    // Nothing is kept by the cache itself by default.
+    CHECK(cache.getRetainedBytes() == 0);
+
+    std::shared_ptr<const ImageCesium> pShared = cache.getImage(key);
+    REQUIRE(pShared);
+    CHECK(pShared->width == first.image->width);
+    CHECK(&pShared->pixelData == first.image->pSharedPixelData.get());
+
+    ImageReaderResult second = cache.readImage(key, jpeg, {});
+    REQUIRE(second.image);
+    CHECK(second.image->pSharedPixelData == first.image->pSharedPixelData);
+    CHECK(
+        second.image->getPixelData().size() ==
+        size_t(first.image->width) * size_t(first.image->height) *
+            size_t(first.image->channels));
+    CHECK(cache.size() == 1);
+  }
+
+  SECTION("releases images when nothing references them") {
+    SharedImageCache cache;
+    const std::string key = SharedImageCache::computeKey(jpeg, {});
+
+    ImageReaderResult first = cache.readImage(key, jpeg, {});
+    REQUIRE(first.image);
+    cache.setKeyForUrl("https://example.com/kota.jpg", {}, key);
+    CHECK(cache.getKeyForUrl("https://example.com/kota.jpg", {}) == key);
+
+    ImageCesium unshared = *first.image;
+    unshared.unsharePixelData();
+    CHECK(!unshared.pSharedPixelData);
+    CHECK(unshared.pixelData == *first.image->pSharedPixelData);
+
+    first.image.reset();
+    CHECK(cache.size() == 0);
+    CHECK(cache.getImage(key) == nullptr);
+    CHECK(!cache.getKeyForUrl("https://example.com/kota.jpg", {}));
+  }
+
+  SECTION("does not keep unreferenced images beyond the retained bytes") {
+    SharedImageCache cache(0);
+    const std::string key = SharedImageCache::computeKey(jpeg, {});
+
+    CHECK(cache.readImage(key, jpeg, {}).image);
+    CHECK(cache.getRetainedBytes() == 0);
+    CHECK(cache.getImage(key) == nullptr);
+    CHECK(cache.size() == 0);
+  }
+
+  SECTION("evicts the least recently used images") {
+    std::vector<std::byte> other = jpeg;
+    other.emplace_back(std::byte(0));
+    const std::string key = SharedImageCache::computeKey(jpeg, {});
+    const std::string otherKey = SharedImageCache::computeKey(other, {});
+
+    ImageReaderResult probe = GltfReader::readImage(jpeg, {});
+    REQUIRE(probe.image);
+    SharedImageCache cache(int64_t(probe.image->pixelData.size()));
+
+    REQUIRE(cache.readImage(key, jpeg, {}).image);
+    std::shared_ptr<const ImageCesium> pHeld = cache.getImage(key);
+    REQUIRE(cache.readImage(otherKey, other, {}).image);
+
+    // The first image is no longer retained, but is still held here.
+    CHECK(cache.getRetainedBytes() == int64_t(probe.image->pixelData.size()));
+    CHECK(cache.size() == 2);
+    CHECK(cache.getImage(key) == pHeld);
+
+    // Getting it again retained it in place of the other image.
+    CHECK(cache.getImage(otherKey) == nullptr);
+    pHeld.reset();
+    CHECK(cache.getImage(key) != nullptr);
+    CHECK(cache.size() == 1);
+  }
+
+  SECTION("fetches external images only once") {
+    AsyncSystem asyncSystem(std::make_shared<SimpleTaskProcessor>());
+
+    std::map<std::string, std::shared_ptr<SimpleAssetRequest>> requests;
+    requests["https://example.com/kota.jpg"] =
+        std::make_shared<SimpleAssetRequest>(
+            "GET",
+            "https://example.com/kota.jpg",
+            HttpHeaders{},
+            std::make_unique<SimpleAssetResponse>(
+                uint16_t(200),
+                "image/jpeg",
+                HttpHeaders{},
+                jpeg));
+
+    GltfReaderOptions options;
+    options.pSharedImageCache = std::make_shared<SharedImageCache>();
+
+    GltfReaderResult first = readExternalImageGltf(
+        asyncSystem,
+        std::make_shared<SimpleAssetAccessor>(std::move(requests)),
+        options);
+    REQUIRE(first.model);
+    REQUIRE(first.model->images.size() == 1);
+    const Image& firstImage = first.model->images[0];
+    CHECK(firstImage.cesium.width > 0);
+    auto keyIt = firstImage.extras.find(SharedImageCache::EXTRAS_KEY);
+    REQUIRE(keyIt != firstImage.extras.end());
+    CHECK(
+        keyIt->second.getStringOrDefault("") ==
+        SharedImageCache::computeKey(jpeg, {}));
+
+    // The second model would fail to fetch the image.
+    GltfReaderResult second = readExternalImageGltf(
+        asyncSystem,
+        std::make_shared<SimpleAssetAccessor>(
+            std::map<std::string, std::shared_ptr<SimpleAssetRequest>>()),
+        options);
+    REQUIRE(second.model);
+    CHECK(second.warnings.empty());
+    REQUIRE(second.model->images.size() == 1);
+    const Image& secondImage = second.model->images[0];
+    CHECK(!secondImage.uri);
+    REQUIRE(secondImage.cesium.pSharedPixelData);
+    CHECK(
+        secondImage.cesium.pSharedPixelData ==
+        firstImage.cesium.pSharedPixelData);
+    auto secondKeyIt = secondImage.extras.find(SharedImageCache::EXTRAS_KEY);
+    REQUIRE(secondKeyIt != secondImage.extras.end());
+    CHECK(
+        secondKeyIt->second.getStringOrDefault("") ==
+        keyIt->second.getStringOrDefault(""));
+  }
+}
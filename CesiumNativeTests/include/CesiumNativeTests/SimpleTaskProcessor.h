@@ -6,5 +6,9 @@ namespace CesiumNativeTests {
 class SimpleTaskProcessor : public CesiumAsync::ITaskProcessor {
 public:
   virtual void startTask(std::function<void()> f) override { f(); }
+
+  virtual void startTaskFunction(CesiumAsync::TaskFunction&& f) override {
+    f();
+  }
 };
 } // namespace CesiumNativeTests
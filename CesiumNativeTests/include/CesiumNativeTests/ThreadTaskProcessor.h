@@ -3,6 +3,7 @@
 #include <CesiumAsync/ITaskProcessor.h>
 
 #include <thread>
+#include <utility>
 
 namespace CesiumNativeTests {
 class ThreadTaskProcessor : public CesiumAsync::ITaskProcessor {
@@ -10,5 +11,9 @@ public:
   virtual void startTask(std::function<void()> f) override {
     std::thread(f).detach();
   }
+
+  virtual void startTaskFunction(CesiumAsync::TaskFunction&& f) override {
+    std::thread(std::move(f)).detach();
+  }
 };
 } // namespace CesiumNativeTests
@@ -3,6 +3,7 @@
 #include "Library.h"
 #include "RasterOverlay.h"
 
+#include <CesiumAsync/EndpointCache.h>
 #include <CesiumAsync/IAssetRequest.h>
 #include <CesiumGeospatial/Ellipsoid.h>
 
@@ -27,13 +28,19 @@ public:
    * @param ionAssetID The asset ID.
    * @param ionAccessToken The access token.
    * @param overlayOptions The {@link RasterOverlayOptions} for this instance.
+   * @param ionAssetEndpointUrl The URL of the Cesium ion API.
+   * @param pEndpointCache The cache of Cesium ion asset endpoints in which to
+   * look up the endpoint of the asset. If `nullptr`,
+   * {@link CesiumAsync::EndpointCache::getDefault} is used.
    */
   IonRasterOverlay(
       const std::string& name,
       int64_t ionAssetID,
       const std::string& ionAccessToken,
       const RasterOverlayOptions& overlayOptions = {},
-      const std::string& ionAssetEndpointUrl = "https://api.cesium.com/");
+      const std::string& ionAssetEndpointUrl = "https://api.cesium.com/",
+      const std::shared_ptr<CesiumAsync::EndpointCache>& pEndpointCache =
+          nullptr);
   virtual ~IonRasterOverlay() override;
 
   virtual CesiumAsync::Future<CreateTileProviderResult> createTileProvider(
@@ -50,6 +57,7 @@ private:
   int64_t _ionAssetID;
   std::string _ionAccessToken;
   std::string _ionAssetEndpointUrl;
+  std::shared_ptr<CesiumAsync::EndpointCache> _pEndpointCache;
 
   struct AssetEndpointAttribution {
     std::string html;
@@ -66,8 +74,6 @@ private:
     std::vector<AssetEndpointAttribution> attributions;
   };
 
-  static std::unordered_map<std::string, ExternalAssetEndpoint> endpointCache;
-
   CesiumAsync::Future<CreateTileProviderResult> createTileProvider(
       const ExternalAssetEndpoint& endpoint,
       const CesiumAsync::AsyncSystem& asyncSystem,
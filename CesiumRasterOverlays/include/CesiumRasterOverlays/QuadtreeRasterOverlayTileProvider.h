@@ -9,6 +9,7 @@
 #include <CesiumGeometry/QuadtreeTileID.h>
 #include <CesiumGeometry/QuadtreeTilingScheme.h>
 #include <CesiumUtility/CreditSystem.h>
+#include <CesiumUtility/FlatHashMap.h>
 
 #include <list>
 #include <memory>
@@ -170,7 +171,7 @@ private:
   TileLeastRecentlyUsedList _tilesOldToRecent;
 
   // Allows a Future to be looked up by quadtree tile ID.
-  std::unordered_map<
+  CesiumUtility::FlatHashMap<
       CesiumGeometry::QuadtreeTileID,
       TileLeastRecentlyUsedList::iterator>
       _tileLookup;
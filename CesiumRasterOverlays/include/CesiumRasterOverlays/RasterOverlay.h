@@ -26,6 +26,7 @@ class CreditSystem;
 namespace CesiumRasterOverlays {
 
 class IPrepareRasterOverlayRendererResources;
+class RasterOverlayTextureAtlas;
 class RasterOverlayTileProvider;
 
 /**
@@ -108,6 +109,15 @@ struct CESIUMRASTEROVERLAYS_API RasterOverlayOptions {
    */
   std::any rendererOptions;
 
+  /**
+   * @brief The atlas in which to place the images of the tiles of this
+   * overlay, or `nullptr` to prepare each image as a separate texture.
+   *
+   * The same atlas may be given to several overlays. See
+   * {@link RasterOverlayTextureAtlas} for how renderers use it.
+   */
+  std::shared_ptr<RasterOverlayTextureAtlas> pTextureAtlas = nullptr;
+
   /**
    * @brief The ellipsoid used for this raster overlay.
    */
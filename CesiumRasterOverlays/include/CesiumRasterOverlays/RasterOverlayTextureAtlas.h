@@ -0,0 +1,197 @@
+#pragma once
+
+#include "Library.h"
+
+#include <CesiumGltf/ImageCesium.h>
+#include <CesiumGltfContent/ImageManipulation.h>
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace CesiumRasterOverlays {
+
+class RasterOverlayTile;
+
+/**
+ * @brief Packs the images of small raster overlay tiles into shared texture
+ * pages, so that renderers can draw many tiles from a few large textures
+ * instead of creating a texture for each tile.
+ *
+ * An atlas is given to raster overlays with
+ * {@link RasterOverlayOptions::pTextureAtlas}, and may be shared by several
+ * overlays. When a tile of such an overlay is loaded, it is assigned a
+ * rectangle in one of the pages before
+ * {@link IPrepareRasterOverlayRendererResources::prepareRasterInMainThread}
+ * is called, and the renderer can look up the assignment with
+ * {@link getAllocation} and copy the image of the tile into the page. Tiles
+ * whose image is compressed, has mipmaps, or is larger than a page, and tiles
+ * that arrive when all pages are full, are not assigned a rectangle and
+ * should be prepared as separate textures as before.
+ *
+ * Each page is packed in horizontal shelves, and only holds images with the
+ * same number of channels and bytes per channel. The rectangle of a tile is
+ * released when the tile is destroyed, and a page whose last rectangle is
+ * released is evicted so that the renderer can free its texture. Because
+ * tiles come and go, pages tend to be left sparsely used; {@link defragment}
+ * moves the rectangles of the emptiest pages into the others so that those
+ * pages can be evicted as well.
+ *
+ * All methods must be called from the main thread.
+ */
+class CESIUMRASTEROVERLAYS_API RasterOverlayTextureAtlas final {
+public:
+  /**
+   * @brief The rectangle assigned to a tile.
+   */
+  struct Allocation {
+    /**
+     * @brief The index of the page that holds the image.
+     */
+    int32_t page;
+
+    /**
+     * @brief The pixels of the page that hold the image.
+     */
+    CesiumGltfContent::PixelRectangle rectangle;
+  };
+
+  /**
+   * @brief The move of the image of a tile from one rectangle to another,
+   * performed by {@link defragment}.
+   */
+  struct Move {
+    /**
+     * @brief The tile whose image is moved.
+     */
+    const RasterOverlayTile* pTile;
+
+    /**
+     * @brief The rectangle that held the image before the move.
+     */
+    Allocation from;
+
+    /**
+     * @brief The rectangle that holds the image after the move.
+     */
+    Allocation to;
+  };
+
+  /**
+   * @brief Creates a new instance.
+   *
+   * @param pageSize The width and height, in pixels, of each page.
+   * @param maximumPages The maximum number of pages that may be in use at
+   * the same time.
+   * @param padding The number of pixels to leave empty to the right of and
+   * below each image, to prevent filtering from bleeding into neighboring
+   * images.
+   */
+  RasterOverlayTextureAtlas(
+      int32_t pageSize = 2048,
+      int32_t maximumPages = 16,
+      int32_t padding = 1);
+
+  /**
+   * @brief Gets the width and height, in pixels, of each page.
+   */
+  int32_t getPageSize() const noexcept { return this->_pageSize; }
+
+  /**
+   * @brief Gets the number of pages that are in use.
+   */
+  int32_t getNumberOfPagesInUse() const noexcept;
+
+  /**
+   * @brief Gets the number of pixels of the given page that are assigned to
+   * tiles, not counting the padding, or 0 if the page is not in use.
+   */
+  int64_t getUsedPixels(int32_t page) const noexcept;
+
+  /**
+   * @brief Assigns a rectangle to the image of the given tile.
+   *
+   * If the tile already has a rectangle, it is returned as is.
+   *
+   * @param tile The tile.
+   * @param image The image of the tile, which is only used for its size and
+   * format.
+   * @return The assigned rectangle, or `std::nullopt` if the image cannot be
+   * placed in the atlas.
+   */
+  std::optional<Allocation> allocate(
+      const RasterOverlayTile& tile,
+      const CesiumGltf::ImageCesium& image);
+
+  /**
+   * @brief Gets the rectangle assigned to the given tile, or `nullptr` if it
+   * has none.
+   */
+  const Allocation* getAllocation(const RasterOverlayTile& tile) const noexcept;
+
+  /**
+   * @brief Releases the rectangle assigned to the given tile, if any.
+   *
+   * If it was the last rectangle of its page, the page is evicted and
+   * reported by {@link takeEvictedPages}.
+   */
+  void release(const RasterOverlayTile& tile) noexcept;
+
+  /**
+   * @brief Moves the images of the emptiest pages into the other pages, so
+   * that the emptiest pages are evicted.
+   *
+   * Only pages all of whose images can be moved are emptied. The moves are
+   * already reflected by {@link getAllocation} when this method returns, but
+   * the pages that are emptied are only reported by {@link takeEvictedPages}
+   * afterwards, so that the renderer can copy the images before freeing the
+   * textures of those pages.
+   *
+   * @param maximumMoves The maximum number of images to move.
+   * @return The moves that were made.
+   */
+  std::vector<Move> defragment(int32_t maximumMoves);
+
+  /**
+   * @brief Gets the pages that were evicted since the last call to this
+   * method, and whose textures can be freed.
+   */
+  std::vector<int32_t> takeEvictedPages();
+
+private:
+  struct Span {
+    int32_t x;
+    int32_t width;
+  };
+
+  struct Shelf {
+    int32_t y;
+    int32_t height;
+    std::vector<Span> freeSpans;
+  };
+
+  struct Page {
+    bool inUse;
+    int32_t channels;
+    int32_t bytesPerChannel;
+    int32_t nextShelfY;
+    std::vector<Shelf> shelves;
+    int64_t usedPixels;
+    int32_t allocationCount;
+  };
+
+  std::optional<Allocation>
+  allocateInPage(int32_t pageIndex, int32_t width, int32_t height);
+  void freeInPage(const Allocation& allocation) noexcept;
+  std::optional<int32_t> addPage(int32_t channels, int32_t bytesPerChannel);
+
+  int32_t _pageSize;
+  int32_t _maximumPages;
+  int32_t _padding;
+  std::vector<Page> _pages;
+  std::unordered_map<const RasterOverlayTile*, Allocation> _allocations;
+  std::vector<int32_t> _evictedPages;
+};
+
+} // namespace CesiumRasterOverlays
@@ -1,3 +1,4 @@
+#include <CesiumAsync/EndpointCache.h>
 #include <CesiumAsync/IAssetAccessor.h>
 #include <CesiumAsync/IAssetResponse.h>
 #include <CesiumRasterOverlays/BingMapsRasterOverlay.h>
@@ -22,17 +23,17 @@ IonRasterOverlay::IonRasterOverlay(
     int64_t ionAssetID,
     const std::string& ionAccessToken,
     const RasterOverlayOptions& overlayOptions,
-    const std::string& ionAssetEndpointUrl)
+    const std::string& ionAssetEndpointUrl,
+    const std::shared_ptr<CesiumAsync::EndpointCache>& pEndpointCache)
     : RasterOverlay(name, overlayOptions),
       _ionAssetID(ionAssetID),
       _ionAccessToken(ionAccessToken),
-      _ionAssetEndpointUrl(ionAssetEndpointUrl) {}
+      _ionAssetEndpointUrl(ionAssetEndpointUrl),
+      _pEndpointCache(
+          pEndpointCache ? pEndpointCache : EndpointCache::getDefault()) {}
 
 IonRasterOverlay::~IonRasterOverlay() {}
 
-std::unordered_map<std::string, IonRasterOverlay::ExternalAssetEndpoint>
-    IonRasterOverlay::endpointCache;
-
 Future<RasterOverlay::CreateTileProviderResult>
 IonRasterOverlay::createTileProvider(
     const ExternalAssetEndpoint& endpoint,
@@ -95,19 +96,7 @@ IonRasterOverlay::createTileProvider(
 
   pOwner = pOwner ? pOwner : this;
 
-  auto cacheIt = IonRasterOverlay::endpointCache.find(ionUrl);
-  if (cacheIt != IonRasterOverlay::endpointCache.end()) {
-    return createTileProvider(
-        cacheIt->second,
-        asyncSystem,
-        pAssetAccessor,
-        pCreditSystem,
-        pPrepareRendererResources,
-        pLogger,
-        pOwner);
-  }
-
-  return pAssetAccessor->get(asyncSystem, ionUrl)
+  return this->_pEndpointCache->get(asyncSystem, pAssetAccessor, ionUrl)
       .thenImmediately(
           [](std::shared_ptr<IAssetRequest>&& pRequest)
               -> nonstd::expected<
@@ -208,14 +197,12 @@ IonRasterOverlay::createTileProvider(
            pAssetAccessor,
            pCreditSystem,
            pPrepareRendererResources,
-           ionUrl,
            this,
            pLogger](nonstd::expected<
                     ExternalAssetEndpoint,
                     RasterOverlayLoadFailureDetails>&& result)
               -> Future<CreateTileProviderResult> {
             if (result) {
-              IonRasterOverlay::endpointCache[ionUrl] = *result;
               return this->createTileProvider(
                   *result,
                   asyncSystem,
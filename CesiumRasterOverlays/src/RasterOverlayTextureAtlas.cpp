@@ -0,0 +1,336 @@
+#include <CesiumRasterOverlays/RasterOverlayTextureAtlas.h>
+#include <CesiumUtility/Assert.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+using namespace CesiumGltf;
+using namespace CesiumGltfContent;
+
+namespace CesiumRasterOverlays {
+
+RasterOverlayTextureAtlas::RasterOverlayTextureAtlas(
+    int32_t pageSize,
+    int32_t maximumPages,
+    int32_t padding)
+    : _pageSize(pageSize),
+      _maximumPages(maximumPages),
+      _padding(std::max(padding, 0)),
+      _pages(),
+      _allocations(),
+      _evictedPages() {}
+
+int32_t RasterOverlayTextureAtlas::getNumberOfPagesInUse() const noexcept {
+  return int32_t(std::count_if(
+      this->_pages.begin(),
+      this->_pages.end(),
+      [](const Page& page) { return page.inUse; }));
+}
+
+int64_t RasterOverlayTextureAtlas::getUsedPixels(int32_t page) const noexcept {
+  if (page < 0 || size_t(page) >= this->_pages.size()) {
+    return 0;
+  }
+  return this->_pages[size_t(page)].usedPixels;
+}
+
+std::optional<RasterOverlayTextureAtlas::Allocation>
+RasterOverlayTextureAtlas::allocate(
+    const RasterOverlayTile& tile,
+    const ImageCesium& image) {
+  auto it = this->_allocations.find(&tile);
+  if (it != this->_allocations.end()) {
+    return it->second;
+  }
+
+  // Compressed images and mip chains cannot be copied into a sub-rectangle.
+  if (image.compressedPixelFormat != GpuCompressedPixelFormat::NONE ||
+      !image.mipPositions.empty() || image.width <= 0 || image.height <= 0) {
+    return std::nullopt;
+  }
+
+  const int32_t width = image.width + this->_padding;
+  const int32_t height = image.height + this->_padding;
+  if (width > this->_pageSize || height > this->_pageSize) {
+    return std::nullopt;
+  }
+
+  std::optional<Allocation> maybeAllocation;
+  for (size_t i = 0; i < this->_pages.size() && !maybeAllocation; ++i) {
+    const Page& page = this->_pages[i];
+    if (page.inUse && page.channels == image.channels &&
+        page.bytesPerChannel == image.bytesPerChannel) {
+      maybeAllocation = this->allocateInPage(int32_t(i), width, height);
+    }
+  }
+
+  if (!maybeAllocation) {
+    std::optional<int32_t> maybePage =
+        this->addPage(image.channels, image.bytesPerChannel);
+    if (maybePage) {
+      maybeAllocation = this->allocateInPage(*maybePage, width, height);
+    }
+  }
+
+  if (maybeAllocation) {
+    this->_allocations.emplace(&tile, *maybeAllocation);
+  }
+
+  return maybeAllocation;
+}
+
+const RasterOverlayTextureAtlas::Allocation*
+RasterOverlayTextureAtlas::getAllocation(
+    const RasterOverlayTile& tile) const noexcept {
+  auto it = this->_allocations.find(&tile);
+  if (it == this->_allocations.end()) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+void RasterOverlayTextureAtlas::release(
+    const RasterOverlayTile& tile) noexcept {
+  auto it = this->_allocations.find(&tile);
+  if (it == this->_allocations.end()) {
+    return;
+  }
+
+  this->freeInPage(it->second);
+  this->_allocations.erase(it);
+}
+
+std::vector<RasterOverlayTextureAtlas::Move>
+RasterOverlayTextureAtlas::defragment(int32_t maximumMoves) {
+  std::vector<Move> moves;
+
+  // Try to empty the pages with the fewest used pixels first.
+  std::vector<int32_t> candidates;
+  for (size_t i = 0; i < this->_pages.size(); ++i) {
+    if (this->_pages[i].inUse) {
+      candidates.emplace_back(int32_t(i));
+    }
+  }
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [this](int32_t a, int32_t b) {
+        return this->_pages[size_t(a)].usedPixels <
+               this->_pages[size_t(b)].usedPixels;
+      });
+
+  for (const int32_t source : candidates) {
+    const Page& sourcePage = this->_pages[size_t(source)];
+    if (!sourcePage.inUse || sourcePage.allocationCount >
+                                 maximumMoves - int32_t(moves.size())) {
+      continue;
+    }
+
+    // Place the tallest images first, as shelves are packed best that way.
+    std::vector<std::pair<const RasterOverlayTile*, Allocation>> toMove;
+    for (const auto& [pTile, allocation] : this->_allocations) {
+      if (allocation.page == source) {
+        toMove.emplace_back(pTile, allocation);
+      }
+    }
+    std::sort(toMove.begin(), toMove.end(), [](const auto& a, const auto& b) {
+      if (a.second.rectangle.height != b.second.rectangle.height) {
+        return a.second.rectangle.height > b.second.rectangle.height;
+      }
+      return std::make_pair(a.second.rectangle.y, a.second.rectangle.x) <
+             std::make_pair(b.second.rectangle.y, b.second.rectangle.x);
+    });
+
+    std::vector<Allocation> targets;
+    targets.reserve(toMove.size());
+    for (const auto& [pTile, allocation] : toMove) {
+      std::optional<Allocation> maybeTarget;
+      for (size_t i = 0; i < this->_pages.size() && !maybeTarget; ++i) {
+        const Page& page = this->_pages[i];
+        if (int32_t(i) != source && page.inUse &&
+            page.channels == sourcePage.channels &&
+            page.bytesPerChannel == sourcePage.bytesPerChannel) {
+          maybeTarget = this->allocateInPage(
+              int32_t(i),
+              allocation.rectangle.width + this->_padding,
+              allocation.rectangle.height + this->_padding);
+        }
+      }
+
+      if (!maybeTarget) {
+        break;
+      }
+      targets.emplace_back(*maybeTarget);
+    }
+
+    if (targets.size() != toMove.size()) {
+      // The page cannot be emptied, so leave everything where it was.
+      for (const Allocation& target : targets) {
+        this->freeInPage(target);
+      }
+      continue;
+    }
+
+    for (size_t i = 0; i < toMove.size(); ++i) {
+      const RasterOverlayTile* pTile = toMove[i].first;
+      this->freeInPage(toMove[i].second);
+      this->_allocations[pTile] = targets[i];
+      moves.emplace_back(Move{pTile, toMove[i].second, targets[i]});
+    }
+  }
+
+  return moves;
+}
+
+std::vector<int32_t> RasterOverlayTextureAtlas::takeEvictedPages() {
+  std::vector<int32_t> result = std::move(this->_evictedPages);
+  this->_evictedPages.clear();
+  return result;
+}
+
+std::optional<RasterOverlayTextureAtlas::Allocation>
+RasterOverlayTextureAtlas::allocateInPage(
+    int32_t pageIndex,
+    int32_t width,
+    int32_t height) {
+  Page& page = this->_pages[size_t(pageIndex)];
+
+  // Use the shortest shelf that is tall enough and has room.
+  Shelf* pShelf = nullptr;
+  std::vector<Span>::iterator spanIt;
+  for (Shelf& shelf : page.shelves) {
+    if (shelf.height < height ||
+        (pShelf && pShelf->height <= shelf.height)) {
+      continue;
+    }
+
+    auto it = std::find_if(
+        shelf.freeSpans.begin(),
+        shelf.freeSpans.end(),
+        [width](const Span& span) { return span.width >= width; });
+    if (it != shelf.freeSpans.end()) {
+      pShelf = &shelf;
+      spanIt = it;
+    }
+  }
+
+  // Start a new shelf rather than waste most of the height of an existing
+  // one.
+  const bool canAddShelf = page.nextShelfY + height <= this->_pageSize;
+  if (canAddShelf && (!pShelf || pShelf->height > 2 * height)) {
+    Shelf& shelf = page.shelves.emplace_back(
+        Shelf{page.nextShelfY, height, {Span{0, this->_pageSize}}});
+    page.nextShelfY += height;
+    pShelf = &shelf;
+    spanIt = shelf.freeSpans.begin();
+  }
+
+  if (!pShelf) {
+    return std::nullopt;
+  }
+
+  const int32_t x = spanIt->x;
+  spanIt->x += width;
+  spanIt->width -= width;
+  if (spanIt->width == 0) {
+    pShelf->freeSpans.erase(spanIt);
+  }
+
+  const int32_t imageWidth = width - this->_padding;
+  const int32_t imageHeight = height - this->_padding;
+  page.usedPixels += int64_t(imageWidth) * int64_t(imageHeight);
+  ++page.allocationCount;
+
+  return Allocation{
+      pageIndex,
+      PixelRectangle{x, pShelf->y, imageWidth, imageHeight}};
+}
+
+void RasterOverlayTextureAtlas::freeInPage(
+    const Allocation& allocation) noexcept {
+  Page& page = this->_pages[size_t(allocation.page)];
+  const PixelRectangle& rectangle = allocation.rectangle;
+
+  page.usedPixels -= int64_t(rectangle.width) * int64_t(rectangle.height);
+  --page.allocationCount;
+
+  if (page.allocationCount == 0) {
+    // The page is evicted, and will only be reused after the renderer has
+    // been told about it.
+    page.inUse = false;
+    page.shelves.clear();
+    page.nextShelfY = 0;
+    page.usedPixels = 0;
+    this->_evictedPages.emplace_back(allocation.page);
+    return;
+  }
+
+  auto shelfIt = std::find_if(
+      page.shelves.begin(),
+      page.shelves.end(),
+      [&rectangle](const Shelf& shelf) { return shelf.y == rectangle.y; });
+  CESIUM_ASSERT(shelfIt != page.shelves.end());
+
+  // Return the span to the shelf, merging it with its free neighbors.
+  std::vector<Span>& spans = shelfIt->freeSpans;
+  Span freed{rectangle.x, rectangle.width + this->_padding};
+  auto nextIt = std::lower_bound(
+      spans.begin(),
+      spans.end(),
+      freed.x,
+      [](const Span& span, int32_t x) { return span.x < x; });
+  if (nextIt != spans.end() && freed.x + freed.width == nextIt->x) {
+    freed.width += nextIt->width;
+    nextIt = spans.erase(nextIt);
+  }
+  if (nextIt != spans.begin()) {
+    auto previousIt = std::prev(nextIt);
+    if (previousIt->x + previousIt->width == freed.x) {
+      previousIt->width += freed.width;
+      freed.width = 0;
+    }
+  }
+  if (freed.width > 0) {
+    spans.insert(nextIt, freed);
+  }
+
+  // An empty shelf at the top of the page can take any height again.
+  while (!page.shelves.empty()) {
+    const Shelf& last = page.shelves.back();
+    if (last.freeSpans.size() != 1 ||
+        last.freeSpans.front().width != this->_pageSize) {
+      break;
+    }
+    page.nextShelfY = last.y;
+    page.shelves.pop_back();
+  }
+}
+
+std::optional<int32_t>
+RasterOverlayTextureAtlas::addPage(int32_t channels, int32_t bytesPerChannel) {
+  if (this->getNumberOfPagesInUse() >= this->_maximumPages) {
+    return std::nullopt;
+  }
+
+  Page newPage{true, channels, bytesPerChannel, 0, {}, 0, 0};
+
+  // Reuse the index of an evicted page once the renderer has been told that
+  // it was evicted.
+  for (size_t i = 0; i < this->_pages.size(); ++i) {
+    const int32_t index = int32_t(i);
+    if (!this->_pages[i].inUse &&
+        std::find(
+            this->_evictedPages.begin(),
+            this->_evictedPages.end(),
+            index) == this->_evictedPages.end()) {
+      this->_pages[i] = std::move(newPage);
+      return index;
+    }
+  }
+
+  this->_pages.emplace_back(std::move(newPage));
+  return int32_t(this->_pages.size() - 1);
+}
+
+} // namespace CesiumRasterOverlays
@@ -2,6 +2,7 @@
 #include <CesiumAsync/ITaskProcessor.h>
 #include <CesiumRasterOverlays/IPrepareRasterOverlayRendererResources.h>
 #include <CesiumRasterOverlays/RasterOverlay.h>
+#include <CesiumRasterOverlays/RasterOverlayTextureAtlas.h>
 #include <CesiumRasterOverlays/RasterOverlayTile.h>
 #include <CesiumRasterOverlays/RasterOverlayTileProvider.h>
 #include <CesiumUtility/joinToString.h>
@@ -57,6 +58,12 @@ RasterOverlayTile::~RasterOverlayTile() {
         pLoadThreadResult,
         pMainThreadResult);
   }
+
+  const std::shared_ptr<RasterOverlayTextureAtlas>& pTextureAtlas =
+      this->getOverlay().getOptions().pTextureAtlas;
+  if (pTextureAtlas) {
+    pTextureAtlas->release(*this);
+  }
 }
 
 RasterOverlay& RasterOverlayTile::getOverlay() noexcept {
@@ -75,6 +82,14 @@ void RasterOverlayTile::loadInMainThread() {
     return;
   }
 
+  // Place the image in the texture atlas, if there is one, so that the
+  // renderer can copy it there.
+  const std::shared_ptr<RasterOverlayTextureAtlas>& pTextureAtlas =
+      this->getOverlay().getOptions().pTextureAtlas;
+  if (pTextureAtlas) {
+    pTextureAtlas->allocate(*this, this->_image);
+  }
+
   // Do the final main thread raster loading
   RasterOverlayTileProvider& tileProvider = *this->_pTileProvider;
   this->_pRendererResources =
@@ -0,0 +1,203 @@
+#include "CesiumRasterOverlays/DebugColorizeTilesRasterOverlay.h"
+#include "CesiumRasterOverlays/RasterOverlayTextureAtlas.h"
+#include "CesiumRasterOverlays/RasterOverlayTile.h"
+#include "CesiumRasterOverlays/RasterOverlayTileProvider.h"
+
+#include <CesiumNativeTests/SimpleAssetAccessor.h>
+#include <CesiumNativeTests/SimpleTaskProcessor.h>
+
+#include <catch2/catch.hpp>
+
+#include <map>
+#include <optional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace CesiumAsync;
+using namespace CesiumGltf;
+using namespace CesiumUtility;
+using namespace CesiumNativeTests;
+using namespace CesiumRasterOverlays;
+
+namespace {
+
+ImageCesium createImage(int32_t width, int32_t height, int32_t channels = 4) {
+  ImageCesium image;
+  image.width = width;
+  image.height = height;
+  image.channels = channels;
+  image.bytesPerChannel = 1;
+  image.pixelData.resize(size_t(width * height * channels));
+  return image;
+}
+
+bool overlaps(
+    const RasterOverlayTextureAtlas::Allocation& a,
+    const RasterOverlayTextureAtlas::Allocation& b) {
+  return a.page == b.page &&
+         a.rectangle.x < b.rectangle.x + b.rectangle.width &&
+         b.rectangle.x < a.rectangle.x + a.rectangle.width &&
+         a.rectangle.y < b.rectangle.y + b.rectangle.height &&
+         b.rectangle.y < a.rectangle.y + a.rectangle.height;
+}
+
+} // namespace
+
+TEST_CASE("Test RasterOverlayTextureAtlas") {
+  AsyncSystem asyncSystem(std::make_shared<SimpleTaskProcessor>());
+  auto pAssetAccessor = std::make_shared<SimpleAssetAccessor>(
+      std::map<std::string, std::shared_ptr<SimpleAssetRequest>>());
+
+  auto pAtlas = std::make_shared<RasterOverlayTextureAtlas>(256, 2, 1);
+
+  RasterOverlayOptions options;
+  options.pTextureAtlas = pAtlas;
+  IntrusivePointer<DebugColorizeTilesRasterOverlay> pOverlay =
+      new DebugColorizeTilesRasterOverlay("test", options);
+  IntrusivePointer<RasterOverlayTileProvider> pProvider =
+      pOverlay->createPlaceholder(asyncSystem, pAssetAccessor);
+
+  SECTION("packs images into a page without overlap") {
+    std::vector<std::unique_ptr<RasterOverlayTile>> tiles;
+    std::vector<RasterOverlayTextureAtlas::Allocation> allocations;
+    for (int32_t i = 0; i < 12; ++i) {
+      tiles.emplace_back(std::make_unique<RasterOverlayTile>(*pProvider));
+      std::optional<RasterOverlayTextureAtlas::Allocation> maybeAllocation =
+          pAtlas->allocate(*tiles.back(), createImage(63, 63 - i));
+      REQUIRE(maybeAllocation);
+      CHECK(maybeAllocation->rectangle.width == 63);
+      CHECK(maybeAllocation->rectangle.height == 63 - i);
+      allocations.emplace_back(*maybeAllocation);
+    }
+
+    CHECK(pAtlas->getNumberOfPagesInUse() == 1);
+    for (size_t i = 0; i < allocations.size(); ++i) {
+      CHECK(allocations[i].page == allocations[0].page);
+      CHECK(
+          allocations[i].rectangle.x + allocations[i].rectangle.width <= 256);
+      CHECK(
+          allocations[i].rectangle.y + allocations[i].rectangle.height <= 256);
+      for (size_t j = i + 1; j < allocations.size(); ++j) {
+        CHECK(!overlaps(allocations[i], allocations[j]));
+      }
+    }
+
+    // Asking again returns the same rectangle.
+    const RasterOverlayTextureAtlas::Allocation* pAllocation =
+        pAtlas->getAllocation(*tiles[3]);
+    REQUIRE(pAllocation);
+    std::optional<RasterOverlayTextureAtlas::Allocation> maybeAgain =
+        pAtlas->allocate(*tiles[3], createImage(63, 60));
+    REQUIRE(maybeAgain);
+    CHECK(maybeAgain->page == pAllocation->page);
+    CHECK(maybeAgain->rectangle.x == pAllocation->rectangle.x);
+    CHECK(maybeAgain->rectangle.y == pAllocation->rectangle.y);
+  }
+
+  SECTION("keeps images of different formats in different pages") {
+    RasterOverlayTile rgba(*pProvider);
+    RasterOverlayTile rgb(*pProvider);
+    std::optional<RasterOverlayTextureAtlas::Allocation> maybeRgba =
+        pAtlas->allocate(rgba, createImage(32, 32, 4));
+    std::optional<RasterOverlayTextureAtlas::Allocation> maybeRgb =
+        pAtlas->allocate(rgb, createImage(32, 32, 3));
+    REQUIRE(maybeRgba);
+    REQUIRE(maybeRgb);
+    CHECK(maybeRgba->page != maybeRgb->page);
+    CHECK(pAtlas->getNumberOfPagesInUse() == 2);
+
+    // Both pages are in use, so a third format does not fit.
+    RasterOverlayTile gray(*pProvider);
+    CHECK(!pAtlas->allocate(gray, createImage(32, 32, 1)));
+  }
+
+  SECTION("does not place images that cannot be copied into a page") {
+    RasterOverlayTile tile(*pProvider);
+    CHECK(!pAtlas->allocate(tile, createImage(256, 16)));
+
+    ImageCesium compressed = createImage(16, 16);
+    compressed.compressedPixelFormat = GpuCompressedPixelFormat::ETC1_RGB;
+    CHECK(!pAtlas->allocate(tile, compressed));
+
+    ImageCesium mipmapped = createImage(16, 16);
+    mipmapped.mipPositions.emplace_back(ImageCesiumMipPosition{0, 1024});
+    CHECK(!pAtlas->allocate(tile, mipmapped));
+
+    CHECK(pAtlas->getAllocation(tile) == nullptr);
+    CHECK(pAtlas->getNumberOfPagesInUse() == 0);
+  }
+
+  SECTION("evicts a page when its last image is released") {
+    std::optional<int32_t> page;
+    {
+      RasterOverlayTile first(*pProvider);
+      RasterOverlayTile second(*pProvider);
+      std::optional<RasterOverlayTextureAtlas::Allocation> maybeFirst =
+          pAtlas->allocate(first, createImage(100, 100));
+      REQUIRE(maybeFirst);
+      REQUIRE(pAtlas->allocate(second, createImage(100, 100)));
+      page = maybeFirst->page;
+      CHECK(pAtlas->getUsedPixels(*page) == 2 * 100 * 100);
+
+      pAtlas->release(first);
+      CHECK(pAtlas->getAllocation(first) == nullptr);
+      CHECK(pAtlas->getUsedPixels(*page) == 100 * 100);
+      CHECK(pAtlas->takeEvictedPages().empty());
+
+      // The second tile is released when it is destroyed.
+    }
+
+    CHECK(pAtlas->getNumberOfPagesInUse() == 0);
+    std::vector<int32_t> evicted = pAtlas->takeEvictedPages();
+    REQUIRE(evicted.size() == 1);
+    CHECK(evicted[0] == *page);
+    CHECK(pAtlas->takeEvictedPages().empty());
+  }
+
+  SECTION("defragments by emptying the least used page") {
+    std::vector<std::unique_ptr<RasterOverlayTile>> tiles;
+    for (int32_t i = 0; i < 8; ++i) {
+      tiles.emplace_back(std::make_unique<RasterOverlayTile>(*pProvider));
+      REQUIRE(pAtlas->allocate(*tiles.back(), createImage(127, 63)));
+    }
+    CHECK(pAtlas->getNumberOfPagesInUse() == 1);
+
+    // The first page is full, so this image starts a second one.
+    RasterOverlayTile large(*pProvider);
+    std::optional<RasterOverlayTextureAtlas::Allocation> maybeLarge =
+        pAtlas->allocate(large, createImage(150, 150));
+    REQUIRE(maybeLarge);
+    CHECK(pAtlas->getNumberOfPagesInUse() == 2);
+    const int32_t largePage = maybeLarge->page;
+
+    // Free most of the first page, which is then the least used one.
+    for (size_t i = 2; i < tiles.size(); ++i) {
+      tiles[i].reset();
+    }
+    CHECK(pAtlas->getUsedPixels(largePage) > pAtlas->getUsedPixels(0));
+
+    // One move is not enough to empty the first page, so the second page is
+    // emptied instead.
+    std::vector<RasterOverlayTextureAtlas::Move> moves =
+        pAtlas->defragment(1);
+    REQUIRE(moves.size() == 1);
+    CHECK(moves[0].pTile == &large);
+    CHECK(moves[0].from.page == largePage);
+    CHECK(moves[0].to.page != largePage);
+    CHECK(pAtlas->getNumberOfPagesInUse() == 1);
+
+    const RasterOverlayTextureAtlas::Allocation* pAllocation =
+        pAtlas->getAllocation(large);
+    REQUIRE(pAllocation);
+    CHECK(pAllocation->page == moves[0].to.page);
+    CHECK(!overlaps(*pAllocation, *pAtlas->getAllocation(*tiles[0])));
+    CHECK(!overlaps(*pAllocation, *pAtlas->getAllocation(*tiles[1])));
+
+    std::vector<int32_t> evicted = pAtlas->takeEvictedPages();
+    REQUIRE(evicted.size() == 1);
+    CHECK(evicted[0] == largePage);
+
+    CHECK(pAtlas->defragment(10).empty());
+  }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace CesiumUtility {
+
+/**
+ * @brief An allocator that allocates like `std::allocator`, and counts the
+ * allocations it makes.
+ *
+ * The count is kept in a variable given to the allocator, so that all of the
+ * containers that share the variable are counted together. This lets the
+ * owner of containers that are reused over and over check that they no
+ * longer allocate once they have grown to size. An allocator created without
+ * a variable does not count.
+ *
+ * All instances allocate from the same heap and compare equal, so containers
+ * can exchange their storage whatever they count in. A container keeps its own
+ * allocator, and so its own count, when another container is moved or copied
+ * into it.
+ *
+ * @tparam T The type of the elements to allocate.
+ */
+template <typename T> class CountingAllocator {
+public:
+  /** @brief The type of the elements to allocate. */
+  using value_type = T;
+
+  /** @brief All instances compare equal. */
+  using is_always_equal = std::true_type;
+
+  /**
+   * @brief Creates an allocator that does not count its allocations.
+   */
+  CountingAllocator() noexcept : _pCount(nullptr) {}
+
+  /**
+   * @brief Creates an allocator that counts its allocations in the given
+   * variable.
+   *
+   * @param pCount The variable to increment on every allocation, which must
+   * outlive the allocator and its copies, or nullptr to not count.
+   */
+  explicit CountingAllocator(size_t* pCount) noexcept : _pCount(pCount) {}
+
+  /**
+   * @brief Creates an allocator of another type of element that counts in
+   * the same variable as the given one.
+   */
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U>& rhs) noexcept
+      : _pCount(rhs.getCount()) {}
+
+  /**
+   * @brief Gets the variable in which the allocations are counted, or nullptr
+   * if they are not counted.
+   */
+  size_t* getCount() const noexcept { return this->_pCount; }
+
+  /**
+   * @brief Allocates storage for the given number of elements, and counts the
+   * allocation.
+   */
+  T* allocate(size_t n) {
+    T* p = std::allocator<T>().allocate(n);
+    if (this->_pCount) {
+      ++*this->_pCount;
+    }
+    return p;
+  }
+
+  /**
+   * @brief Frees storage allocated by any `CountingAllocator` of the same
+   * type of element.
+   */
+  void deallocate(T* p, size_t n) noexcept {
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  /** @brief Returns true, since all instances compare equal. */
+  template <typename U>
+  bool operator==(const CountingAllocator<U>&) const noexcept {
+    return true;
+  }
+
+  /** @brief Returns false, since all instances compare equal. */
+  template <typename U>
+  bool operator!=(const CountingAllocator<U>&) const noexcept {
+    return false;
+  }
+
+private:
+  size_t* _pCount;
+};
+
+/**
+ * @brief A `std::vector` whose allocations are counted by a
+ * {@link CountingAllocator}.
+ */
+template <typename T>
+using CountingVector = std::vector<T, CountingAllocator<T>>;
+
+} // namespace CesiumUtility
@@ -2,6 +2,7 @@
 
 #include "Library.h"
 
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -89,12 +90,11 @@ public:
    * @brief Get the credits that were shown last frame but should no longer be
    * shown.
    */
-  const std::vector<Credit>&
-  getCreditsToNoLongerShowThisFrame() const noexcept {
-    return _creditsToNoLongerShowThisFrame;
-  }
+  const std::vector<Credit>& getCreditsToNoLongerShowThisFrame() const noexcept;
 
 private:
+  std::optional<size_t> findCredit(const std::string& html) const noexcept;
+
   const std::string INVALID_CREDIT_MESSAGE =
       "Error: Invalid Credit, cannot get HTML string.";
 
@@ -107,8 +107,17 @@ private:
 
   std::vector<HtmlAndLastFrameNumber> _credits;
 
+  // The IDs of the credits, by the hash of their HTML string, so that
+  // creating a credit does not need to compare it to every other credit.
+  std::unordered_multimap<size_t, size_t> _creditIdsByHtmlHash;
+
   int32_t _currentFrameNumber = 0;
   std::vector<Credit> _creditsToShowThisFrame;
-  std::vector<Credit> _creditsToNoLongerShowThisFrame;
+
+  // The credits shown last frame. The ones that are shown again this frame
+  // are only removed when the list is requested, so that adding a credit to
+  // the frame takes constant time.
+  mutable std::vector<Credit> _creditsToNoLongerShowThisFrame;
+  mutable bool _creditsToNoLongerShowAreStale = false;
 };
 } // namespace CesiumUtility
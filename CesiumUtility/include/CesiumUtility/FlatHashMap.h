@@ -0,0 +1,128 @@
+#pragma once
+
+#include <CesiumUtility/FlatHashTable.h>
+
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace CesiumUtility {
+
+/**
+ * @brief A map from unique keys to values that stores its key-value pairs in a
+ * single array with open addressing, rather than in separately allocated
+ * nodes like in a `std::unordered_map`.
+ *
+ * This is well suited to maps with small keys and values that are updated
+ * often, because clearing the map keeps its storage. See
+ * {@link FlatHashTable} for the rules on iterator invalidation.
+ *
+ * @tparam TKey The type of the keys.
+ * @tparam TValue The type of the values.
+ * @tparam THash The hash function of the keys.
+ * @tparam TEqual The equality comparison of the keys.
+ */
+template <
+    typename TKey,
+    typename TValue,
+    typename THash = std::hash<TKey>,
+    typename TEqual = std::equal_to<TKey>>
+class FlatHashMap final : public FlatHashTable<
+                              std::pair<const TKey, TValue>,
+                              TKey,
+                              CesiumImpl::FlatHashMapKey,
+                              THash,
+                              TEqual> {
+private:
+  using Base = FlatHashTable<
+      std::pair<const TKey, TValue>,
+      TKey,
+      CesiumImpl::FlatHashMapKey,
+      THash,
+      TEqual>;
+
+public:
+  /** @brief The type of the keys. */
+  using key_type = TKey;
+  /** @brief The type of the values. */
+  using mapped_type = TValue;
+  /** @brief The type of the key-value pairs. */
+  using value_type = std::pair<const TKey, TValue>;
+
+  /**
+   * @brief Inserts a key-value pair unless the key is in the map already.
+   *
+   * @return An iterator to the pair with the key, and whether it was
+   * inserted.
+   */
+  std::pair<typename Base::iterator, bool> insert(const value_type& value) {
+    return this->emplaceWithKey(value.first, value);
+  }
+
+  /**
+   * @brief Inserts a value constructed from the given arguments unless the
+   * key is in the map already, in which case the arguments are not used.
+   *
+   * @return An iterator to the pair with the key, and whether it was
+   * inserted.
+   */
+  template <typename... TArgs>
+  std::pair<typename Base::iterator, bool>
+  try_emplace(const TKey& key, TArgs&&... args) {
+    return this->emplaceWithKey(
+        key,
+        std::piecewise_construct,
+        std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<TArgs>(args)...));
+  }
+
+  /**
+   * @brief Sets the value of a key, inserting the key if it is not in the map
+   * yet.
+   *
+   * @return An iterator to the pair with the key, and whether it was
+   * inserted.
+   */
+  template <typename T>
+  std::pair<typename Base::iterator, bool>
+  insert_or_assign(const TKey& key, T&& value) {
+    auto result = this->try_emplace(key, std::forward<T>(value));
+    if (!result.second) {
+      result.first->second = std::forward<T>(value);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Gets the value of a key, inserting a default-constructed value if
+   * the key is not in the map yet.
+   */
+  TValue& operator[](const TKey& key) {
+    return this->try_emplace(key).first->second;
+  }
+
+  /**
+   * @brief Gets the value of a key.
+   *
+   * @throws std::out_of_range If the key is not in the map.
+   */
+  TValue& at(const TKey& key) {
+    auto it = this->find(key);
+    if (it == this->end()) {
+      throw std::out_of_range("The key is not in the map.");
+    }
+    return it->second;
+  }
+
+  /** @copydoc at */
+  const TValue& at(const TKey& key) const {
+    auto it = this->find(key);
+    if (it == this->end()) {
+      throw std::out_of_range("The key is not in the map.");
+    }
+    return it->second;
+  }
+};
+
+} // namespace CesiumUtility
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <CesiumUtility/FlatHashTable.h>
+
+#include <functional>
+#include <utility>
+
+namespace CesiumUtility {
+
+/**
+ * @brief A set of unique values that are stored in a single array with open
+ * addressing, rather than in separately allocated nodes like in a
+ * `std::unordered_set`.
+ *
+ * This is well suited to sets of small values, such as pointers and IDs, that
+ * are filled and emptied often, because clearing the set keeps its storage.
+ * See {@link FlatHashTable} for the rules on iterator invalidation.
+ *
+ * @tparam T The type of the values.
+ * @tparam THash The hash function of the values.
+ * @tparam TEqual The equality comparison of the values.
+ */
+template <
+    typename T,
+    typename THash = std::hash<T>,
+    typename TEqual = std::equal_to<T>>
+class FlatHashSet final
+    : public FlatHashTable<T, T, CesiumImpl::FlatHashSetKey, THash, TEqual> {
+private:
+  using Base = FlatHashTable<T, T, CesiumImpl::FlatHashSetKey, THash, TEqual>;
+
+public:
+  /** @brief The type of the values. */
+  using value_type = T;
+  /** @brief The type of the values. */
+  using key_type = T;
+
+  /**
+   * @brief Inserts a value unless it is in the set already.
+   *
+   * @return An iterator to the value in the set, and whether it was inserted.
+   */
+  std::pair<typename Base::iterator, bool> insert(const T& value) {
+    return this->emplaceWithKey(value, value);
+  }
+
+  /** @copydoc insert */
+  std::pair<typename Base::iterator, bool> insert(T&& value) {
+    // The value is only moved if it is not in the set already.
+    return this->emplaceWithKey(value, std::move(value));
+  }
+};
+
+} // namespace CesiumUtility
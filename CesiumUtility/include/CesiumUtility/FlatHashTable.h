@@ -0,0 +1,467 @@
+#pragma once
+
+#include <CesiumUtility/Assert.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CesiumUtility {
+
+namespace CesiumImpl {
+// Begin omitting doxgen warnings for Impl namespace
+//! @cond Doxygen_Suppress
+
+// Gets the key of an element of a FlatHashSet, which is the element itself.
+struct FlatHashSetKey {
+  template <typename T> const T& operator()(const T& value) const noexcept {
+    return value;
+  }
+};
+
+// Gets the key of an element of a FlatHashMap.
+struct FlatHashMapKey {
+  template <typename TPair>
+  const typename TPair::first_type&
+  operator()(const TPair& value) const noexcept {
+    return value.first;
+  }
+};
+
+//! @endcond
+// End omitting doxgen warnings for Impl namespace
+} // namespace CesiumImpl
+
+/**
+ * @brief The hash table shared by {@link FlatHashSet} and
+ * {@link FlatHashMap}.
+ *
+ * The elements are stored in a single array and found by linear probing, so
+ * inserting an element only allocates when the table grows, and clearing the
+ * table keeps its capacity. Erased elements leave a marker that is reused by
+ * later insertions and dropped when the table is rehashed, so erasing while
+ * iterating visits every other element exactly once.
+ *
+ * Inserting an element may invalidate all iterators and references. Erasing
+ * an element only invalidates iterators and references to it.
+ *
+ * @tparam TValue The type of the stored elements.
+ * @tparam TKey The type of the keys of the elements.
+ * @tparam TKeyOf A function object that gets the key of an element.
+ * @tparam THash The hash function of the keys.
+ * @tparam TEqual The equality comparison of the keys.
+ */
+template <
+    typename TValue,
+    typename TKey,
+    typename TKeyOf,
+    typename THash,
+    typename TEqual>
+class FlatHashTable {
+private:
+  enum class SlotState : uint8_t { Empty, Full, Erased };
+
+  template <typename TTable, typename TElement> class Iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = TValue;
+    using difference_type = std::ptrdiff_t;
+    using pointer = TElement*;
+    using reference = TElement&;
+
+    Iterator() noexcept : _pTable(nullptr), _index(0) {}
+
+    Iterator(TTable* pTable, size_t index) noexcept
+        : _pTable(pTable), _index(index) {
+      this->skipToFull();
+    }
+
+    template <
+        typename TOtherElement,
+        typename = std::enable_if_t<
+            std::is_convertible_v<TOtherElement*, TElement*>>>
+    Iterator(const Iterator<
+             std::remove_const_t<TTable>,
+             TOtherElement>& rhs) noexcept
+        : _pTable(rhs._pTable), _index(rhs._index) {}
+
+    reference operator*() const noexcept {
+      return this->_pTable->_pSlots[this->_index];
+    }
+
+    pointer operator->() const noexcept {
+      return &this->_pTable->_pSlots[this->_index];
+    }
+
+    Iterator& operator++() noexcept {
+      ++this->_index;
+      this->skipToFull();
+      return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+      Iterator result = *this;
+      ++*this;
+      return result;
+    }
+
+    bool operator==(const Iterator& rhs) const noexcept {
+      return this->_index == rhs._index;
+    }
+
+    bool operator!=(const Iterator& rhs) const noexcept {
+      return this->_index != rhs._index;
+    }
+
+  private:
+    void skipToFull() noexcept {
+      while (this->_index < this->_pTable->_states.size() &&
+             this->_pTable->_states[this->_index] != SlotState::Full) {
+        ++this->_index;
+      }
+    }
+
+    TTable* _pTable;
+    size_t _index;
+
+    template <typename, typename> friend class Iterator;
+    friend class FlatHashTable;
+  };
+
+public:
+  /**
+   * @brief An iterator over the elements.
+   */
+  using iterator = Iterator<FlatHashTable, TValue>;
+
+  /**
+   * @brief An iterator over the elements that does not allow them to be
+   * modified.
+   */
+  using const_iterator = Iterator<const FlatHashTable, const TValue>;
+
+  /**
+   * @brief Creates an empty table, which does not allocate.
+   */
+  FlatHashTable() noexcept : _pSlots(nullptr), _states(), _size(0), _used(0) {}
+
+  /**
+   * @brief Copies another table.
+   */
+  FlatHashTable(const FlatHashTable& rhs) : FlatHashTable() {
+    this->reserve(rhs._size);
+    for (const TValue& value : rhs) {
+      this->insertUnique(value);
+    }
+  }
+
+  /**
+   * @brief Moves another table, which is left empty.
+   */
+  FlatHashTable(FlatHashTable&& rhs) noexcept
+      : _pSlots(std::exchange(rhs._pSlots, nullptr)),
+        _states(std::move(rhs._states)),
+        _size(std::exchange(rhs._size, 0)),
+        _used(std::exchange(rhs._used, 0)) {
+    rhs._states.clear();
+  }
+
+  ~FlatHashTable() noexcept { this->release(); }
+
+  /**
+   * @brief Copies another table into this one.
+   */
+  FlatHashTable& operator=(const FlatHashTable& rhs) {
+    if (this != &rhs) {
+      this->clear();
+      this->reserve(rhs._size);
+      for (const TValue& value : rhs) {
+        this->insertUnique(value);
+      }
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Moves another table into this one, leaving the other one empty.
+   */
+  FlatHashTable& operator=(FlatHashTable&& rhs) noexcept {
+    if (this != &rhs) {
+      this->release();
+      this->_pSlots = std::exchange(rhs._pSlots, nullptr);
+      this->_states = std::move(rhs._states);
+      this->_size = std::exchange(rhs._size, 0);
+      this->_used = std::exchange(rhs._used, 0);
+      rhs._states.clear();
+    }
+    return *this;
+  }
+
+  /** @brief Gets an iterator to the first element. */
+  iterator begin() noexcept { return iterator(this, 0); }
+  /** @brief Gets an iterator past the last element. */
+  iterator end() noexcept { return iterator(this, this->_states.size()); }
+  /** @brief Gets an iterator to the first element. */
+  const_iterator begin() const noexcept { return const_iterator(this, 0); }
+  /** @brief Gets an iterator past the last element. */
+  const_iterator end() const noexcept {
+    return const_iterator(this, this->_states.size());
+  }
+
+  /** @brief Determines if the table has no elements. */
+  bool empty() const noexcept { return this->_size == 0; }
+
+  /** @brief Gets the number of elements. */
+  size_t size() const noexcept { return this->_size; }
+
+  /**
+   * @brief Gets the number of elements that fit in the table before it needs
+   * to grow.
+   */
+  size_t capacity() const noexcept {
+    return maximumUsed(this->_states.size());
+  }
+
+  /**
+   * @brief Removes all elements, keeping the allocated storage.
+   */
+  void clear() noexcept {
+    for (size_t i = 0; i < this->_states.size(); ++i) {
+      if (this->_states[i] == SlotState::Full) {
+        this->_pSlots[i].~TValue();
+      }
+      this->_states[i] = SlotState::Empty;
+    }
+    this->_size = 0;
+    this->_used = 0;
+  }
+
+  /**
+   * @brief Makes room for at least the given number of elements.
+   */
+  void reserve(size_t count) {
+    if (count > this->capacity()) {
+      this->rehash(count);
+    }
+  }
+
+  /**
+   * @brief Finds the element with the given key.
+   *
+   * @return An iterator to the element, or {@link end} if there is none.
+   */
+  iterator find(const TKey& key) noexcept {
+    return iterator(this, this->findIndex(key));
+  }
+
+  /** @copydoc find */
+  const_iterator find(const TKey& key) const noexcept {
+    return const_iterator(this, this->findIndex(key));
+  }
+
+  /**
+   * @brief Counts the elements with the given key, which is zero or one.
+   */
+  size_t count(const TKey& key) const noexcept {
+    return this->contains(key) ? 1 : 0;
+  }
+
+  /**
+   * @brief Determines if the table has an element with the given key.
+   */
+  bool contains(const TKey& key) const noexcept {
+    return this->findIndex(key) != this->_states.size();
+  }
+
+  /**
+   * @brief Erases the element at the given position.
+   *
+   * @return An iterator to the next element.
+   */
+  iterator erase(iterator position) noexcept {
+    return this->erase(const_iterator(position));
+  }
+
+  /** @copydoc erase(iterator) */
+  iterator erase(const_iterator position) noexcept {
+    CESIUM_ASSERT(position._pTable == this);
+    CESIUM_ASSERT(this->_states[position._index] == SlotState::Full);
+    this->eraseIndex(position._index);
+    return iterator(this, position._index + 1);
+  }
+
+  /**
+   * @brief Erases the element with the given key, if there is one.
+   *
+   * @return The number of elements erased, which is zero or one.
+   */
+  size_t erase(const TKey& key) noexcept {
+    const size_t index = this->findIndex(key);
+    if (index == this->_states.size()) {
+      return 0;
+    }
+    this->eraseIndex(index);
+    return 1;
+  }
+
+protected:
+  /**
+   * @brief Inserts an element constructed from the given arguments unless an
+   * element with the given key exists already.
+   *
+   * @return An iterator to the element with the key, and whether it was
+   * inserted.
+   */
+  template <typename... TArgs>
+  std::pair<iterator, bool> emplaceWithKey(const TKey& key, TArgs&&... args) {
+    size_t index = this->findIndex(key);
+    if (index != this->_states.size()) {
+      return std::make_pair(iterator(this, index), false);
+    }
+
+    if (this->_used + 1 > this->capacity()) {
+      this->rehash(this->_size + 1);
+    }
+
+    index = this->findInsertIndex(key);
+    new (&this->_pSlots[index]) TValue(std::forward<TArgs>(args)...);
+    if (this->_states[index] == SlotState::Empty) {
+      ++this->_used;
+    }
+    this->_states[index] = SlotState::Full;
+    ++this->_size;
+
+    return std::make_pair(iterator(this, index), true);
+  }
+
+private:
+  static constexpr size_t MinimumSlots = 8;
+
+  // At most seven eighths of the slots are used, including erased ones, so
+  // that probe sequences stay short.
+  static constexpr size_t maximumUsed(size_t slots) noexcept {
+    return slots - slots / 8;
+  }
+
+  // Spreads the bits of the hash, as hashes of pointers and integers are
+  // often the values themselves, whose low bits alone make poor indices.
+  static size_t mix(size_t hash) noexcept {
+    uint64_t h = uint64_t(hash);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return size_t(h);
+  }
+
+  size_t startIndex(const TKey& key) const noexcept {
+    return mix(THash()(key)) & (this->_states.size() - 1);
+  }
+
+  size_t findIndex(const TKey& key) const noexcept {
+    const size_t slots = this->_states.size();
+    if (this->_size == 0) {
+      return slots;
+    }
+
+    for (size_t index = this->startIndex(key);;
+         index = (index + 1) & (slots - 1)) {
+      switch (this->_states[index]) {
+      case SlotState::Empty:
+        return slots;
+      case SlotState::Full:
+        if (TEqual()(TKeyOf()(this->_pSlots[index]), key)) {
+          return index;
+        }
+        break;
+      case SlotState::Erased:
+        break;
+      }
+    }
+  }
+
+  // Finds the slot in which to insert a key that is not in the table. There
+  // is always an empty slot, because the table is never entirely used.
+  size_t findInsertIndex(const TKey& key) const noexcept {
+    const size_t slots = this->_states.size();
+    size_t index = this->startIndex(key);
+    while (this->_states[index] == SlotState::Full) {
+      index = (index + 1) & (slots - 1);
+    }
+    return index;
+  }
+
+  void insertUnique(const TValue& value) {
+    const size_t index = this->findInsertIndex(TKeyOf()(value));
+    new (&this->_pSlots[index]) TValue(value);
+    this->_states[index] = SlotState::Full;
+    ++this->_size;
+    ++this->_used;
+  }
+
+  void eraseIndex(size_t index) noexcept {
+    this->_pSlots[index].~TValue();
+    this->_states[index] = SlotState::Erased;
+    --this->_size;
+  }
+
+  // Moves the elements into new storage with room for at least the given
+  // number of elements, dropping the markers of erased elements.
+  void rehash(size_t count) {
+    size_t slots = MinimumSlots;
+    while (maximumUsed(slots) < count) {
+      slots *= 2;
+    }
+
+    // Only grow if live elements, rather than erased ones, fill the table.
+    if (slots < this->_states.size()) {
+      slots = this->_states.size();
+    }
+
+    std::allocator<TValue> allocator;
+    TValue* pNewSlots = allocator.allocate(slots);
+    std::vector<SlotState> newStates(slots, SlotState::Empty);
+
+    TValue* pOldSlots = std::exchange(this->_pSlots, pNewSlots);
+    std::vector<SlotState> oldStates =
+        std::exchange(this->_states, std::move(newStates));
+    this->_size = 0;
+    this->_used = 0;
+
+    for (size_t i = 0; i < oldStates.size(); ++i) {
+      if (oldStates[i] == SlotState::Full) {
+        const size_t index = this->findInsertIndex(TKeyOf()(pOldSlots[i]));
+        new (&this->_pSlots[index]) TValue(std::move_if_noexcept(pOldSlots[i]));
+        this->_states[index] = SlotState::Full;
+        ++this->_size;
+        ++this->_used;
+        pOldSlots[i].~TValue();
+      }
+    }
+
+    if (pOldSlots) {
+      allocator.deallocate(pOldSlots, oldStates.size());
+    }
+  }
+
+  void release() noexcept {
+    this->clear();
+    if (this->_pSlots) {
+      std::allocator<TValue>().deallocate(this->_pSlots, this->_states.size());
+      this->_pSlots = nullptr;
+    }
+    this->_states.clear();
+  }
+
+  TValue* _pSlots;
+  std::vector<SlotState> _states;
+  size_t _size;
+  size_t _used;
+};
+
+} // namespace CesiumUtility
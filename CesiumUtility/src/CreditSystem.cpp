@@ -1,24 +1,34 @@
 #include <CesiumUtility/CreditSystem.h>
 
 #include <algorithm>
+#include <functional>
+#include <optional>
 
 namespace CesiumUtility {
 
 Credit CreditSystem::createCredit(const std::string& html, bool showOnScreen) {
+  const std::optional<size_t> maybeId = this->findCredit(html);
+  if (maybeId) {
+    // Override the existing credit's showOnScreen value.
+    _credits[*maybeId].showOnScreen = showOnScreen;
+    return Credit(*maybeId);
+  }
+
   return this->createCredit(std::string(html), showOnScreen);
 }
 
 Credit CreditSystem::createCredit(std::string&& html, bool showOnScreen) {
   // if this credit already exists, return a Credit handle to it
-  for (size_t id = 0; id < _credits.size(); ++id) {
-    if (_credits[id].html == html) {
-      // Override the existing credit's showOnScreen value.
-      _credits[id].showOnScreen = showOnScreen;
-      return Credit(id);
-    }
+  const std::optional<size_t> maybeId = this->findCredit(html);
+  if (maybeId) {
+    // Override the existing credit's showOnScreen value.
+    _credits[*maybeId].showOnScreen = showOnScreen;
+    return Credit(*maybeId);
   }
 
+  const size_t hash = std::hash<std::string>{}(html);
   _credits.push_back({std::move(html), showOnScreen, -1, 0});
+  _creditIdsByHtmlHash.emplace(hash, _credits.size() - 1);
 
   return Credit(_credits.size() - 1);
 }
@@ -54,23 +64,36 @@ void CreditSystem::addCreditToFrame(Credit credit) {
   // add the credit to this frame
   _creditsToShowThisFrame.push_back(credit);
 
-  // if the credit was shown last frame, remove it from
+  // if the credit was shown last frame, it needs to be removed from
   // _creditsToNoLongerShowThisFrame since it will still be shown
   if (_credits[credit.id].lastFrameNumber == _currentFrameNumber - 1) {
+    _creditsToNoLongerShowAreStale = true;
+  }
+
+  // update the last frame this credit was shown
+  _credits[credit.id].lastFrameNumber = _currentFrameNumber;
+}
+
+const std::vector<Credit>&
+CreditSystem::getCreditsToNoLongerShowThisFrame() const noexcept {
+  if (_creditsToNoLongerShowAreStale) {
     _creditsToNoLongerShowThisFrame.erase(
-        std::remove(
+        std::remove_if(
             _creditsToNoLongerShowThisFrame.begin(),
             _creditsToNoLongerShowThisFrame.end(),
-            credit),
+            [this](const Credit& credit) {
+              return _credits[credit.id].lastFrameNumber ==
+                     _currentFrameNumber;
+            }),
         _creditsToNoLongerShowThisFrame.end());
+    _creditsToNoLongerShowAreStale = false;
   }
-
-  // update the last frame this credit was shown
-  _credits[credit.id].lastFrameNumber = _currentFrameNumber;
+  return _creditsToNoLongerShowThisFrame;
 }
 
 void CreditSystem::startNextFrame() noexcept {
   _creditsToNoLongerShowThisFrame.swap(_creditsToShowThisFrame);
+  _creditsToNoLongerShowAreStale = false;
   _creditsToShowThisFrame.clear();
   _currentFrameNumber++;
   for (const auto& credit : _creditsToNoLongerShowThisFrame) {
@@ -96,4 +119,16 @@ const std::vector<Credit>& CreditSystem::getCreditsToShowThisFrame() noexcept {
       });
   return _creditsToShowThisFrame;
 }
+
+std::optional<size_t>
+CreditSystem::findCredit(const std::string& html) const noexcept {
+  const size_t hash = std::hash<std::string>{}(html);
+  auto range = _creditIdsByHtmlHash.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (_credits[it->second].html == html) {
+      return it->second;
+    }
+  }
+  return std::nullopt;
+}
 } // namespace CesiumUtility
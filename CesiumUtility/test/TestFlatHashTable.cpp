@@ -0,0 +1,117 @@
+#include "CesiumUtility/FlatHashMap.h"
+#include "CesiumUtility/FlatHashSet.h"
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace CesiumUtility;
+
+TEST_CASE("FlatHashSet") {
+  FlatHashSet<uint64_t> set;
+  CHECK(set.empty());
+  CHECK(set.begin() == set.end());
+
+  SECTION("inserts, finds, and erases values") {
+    CHECK(set.insert(1).second);
+    CHECK(set.insert(2).second);
+    CHECK(!set.insert(1).second);
+    CHECK(set.size() == 2);
+    CHECK(set.contains(1));
+    CHECK(set.count(2) == 1);
+    CHECK(set.find(3) == set.end());
+
+    CHECK(set.erase(1) == 1);
+    CHECK(set.erase(1) == 0);
+    CHECK(!set.contains(1));
+    CHECK(set.size() == 1);
+
+    // The erased slot can be used again.
+    CHECK(set.insert(1).second);
+    CHECK(set.size() == 2);
+  }
+
+  SECTION("grows and keeps its storage when cleared") {
+    for (uint64_t i = 0; i < 1000; ++i) {
+      set.insert(i * 4096);
+    }
+    CHECK(set.size() == 1000);
+    for (uint64_t i = 0; i < 1000; ++i) {
+      CHECK(set.contains(i * 4096));
+    }
+
+    const size_t capacity = set.capacity();
+    CHECK(capacity >= 1000);
+    set.clear();
+    CHECK(set.empty());
+    CHECK(set.capacity() == capacity);
+    CHECK(!set.contains(0));
+  }
+
+  SECTION("visits each other value once when erasing while iterating") {
+    for (uint64_t i = 0; i < 100; ++i) {
+      set.insert(i);
+    }
+
+    std::unordered_set<uint64_t> visited;
+    for (auto it = set.begin(); it != set.end();) {
+      CHECK(visited.insert(*it).second);
+      if (*it % 2 == 0) {
+        it = set.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    CHECK(visited.size() == 100);
+    CHECK(set.size() == 50);
+    for (const uint64_t value : set) {
+      CHECK(value % 2 == 1);
+    }
+  }
+
+  SECTION("can be copied and moved") {
+    set.insert(1);
+    set.insert(2);
+
+    FlatHashSet<uint64_t> copy = set;
+    CHECK(copy.size() == 2);
+    CHECK(copy.contains(1));
+    CHECK(copy.contains(2));
+
+    FlatHashSet<uint64_t> moved = std::move(set);
+    CHECK(moved.size() == 2);
+    CHECK(set.empty());
+
+    set = moved;
+    CHECK(set.size() == 2);
+  }
+}
+
+TEST_CASE("FlatHashMap") {
+  FlatHashMap<std::string, int32_t> map;
+
+  map["one"] = 1;
+  CHECK(map.try_emplace("two", 2).second);
+  CHECK(!map.try_emplace("two", 3).second);
+  CHECK(!map.insert_or_assign("one", 10).second);
+  CHECK(map.insert_or_assign("three", 3).second);
+
+  CHECK(map.size() == 3);
+  CHECK(map.at("one") == 10);
+  CHECK(map.at("two") == 2);
+  CHECK(map.find("three")->second == 3);
+  CHECK_THROWS(map.at("four"));
+
+  CHECK(map.erase("two") == 1);
+  CHECK(map.size() == 2);
+
+  std::vector<std::string> keys;
+  for (const auto& pair : map) {
+    keys.emplace_back(pair.first);
+  }
+  CHECK(keys.size() == 2);
+}